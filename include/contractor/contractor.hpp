@@ -58,6 +58,23 @@ class Contractor
 
     int Run();
 
+    // Loads the edge-based graph and node weights, applying the speed and turn penalty updates.
+    // Also used by osrm-customize to get the same weights without contracting.
+    static EdgeID
+    LoadEdgeExpandedGraph(const std::string &edge_based_graph_path,
+                          util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+                          std::vector<EdgeWeight> &node_weights,
+                          const std::string &edge_segment_lookup_path,
+                          const std::string &edge_penalty_path,
+                          const std::vector<std::string> &segment_speed_path,
+                          const std::vector<std::string> &turn_penalty_path,
+                          const std::string &nodes_filename,
+                          const std::string &geometry_filename,
+                          const std::string &datasource_names_filename,
+                          const std::string &datasource_indexes_filename,
+                          const std::string &rtree_leaf_filename,
+                          const double log_edge_updates_factor);
+
   protected:
     void ContractGraph(const unsigned max_edge_id,
                        util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
@@ -65,6 +82,13 @@ class Contractor
                        std::vector<EdgeWeight> &&node_weights,
                        std::vector<bool> &is_core_node,
                        std::vector<float> &inout_node_levels) const;
+    // Contracts the graph in the order of the node levels, reusing the hierarchy of the last run
+    void ContractGraphIncremental(
+        const unsigned max_edge_id,
+        util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+        util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+        std::vector<EdgeWeight> &&node_weights,
+        std::vector<float> &inout_node_levels) const;
     void WriteCoreNodeMarker(std::vector<bool> &&is_core_node) const;
     void WriteNodeLevels(std::vector<float> &&node_levels) const;
     void ReadNodeLevels(std::vector<float> &contraction_order) const;
@@ -77,21 +101,6 @@ class Contractor
 
   private:
     ContractorConfig config;
-
-    EdgeID
-    LoadEdgeExpandedGraph(const std::string &edge_based_graph_path,
-                          util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
-                          std::vector<EdgeWeight> &node_weights,
-                          const std::string &edge_segment_lookup_path,
-                          const std::string &edge_penalty_path,
-                          const std::vector<std::string> &segment_speed_path,
-                          const std::vector<std::string> &turn_penalty_path,
-                          const std::string &nodes_filename,
-                          const std::string &geometry_filename,
-                          const std::string &datasource_names_filename,
-                          const std::string &datasource_indexes_filename,
-                          const std::string &rtree_leaf_filename,
-                          const double log_edge_updates_factor);
 };
 }
 }
@@ -71,6 +71,9 @@ struct ContractorConfig
     std::string geometry_path;
     std::string rtree_leaf_path;
     bool use_cached_priority;
+    // Re-contract only the parts of the hierarchy of the last run that are affected by changed
+    // weights, needs its .hsgr and .level
+    bool use_previous_hierarchy;
 
     unsigned requested_num_threads;
     double log_edge_updates_factor;
@@ -5,9 +5,13 @@
 #include "util/binary_heap.hpp"
 #include "util/deallocating_vector.hpp"
 #include "util/dynamic_graph.hpp"
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
 #include "util/integer_range.hpp"
 #include "util/log.hpp"
 #include "util/percent.hpp"
+#include "util/radix_heap.hpp"
+#include "util/static_graph.hpp"
 #include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 #include "util/xor_fast_hash.hpp"
@@ -22,8 +26,12 @@
 #include <tbb/parallel_sort.h>
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <memory>
+#include <numeric>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -74,18 +82,60 @@ class GraphContractor
     //    using ContractorHeap = util::BinaryHeap<NodeID, NodeID, int, ContractorHeapData,
     //    ArrayStorage<NodeID, NodeID>
     //    >;
-    using ContractorHeap = util::BinaryHeap<NodeID,
-                                            NodeID,
-                                            int,
-                                            ContractorHeapData,
-                                            util::XORFastHashStorage<NodeID, NodeID>>;
+    // The witness search is monotone (targets start at INVALID_EDGE_WEIGHT and are only
+    // decreased), so the radix heap can be used, see heap-bench
+    using ContractorHeap = util::RadixHeap<NodeID,
+                                           NodeID,
+                                           int,
+                                           ContractorHeapData,
+                                           util::XORFastHashStorage<NodeID, NodeID>>;
     using ContractorEdge = ContractorGraph::InputEdge;
 
+    // One direction of an edge of a node, used to compare it to the previous hierarchy
+    struct AdjacentEdge
+    {
+        NodeID target;
+        EdgeWeight weight;
+        bool forward;
+        EdgeID edge;
+
+        bool operator<(const AdjacentEdge &other) const
+        {
+            return std::tie(target, weight, forward) <
+                   std::tie(other.target, other.weight, other.forward);
+        }
+        bool operator==(const AdjacentEdge &other) const
+        {
+            return std::tie(target, weight, forward) ==
+                   std::tie(other.target, other.weight, other.forward);
+        }
+    };
+
+    // A shortcut of a node in forward direction, used to compare it to the previous hierarchy
+    struct Shortcut
+    {
+        NodeID source;
+        NodeID target;
+        EdgeWeight weight;
+
+        bool operator<(const Shortcut &other) const
+        {
+            return std::tie(source, target, weight) <
+                   std::tie(other.source, other.target, other.weight);
+        }
+    };
+
     struct ContractorThreadData
     {
         ContractorHeap heap;
         std::vector<ContractorEdge> inserted_edges;
         std::vector<NodeID> neighbours;
+        std::vector<AdjacentEdge> current_edges;
+        std::vector<AdjacentEdge> previous_edges;
+        // edge directions ignored when contracting with the previous hierarchy
+        std::vector<AdjacentEdge> dominated_edges;
+        std::vector<Shortcut> current_shortcuts;
+        std::vector<Shortcut> previous_shortcuts;
         explicit ContractorThreadData(NodeID nodes) : heap(nodes) {}
     };
 
@@ -133,6 +183,75 @@ class GraphContractor
         EnumerableThreadData data;
     };
 
+    // Lower bounds of the distances from a node to the closest change that witness searches can
+    // still reach, see RunIncremental. The graph holds the reversed edges. Distances above the
+    // bound are not needed and stay INVALID_EDGE_WEIGHT.
+    struct ChangeDistances
+    {
+        template <typename ContainerT>
+        ChangeDistances(const NodeID number_of_nodes,
+                        const ContainerT &edges,
+                        const std::int64_t bound)
+            : graph(number_of_nodes, edges), distances(number_of_nodes, INVALID_EDGE_WEIGHT),
+              heap(number_of_nodes),
+              bound(std::min<std::int64_t>(bound, INVALID_EDGE_WEIGHT - 1))
+        {
+        }
+
+        // Replaces the distances by the ones to the closest of changed_nodes
+        void Reset(const std::vector<NodeID> &changed_nodes)
+        {
+            for (const auto node : reached_nodes)
+            {
+                distances[node] = INVALID_EDGE_WEIGHT;
+            }
+            reached_nodes.clear();
+            heap.Clear();
+            for (const auto node : changed_nodes)
+            {
+                if (distances[node] > 0)
+                {
+                    distances[node] = 0;
+                    reached_nodes.push_back(node);
+                    heap.Insert(node, 0, node);
+                }
+            }
+            while (!heap.Empty())
+            {
+                const NodeID node = heap.DeleteMin();
+                const std::int64_t distance = distances[node];
+                for (const auto edge : graph.GetAdjacentEdgeRange(node))
+                {
+                    const NodeID target = graph.GetTarget(edge);
+                    const auto target_distance = distance + graph.GetEdgeData(edge).weight;
+                    if (target_distance > bound || target_distance >= distances[target])
+                    {
+                        continue;
+                    }
+                    if (distances[target] == INVALID_EDGE_WEIGHT)
+                    {
+                        reached_nodes.push_back(target);
+                    }
+                    distances[target] = static_cast<EdgeWeight>(target_distance);
+                    if (heap.WasInserted(target))
+                    {
+                        heap.DecreaseKey(target, distances[target]);
+                    }
+                    else
+                    {
+                        heap.Insert(target, distances[target], target);
+                    }
+                }
+            }
+        }
+
+        util::StaticGraph<QueryEdge::EdgeData> graph;
+        std::vector<EdgeWeight> distances;
+        std::vector<NodeID> reached_nodes;
+        util::BinaryHeap<NodeID, NodeID, EdgeWeight, NodeID> heap;
+        std::int64_t bound;
+    };
+
   public:
     template <class ContainerT>
     GraphContractor(int nodes, ContainerT &input_edge_list)
@@ -508,39 +627,7 @@ class GraphContractor
                     }
                 });
 
-            // make sure we really sort each block
-            tbb::parallel_for(
-                thread_data_list.data.range(),
-                [&](const ThreadDataContainer::EnumerableThreadData::range_type &range) {
-                    for (auto &data : range)
-                        tbb::parallel_sort(data->inserted_edges.begin(),
-                                           data->inserted_edges.end());
-                });
-
-            // insert new edges
-            for (auto &data : thread_data_list.data)
-            {
-                for (const ContractorEdge &edge : data->inserted_edges)
-                {
-                    const EdgeID current_edge_ID =
-                        contractor_graph->FindEdge(edge.source, edge.target);
-                    if (current_edge_ID < contractor_graph->EndEdges(edge.source))
-                    {
-                        ContractorGraph::EdgeData &current_data =
-                            contractor_graph->GetEdgeData(current_edge_ID);
-                        if (current_data.shortcut && edge.data.forward == current_data.forward &&
-                            edge.data.backward == current_data.backward &&
-                            edge.data.weight < current_data.weight)
-                        {
-                            // found a duplicate edge with smaller weight, update it.
-                            current_data = edge.data;
-                            continue;
-                        }
-                    }
-                    contractor_graph->InsertEdge(edge.source, edge.target, edge.data);
-                }
-                data->inserted_edges.clear();
-            }
+            InsertEdges(thread_data_list);
 
             if (!use_cached_node_priorities)
             {
@@ -607,6 +694,357 @@ class GraphContractor
         thread_data_list.data.clear();
     }
 
+    /**
+     * Contracts the graph again after weight updates, in the order stored in the node levels of
+     * a previous run and reusing the witness searches of the hierarchy that run produced.
+     *
+     * The previous hierarchy has to come from a run that wrote the node levels, so that the nodes
+     * were contracted level by level. Contracting in the same order, the witnesses found for a
+     * node stay valid as long as no edge in the radius of its witness searches changed: every
+     * edge there either is an original edge with the same weight or a shortcut whose middle node
+     * could reuse its contraction as well. A witness search only sees a changed edge if it
+     * settles its source, and it only settles nodes that are not contracted yet, so a change is
+     * out of reach as soon as one of its end points is contracted. The distance from a node to
+     * the source of the closest change left is bounded from below by searches on the reversed
+     * original edges with the smaller of both weights, and a node is only re-contracted with
+     * witness searches if
+     *
+     *  - its edges differ from the edges it has in the previous hierarchy, other than by parallel
+     *    edges that are dominated by a shorter one,
+     *  - that distance is at most the radius of one of its witness searches, which start at the
+     *    source of an incoming edge and settle nodes up to the longest path over the node,
+     *  - or it can't be contracted in the same round as before because of new shortcuts.
+     *
+     * All other nodes get the shortcuts of the previous run, which are looked up in the previous
+     * hierarchy. A re-contracted node only changes the graph the later nodes see if its witness
+     * searches found other shortcuts than the previous run inserted for it, so only the end
+     * points of these shortcuts count as changes for the nodes contracted later.
+     *
+     * Returns the number of nodes that had to be re-contracted.
+     */
+    NodeID RunIncremental(const util::StaticGraph<QueryEdge::EdgeData> &previous_hierarchy)
+    {
+        const NodeID number_of_nodes = contractor_graph->GetNumberOfNodes();
+        if (node_levels.size() != number_of_nodes ||
+            previous_hierarchy.GetNumberOfNodes() != number_of_nodes)
+        {
+            throw util::exception("The node levels and the previous hierarchy don't match the "
+                                  "edge-based graph" +
+                                  SOURCE_REF);
+        }
+
+        previous_node_levels.swap(node_levels);
+        node_levels.resize(number_of_nodes);
+
+        // compare the original edges to the ones in the previous hierarchy, which are stored at
+        // the node that was contracted first
+        std::vector<QueryEdge> current_original_edges;
+        std::vector<QueryEdge> previous_original_edges;
+        EdgeWeight max_search_weight = 0;
+        for (const auto node : util::irange(0u, number_of_nodes))
+        {
+            for (const auto edge : contractor_graph->GetAdjacentEdgeRange(node))
+            {
+                current_original_edges.emplace_back(
+                    node, contractor_graph->GetTarget(edge), contractor_graph->GetEdgeData(edge));
+            }
+
+            EdgeWeight max_in_weight = 0;
+            EdgeWeight max_out_weight = 0;
+            for (const auto edge : previous_hierarchy.GetAdjacentEdgeRange(node))
+            {
+                const NodeID target = previous_hierarchy.GetTarget(edge);
+                const auto &data = previous_hierarchy.GetEdgeData(edge);
+                if (target == node)
+                {
+                    continue;
+                }
+                if (target >= number_of_nodes ||
+                    previous_node_levels[target] <= previous_node_levels[node])
+                {
+                    throw util::exception("The previous hierarchy was not contracted in the "
+                                          "order of the node levels" +
+                                          SOURCE_REF);
+                }
+                if (data.backward)
+                {
+                    max_in_weight = std::max<EdgeWeight>(max_in_weight, data.weight);
+                }
+                if (data.forward)
+                {
+                    max_out_weight = std::max<EdgeWeight>(max_out_weight, data.weight);
+                }
+                if (!data.shortcut)
+                {
+                    previous_original_edges.emplace_back(node, target, data);
+                    auto reverse_data = data;
+                    reverse_data.forward = data.backward;
+                    reverse_data.backward = data.forward;
+                    previous_original_edges.emplace_back(target, node, reverse_data);
+                }
+            }
+            max_search_weight = std::max(max_search_weight, max_in_weight + max_out_weight);
+        }
+        const auto by_edge = [](const QueryEdge &lhs, const QueryEdge &rhs) {
+            return std::make_tuple(lhs.source, lhs.target, lhs.data.weight, lhs.data.forward) <
+                   std::make_tuple(rhs.source, rhs.target, rhs.data.weight, rhs.data.forward);
+        };
+        tbb::parallel_sort(current_original_edges.begin(), current_original_edges.end(), by_edge);
+        tbb::parallel_sort(previous_original_edges.begin(), previous_original_edges.end(), by_edge);
+
+        // edges that are only in one of both graphs, later also the shortcuts that differ, from
+        // source to target
+        std::vector<std::pair<NodeID, NodeID>> changed_edges;
+        {
+            const auto add_changed_edge = [&changed_edges](const QueryEdge &edge) {
+                if (edge.data.forward)
+                {
+                    changed_edges.emplace_back(edge.source, edge.target);
+                }
+                if (edge.data.backward)
+                {
+                    changed_edges.emplace_back(edge.target, edge.source);
+                }
+            };
+            const auto same_edge = [](const QueryEdge &lhs, const QueryEdge &rhs) {
+                return lhs.source == rhs.source && lhs.target == rhs.target &&
+                       lhs.data.weight == rhs.data.weight && lhs.data.forward == rhs.data.forward &&
+                       lhs.data.backward == rhs.data.backward;
+            };
+            auto current = current_original_edges.begin();
+            auto previous = previous_original_edges.begin();
+            while (current != current_original_edges.end() ||
+                   previous != previous_original_edges.end())
+            {
+                if (previous == previous_original_edges.end() ||
+                    (current != current_original_edges.end() && by_edge(*current, *previous)))
+                {
+                    add_changed_edge(*current++);
+                }
+                else if (current == current_original_edges.end() || by_edge(*previous, *current))
+                {
+                    add_changed_edge(*previous++);
+                }
+                else
+                {
+                    if (!same_edge(*current, *previous))
+                    {
+                        add_changed_edge(*current);
+                        add_changed_edge(*previous);
+                    }
+                    ++current;
+                    ++previous;
+                }
+            }
+        }
+        std::vector<bool> is_changed_node(number_of_nodes, false);
+        for (const auto &edge : changed_edges)
+        {
+            is_changed_node[edge.first] = true;
+            is_changed_node[edge.second] = true;
+        }
+        const auto number_of_changed_nodes =
+            std::count(is_changed_node.begin(), is_changed_node.end(), true);
+
+        // the sources of the changes
+        std::vector<NodeID> changed_nodes;
+        const auto collect_changed_nodes = [&changed_edges, &changed_nodes] {
+            changed_nodes.clear();
+            for (const auto &edge : changed_edges)
+            {
+                changed_nodes.push_back(edge.first);
+            }
+            std::sort(changed_nodes.begin(), changed_nodes.end());
+            changed_nodes.erase(std::unique(changed_nodes.begin(), changed_nodes.end()),
+                                changed_nodes.end());
+        };
+        collect_changed_nodes();
+
+        // the original edges with the smaller of both weights, kept at their target, the distances
+        // in this graph are lower bounds for both the previous and the current graph
+        auto &edges = current_original_edges;
+        edges.insert(edges.end(), previous_original_edges.begin(), previous_original_edges.end());
+        previous_original_edges.clear();
+        previous_original_edges.shrink_to_fit();
+        edges.erase(std::remove_if(edges.begin(),
+                                   edges.end(),
+                                   [](const QueryEdge &edge) { return !edge.data.backward; }),
+                    edges.end());
+        tbb::parallel_sort(edges.begin(), edges.end(), by_edge);
+        edges.erase(std::unique(edges.begin(),
+                                edges.end(),
+                                [](const QueryEdge &lhs, const QueryEdge &rhs) {
+                                    return lhs.source == rhs.source && lhs.target == rhs.target;
+                                }),
+                    edges.end());
+        ChangeDistances change_distances(number_of_nodes, edges, max_search_weight);
+        edges.clear();
+        edges.shrink_to_fit();
+        change_distances.Reset(changed_nodes);
+
+        std::vector<bool> is_contracted_node(number_of_nodes, false);
+
+        // contract the nodes level by level
+        std::vector<NodeID> nodes_by_level(number_of_nodes);
+        std::iota(nodes_by_level.begin(), nodes_by_level.end(), 0);
+        tbb::parallel_sort(
+            nodes_by_level.begin(), nodes_by_level.end(), [&](const NodeID lhs, const NodeID rhs) {
+                return std::tie(previous_node_levels[lhs], lhs) <
+                       std::tie(previous_node_levels[rhs], rhs);
+            });
+
+        util::Log() << "re-contracting " << number_of_nodes << " nodes, "
+                    << number_of_changed_nodes << " nodes have changed edges ...";
+
+        util::UnbufferedLog log;
+        util::Percent p(log, number_of_nodes);
+
+        const constexpr size_t IndependentGrainSize = 1;
+        const constexpr size_t ContractGrainSize = 1;
+        const constexpr size_t DeleteGrainSize = 1;
+
+        ThreadDataContainer thread_data_list(number_of_nodes);
+        this->previous_hierarchy = &previous_hierarchy;
+        NodeID number_of_recontracted_nodes = 0;
+        NodeID number_of_contracted_nodes = 0;
+        unsigned current_level = 0;
+
+        std::vector<RemainingNodeData> level_nodes;
+        auto level_begin = nodes_by_level.begin();
+        while (level_begin != nodes_by_level.end())
+        {
+            const auto level_end = std::find_if(level_begin, nodes_by_level.end(), [&](NodeID node) {
+                return previous_node_levels[node] != previous_node_levels[*level_begin];
+            });
+            level_nodes.resize(std::distance(level_begin, level_end));
+            std::transform(level_begin, level_end, level_nodes.begin(), [](const NodeID node) {
+                RemainingNodeData node_data;
+                node_data.id = node;
+                return node_data;
+            });
+            level_begin = level_end;
+
+            // new shortcuts can connect nodes of the same level, these wait for another round
+            while (!level_nodes.empty())
+            {
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(0, level_nodes.size(), IndependentGrainSize),
+                    [this, &level_nodes, &thread_data_list](
+                        const tbb::blocked_range<std::size_t> &range) {
+                        ContractorThreadData *data = thread_data_list.GetThreadData();
+                        for (auto i = range.begin(), end = range.end(); i != end; ++i)
+                        {
+                            const NodeID node = level_nodes[i].id;
+                            level_nodes[i].is_independent =
+                                this->IsNodeIndependent(previous_node_levels, data, node);
+                        }
+                    });
+                const auto begin_independent_nodes = std::stable_partition(
+                    level_nodes.begin(), level_nodes.end(), [](RemainingNodeData node_data) {
+                        return !node_data.is_independent;
+                    });
+                const std::size_t begin_independent_nodes_idx =
+                    std::distance(level_nodes.begin(), begin_independent_nodes);
+                const std::size_t end_independent_nodes_idx = level_nodes.size();
+                for (const auto i : util::irange<std::size_t>(0, begin_independent_nodes_idx))
+                {
+                    is_changed_node[level_nodes[i].id] = true;
+                }
+
+                std::vector<char> recontract(end_independent_nodes_idx -
+                                             begin_independent_nodes_idx);
+                std::vector<std::vector<std::pair<NodeID, NodeID>>> changed_shortcuts(
+                    recontract.size());
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(
+                        begin_independent_nodes_idx, end_independent_nodes_idx, ContractGrainSize),
+                    [&](const tbb::blocked_range<std::size_t> &range) {
+                        ContractorThreadData *data = thread_data_list.GetThreadData();
+                        for (auto position = range.begin(), end = range.end(); position != end;
+                             ++position)
+                        {
+                            const NodeID x = level_nodes[position].id;
+                            node_levels[x] = current_level;
+                            if (!is_changed_node[x] &&
+                                this->CanReuseContraction(data, change_distances, x))
+                            {
+                                this->ContractNode<false, true>(data, x);
+                            }
+                            else
+                            {
+                                const auto index = position - begin_independent_nodes_idx;
+                                const auto first_inserted_edge = data->inserted_edges.size();
+                                recontract[index] = true;
+                                this->ContractNode<false>(data, x);
+                                this->FindChangedShortcuts(
+                                    data, x, first_inserted_edge, changed_shortcuts[index]);
+                            }
+                        }
+                    });
+
+                tbb::parallel_for(
+                    tbb::blocked_range<std::size_t>(
+                        begin_independent_nodes_idx, end_independent_nodes_idx, DeleteGrainSize),
+                    [this, &level_nodes, &thread_data_list](
+                        const tbb::blocked_range<std::size_t> &range) {
+                        ContractorThreadData *data = thread_data_list.GetThreadData();
+                        for (auto position = range.begin(), end = range.end(); position != end;
+                             ++position)
+                        {
+                            this->DeleteIncomingEdges(data, level_nodes[position].id);
+                        }
+                    });
+
+                InsertEdges(thread_data_list);
+
+                // drop the changes that the witness searches of later nodes can't reach anymore
+                for (const auto position :
+                     util::irange(begin_independent_nodes_idx, end_independent_nodes_idx))
+                {
+                    is_contracted_node[level_nodes[position].id] = true;
+                }
+                const auto number_of_changed_edges = changed_edges.size();
+                changed_edges.erase(
+                    std::remove_if(changed_edges.begin(),
+                                   changed_edges.end(),
+                                   [&](const std::pair<NodeID, NodeID> &edge) {
+                                       return is_contracted_node[edge.first] ||
+                                              is_contracted_node[edge.second];
+                                   }),
+                    changed_edges.end());
+                bool changes_differ = changed_edges.size() != number_of_changed_edges;
+                for (const auto &shortcuts : changed_shortcuts)
+                {
+                    changed_edges.insert(changed_edges.end(), shortcuts.begin(), shortcuts.end());
+                    changes_differ |= !shortcuts.empty();
+                }
+                if (changes_differ)
+                {
+                    collect_changed_nodes();
+                    change_distances.Reset(changed_nodes);
+                }
+
+                number_of_recontracted_nodes +=
+                    std::count(recontract.begin(), recontract.end(), true);
+                number_of_contracted_nodes +=
+                    end_independent_nodes_idx - begin_independent_nodes_idx;
+                level_nodes.resize(begin_independent_nodes_idx);
+
+                p.PrintStatus(number_of_contracted_nodes);
+                ++current_level;
+            }
+        }
+        log << " re-contracted " << number_of_recontracted_nodes << " nodes";
+
+        this->previous_hierarchy = nullptr;
+        previous_node_levels.clear();
+        previous_node_levels.shrink_to_fit();
+        thread_data_list.data.clear();
+        is_core_node.clear();
+
+        return number_of_recontracted_nodes;
+    }
+
     inline void GetCoreMarker(std::vector<bool> &out_is_core_node)
     {
         out_is_core_node.swap(is_core_node);
@@ -675,6 +1113,274 @@ class GraphContractor
     }
 
   private:
+    // Inserts the shortcuts of the contracted nodes, keeping only the shorter of duplicates
+    inline void InsertEdges(ThreadDataContainer &thread_data_list)
+    {
+        // make sure we really sort each block
+        tbb::parallel_for(
+            thread_data_list.data.range(),
+            [&](const ThreadDataContainer::EnumerableThreadData::range_type &range) {
+                for (auto &data : range)
+                    tbb::parallel_sort(data->inserted_edges.begin(), data->inserted_edges.end());
+            });
+
+        for (auto &data : thread_data_list.data)
+        {
+            for (const ContractorEdge &edge : data->inserted_edges)
+            {
+                const EdgeID current_edge_ID = contractor_graph->FindEdge(edge.source, edge.target);
+                if (current_edge_ID < contractor_graph->EndEdges(edge.source))
+                {
+                    ContractorGraph::EdgeData &current_data =
+                        contractor_graph->GetEdgeData(current_edge_ID);
+                    if (current_data.shortcut && edge.data.forward == current_data.forward &&
+                        edge.data.backward == current_data.backward &&
+                        edge.data.weight < current_data.weight)
+                    {
+                        // found a duplicate edge with smaller weight, update it.
+                        current_data = edge.data;
+                        continue;
+                    }
+                }
+                contractor_graph->InsertEdge(edge.source, edge.target, edge.data);
+            }
+            data->inserted_edges.clear();
+        }
+    }
+
+    // A node can be contracted with the witnesses of the previous hierarchy if it has the same
+    // edges as there and no change is in reach of its witness searches, see RunIncremental.
+    // Edges are compared per direction. Differences are fine if the edge is dominated by a
+    // parallel one of the other side, they occur when a shortcut of a node contracted later
+    // replaces one edge or another. Additional dominated edges are kept in the thread data.
+    inline bool CanReuseContraction(ContractorThreadData *const data,
+                                    const ChangeDistances &change_distances,
+                                    const NodeID node) const
+    {
+        BOOST_ASSERT(previous_hierarchy);
+        auto &current_edges = data->current_edges;
+        auto &previous_edges = data->previous_edges;
+        auto &dominated_edges = data->dominated_edges;
+        current_edges.clear();
+        previous_edges.clear();
+        dominated_edges.clear();
+
+        for (const auto edge : contractor_graph->GetAdjacentEdgeRange(node))
+        {
+            const auto &edge_data = contractor_graph->GetEdgeData(edge);
+            const auto target = contractor_graph->GetTarget(edge);
+            const auto weight = static_cast<EdgeWeight>(edge_data.weight);
+            if (edge_data.backward)
+            {
+                current_edges.push_back({target, weight, false, edge});
+            }
+            if (edge_data.forward)
+            {
+                current_edges.push_back({target, weight, true, edge});
+            }
+        }
+
+        for (const auto edge : previous_hierarchy->GetAdjacentEdgeRange(node))
+        {
+            const auto &edge_data = previous_hierarchy->GetEdgeData(edge);
+            const auto target = previous_hierarchy->GetTarget(edge);
+            if (edge_data.backward)
+            {
+                previous_edges.push_back({target, edge_data.weight, false, edge});
+            }
+            if (edge_data.forward)
+            {
+                previous_edges.push_back({target, edge_data.weight, true, edge});
+            }
+        }
+        std::sort(current_edges.begin(), current_edges.end());
+        std::sort(previous_edges.begin(), previous_edges.end());
+
+        const auto is_dominated = [](const AdjacentEdge &edge,
+                                     const std::vector<AdjacentEdge> &other_edges) {
+            return std::any_of(
+                other_edges.begin(), other_edges.end(), [&](const AdjacentEdge &other) {
+                    return other.target == edge.target && other.forward == edge.forward &&
+                           other.weight <= edge.weight;
+                });
+        };
+        auto current = current_edges.begin();
+        auto previous = previous_edges.begin();
+        while (current != current_edges.end() || previous != previous_edges.end())
+        {
+            if (previous == previous_edges.end() ||
+                (current != current_edges.end() && *current < *previous))
+            {
+                if (!is_dominated(*current, previous_edges))
+                {
+                    return false;
+                }
+                dominated_edges.push_back(*current++);
+            }
+            else if (current == current_edges.end() || *previous < *current)
+            {
+                // the previous contraction only added dominated shortcuts for it
+                if (!is_dominated(*previous++, current_edges))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                ++current;
+                ++previous;
+            }
+        }
+
+        // the previous witness searches started at the source of an incoming edge and settled
+        // nodes up to the longest path over node, the edges that differ were dominated there
+        std::int64_t max_out_weight = 0;
+        for (const auto &edge : previous_edges)
+        {
+            if (edge.forward && edge.target != node)
+            {
+                max_out_weight = std::max<std::int64_t>(max_out_weight, edge.weight);
+            }
+        }
+        return std::none_of(
+            previous_edges.begin(), previous_edges.end(), [&](const AdjacentEdge &edge) {
+                return !edge.forward && edge.target != node &&
+                       change_distances.distances[edge.target] <= edge.weight + max_out_weight;
+            });
+    }
+
+    // Compares the shortcuts the witness searches of node found, the inserted edges from
+    // first_inserted_edge on, to the ones the previous contraction of node inserted, and adds the
+    // end points of the differences to changed_shortcuts. A shortcut of the previous run that
+    // was replaced by a shorter one of a node contracted later is only known to be different if
+    // the witness searches now need it. If they don't, a witness at most as long exists, which
+    // leaves the distances the later witness searches see unchanged.
+    inline void
+    FindChangedShortcuts(ContractorThreadData *const data,
+                         const NodeID node,
+                         const std::size_t first_inserted_edge,
+                         std::vector<std::pair<NodeID, NodeID>> &changed_shortcuts) const
+    {
+        auto &current_shortcuts = data->current_shortcuts;
+        auto &previous_shortcuts = data->previous_shortcuts;
+        current_shortcuts.clear();
+        previous_shortcuts.clear();
+
+        for (const auto i : util::irange(first_inserted_edge, data->inserted_edges.size()))
+        {
+            const auto &edge = data->inserted_edges[i];
+            if (edge.data.forward && edge.source != edge.target)
+            {
+                current_shortcuts.push_back(
+                    {edge.source, edge.target, static_cast<EdgeWeight>(edge.data.weight)});
+            }
+        }
+
+        for (const auto edge : previous_hierarchy->GetAdjacentEdgeRange(node))
+        {
+            // the shortcuts of node are stored at its neighbours, which were contracted later
+            const NodeID neighbour = previous_hierarchy->GetTarget(edge);
+            for (const auto shortcut : previous_hierarchy->GetAdjacentEdgeRange(neighbour))
+            {
+                const auto &shortcut_data = previous_hierarchy->GetEdgeData(shortcut);
+                const NodeID other = previous_hierarchy->GetTarget(shortcut);
+                if (!shortcut_data.shortcut || shortcut_data.id != node || other == neighbour)
+                {
+                    continue;
+                }
+                const auto weight = static_cast<EdgeWeight>(shortcut_data.weight);
+                if (shortcut_data.forward)
+                {
+                    previous_shortcuts.push_back({neighbour, other, weight});
+                }
+                if (shortcut_data.backward)
+                {
+                    previous_shortcuts.push_back({other, neighbour, weight});
+                }
+            }
+        }
+
+        const auto same_end_points = [](const Shortcut &lhs, const Shortcut &rhs) {
+            return lhs.source == rhs.source && lhs.target == rhs.target;
+        };
+        for (auto *shortcuts : {&current_shortcuts, &previous_shortcuts})
+        {
+            std::sort(shortcuts->begin(), shortcuts->end());
+            shortcuts->erase(std::unique(shortcuts->begin(), shortcuts->end(), same_end_points),
+                             shortcuts->end());
+        }
+
+        const auto add_end_points = [&changed_shortcuts](const Shortcut &shortcut) {
+            changed_shortcuts.emplace_back(shortcut.source, shortcut.target);
+        };
+        auto current = current_shortcuts.begin();
+        auto previous = previous_shortcuts.begin();
+        while (current != current_shortcuts.end() || previous != previous_shortcuts.end())
+        {
+            if (previous == previous_shortcuts.end() ||
+                (current != current_shortcuts.end() && *current < *previous))
+            {
+                if (!HasPreviousShortcut(current->source, current->target, node, current->weight))
+                {
+                    add_end_points(*current);
+                }
+                ++current;
+            }
+            else if (current == current_shortcuts.end() || *previous < *current)
+            {
+                add_end_points(*previous++);
+            }
+            else
+            {
+                ++current;
+                ++previous;
+            }
+        }
+    }
+
+    // Whether the previous contraction of node inserted a shortcut from source to target with
+    // the given weight. It is either still in the previous hierarchy or was replaced by a shorter
+    // one of a node contracted later. The latter might as well have been a witness, so this
+    // errs on the side of inserting a shortcut.
+    inline bool HasPreviousShortcut(const NodeID source,
+                                    const NodeID target,
+                                    const NodeID node,
+                                    const int weight) const
+    {
+        BOOST_ASSERT(previous_hierarchy);
+        const auto is_previous_shortcut = [&](const QueryEdge::EdgeData &data) {
+            if (!data.shortcut)
+            {
+                return false;
+            }
+            if (data.id == node)
+            {
+                return data.weight == weight;
+            }
+            return data.weight < weight &&
+                   previous_node_levels[data.id] > previous_node_levels[node];
+        };
+        for (const auto edge : previous_hierarchy->GetAdjacentEdgeRange(source))
+        {
+            const auto &data = previous_hierarchy->GetEdgeData(edge);
+            if (data.forward && previous_hierarchy->GetTarget(edge) == target &&
+                is_previous_shortcut(data))
+            {
+                return true;
+            }
+        }
+        for (const auto edge : previous_hierarchy->GetAdjacentEdgeRange(target))
+        {
+            const auto &data = previous_hierarchy->GetEdgeData(edge);
+            if (data.backward && previous_hierarchy->GetTarget(edge) == source &&
+                is_previous_shortcut(data))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
     inline void RelaxNode(const NodeID node,
                           const NodeID forbidden_node,
                           const int weight,
@@ -773,7 +1479,9 @@ class GraphContractor
         return result;
     }
 
-    template <bool RUNSIMULATION>
+    // With USE_PREVIOUS_HIERARCHY no witness searches are run, the shortcuts of the previous
+    // hierarchy are inserted instead, see RunIncremental.
+    template <bool RUNSIMULATION, bool USE_PREVIOUS_HIERARCHY = false>
     inline bool
     ContractNode(ContractorThreadData *data, const NodeID node, ContractionStats *stats = nullptr)
     {
@@ -786,6 +1494,15 @@ class GraphContractor
         const constexpr bool REVERSE_DIRECTION_ENABLED = true;
         const constexpr bool REVERSE_DIRECTION_DISABLED = false;
 
+        const auto is_dominated = [data](const EdgeID edge, const bool forward) {
+            return USE_PREVIOUS_HIERARCHY &&
+                   std::any_of(data->dominated_edges.begin(),
+                               data->dominated_edges.end(),
+                               [&](const AdjacentEdge &dominated) {
+                                   return dominated.edge == edge && dominated.forward == forward;
+                               });
+        };
+
         for (auto in_edge : contractor_graph->GetAdjacentEdgeRange(node))
         {
             const ContractorEdgeData &in_data = contractor_graph->GetEdgeData(in_edge);
@@ -799,13 +1516,16 @@ class GraphContractor
                 ++stats->edges_deleted_count;
                 stats->original_edges_deleted_count += in_data.originalEdges;
             }
-            if (!in_data.backward)
+            if (!in_data.backward || is_dominated(in_edge, false))
             {
                 continue;
             }
 
-            heap.Clear();
-            heap.Insert(source, 0, ContractorHeapData{});
+            if (!USE_PREVIOUS_HIERARCHY)
+            {
+                heap.Clear();
+                heap.Insert(source, 0, ContractorHeapData{});
+            }
             int max_weight = 0;
             unsigned number_of_targets = 0;
 
@@ -817,7 +1537,7 @@ class GraphContractor
                     continue;
                 }
                 const NodeID target = contractor_graph->GetTarget(out_edge);
-                if (node == target)
+                if (node == target || is_dominated(out_edge, true))
                     continue;
 
                 const EdgeWeight path_weight = in_data.weight + out_data.weight;
@@ -868,7 +1588,7 @@ class GraphContractor
                     continue;
                 }
                 max_weight = std::max(max_weight, path_weight);
-                if (!heap.WasInserted(target))
+                if (!USE_PREVIOUS_HIERARCHY && !heap.WasInserted(target))
                 {
                     heap.Insert(target, INVALID_EDGE_WEIGHT, ContractorHeapData{0, true});
                     ++number_of_targets;
@@ -880,7 +1600,7 @@ class GraphContractor
                 const int constexpr SIMULATION_SEARCH_SPACE_SIZE = 1000;
                 Dijkstra(max_weight, number_of_targets, SIMULATION_SEARCH_SPACE_SIZE, *data, node);
             }
-            else
+            else if (!USE_PREVIOUS_HIERARCHY)
             {
                 const int constexpr FULL_SEARCH_SPACE_SIZE = 2000;
                 Dijkstra(max_weight, number_of_targets, FULL_SEARCH_SPACE_SIZE, *data, node);
@@ -893,11 +1613,13 @@ class GraphContractor
                     continue;
                 }
                 const NodeID target = contractor_graph->GetTarget(out_edge);
-                if (target == node)
+                if (target == node || is_dominated(out_edge, true))
                     continue;
                 const int path_weight = in_data.weight + out_data.weight;
-                const int weight = heap.GetKey(target);
-                if (path_weight < weight)
+                const bool needs_shortcut = USE_PREVIOUS_HIERARCHY
+                                                ? HasPreviousShortcut(source, target, node, path_weight)
+                                                : path_weight < heap.GetKey(target);
+                if (needs_shortcut)
                 {
                     if (RUNSIMULATION)
                     {
@@ -1104,6 +1826,9 @@ class GraphContractor
     }
 
     std::shared_ptr<ContractorGraph> contractor_graph;
+    // only set during RunIncremental
+    const util::StaticGraph<QueryEdge::EdgeData> *previous_hierarchy = nullptr;
+    std::vector<float> previous_node_levels;
     stxxl::vector<QueryEdge> external_edge_list;
     std::vector<NodeID> orig_node_id_from_new_node_id_map;
     std::vector<float> node_levels;
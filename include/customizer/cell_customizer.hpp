@@ -0,0 +1,151 @@
+#ifndef OSRM_CUSTOMIZER_CELL_CUSTOMIZER_HPP
+#define OSRM_CUSTOMIZER_CELL_CUSTOMIZER_HPP
+
+#include "customizer/cell_storage.hpp"
+#include "partition/multi_level_partition.hpp"
+
+#include "util/binary_heap.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <cstdint>
+
+namespace osrm
+{
+namespace customizer
+{
+
+/**
+ * Relaxes the outgoing arcs of node in a search restricted to the given cell on level: the
+ * cliques of the cells on level - 1 and the edges between those cells. On level 1 these are all
+ * edges inside the cell.
+ *
+ * The graph can be anything with the interface of a util::StaticGraph that stores every edge as
+ * forward edge at its source, like the graph of osrm-customize or the query data facade.
+ */
+template <bool UseSharedMemory, typename GraphT, typename HeapT>
+void relaxNodeInCell(const partition::MultiLevelPartitionImpl<UseSharedMemory> &partition,
+                     const CellStorageImpl<UseSharedMemory> &cell_storage,
+                     const GraphT &graph,
+                     HeapT &heap,
+                     const LevelID level,
+                     const CellID cell,
+                     const NodeID node,
+                     const EdgeWeight weight)
+{
+    BOOST_ASSERT(level > 0);
+    BOOST_ASSERT(partition.GetCell(level, node) == cell);
+    const LevelID sublevel = level - 1;
+
+    const auto relax = [&heap, node](const NodeID to, const EdgeWeight to_weight) {
+        if (!heap.WasInserted(to))
+        {
+            heap.Insert(to, to_weight, node);
+        }
+        else if (to_weight < heap.GetKey(to))
+        {
+            heap.GetData(to).parent = node;
+            heap.DecreaseKey(to, to_weight);
+        }
+    };
+
+    if (sublevel > 0)
+    {
+        const auto subcell = cell_storage.GetCell(sublevel, partition.GetCell(sublevel, node));
+        const auto source_index = subcell.GetSourceIndex(node);
+        if (source_index != subcell.INVALID_INDEX)
+        {
+            for (std::uint32_t index = 0; index < subcell.GetNumberOfDestinationNodes(); ++index)
+            {
+                const auto destination = subcell.GetDestinationNode(index);
+                const auto clique_weight = subcell.GetWeight(source_index, index);
+                if (destination != node && clique_weight != INVALID_EDGE_WEIGHT)
+                {
+                    relax(destination, weight + clique_weight);
+                }
+            }
+        }
+    }
+
+    for (const auto edge : graph.GetAdjacentEdgeRange(node))
+    {
+        const auto &data = graph.GetEdgeData(edge);
+        if (!data.forward)
+        {
+            continue;
+        }
+        const auto to = graph.GetTarget(edge);
+        if (partition.GetCell(level, to) == cell &&
+            (sublevel == 0 || partition.GetCell(sublevel, to) != partition.GetCell(sublevel, node)))
+        {
+            relax(to, weight + data.weight);
+        }
+    }
+}
+
+// Computes the clique weights of cells from the cliques one level below
+class CellCustomizer
+{
+  public:
+    struct HeapData
+    {
+        /* explicit */ HeapData(NodeID parent_) : parent(parent_) {}
+        NodeID parent;
+    };
+    using Heap = util::
+        BinaryHeap<NodeID, NodeID, EdgeWeight, HeapData, util::AdaptiveArrayStorage<NodeID, int>>;
+
+    explicit CellCustomizer(const partition::MultiLevelPartition &partition_)
+        : partition(partition_)
+    {
+    }
+
+    // Runs a search inside the cell from each of its source nodes until all destination nodes
+    // are settled. The cells on level - 1 need to be customized already.
+    template <typename GraphT>
+    void Customize(const GraphT &graph,
+                   Heap &heap,
+                   CellStorage &cell_storage,
+                   const LevelID level,
+                   const CellID id) const
+    {
+        auto cell = cell_storage.GetCell(level, id);
+        const auto &const_cell_storage = cell_storage;
+        for (std::uint32_t source_index = 0; source_index < cell.GetNumberOfSourceNodes();
+             ++source_index)
+        {
+            const auto source = cell.GetSourceNode(source_index);
+            heap.Clear();
+            heap.Insert(source, 0, source);
+
+            auto remaining_destinations = cell.GetNumberOfDestinationNodes();
+            while (!heap.Empty() && remaining_destinations > 0)
+            {
+                const auto weight = heap.MinKey();
+                const auto node = heap.DeleteMin();
+                if (cell.GetDestinationIndex(node) != cell.INVALID_INDEX)
+                {
+                    --remaining_destinations;
+                }
+                relaxNodeInCell(
+                    partition, const_cell_storage, graph, heap, level, id, node, weight);
+            }
+
+            // either all destinations or all reachable nodes are settled
+            for (std::uint32_t index = 0; index < cell.GetNumberOfDestinationNodes(); ++index)
+            {
+                const auto destination = cell.GetDestinationNode(index);
+                cell.GetWeight(source_index, index) =
+                    heap.WasInserted(destination) ? heap.GetKey(destination) : INVALID_EDGE_WEIGHT;
+            }
+        }
+    }
+
+  private:
+    const partition::MultiLevelPartition &partition;
+};
+}
+}
+
+#endif
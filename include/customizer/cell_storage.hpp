@@ -0,0 +1,277 @@
+#ifndef OSRM_CUSTOMIZER_CELL_STORAGE_HPP
+#define OSRM_CUSTOMIZER_CELL_STORAGE_HPP
+
+#include "partition/multi_level_partition.hpp"
+
+#include "util/shared_memory_vector_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+template <bool UseSharedMemory> class CellStorageImpl;
+namespace io
+{
+inline void write(const std::string &path, const CellStorageImpl<false> &storage);
+}
+
+/**
+ * Boundary nodes and clique weights of all cells of a multi-level partition.
+ *
+ * The source nodes of a cell are the nodes that are entered by an edge from another cell, the
+ * destination nodes the ones left by an edge to another cell. For every pair of them the cell
+ * stores the weight of the shortest path inside the cell, or INVALID_EDGE_WEIGHT if there is
+ * none, as a matrix with a row per source node. The weights are filled by the CellCustomizer.
+ *
+ * The shared memory version is a view on the data loaded by osrm-datastore.
+ */
+template <bool UseSharedMemory> class CellStorageImpl
+{
+    template <typename T> using Vector = typename util::ShM<T, UseSharedMemory>::vector;
+
+  public:
+    struct CellData
+    {
+        std::uint64_t value_offset;
+        std::uint32_t source_boundary_offset;
+        std::uint32_t destination_boundary_offset;
+        std::uint32_t number_of_source_nodes;
+        std::uint32_t number_of_destination_nodes;
+    };
+
+    // Access to the boundary nodes and weights of a single cell
+    template <typename WeightValueT> class CellImpl
+    {
+      public:
+        CellImpl(const CellData &data,
+                 WeightValueT *const all_weights,
+                 const NodeID *const all_sources,
+                 const NodeID *const all_destinations)
+            : number_of_source_nodes{data.number_of_source_nodes},
+              number_of_destination_nodes{data.number_of_destination_nodes},
+              weights{all_weights + data.value_offset},
+              source_boundary{all_sources + data.source_boundary_offset},
+              destination_boundary{all_destinations + data.destination_boundary_offset}
+        {
+        }
+
+        std::uint32_t GetNumberOfSourceNodes() const { return number_of_source_nodes; }
+
+        std::uint32_t GetNumberOfDestinationNodes() const { return number_of_destination_nodes; }
+
+        NodeID GetSourceNode(const std::uint32_t index) const
+        {
+            BOOST_ASSERT(index < number_of_source_nodes);
+            return source_boundary[index];
+        }
+
+        NodeID GetDestinationNode(const std::uint32_t index) const
+        {
+            BOOST_ASSERT(index < number_of_destination_nodes);
+            return destination_boundary[index];
+        }
+
+        // Returns the row of node in the weight matrix or INVALID_INDEX if it's no source node
+        std::uint32_t GetSourceIndex(const NodeID node) const
+        {
+            return FindIndex(source_boundary, number_of_source_nodes, node);
+        }
+
+        // Returns the column of node in the weight matrix or INVALID_INDEX if it's no destination
+        std::uint32_t GetDestinationIndex(const NodeID node) const
+        {
+            return FindIndex(destination_boundary, number_of_destination_nodes, node);
+        }
+
+        WeightValueT &GetWeight(const std::uint32_t source_index,
+                                const std::uint32_t destination_index) const
+        {
+            BOOST_ASSERT(source_index < number_of_source_nodes);
+            BOOST_ASSERT(destination_index < number_of_destination_nodes);
+            return weights[static_cast<std::size_t>(source_index) * number_of_destination_nodes +
+                           destination_index];
+        }
+
+        static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+      private:
+        static std::uint32_t
+        FindIndex(const NodeID *const boundary, const std::uint32_t size, const NodeID node)
+        {
+            const auto iter = std::lower_bound(boundary, boundary + size, node);
+            if (iter == boundary + size || *iter != node)
+            {
+                return INVALID_INDEX;
+            }
+            return static_cast<std::uint32_t>(iter - boundary);
+        }
+
+        std::uint32_t number_of_source_nodes;
+        std::uint32_t number_of_destination_nodes;
+        WeightValueT *weights;
+        const NodeID *source_boundary;
+        const NodeID *destination_boundary;
+    };
+
+    using Cell = CellImpl<EdgeWeight>;
+    using ConstCell = CellImpl<const EdgeWeight>;
+
+    CellStorageImpl() = default;
+
+    // Computes the boundary nodes of all cells from the forward edges of the graph
+    template <typename GraphT,
+              bool Q = UseSharedMemory,
+              typename = typename std::enable_if<!Q>::type>
+    CellStorageImpl(const partition::MultiLevelPartition &partition, const GraphT &graph)
+    {
+        const auto number_of_levels = partition.GetNumberOfLevels();
+
+        // (level, cell, node) of all boundary nodes
+        using BoundaryNode = std::tuple<LevelID, CellID, NodeID>;
+        std::vector<BoundaryNode> sources;
+        std::vector<BoundaryNode> destinations;
+        for (NodeID node = 0; node < graph.GetNumberOfNodes(); ++node)
+        {
+            for (const auto edge : graph.GetAdjacentEdgeRange(node))
+            {
+                if (!graph.GetEdgeData(edge).forward)
+                {
+                    continue;
+                }
+                const auto target = graph.GetTarget(edge);
+                for (LevelID level = 1; level <= number_of_levels; ++level)
+                {
+                    const auto node_cell = partition.GetCell(level, node);
+                    const auto target_cell = partition.GetCell(level, target);
+                    if (node_cell != target_cell)
+                    {
+                        destinations.emplace_back(level, node_cell, node);
+                        sources.emplace_back(level, target_cell, target);
+                    }
+                }
+            }
+        }
+        for (auto *boundary : {&sources, &destinations})
+        {
+            std::sort(boundary->begin(), boundary->end());
+            boundary->erase(std::unique(boundary->begin(), boundary->end()), boundary->end());
+        }
+
+        level_offsets.push_back(0);
+        for (LevelID level = 1; level <= number_of_levels; ++level)
+        {
+            level_offsets.push_back(level_offsets.back() + partition.GetNumberOfCells(level));
+        }
+        cells.resize(level_offsets.back(), CellData{0, 0, 0, 0, 0});
+
+        const auto fill_boundary = [this](const std::vector<BoundaryNode> &boundary,
+                                          Vector<NodeID> &boundary_nodes,
+                                          std::uint32_t CellData::*offset,
+                                          std::uint32_t CellData::*size) {
+            boundary_nodes.reserve(boundary.size());
+            for (const auto &boundary_node : boundary)
+            {
+                auto &cell = cells[level_offsets[std::get<0>(boundary_node) - 1] +
+                                   std::get<1>(boundary_node)];
+                if (cell.*size == 0)
+                {
+                    cell.*offset = static_cast<std::uint32_t>(boundary_nodes.size());
+                }
+                ++(cell.*size);
+                boundary_nodes.push_back(std::get<2>(boundary_node));
+            }
+        };
+        fill_boundary(sources,
+                      source_boundary,
+                      &CellData::source_boundary_offset,
+                      &CellData::number_of_source_nodes);
+        fill_boundary(destinations,
+                      destination_boundary,
+                      &CellData::destination_boundary_offset,
+                      &CellData::number_of_destination_nodes);
+
+        std::uint64_t number_of_weights = 0;
+        for (auto &cell : cells)
+        {
+            cell.value_offset = number_of_weights;
+            number_of_weights +=
+                static_cast<std::uint64_t>(cell.number_of_source_nodes) *
+                cell.number_of_destination_nodes;
+        }
+        weights.resize(number_of_weights, INVALID_EDGE_WEIGHT);
+    }
+
+    CellStorageImpl(Vector<std::uint32_t> level_offsets_,
+                    Vector<CellData> cells_,
+                    Vector<NodeID> source_boundary_,
+                    Vector<NodeID> destination_boundary_,
+                    Vector<EdgeWeight> weights_)
+        : level_offsets(std::move(level_offsets_)), cells(std::move(cells_)),
+          source_boundary(std::move(source_boundary_)),
+          destination_boundary(std::move(destination_boundary_)), weights(std::move(weights_))
+    {
+    }
+
+    ConstCell GetCell(const LevelID level, const CellID id) const
+    {
+        return ConstCell{GetCellData(level, id),
+                         Data(weights),
+                         Data(source_boundary),
+                         Data(destination_boundary)};
+    }
+
+    template <bool Q = UseSharedMemory, typename = typename std::enable_if<!Q>::type>
+    Cell GetCell(const LevelID level, const CellID id)
+    {
+        return Cell{GetCellData(level, id),
+                    Data(weights),
+                    Data(source_boundary),
+                    Data(destination_boundary)};
+    }
+
+  private:
+    friend void io::write(const std::string &path, const CellStorageImpl<false> &storage);
+
+    const CellData &GetCellData(const LevelID level, const CellID id) const
+    {
+        BOOST_ASSERT(level > 0 && level < level_offsets.size());
+        BOOST_ASSERT(level_offsets[level - 1] + id < level_offsets[level]);
+        return cells[level_offsets[level - 1] + id];
+    }
+
+    template <typename VectorT> static auto Data(VectorT &vector) -> decltype(&vector[0])
+    {
+        return vector.empty() ? nullptr : &vector[0];
+    }
+
+    // index of the first cell of every level, with a sentinel
+    Vector<std::uint32_t> level_offsets;
+    Vector<CellData> cells;
+    Vector<NodeID> source_boundary;
+    Vector<NodeID> destination_boundary;
+    Vector<EdgeWeight> weights;
+};
+
+template <bool UseSharedMemory>
+template <typename WeightValueT>
+constexpr std::uint32_t
+    CellStorageImpl<UseSharedMemory>::CellImpl<WeightValueT>::INVALID_INDEX;
+
+using CellStorage = CellStorageImpl<false>;
+using CellStorageView = CellStorageImpl<true>;
+}
+}
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef OSRM_CUSTOMIZER_CUSTOMIZER_HPP
+#define OSRM_CUSTOMIZER_CUSTOMIZER_HPP
+
+#include "customizer/customizer_config.hpp"
+
+namespace osrm
+{
+namespace customizer
+{
+
+// Computes the edge weights and the cliques of all cells of the multi-level partition, which
+// is all that needs to be redone for new traffic data
+class Customizer
+{
+  public:
+    explicit Customizer(const CustomizerConfig &config_) : config{config_} {}
+
+    Customizer(const Customizer &) = delete;
+    Customizer &operator=(const Customizer &) = delete;
+
+    int Run();
+
+  private:
+    CustomizerConfig config;
+};
+}
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef OSRM_CUSTOMIZER_CUSTOMIZER_CONFIG_HPP
+#define OSRM_CUSTOMIZER_CUSTOMIZER_CONFIG_HPP
+
+#include <boost/filesystem/path.hpp>
+
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+
+struct CustomizerConfig
+{
+    CustomizerConfig() : requested_num_threads(0), log_edge_updates_factor(0.0) {}
+
+    // Infer the input and output names from the path of the .osrm file
+    void UseDefaultOutputNames()
+    {
+        edge_based_graph_path = osrm_input_path.string() + ".ebg";
+        edge_based_node_weights_path = osrm_input_path.string() + ".enw";
+        partition_path = osrm_input_path.string() + ".partition";
+        graph_output_path = osrm_input_path.string() + ".mldgr";
+        cells_output_path = osrm_input_path.string() + ".cells";
+
+        edge_segment_lookup_path = osrm_input_path.string() + ".edge_segment_lookup";
+        edge_penalty_path = osrm_input_path.string() + ".edge_penalties";
+        node_based_graph_path = osrm_input_path.string() + ".nodes";
+        geometry_path = osrm_input_path.string() + ".geometry";
+        rtree_leaf_path = osrm_input_path.string() + ".fileIndex";
+        datasource_names_path = osrm_input_path.string() + ".datasource_names";
+        datasource_indexes_path = osrm_input_path.string() + ".datasource_indexes";
+    }
+
+    boost::filesystem::path osrm_input_path;
+
+    std::string edge_based_graph_path;
+    std::string edge_based_node_weights_path;
+    std::string partition_path;
+    std::string graph_output_path;
+    std::string cells_output_path;
+
+    std::string edge_segment_lookup_path;
+    std::string edge_penalty_path;
+    std::string node_based_graph_path;
+    std::string geometry_path;
+    std::string rtree_leaf_path;
+    std::string datasource_names_path;
+    std::string datasource_indexes_path;
+
+    unsigned requested_num_threads;
+    double log_edge_updates_factor;
+
+    std::vector<std::string> segment_speed_lookup_paths;
+    std::vector<std::string> turn_penalty_lookup_paths;
+};
+}
+}
+
+#endif
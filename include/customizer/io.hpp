@@ -0,0 +1,59 @@
+#ifndef OSRM_CUSTOMIZER_IO_HPP
+#define OSRM_CUSTOMIZER_IO_HPP
+
+#include "customizer/cell_storage.hpp"
+
+#include "storage/io.hpp"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+namespace io
+{
+
+// The .cells file holds the level offsets, the cells, their source and destination nodes and
+// the clique weights
+
+inline void write(const std::string &path, const CellStorage &storage)
+{
+    storage::io::FileWriter writer(path, storage::io::FileWriter::GenerateFingerprint);
+
+    writer.SerializeVector(storage.level_offsets);
+    writer.SerializeVector(storage.cells);
+    writer.SerializeVector(storage.source_boundary);
+    writer.SerializeVector(storage.destination_boundary);
+    writer.SerializeVector(storage.weights);
+}
+
+inline CellStorage read(const std::string &path)
+{
+    storage::io::FileReader reader(path, storage::io::FileReader::VerifyFingerprint);
+
+    std::vector<std::uint32_t> level_offsets;
+    std::vector<CellStorage::CellData> cells;
+    std::vector<NodeID> source_boundary;
+    std::vector<NodeID> destination_boundary;
+    std::vector<EdgeWeight> weights;
+    reader.DeserializeVector(level_offsets);
+    reader.DeserializeVector(cells);
+    reader.DeserializeVector(source_boundary);
+    reader.DeserializeVector(destination_boundary);
+    reader.DeserializeVector(weights);
+
+    return CellStorage(std::move(level_offsets),
+                       std::move(cells),
+                       std::move(source_boundary),
+                       std::move(destination_boundary),
+                       std::move(weights));
+}
+}
+}
+}
+
+#endif
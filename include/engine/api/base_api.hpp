@@ -2,6 +2,7 @@
 #define ENGINE_API_BASE_API_HPP
 
 #include "engine/api/base_parameters.hpp"
+#include "engine/api/binary_writer.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 
 #include "engine/api/json_factory.hpp"
@@ -53,6 +54,13 @@ class BaseAPI
                                   Hint{phantom, facade.GetCheckSum()});
     }
 
+    void WriteWaypoint(binary::BinaryWriter &writer, const PhantomNode &phantom) const
+    {
+        writer.WriteString(facade.GetNameForID(phantom.name_id));
+        writer.WriteCoordinate(phantom.location);
+        writer.WriteString(Hint{phantom, facade.GetCheckSum()}.ToBase64());
+    }
+
     const datafacade::BaseDataFacade &facade;
     const BaseParameters &parameters;
 };
@@ -0,0 +1,126 @@
+#ifndef ENGINE_API_BINARY_WRITER_HPP
+#define ENGINE_API_BINARY_WRITER_HPP
+
+#include "util/coordinate.hpp"
+
+#include <boost/assert.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+namespace binary
+{
+
+// Compact binary responses, requested with the `.bin` extension instead of `.json`.
+// All values are little-endian and written in the order given below, there is no padding.
+//
+//   Header     char[4] magic "OSRM", uint16 schema version, uint16 response type
+//   String     uint32 length in bytes, UTF-8 bytes without terminator
+//   Coordinate int32 longitude, int32 latitude in fixed point (degrees * 1e6)
+//   Geometry   uint32 number of coordinates, Coordinate[]
+//   Waypoint   String name, Coordinate location, String hint
+//
+//   Table      Header, String code, uint32 number of sources, uint32 number of destinations,
+//              Waypoint[sources], Waypoint[destinations],
+//              int32[sources * destinations] row-major durations in deciseconds,
+//              INT32_MAX marks pairs without a route
+//
+//   Route      Header, String code, uint32 number of waypoints, Waypoint[],
+//              uint32 number of routes, then per route:
+//                float64 distance, float64 duration, Geometry overview (empty for
+//                overview=false), uint32 number of legs, Leg[]
+//   Leg        float64 distance, float64 duration, String summary, uint32 number of steps,
+//              Step[], uint8 has annotation, Annotation if has annotation is 1
+//   Step       float64 distance, float64 duration, String name, String mode,
+//              String maneuver type, String maneuver modifier (empty if none),
+//              Coordinate maneuver location, Geometry geometry
+//   Annotation uint32 number of segments, float64[] distances, float64[] durations,
+//              uint8[] datasources, uint32 number of nodes, uint64[] OSM node ids
+//
+// Distances are in meters and durations in seconds, rounded like their JSON counterparts.
+// Readers must reject buffers with an unknown schema version.
+const constexpr char MAGIC[4] = {'O', 'S', 'R', 'M'};
+const constexpr std::uint16_t SCHEMA_VERSION = 1;
+
+enum class ResponseType : std::uint16_t
+{
+    Table = 1,
+    Route = 2
+};
+
+class BinaryWriter
+{
+  public:
+    explicit BinaryWriter(std::vector<char> &buffer_) : buffer(buffer_) {}
+
+    void WriteHeader(const ResponseType type)
+    {
+        buffer.insert(buffer.end(), std::begin(MAGIC), std::end(MAGIC));
+        Write(SCHEMA_VERSION);
+        Write(static_cast<std::uint16_t>(type));
+    }
+
+    template <typename T> void Write(const T value)
+    {
+        static_assert(std::is_arithmetic<T>::value, "only numbers can be written directly");
+
+        using BitsType = typename std::conditional<
+            sizeof(T) == 1,
+            std::uint8_t,
+            typename std::conditional<
+                sizeof(T) == 2,
+                std::uint16_t,
+                typename std::conditional<sizeof(T) == 4, std::uint32_t, std::uint64_t>::type>::
+                type>::type;
+        static_assert(sizeof(BitsType) == sizeof(T), "unsupported number size");
+
+        BitsType bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        for (std::size_t byte = 0; byte < sizeof(T); ++byte)
+        {
+            buffer.push_back(static_cast<char>((bits >> (8 * byte)) & 0xff));
+        }
+    }
+
+    void WriteString(const std::string &string)
+    {
+        BOOST_ASSERT(string.size() <= std::numeric_limits<std::uint32_t>::max());
+        Write(static_cast<std::uint32_t>(string.size()));
+        buffer.insert(buffer.end(), string.begin(), string.end());
+    }
+
+    void WriteCoordinate(const util::Coordinate coordinate)
+    {
+        Write(static_cast<std::int32_t>(coordinate.lon));
+        Write(static_cast<std::int32_t>(coordinate.lat));
+    }
+
+    template <typename ForwardIter> void WriteGeometry(ForwardIter begin, ForwardIter end)
+    {
+        Write(static_cast<std::uint32_t>(std::distance(begin, end)));
+        for (; begin != end; ++begin)
+        {
+            WriteCoordinate(*begin);
+        }
+    }
+
+  private:
+    std::vector<char> &buffer;
+};
+}
+}
+}
+}
+
+#endif
@@ -35,6 +35,10 @@ namespace detail
 
 std::string instructionTypeToString(extractor::guidance::TurnType::Enum type);
 std::string instructionModifierToString(extractor::guidance::DirectionModifier::Enum modifier);
+std::string waypointTypeToString(const guidance::WaypointType waypoint_type);
+
+// Check whether to include a modifier in the result of the API
+bool isValidModifier(const guidance::StepManeuver maneuver);
 
 util::json::Array coordinateToLonLat(const util::Coordinate coordinate);
 
@@ -20,7 +20,10 @@
 #include "util/coordinate.hpp"
 #include "util/integer_range.hpp"
 
+#include <cmath>
+#include <cstdint>
 #include <iterator>
+#include <string>
 #include <vector>
 
 namespace osrm
@@ -61,6 +64,40 @@ class RouteAPI : public BaseAPI
         response.values["code"] = "Ok";
     }
 
+    // Writes the route layout of binary_writer.hpp without building a json::Object
+    void MakeBinaryResponse(const InternalRouteResult &raw_route, std::vector<char> &output) const
+    {
+        binary::BinaryWriter writer(output);
+        writer.WriteHeader(binary::ResponseType::Route);
+        writer.WriteString("Ok");
+
+        const auto &segment_end_coordinates = raw_route.segment_end_coordinates;
+        BOOST_ASSERT(!segment_end_coordinates.empty());
+        writer.Write(static_cast<std::uint32_t>(segment_end_coordinates.size() + 1));
+        BaseAPI::WriteWaypoint(writer, segment_end_coordinates.front().source_phantom);
+        for (const auto &phantom_pair : segment_end_coordinates)
+        {
+            BaseAPI::WriteWaypoint(writer, phantom_pair.target_phantom);
+        }
+
+        writer.Write(static_cast<std::uint32_t>(raw_route.has_alternative() ? 2 : 1));
+        WriteRoute(writer,
+                   segment_end_coordinates,
+                   raw_route.unpacked_path_segments,
+                   raw_route.source_traversed_in_reverse,
+                   raw_route.target_traversed_in_reverse);
+        if (raw_route.has_alternative())
+        {
+            std::vector<std::vector<PathData>> wrapped_leg(1);
+            wrapped_leg.front() = raw_route.unpacked_alternative;
+            WriteRoute(writer,
+                       segment_end_coordinates,
+                       wrapped_leg,
+                       raw_route.alt_source_traversed_in_reverse,
+                       raw_route.alt_target_traversed_in_reverse);
+        }
+    }
+
     // FIXME gcc 4.8 doesn't support for lambdas to call protected member functions
     //  protected:
     template <typename ForwardIter>
@@ -80,13 +117,14 @@ class RouteAPI : public BaseAPI
         return json::makeGeoJSONGeometry(begin, end);
     }
 
-    util::json::Object MakeRoute(const std::vector<PhantomNodes> &segment_end_coordinates,
-                                 const std::vector<std::vector<PathData>> &unpacked_path_segments,
-                                 const std::vector<bool> &source_traversed_in_reverse,
-                                 const std::vector<bool> &target_traversed_in_reverse) const
+    // Unpacks the legs and their geometries, including the post-processed steps if requested
+    void AssembleLegs(const std::vector<PhantomNodes> &segment_end_coordinates,
+                      const std::vector<std::vector<PathData>> &unpacked_path_segments,
+                      const std::vector<bool> &source_traversed_in_reverse,
+                      const std::vector<bool> &target_traversed_in_reverse,
+                      std::vector<guidance::RouteLeg> &legs,
+                      std::vector<guidance::LegGeometry> &leg_geometries) const
     {
-        std::vector<guidance::RouteLeg> legs;
-        std::vector<guidance::LegGeometry> leg_geometries;
         auto number_of_legs = segment_end_coordinates.size();
         legs.reserve(number_of_legs);
         leg_geometries.reserve(number_of_legs);
@@ -168,6 +206,21 @@ class RouteAPI : public BaseAPI
             leg_geometries.push_back(std::move(leg_geometry));
             legs.push_back(std::move(leg));
         }
+    }
+
+    util::json::Object MakeRoute(const std::vector<PhantomNodes> &segment_end_coordinates,
+                                 const std::vector<std::vector<PathData>> &unpacked_path_segments,
+                                 const std::vector<bool> &source_traversed_in_reverse,
+                                 const std::vector<bool> &target_traversed_in_reverse) const
+    {
+        std::vector<guidance::RouteLeg> legs;
+        std::vector<guidance::LegGeometry> leg_geometries;
+        AssembleLegs(segment_end_coordinates,
+                     unpacked_path_segments,
+                     source_traversed_in_reverse,
+                     target_traversed_in_reverse,
+                     legs,
+                     leg_geometries);
 
         auto route = guidance::assembleRoute(legs);
         boost::optional<util::json::Value> json_overview;
@@ -263,6 +316,97 @@ class RouteAPI : public BaseAPI
         return result;
     }
 
+    void WriteRoute(binary::BinaryWriter &writer,
+                    const std::vector<PhantomNodes> &segment_end_coordinates,
+                    const std::vector<std::vector<PathData>> &unpacked_path_segments,
+                    const std::vector<bool> &source_traversed_in_reverse,
+                    const std::vector<bool> &target_traversed_in_reverse) const
+    {
+        // same rounding as the JSON responses
+        const auto round = [](const double value) { return std::round(value * 10) / 10.; };
+
+        std::vector<guidance::RouteLeg> legs;
+        std::vector<guidance::LegGeometry> leg_geometries;
+        AssembleLegs(segment_end_coordinates,
+                     unpacked_path_segments,
+                     source_traversed_in_reverse,
+                     target_traversed_in_reverse,
+                     legs,
+                     leg_geometries);
+
+        const auto route = guidance::assembleRoute(legs);
+        writer.Write(round(route.distance));
+        writer.Write(round(route.duration));
+
+        if (parameters.overview != RouteParameters::OverviewType::False)
+        {
+            const auto use_simplification =
+                parameters.overview == RouteParameters::OverviewType::Simplified;
+            const auto overview = guidance::assembleOverview(leg_geometries, use_simplification);
+            writer.WriteGeometry(overview.begin(), overview.end());
+        }
+        else
+        {
+            writer.Write(std::uint32_t{0});
+        }
+
+        writer.Write(static_cast<std::uint32_t>(legs.size()));
+        for (const auto idx : util::irange<std::size_t>(0UL, legs.size()))
+        {
+            const auto &leg = legs[idx];
+            const auto &leg_geometry = leg_geometries[idx];
+
+            writer.Write(round(leg.distance));
+            writer.Write(round(leg.duration));
+            writer.WriteString(leg.summary);
+
+            writer.Write(static_cast<std::uint32_t>(leg.steps.size()));
+            for (const auto &step : leg.steps)
+            {
+                writer.Write(round(step.distance));
+                writer.Write(round(step.duration));
+                writer.WriteString(step.name);
+                writer.WriteString(json::detail::modeToString(step.mode));
+                writer.WriteString(
+                    step.maneuver.waypoint_type == guidance::WaypointType::None
+                        ? json::detail::instructionTypeToString(step.maneuver.instruction.type)
+                        : json::detail::waypointTypeToString(step.maneuver.waypoint_type));
+                writer.WriteString(json::detail::isValidModifier(step.maneuver)
+                                       ? json::detail::instructionModifierToString(
+                                             step.maneuver.instruction.direction_modifier)
+                                       : std::string());
+                writer.WriteCoordinate(step.maneuver.location);
+                writer.WriteGeometry(leg_geometry.locations.begin() + step.geometry_begin,
+                                     leg_geometry.locations.begin() + step.geometry_end);
+            }
+
+            writer.Write(static_cast<std::uint8_t>(parameters.annotations ? 1 : 0));
+            if (parameters.annotations)
+            {
+                // one array per member like the JSON annotation
+                writer.Write(static_cast<std::uint32_t>(leg_geometry.annotations.size()));
+                for (const auto &annotation : leg_geometry.annotations)
+                {
+                    writer.Write(annotation.distance);
+                }
+                for (const auto &annotation : leg_geometry.annotations)
+                {
+                    writer.Write(annotation.duration);
+                }
+                for (const auto &annotation : leg_geometry.annotations)
+                {
+                    writer.Write(static_cast<std::uint8_t>(annotation.datasource));
+                }
+
+                writer.Write(static_cast<std::uint32_t>(leg_geometry.osm_node_ids.size()));
+                for (const auto node_id : leg_geometry.osm_node_ids)
+                {
+                    writer.Write(static_cast<std::uint64_t>(node_id));
+                }
+            }
+        }
+    }
+
     const RouteParameters &parameters;
 };
 
@@ -16,10 +16,14 @@
 #include "engine/internal_route_result.hpp"
 
 #include "util/integer_range.hpp"
+#include "util/json_renderer.hpp"
 
 #include <boost/range/algorithm/transform.hpp>
 
+#include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <vector>
 
 namespace osrm
 {
@@ -70,6 +74,107 @@ class TableAPI final : public BaseAPI
         response.values["code"] = "Ok";
     }
 
+    // Variant of MakeResponse for tables that are computed in tiles of rows: renders the
+    // waypoints and opens the durations array, MakeResponseRows then appends the rows of each
+    // tile once it is computed and MakeResponseEnd closes the response. All parts go to the same
+    // buffer, only the durations of a tile are released before the next one.
+    // JSON output matches util::json::render of the object built by MakeResponse, binary
+    // output follows the table layout in binary_writer.hpp.
+    virtual void MakeResponseBegin(const std::vector<PhantomNode> &phantoms,
+                                   std::vector<char> &output) const
+    {
+        if (parameters.format == TableParameters::OutputFormatType::Binary)
+        {
+            const auto number_of_sources =
+                parameters.sources.empty() ? phantoms.size() : parameters.sources.size();
+            const auto number_of_destinations =
+                parameters.destinations.empty() ? phantoms.size() : parameters.destinations.size();
+
+            binary::BinaryWriter writer(output);
+            writer.WriteHeader(binary::ResponseType::Table);
+            writer.WriteString("Ok");
+            writer.Write(static_cast<std::uint32_t>(number_of_sources));
+            writer.Write(static_cast<std::uint32_t>(number_of_destinations));
+            WriteWaypoints(writer, phantoms, parameters.sources);
+            WriteWaypoints(writer, phantoms, parameters.destinations);
+            return;
+        }
+
+        const auto append = [&output](const char *string) {
+            output.insert(output.end(), string, string + std::strlen(string));
+        };
+        const util::json::ArrayRenderer renderer(output);
+
+        append("{\"code\":\"Ok\",\"sources\":");
+        renderer(parameters.sources.empty() ? MakeWaypoints(phantoms)
+                                            : MakeWaypoints(phantoms, parameters.sources));
+        append(",\"destinations\":");
+        renderer(parameters.destinations.empty()
+                     ? MakeWaypoints(phantoms)
+                     : MakeWaypoints(phantoms, parameters.destinations));
+        append(",\"durations\":[");
+    }
+
+    virtual void MakeResponseRows(const std::vector<EdgeWeight> &durations,
+                                  const std::size_t first_row,
+                                  const std::size_t number_of_columns,
+                                  std::vector<char> &output) const
+    {
+        BOOST_ASSERT(number_of_columns > 0);
+        BOOST_ASSERT(durations.size() % number_of_columns == 0);
+
+        if (parameters.format == TableParameters::OutputFormatType::Binary)
+        {
+            // INVALID_EDGE_WEIGHT already is the INT32_MAX the schema uses for missing routes
+            binary::BinaryWriter writer(output);
+            for (const auto duration : durations)
+            {
+                writer.Write(static_cast<std::int32_t>(duration));
+            }
+            return;
+        }
+
+        const util::json::ArrayRenderer renderer(output);
+        const auto number_of_rows = durations.size() / number_of_columns;
+        for (const auto row : util::irange<std::size_t>(0UL, number_of_rows))
+        {
+            if (first_row + row > 0)
+            {
+                output.push_back(',');
+            }
+            output.push_back('[');
+            for (const auto column : util::irange<std::size_t>(0UL, number_of_columns))
+            {
+                if (column > 0)
+                {
+                    output.push_back(',');
+                }
+                const auto duration = durations[row * number_of_columns + column];
+                if (duration == INVALID_EDGE_WEIGHT)
+                {
+                    renderer(util::json::Null());
+                }
+                else
+                {
+                    renderer(util::json::Number(duration / 10.));
+                }
+            }
+            output.push_back(']');
+        }
+    }
+
+    virtual void MakeResponseEnd(std::vector<char> &output) const
+    {
+        // the binary table ends with the last row
+        if (parameters.format == TableParameters::OutputFormatType::Binary)
+        {
+            return;
+        }
+
+        output.push_back(']');
+        output.push_back('}');
+    }
+
     // FIXME gcc 4.8 doesn't support for lambdas to call protected member functions
     //  protected:
     virtual util::json::Array MakeWaypoints(const std::vector<PhantomNode> &phantoms) const
@@ -99,6 +204,27 @@ class TableAPI final : public BaseAPI
         return json_waypoints;
     }
 
+    // All phantoms in the symmetric case, otherwise the ones given by indices
+    virtual void WriteWaypoints(binary::BinaryWriter &writer,
+                                const std::vector<PhantomNode> &phantoms,
+                                const std::vector<std::size_t> &indices) const
+    {
+        if (indices.empty())
+        {
+            for (const auto &phantom : phantoms)
+            {
+                BaseAPI::WriteWaypoint(writer, phantom);
+            }
+            return;
+        }
+
+        for (const auto idx : indices)
+        {
+            BOOST_ASSERT(idx < phantoms.size());
+            BaseAPI::WriteWaypoint(writer, phantoms[idx]);
+        }
+    }
+
     virtual util::json::Array MakeTable(const std::vector<EdgeWeight> &values,
                                         std::size_t number_of_rows,
                                         std::size_t number_of_columns) const
@@ -2,17 +2,25 @@
 #define OSRM_ENGINE_DATA_WATCHDOG_HPP
 
 #include "engine/datafacade/shared_memory_datafacade.hpp"
+#include "engine/dataset_slot.hpp"
+#include "engine/engine_config.hpp"
 
 #include "storage/shared_barriers.hpp"
 #include "storage/shared_datatype.hpp"
 #include "storage/shared_memory.hpp"
 
+#include <boost/assert.hpp>
+#include <boost/interprocess/sync/named_sharable_mutex.hpp>
 #include <boost/interprocess/sync/named_upgradable_mutex.hpp>
-#include <boost/thread/lock_types.hpp>
-#include <boost/thread/locks.hpp>
-#include <boost/thread/shared_mutex.hpp>
+#include <boost/interprocess/sync/sharable_lock.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 namespace osrm
 {
@@ -23,18 +31,54 @@ namespace engine
 // the data and layout regions that should be used. This region is updated
 // once a new dataset arrives.
 //
+// Queries have to hold a sharable lock on the regions_N mutex of the data they use, so that
+// osrm-datastore doesn't overwrite it. Instead of taking the named cross-process locks for every
+// query, each of the two data regions has a DatasetSlot with an in-process reference count, and
+// only the slot as a whole holds the named lock while it is referenced. The watchdog keeps a
+// reference to the slot of the newest dataset, so a query is one load of the shared timestamp
+// and one increment and decrement of the reference count of the current slot.
+//
+// osrm-datastore waits for the lock of the old region before it loads the next dataset into it.
+// A thread therefore checks the shared timestamp once a second and switches to a new dataset
+// even if no queries arrive, the last query on the old one then releases its lock.
+//
 // TODO: This also needs a shared memory reader lock with other clients and
 // possibly osrm-datastore since updating the CURRENT_REGIONS data is not atomic.
 // Currently we enfore this by waiting that all queries have finished before
 // osrm-datastore writes to this section.
 class DataWatchdog
 {
+    using Slot = DatasetSlot<datafacade::SharedMemoryDataFacade,
+                             boost::interprocess::named_sharable_mutex>;
+
   public:
-    DataWatchdog()
-        : shared_barriers{std::make_shared<storage::SharedBarriers>()},
+    DataWatchdog(const EngineConfig::Algorithm algorithm_,
+                 const bool compress_rtree_leaves_,
+                 const std::size_t phantom_node_cache_size_)
+        : algorithm{algorithm_}, compress_rtree_leaves{compress_rtree_leaves_},
+          phantom_node_cache_size{phantom_node_cache_size_},
+          shared_barriers{std::make_shared<storage::SharedBarriers>()},
           shared_regions(storage::makeSharedMemory(storage::CURRENT_REGIONS)),
-          current_timestamp{storage::LAYOUT_NONE, storage::DATA_NONE, 0}
+          slots{{shared_barriers->regions_1_mutex}, {shared_barriers->regions_2_mutex}},
+          current_slot{nullptr}, watcher{[this] { WatchSharedTimestamp(); }}
+    {
+    }
+
+    ~DataWatchdog()
     {
+        {
+            std::lock_guard<std::mutex> update_lock(update_mutex);
+            stop_watcher = true;
+        }
+        watcher_condition.notify_one();
+        watcher.join();
+
+        if (auto *slot = current_slot.load())
+        {
+            slot->Release();
+        }
+        BOOST_ASSERT(slots[0].GetReferences() == 0);
+        BOOST_ASSERT(slots[1].GetReferences() == 0);
     }
 
     // Tries to connect to the shared memory containing the regions table
@@ -43,84 +87,148 @@ class DataWatchdog
         return storage::SharedMemory::RegionExists(storage::CURRENT_REGIONS);
     }
 
-    using RegionsLock =
-        boost::interprocess::sharable_lock<boost::interprocess::named_sharable_mutex>;
-    using LockAndFacade = std::pair<RegionsLock, std::shared_ptr<datafacade::BaseDataFacade>>;
-
-    // This will either update the contens of facade or just leave it as is
-    // if the update was already done by another thread
-    LockAndFacade GetDataFacade()
+    // Keeps the data of a facade from being replaced by osrm-datastore while it is alive
+    class FacadeHandle
     {
-        const boost::interprocess::sharable_lock<boost::interprocess::named_upgradable_mutex> lock(
-            shared_barriers->current_regions_mutex);
+      public:
+        explicit FacadeHandle(Slot &slot_) : slot(&slot_) {}
 
-        const auto shared_timestamp =
-            static_cast<const storage::SharedDataTimestamp *>(shared_regions->Ptr());
+        FacadeHandle(FacadeHandle &&other) : slot(other.slot) { other.slot = nullptr; }
 
-        const auto get_locked_facade = [this, shared_timestamp]() {
-            if (current_timestamp.data == storage::DATA_1)
-            {
-                BOOST_ASSERT(current_timestamp.layout == storage::LAYOUT_1);
-                return std::make_pair(RegionsLock(shared_barriers->regions_1_mutex), facade);
-            }
-            else
+        FacadeHandle(const FacadeHandle &) = delete;
+        FacadeHandle &operator=(const FacadeHandle &) = delete;
+        FacadeHandle &operator=(FacadeHandle &&) = delete;
+
+        ~FacadeHandle()
+        {
+            if (slot != nullptr)
             {
-                BOOST_ASSERT(current_timestamp.layout == storage::LAYOUT_2);
-                BOOST_ASSERT(current_timestamp.data == storage::DATA_2);
-                return std::make_pair(RegionsLock(shared_barriers->regions_2_mutex), facade);
+                slot->Release();
             }
-        };
+        }
 
-        // this blocks handle the common case when there is no data update -> we will only need a
-        // shared lock
+        std::shared_ptr<datafacade::BaseDataFacade> GetFacade() const
         {
-            boost::shared_lock<boost::shared_mutex> facade_lock(facade_mutex);
+            return slot->GetFacade();
+        }
+
+      private:
+        Slot *slot;
+    };
+
+    // Returns the facade of the newest dataset, updating it if a new dataset was loaded
+    FacadeHandle GetDataFacade()
+    {
+        const auto shared_timestamp = LoadSharedTimestamp();
 
-            if (shared_timestamp->timestamp == current_timestamp.timestamp)
+        Slot *slot = current_slot.load(std::memory_order_acquire);
+        if (slot != nullptr && slot->TryAcquire())
+        {
+            // the slot can only have changed in between if it was unused at some point
+            if (slot->GetTimestamp() == shared_timestamp)
             {
-                BOOST_ASSERT(shared_timestamp->layout == current_timestamp.layout);
-                BOOST_ASSERT(shared_timestamp->data == current_timestamp.data);
-                return get_locked_facade();
+                return FacadeHandle(*slot);
             }
+            slot->Release();
         }
 
-        // if we reach this code there is a data update to be made. multiple
-        // requests can reach this, but only ever one goes through at a time.
-        boost::upgrade_lock<boost::shared_mutex> facade_lock(facade_mutex);
+        std::lock_guard<std::mutex> update_lock(update_mutex);
+        auto &newest_slot = UpdateCurrentSlot();
+        // the reference of the watchdog keeps it in use while the update lock is held
+        const auto acquired = newest_slot.TryAcquire();
+        BOOST_ASSERT(acquired);
+        (void)acquired;
+        return FacadeHandle(newest_slot);
+    }
 
-        // we might get overtaken before we actually do the writing
-        // in that case we don't modify anthing
-        if (shared_timestamp->timestamp == current_timestamp.timestamp)
-        {
-            BOOST_ASSERT(shared_timestamp->layout == current_timestamp.layout);
-            BOOST_ASSERT(shared_timestamp->data == current_timestamp.data);
+  private:
+    // osrm-datastore writes the timestamp from another process, after layout and data
+    unsigned LoadSharedTimestamp() const
+    {
+        const auto regions =
+            static_cast<const storage::SharedDataTimestamp *>(shared_regions->Ptr());
+        const auto timestamp = *static_cast<const volatile unsigned *>(&regions->timestamp);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return timestamp;
+    }
+
+    // Moves the reference of the watchdog to the slot of the newest dataset, must be called
+    // with the update mutex held
+    Slot &UpdateCurrentSlot()
+    {
+        const boost::interprocess::sharable_lock<boost::interprocess::named_upgradable_mutex>
+            current_regions_lock(shared_barriers->current_regions_mutex);
+        const auto shared_timestamp =
+            *static_cast<const storage::SharedDataTimestamp *>(shared_regions->Ptr());
 
-            return get_locked_facade();
+        BOOST_ASSERT(shared_timestamp.data == storage::DATA_1 ||
+                     shared_timestamp.data == storage::DATA_2);
+        auto &slot = shared_timestamp.data == storage::DATA_1 ? slots[0] : slots[1];
+        auto *previous_slot = current_slot.load(std::memory_order_relaxed);
+        if (previous_slot == &slot && slot.GetTimestamp() == shared_timestamp.timestamp)
+        {
+            return slot;
         }
 
-        // this thread has won and can update the data
-        boost::upgrade_to_unique_lock<boost::upgrade_mutex> unique_facade_lock(facade_lock);
+        // the region of the current slot was overwritten, which can only happen if
+        // osrm-datastore claimed the locks by force: drop it before waiting for its queries
+        if (previous_slot == &slot)
+        {
+            current_slot.store(nullptr, std::memory_order_release);
+            previous_slot->Release();
+            previous_slot = nullptr;
+        }
 
-        current_timestamp = *shared_timestamp;
-        facade = std::make_shared<datafacade::SharedMemoryDataFacade>(shared_barriers,
-                                                                      current_timestamp.layout,
-                                                                      current_timestamp.data,
-                                                                      current_timestamp.timestamp);
+        slot.Acquire(shared_timestamp.timestamp, [&] {
+            return std::make_shared<datafacade::SharedMemoryDataFacade>(shared_barriers,
+                                                                        shared_timestamp.layout,
+                                                                        shared_timestamp.data,
+                                                                        shared_timestamp.timestamp,
+                                                                        algorithm,
+                                                                        compress_rtree_leaves,
+                                                                        phantom_node_cache_size);
+        });
+        current_slot.store(&slot, std::memory_order_release);
+
+        // the last query on the old dataset releases it
+        if (previous_slot != nullptr)
+        {
+            previous_slot->Release();
+        }
+        return slot;
+    }
 
-        return get_locked_facade();
+    void WatchSharedTimestamp()
+    {
+        std::unique_lock<std::mutex> update_lock(update_mutex);
+        while (!watcher_condition.wait_for(
+            update_lock, std::chrono::seconds(1), [this] { return stop_watcher; }))
+        {
+            const auto *slot = current_slot.load(std::memory_order_relaxed);
+            if (slot != nullptr && slot->GetTimestamp() != LoadSharedTimestamp())
+            {
+                UpdateCurrentSlot();
+            }
+        }
     }
 
-  private:
-    // mutexes should be mutable even on const objects: This enables
-    // marking functions as logical const and thread-safe.
+    const EngineConfig::Algorithm algorithm;
+    const bool compress_rtree_leaves;
+    const std::size_t phantom_node_cache_size;
     std::shared_ptr<storage::SharedBarriers> shared_barriers;
 
     // shared memory table containing pointers to all shared regions
     std::unique_ptr<storage::SharedMemory> shared_regions;
 
-    mutable boost::shared_mutex facade_mutex;
-    std::shared_ptr<datafacade::SharedMemoryDataFacade> facade;
-    storage::SharedDataTimestamp current_timestamp;
+    // one slot per data region, indexed by DATA_1 and DATA_2
+    Slot slots[2];
+    // changed under the update mutex, holds a reference to its slot
+    std::atomic<Slot *> current_slot;
+    std::mutex update_mutex;
+
+    bool stop_watcher = false;
+    std::condition_variable watcher_condition;
+    std::thread watcher;
 };
 }
 }
@@ -2,16 +2,20 @@
 #define CONTIGUOUS_INTERNALMEM_DATAFACADE_HPP
 
 #include "engine/datafacade/datafacade_base.hpp"
+#include "engine/engine_config.hpp"
 
+#include "customizer/cell_storage.hpp"
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/guidance/turn_instruction.hpp"
 #include "extractor/guidance/turn_lane_types.hpp"
 #include "extractor/profile_properties.hpp"
+#include "partition/multi_level_partition.hpp"
 #include "util/guidance/bearing_class.hpp"
 #include "util/guidance/entry_class.hpp"
 #include "util/guidance/turn_lanes.hpp"
 
 #include "engine/geospatial_query.hpp"
+#include "engine/phantom_node_cache.hpp"
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
 #include "util/guidance/turn_bearing.hpp"
@@ -21,6 +25,7 @@
 #include "util/rectangle.hpp"
 #include "util/static_graph.hpp"
 #include "util/static_rtree.hpp"
+#include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
@@ -98,6 +103,8 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
 
     std::unique_ptr<SharedRTree> m_static_rtree;
     std::unique_ptr<SharedGeospatialQuery> m_geospatial_query;
+    std::unique_ptr<PhantomNodeCache<std::vector<PhantomNodeWithDistance>>> m_nearest_cache;
+    std::unique_ptr<PhantomNodeCache<PhantomNodePair>> m_snapping_cache;
     boost::filesystem::path file_index_path;
 
     std::shared_ptr<util::RangeTable<16, true>> m_name_table;
@@ -114,6 +121,9 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     std::shared_ptr<util::RangeTable<16, true>> m_bearing_ranges_table;
     util::ShM<DiscreteBearing, true>::vector m_bearing_values_table;
 
+    partition::MultiLevelPartitionView m_multi_level_partition;
+    customizer::CellStorageView m_cell_storage;
+
     void InitializeChecksumPointer(storage::DataLayout &data_layout, char *memory_block)
     {
         m_check_sum =
@@ -137,7 +147,9 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                   m_timestamp.begin());
     }
 
-    void InitializeRTreePointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeRTreePointers(storage::DataLayout &data_layout,
+                                 char *memory_block,
+                                 const bool compress_rtree_leaves)
     {
         BOOST_ASSERT_MSG(!m_coordinate_list.empty(), "coordinates must be loaded before r-tree");
 
@@ -158,22 +170,43 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                             data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE],
                             file_index_path,
                             m_coordinate_list));
+        if (compress_rtree_leaves)
+        {
+            TIMER_START(compress_leaves);
+            m_static_rtree->CompressLeaves();
+            TIMER_STOP(compress_leaves);
+            util::Log() << "compressed r-tree leaves to " << m_static_rtree->GetLeavesSize()
+                        << " bytes in " << TIMER_SEC(compress_leaves) << " seconds";
+        }
         m_geospatial_query.reset(
             new SharedGeospatialQuery(*m_static_rtree, m_coordinate_list, *this));
     }
 
-    void InitializeGraphPointer(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeGraphPointer(storage::DataLayout &data_layout,
+                                char *memory_block,
+                                const EngineConfig::Algorithm algorithm)
     {
-        auto graph_nodes_ptr =
-            data_layout.GetBlockPtr<GraphNode>(memory_block, storage::DataLayout::GRAPH_NODE_LIST);
+        const auto use_mld = algorithm == EngineConfig::Algorithm::MLD;
+        const auto node_list_id = use_mld ? storage::DataLayout::MLD_GRAPH_NODE_LIST
+                                          : storage::DataLayout::GRAPH_NODE_LIST;
+        const auto edge_list_id = use_mld ? storage::DataLayout::MLD_GRAPH_EDGE_LIST
+                                          : storage::DataLayout::GRAPH_EDGE_LIST;
+        if (data_layout.num_entries[node_list_id] == 0)
+        {
+            const std::string missing =
+                use_mld ? "No multi-level graph loaded, run osrm-partition and osrm-customize"
+                        : "No contracted graph loaded, run osrm-contract";
+            throw util::exception(missing + SOURCE_REF);
+        }
 
-        auto graph_edges_ptr =
-            data_layout.GetBlockPtr<GraphEdge>(memory_block, storage::DataLayout::GRAPH_EDGE_LIST);
+        auto graph_nodes_ptr = data_layout.GetBlockPtr<GraphNode>(memory_block, node_list_id);
 
-        util::ShM<GraphNode, true>::vector node_list(
-            graph_nodes_ptr, data_layout.num_entries[storage::DataLayout::GRAPH_NODE_LIST]);
-        util::ShM<GraphEdge, true>::vector edge_list(
-            graph_edges_ptr, data_layout.num_entries[storage::DataLayout::GRAPH_EDGE_LIST]);
+        auto graph_edges_ptr = data_layout.GetBlockPtr<GraphEdge>(memory_block, edge_list_id);
+
+        util::ShM<GraphNode, true>::vector node_list(graph_nodes_ptr,
+                                                     data_layout.num_entries[node_list_id]);
+        util::ShM<GraphEdge, true>::vector edge_list(graph_edges_ptr,
+                                                     data_layout.num_entries[edge_list_id]);
         m_query_graph.reset(new QueryGraph(node_list, edge_list));
     }
 
@@ -306,6 +339,56 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
         m_is_core_node = std::move(is_core_node);
     }
 
+    void InitializeMultiLevelPointers(storage::DataLayout &data_layout, char *memory_block)
+    {
+        const auto cells_per_level_ptr = data_layout.GetBlockPtr<std::uint32_t>(
+            memory_block, storage::DataLayout::MLD_CELLS_PER_LEVEL);
+        util::ShM<std::uint32_t, true>::vector cells_per_level(
+            cells_per_level_ptr, data_layout.num_entries[storage::DataLayout::MLD_CELLS_PER_LEVEL]);
+        const auto cell_ids_ptr =
+            data_layout.GetBlockPtr<CellID>(memory_block, storage::DataLayout::MLD_CELL_IDS);
+        util::ShM<CellID, true>::vector cell_ids(
+            cell_ids_ptr, data_layout.num_entries[storage::DataLayout::MLD_CELL_IDS]);
+        m_multi_level_partition = partition::MultiLevelPartitionView{std::move(cells_per_level),
+                                                                     std::move(cell_ids)};
+        if (m_multi_level_partition.GetNumberOfNodes() != m_query_graph->GetNumberOfNodes())
+        {
+            throw util::exception("The partition doesn't match the multi-level graph, rerun "
+                                  "osrm-partition and osrm-customize" +
+                                  SOURCE_REF);
+        }
+
+        using CellData = customizer::CellStorageView::CellData;
+        const auto level_offsets_ptr = data_layout.GetBlockPtr<std::uint32_t>(
+            memory_block, storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
+        util::ShM<std::uint32_t, true>::vector level_offsets(
+            level_offsets_ptr,
+            data_layout.num_entries[storage::DataLayout::MLD_CELL_LEVEL_OFFSETS]);
+        const auto cells_ptr =
+            data_layout.GetBlockPtr<CellData>(memory_block, storage::DataLayout::MLD_CELLS);
+        util::ShM<CellData, true>::vector cells(
+            cells_ptr, data_layout.num_entries[storage::DataLayout::MLD_CELLS]);
+        const auto source_boundary_ptr = data_layout.GetBlockPtr<NodeID>(
+            memory_block, storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY);
+        util::ShM<NodeID, true>::vector source_boundary(
+            source_boundary_ptr,
+            data_layout.num_entries[storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY]);
+        const auto destination_boundary_ptr = data_layout.GetBlockPtr<NodeID>(
+            memory_block, storage::DataLayout::MLD_CELL_DESTINATION_BOUNDARY);
+        util::ShM<NodeID, true>::vector destination_boundary(
+            destination_boundary_ptr,
+            data_layout.num_entries[storage::DataLayout::MLD_CELL_DESTINATION_BOUNDARY]);
+        const auto weights_ptr = data_layout.GetBlockPtr<EdgeWeight>(
+            memory_block, storage::DataLayout::MLD_CELL_WEIGHTS);
+        util::ShM<EdgeWeight, true>::vector weights(
+            weights_ptr, data_layout.num_entries[storage::DataLayout::MLD_CELL_WEIGHTS]);
+        m_cell_storage = customizer::CellStorageView{std::move(level_offsets),
+                                                     std::move(cells),
+                                                     std::move(source_boundary),
+                                                     std::move(destination_boundary),
+                                                     std::move(weights)};
+    }
+
     void InitializeGeometryPointers(storage::DataLayout &data_layout, char *memory_block)
     {
         auto geometries_index_ptr =
@@ -397,9 +480,13 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     }
 
   public:
-    void InitializeInternalPointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeInternalPointers(storage::DataLayout &data_layout,
+                                    char *memory_block,
+                                    const EngineConfig::Algorithm algorithm,
+                                    const bool compress_rtree_leaves,
+                                    const std::size_t phantom_node_cache_size)
     {
-        InitializeGraphPointer(data_layout, memory_block);
+        InitializeGraphPointer(data_layout, memory_block, algorithm);
         InitializeChecksumPointer(data_layout, memory_block);
         InitializeNodeAndEdgeInformationPointers(data_layout, memory_block);
         InitializeGeometryPointers(data_layout, memory_block);
@@ -407,10 +494,25 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
         InitializeViaNodeListPointer(data_layout, memory_block);
         InitializeNamePointers(data_layout, memory_block);
         InitializeTurnLaneDescriptionsPointers(data_layout, memory_block);
-        InitializeCoreInformationPointer(data_layout, memory_block);
+        if (algorithm == EngineConfig::Algorithm::MLD)
+        {
+            InitializeMultiLevelPointers(data_layout, memory_block);
+        }
+        else
+        {
+            InitializeCoreInformationPointer(data_layout, memory_block);
+        }
         InitializeProfilePropertiesPointer(data_layout, memory_block);
-        InitializeRTreePointers(data_layout, memory_block);
+        InitializeRTreePointers(data_layout, memory_block, compress_rtree_leaves);
         InitializeIntersectionClassPointers(data_layout, memory_block);
+
+        if (phantom_node_cache_size > 0)
+        {
+            m_nearest_cache.reset(new PhantomNodeCache<std::vector<PhantomNodeWithDistance>>(
+                "nearest phantom node", phantom_node_cache_size));
+            m_snapping_cache.reset(new PhantomNodeCache<PhantomNodePair>(
+                "snapped phantom node", phantom_node_cache_size));
+        }
     }
 
     // search graph access
@@ -701,6 +803,38 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
             input_coordinate, bearing, bearing_range);
     }
 
+    std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodes(const std::vector<NearestQuery> &queries) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+
+        if (m_nearest_cache)
+        {
+            return m_nearest_cache->Query(
+                queries, [this](const std::vector<NearestQuery> &missing_queries) {
+                    return m_geospatial_query->NearestPhantomNodes(missing_queries);
+                });
+        }
+        return m_geospatial_query->NearestPhantomNodes(queries);
+    }
+
+    std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodeWithAlternativeFromBigComponent(
+        const std::vector<NearestQuery> &queries) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+
+        if (m_snapping_cache)
+        {
+            return m_snapping_cache->Query(
+                queries, [this](const std::vector<NearestQuery> &missing_queries) {
+                    return m_geospatial_query->NearestPhantomNodeWithAlternativeFromBigComponent(
+                        missing_queries);
+                });
+        }
+        return m_geospatial_query->NearestPhantomNodeWithAlternativeFromBigComponent(queries);
+    }
+
     unsigned GetCheckSum() const override final { return m_check_sum; }
 
     unsigned GetNameIndexFromEdgeID(const unsigned id) const override final
@@ -767,6 +901,16 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
 
     virtual std::size_t GetCoreSize() const override final { return m_is_core_node.size(); }
 
+    const partition::MultiLevelPartitionView &GetMultiLevelPartition() const override final
+    {
+        return m_multi_level_partition;
+    }
+
+    const customizer::CellStorageView &GetCellStorage() const override final
+    {
+        return m_cell_storage;
+    }
+
     // Returns the data source ids that were used to supply the edge
     // weights.
     virtual std::vector<uint8_t>
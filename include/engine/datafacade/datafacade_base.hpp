@@ -4,12 +4,15 @@
 // Exposes all data access interfaces to the algorithms via base class ptr
 
 #include "contractor/query_edge.hpp"
+#include "customizer/cell_storage.hpp"
 #include "extractor/edge_based_node.hpp"
 #include "extractor/external_memory_node.hpp"
 #include "extractor/guidance/turn_instruction.hpp"
 #include "extractor/guidance/turn_lane_types.hpp"
 #include "extractor/original_edge_data.hpp"
+#include "engine/nearest_query.hpp"
 #include "engine/phantom_node.hpp"
+#include "partition/multi_level_partition.hpp"
 #include "util/exception.hpp"
 #include "util/guidance/bearing_class.hpp"
 #include "util/guidance/entry_class.hpp"
@@ -148,6 +151,13 @@ class BaseDataFacade
                                                       const int bearing,
                                                       const int bearing_range) const = 0;
 
+    // Batch versions of the queries above, the results are in the order of the queries
+    virtual std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodes(const std::vector<NearestQuery> &queries) const = 0;
+    virtual std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodeWithAlternativeFromBigComponent(
+        const std::vector<NearestQuery> &queries) const = 0;
+
     virtual bool hasLaneData(const EdgeID id) const = 0;
     virtual util::guidance::LaneTupleIdPair GetLaneData(const EdgeID id) const = 0;
     virtual extractor::guidance::TurnLaneDescription
@@ -169,6 +179,12 @@ class BaseDataFacade
 
     virtual std::size_t GetCoreSize() const = 0;
 
+    // The partition has no levels if the data was not prepared with osrm-partition and
+    // osrm-customize or the engine uses CH
+    virtual const partition::MultiLevelPartitionView &GetMultiLevelPartition() const = 0;
+
+    virtual const customizer::CellStorageView &GetCellStorage() const = 0;
+
     virtual std::string GetTimestamp() const = 0;
 
     virtual bool GetContinueStraightDefault() const = 0;
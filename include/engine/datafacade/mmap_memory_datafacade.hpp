@@ -0,0 +1,73 @@
+#ifndef MMAP_MEMORY_DATAFACADE_HPP
+#define MMAP_MEMORY_DATAFACADE_HPP
+
+// implements all data storage by mapping the memory image of the data files
+
+#include "storage/memory_image.hpp"
+#include "storage/storage.hpp"
+#include "engine/datafacade/contiguous_internalmem_datafacade_base.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/log.hpp"
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <algorithm>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+/**
+ * This datafacade maps the memory image of the data files, which has the same layout as the
+ * process memory and shared memory blocks. The image has to be current, see
+ * Storage::UpdateMemoryImage, then loading the data only maps the file and all processes that
+ * map it share its pages through the page cache. The mapping is private, so pages that are
+ * written are copied and the image stays unchanged.
+ */
+class MMapMemoryDataFacade final : public ContiguousInternalMemoryDataFacadeBase
+{
+
+  private:
+    boost::iostreams::mapped_file memory_image;
+    storage::DataLayout internal_layout;
+
+  public:
+    MMapMemoryDataFacade(const storage::StorageConfig &config,
+                         const EngineConfig::Algorithm algorithm,
+                         const bool compress_rtree_leaves,
+                         const std::size_t phantom_node_cache_size)
+    {
+        util::Log() << "mapping memory image " << config.memory_image_path;
+        boost::iostreams::mapped_file_params params(config.memory_image_path.string());
+        params.flags = boost::iostreams::mapped_file::priv;
+        memory_image.open(params);
+
+        if (memory_image.size() < storage::MEMORY_IMAGE_DATA_OFFSET)
+        {
+            throw util::exception("Memory image " + config.memory_image_path.string() +
+                                  " is truncated" + SOURCE_REF);
+        }
+        storage::MemoryImageHeader header;
+        std::copy_n(memory_image.const_data(), sizeof(header), reinterpret_cast<char *>(&header));
+        storage::Storage::CheckMemoryImageHeader(
+            header, memory_image.size(), config.memory_image_path);
+        internal_layout = header.layout;
+
+        // Adjust all the private m_* members to point to the right places
+        InitializeInternalPointers(internal_layout,
+                                   memory_image.data() + storage::MEMORY_IMAGE_DATA_OFFSET,
+                                   algorithm,
+                                   compress_rtree_leaves,
+                                   phantom_node_cache_size);
+    }
+};
+}
+}
+}
+
+#endif // MMAP_MEMORY_DATAFACADE_HPP
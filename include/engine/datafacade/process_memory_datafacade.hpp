@@ -29,7 +29,10 @@ class ProcessMemoryDataFacade final : public ContiguousInternalMemoryDataFacadeB
     std::unique_ptr<storage::DataLayout> internal_layout;
 
   public:
-    explicit ProcessMemoryDataFacade(const storage::StorageConfig &config)
+    ProcessMemoryDataFacade(const storage::StorageConfig &config,
+                            const EngineConfig::Algorithm algorithm,
+                            const bool compress_rtree_leaves,
+                            const std::size_t phantom_node_cache_size)
     {
         storage::Storage storage(config);
 
@@ -42,7 +45,11 @@ class ProcessMemoryDataFacade final : public ContiguousInternalMemoryDataFacadeB
         storage.PopulateData(*internal_layout, internal_memory.get());
 
         // Adjust all the private m_* members to point to the right places
-        InitializeInternalPointers(*internal_layout.get(), internal_memory.get());
+        InitializeInternalPointers(*internal_layout.get(),
+                                   internal_memory.get(),
+                                   algorithm,
+                                   compress_rtree_leaves,
+                                   phantom_node_cache_size);
     }
 };
 }
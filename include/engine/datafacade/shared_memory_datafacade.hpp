@@ -74,7 +74,10 @@ class SharedMemoryDataFacade : public ContiguousInternalMemoryDataFacadeBase
     SharedMemoryDataFacade(const std::shared_ptr<storage::SharedBarriers> &shared_barriers_,
                            storage::SharedDataType layout_region_,
                            storage::SharedDataType data_region_,
-                           unsigned shared_timestamp_)
+                           unsigned shared_timestamp_,
+                           const EngineConfig::Algorithm algorithm,
+                           const bool compress_rtree_leaves,
+                           const std::size_t phantom_node_cache_size)
         : shared_barriers(shared_barriers_), layout_region(layout_region_),
           data_region(data_region_), shared_timestamp(shared_timestamp_)
     {
@@ -87,7 +90,10 @@ class SharedMemoryDataFacade : public ContiguousInternalMemoryDataFacadeBase
         m_large_memory = storage::makeSharedMemory(data_region);
 
         InitializeInternalPointers(*reinterpret_cast<storage::DataLayout *>(m_layout_memory->Ptr()),
-                                   reinterpret_cast<char *>(m_large_memory->Ptr()));
+                                   reinterpret_cast<char *>(m_large_memory->Ptr()),
+                                   algorithm,
+                                   compress_rtree_leaves,
+                                   phantom_node_cache_size);
     }
 };
 }
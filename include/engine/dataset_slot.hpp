@@ -0,0 +1,121 @@
+#ifndef OSRM_ENGINE_DATASET_SLOT_HPP
+#define OSRM_ENGINE_DATASET_SLOT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace osrm
+{
+namespace engine
+{
+
+/**
+ * Reference counted facade of one shared memory data region, see DataWatchdog.
+ *
+ * The slot holds a sharable lock on the regions mutex of its data while it has a facade, and it
+ * has a facade while it is referenced. Adding and dropping references to a slot in use is lock
+ * free. Whoever drops the last reference releases the facade and the lock under the slot mutex,
+ * unless Acquire revived the slot in between, which is checked under the same mutex.
+ */
+template <typename FacadeT, typename RegionsMutexT> class DatasetSlot
+{
+  public:
+    DatasetSlot(RegionsMutexT &regions_mutex_) : regions_mutex(regions_mutex_) {}
+
+    DatasetSlot(const DatasetSlot &) = delete;
+    DatasetSlot &operator=(const DatasetSlot &) = delete;
+
+    // Adds a reference if the slot is in use, only Acquire can take an unused slot
+    bool TryAcquire()
+    {
+        auto count = references.load(std::memory_order_relaxed);
+        while (count != 0)
+        {
+            if (references.compare_exchange_weak(count, count + 1, std::memory_order_acquire))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Adds a reference to the dataset with the given timestamp, make_facade creates its facade
+    // if the slot has none or one of an older dataset. Waits for the queries on an older dataset
+    // to finish, which only use it if osrm-datastore claimed the lock by force.
+    template <typename MakeFacadeT>
+    void Acquire(const unsigned dataset_timestamp, const MakeFacadeT &make_facade)
+    {
+        while (true)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (references.load(std::memory_order_acquire) == 0)
+                {
+                    if (facade && timestamp.load(std::memory_order_relaxed) != dataset_timestamp)
+                    {
+                        ReleaseFacade();
+                    }
+                    if (!facade)
+                    {
+                        regions_mutex.lock_sharable();
+                        facade = make_facade();
+                        timestamp.store(dataset_timestamp, std::memory_order_relaxed);
+                    }
+                    references.store(1, std::memory_order_release);
+                    return;
+                }
+
+                // a last reference dropped now waits for the mutex and finds the slot in use
+                if (timestamp.load(std::memory_order_relaxed) == dataset_timestamp)
+                {
+                    references.fetch_add(1, std::memory_order_acquire);
+                    return;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void Release()
+    {
+        if (references.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (facade && references.load(std::memory_order_acquire) == 0)
+        {
+            ReleaseFacade();
+        }
+    }
+
+    // Only valid while holding a reference
+    const std::shared_ptr<FacadeT> &GetFacade() const { return facade; }
+
+    // Only stable while holding a reference
+    unsigned GetTimestamp() const { return timestamp.load(std::memory_order_relaxed); }
+
+    std::uint32_t GetReferences() const { return references.load(std::memory_order_relaxed); }
+
+  private:
+    void ReleaseFacade()
+    {
+        facade.reset();
+        regions_mutex.unlock_sharable();
+    }
+
+    RegionsMutexT &regions_mutex;
+    // guards changes of the facade, which are only done while references is zero
+    std::mutex mutex;
+    std::shared_ptr<FacadeT> facade;
+    std::atomic<unsigned> timestamp{0};
+    std::atomic<std::uint32_t> references{0};
+};
+}
+}
+
+#endif // OSRM_ENGINE_DATASET_SLOT_HPP
@@ -25,6 +25,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -43,7 +44,9 @@ class Engine final
     Engine &operator=(const Engine &) = delete;
 
     Status Route(const api::RouteParameters &parameters, util::json::Object &result) const;
+    Status Route(const api::RouteParameters &parameters, std::vector<char> &result) const;
     Status Table(const api::TableParameters &parameters, util::json::Object &result) const;
+    Status Table(const api::TableParameters &parameters, std::vector<char> &result) const;
     Status Nearest(const api::NearestParameters &parameters, util::json::Object &result) const;
     Status Trip(const api::TripParameters &parameters, util::json::Object &result) const;
     Status Match(const api::MatchParameters &parameters, util::json::Object &result) const;
@@ -53,7 +53,23 @@ namespace engine
  *  - Match
  *  - Nearest
  *
- * In addition, shared memory can be used for datasets loaded with osrm-datastore.
+ * The number of threads a single Table request may use is capped by max_threads_distance_table,
+ * the default of 1 computes every table on the thread handling the request.
+ * Tables rendered directly to text are computed in tiles of at most max_entries_table_tile
+ * durations (but at least one row). The rendered text is kept whole, only the durations are
+ * limited to one tile.
+ *
+ * In addition, shared memory can be used for datasets loaded with osrm-datastore. Without shared
+ * memory the data is loaded into the process, or with use_mmap mapped from a memory image of the
+ * data files at the memory_image_path of the storage config. If the image is missing or the data
+ * files changed, it is written first, which loads all data and copies it to disk once. If it
+ * can't be written the data is loaded into the process. With compress_rtree_leaves the leaves of
+ * the r-tree are read once and kept delta encoded in memory, instead of mapping the leaf file.
+ * A phantom_node_cache_size above zero keeps the phantom nodes of that many recent queries of a
+ * coordinate, radius and bearing, for clients that keep requesting the same locations.
+ *
+ * Routes are computed with contraction hierarchies from osrm-contract by default, or with the
+ * multi-level Dijkstra on the overlay graph from osrm-partition and osrm-customize.
  *
  * \see OSRM, StorageConfig
  */
@@ -61,13 +77,25 @@ struct EngineConfig final
 {
     bool IsValid() const;
 
+    enum class Algorithm
+    {
+        CH,
+        MLD
+    };
+
     storage::StorageConfig storage_config;
     int max_locations_trip = -1;
     int max_locations_viaroute = -1;
     int max_locations_distance_table = -1;
     int max_locations_map_matching = -1;
     int max_results_nearest = -1;
+    int max_threads_distance_table = 1;
+    int max_entries_table_tile = 1 << 20;
     bool use_shared_memory = true;
+    bool use_mmap = false;
+    bool compress_rtree_leaves = false;
+    int phantom_node_cache_size = 0;
+    Algorithm algorithm = Algorithm::CH;
 };
 }
 }
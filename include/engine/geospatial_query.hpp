@@ -1,9 +1,11 @@
 #ifndef GEOSPATIAL_QUERY_HPP
 #define GEOSPATIAL_QUERY_HPP
 
+#include "engine/nearest_query.hpp"
 #include "engine/phantom_node.hpp"
 #include "util/bearing.hpp"
 #include "util/coordinate_calculation.hpp"
+#include "util/integer_range.hpp"
 #include "util/rectangle.hpp"
 #include "util/typedefs.hpp"
 #include "util/web_mercator.hpp"
@@ -13,6 +15,7 @@
 #include <algorithm>
 #include <cmath>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -339,7 +342,115 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                               MakePhantomNode(input_coordinate, results.back()).phantom_node);
     }
 
+    // Returns the nearest PhantomNodes of every query, in the order of the queries.
+    // Does not filter by small/big component!
+    std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodes(const std::vector<NearestQuery> &queries) const
+    {
+        auto results = rtree.Nearest(
+            GetCoordinates(queries),
+            [this, &queries](const std::size_t query, const CandidateSegment &segment) {
+                const auto &bearing = queries[query].bearing;
+                if (bearing)
+                {
+                    return boolPairAnd(
+                        CheckSegmentBearing(segment, bearing->bearing, bearing->range),
+                        HasValidEdge(segment));
+                }
+                return HasValidEdge(segment);
+            },
+            [this, &queries](const std::size_t query,
+                             const std::size_t num_results,
+                             const CandidateSegment &segment) {
+                const auto &current_query = queries[query];
+                return (current_query.max_results && num_results >= *current_query.max_results) ||
+                       (current_query.max_distance &&
+                        CheckSegmentDistance(
+                            current_query.coordinate, segment, *current_query.max_distance));
+            });
+
+        std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(queries.size());
+        for (const auto query : util::irange<std::size_t>(0, queries.size()))
+        {
+            phantom_nodes[query] = MakePhantomNodes(queries[query].coordinate, results[query]);
+        }
+        return phantom_nodes;
+    }
+
+    // Returns the nearest phantom node of every query, in the order of the queries. If this
+    // phantom node is not from a big component a second phantom node is returned that is the
+    // nearest coordinate in a big component. max_results of the queries is ignored.
+    std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodeWithAlternativeFromBigComponent(
+        const std::vector<NearestQuery> &queries) const
+    {
+        std::vector<bool> has_small_component(queries.size(), false);
+        std::vector<bool> has_big_component(queries.size(), false);
+        auto results = rtree.Nearest(
+            GetCoordinates(queries),
+            [this, &queries, &has_big_component, &has_small_component](
+                const std::size_t query, const CandidateSegment &segment) {
+                auto use_segment =
+                    (!has_small_component[query] ||
+                     (!has_big_component[query] && !segment.data.component.is_tiny));
+                if (!use_segment)
+                {
+                    return std::make_pair(false, false);
+                }
+
+                auto use_directions = HasValidEdge(segment);
+                const auto &bearing = queries[query].bearing;
+                if (bearing)
+                {
+                    use_directions = boolPairAnd(
+                        CheckSegmentBearing(segment, bearing->bearing, bearing->range),
+                        use_directions);
+                }
+
+                if (use_directions.first || use_directions.second)
+                {
+                    has_big_component[query] =
+                        has_big_component[query] || !segment.data.component.is_tiny;
+                    has_small_component[query] =
+                        has_small_component[query] || segment.data.component.is_tiny;
+                }
+                return use_directions;
+            },
+            [this, &queries, &has_big_component](const std::size_t query,
+                                                 const std::size_t num_results,
+                                                 const CandidateSegment &segment) {
+                const auto &current_query = queries[query];
+                return (num_results > 0 && has_big_component[query]) ||
+                       (current_query.max_distance &&
+                        CheckSegmentDistance(
+                            current_query.coordinate, segment, *current_query.max_distance));
+            });
+
+        std::vector<std::pair<PhantomNode, PhantomNode>> phantom_node_pairs(queries.size());
+        for (const auto query : util::irange<std::size_t>(0, queries.size()))
+        {
+            const auto &coordinate = queries[query].coordinate;
+            if (!results[query].empty())
+            {
+                phantom_node_pairs[query] = std::make_pair(
+                    MakePhantomNode(coordinate, results[query].front()).phantom_node,
+                    MakePhantomNode(coordinate, results[query].back()).phantom_node);
+            }
+        }
+        return phantom_node_pairs;
+    }
+
   private:
+    static std::vector<util::Coordinate> GetCoordinates(const std::vector<NearestQuery> &queries)
+    {
+        std::vector<util::Coordinate> coordinates(queries.size());
+        std::transform(queries.begin(),
+                       queries.end(),
+                       coordinates.begin(),
+                       [](const NearestQuery &query) { return query.coordinate; });
+        return coordinates;
+    }
+
     std::vector<PhantomNodeWithDistance>
     MakePhantomNodes(const util::Coordinate input_coordinate,
                      const std::vector<EdgeData> &results) const
@@ -0,0 +1,34 @@
+#ifndef OSRM_ENGINE_NEAREST_QUERY_HPP
+#define OSRM_ENGINE_NEAREST_QUERY_HPP
+
+#include "engine/bearing.hpp"
+#include "util/coordinate.hpp"
+
+#include <boost/optional.hpp>
+
+namespace osrm
+{
+namespace engine
+{
+
+// A query of a batch of nearest phantom node queries, the restrictions are optional.
+// Without max_results and max_distance a query returns all segments.
+struct NearestQuery
+{
+    explicit NearestQuery(const util::Coordinate coordinate) : coordinate(coordinate) {}
+
+    util::Coordinate coordinate;
+    boost::optional<unsigned> max_results;
+    boost::optional<double> max_distance;
+    boost::optional<Bearing> bearing;
+};
+
+inline bool operator==(const NearestQuery &lhs, const NearestQuery &rhs)
+{
+    return lhs.coordinate == rhs.coordinate && lhs.max_results == rhs.max_results &&
+           lhs.max_distance == rhs.max_distance && lhs.bearing == rhs.bearing;
+}
+}
+}
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef OSRM_ENGINE_PHANTOM_NODE_CACHE_HPP
+#define OSRM_ENGINE_PHANTOM_NODE_CACHE_HPP
+
+#include "engine/nearest_query.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/lru_cache.hpp"
+#include "util/std_hash.hpp"
+
+#include <boost/assert.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+struct NearestQueryHash
+{
+    std::size_t operator()(const NearestQuery &query) const
+    {
+        return hash_val(static_cast<std::int32_t>(query.coordinate.lon),
+                        static_cast<std::int32_t>(query.coordinate.lat),
+                        query.max_results.value_or(0),
+                        query.max_distance.value_or(-1.),
+                        query.bearing ? query.bearing->bearing : -1,
+                        query.bearing ? query.bearing->range : -1);
+    }
+};
+
+/**
+ * Caches the results of nearest queries of a dataset, so clients that keep snapping the same
+ * coordinates skip the r-tree.
+ *
+ * A query is identified by its coordinate, which is rounded to COORDINATE_PRECISION when the
+ * request is parsed, and its restrictions: the number of results, the radius and the bearing.
+ * The results of a query only depend on these and the data, every facade therefore owns its
+ * caches and they are dropped together with the dataset.
+ *
+ * Queries from all threads share the cache, the lookups of a batch take the lock once. The hit
+ * rate is logged every REPORT_INTERVAL lookups at debug level and when the cache is destroyed.
+ */
+template <typename ResultT> class PhantomNodeCache
+{
+    static constexpr std::uint64_t REPORT_INTERVAL = 1 << 16;
+
+  public:
+    PhantomNodeCache(std::string name, const std::size_t capacity)
+        : name(std::move(name)), cache(capacity)
+    {
+    }
+
+    ~PhantomNodeCache()
+    {
+        if (GetHits() + GetMisses() > 0)
+        {
+            util::Log() << name << " cache: " << GetHits() << " hits, " << GetMisses()
+                        << " misses, hit rate " << GetHitRate() * 100. << "%";
+        }
+    }
+
+    // Answers the queries from the cache, the missing ones are answered by nearest in one batch
+    template <typename NearestFunction>
+    std::vector<ResultT> Query(const std::vector<NearestQuery> &queries,
+                               const NearestFunction &nearest)
+    {
+        std::vector<ResultT> results(queries.size());
+        std::vector<NearestQuery> missing_queries;
+        std::vector<std::size_t> missing_indices;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto index : util::irange<std::size_t>(0UL, queries.size()))
+            {
+                if (!cache.Get(queries[index], results[index]))
+                {
+                    missing_queries.push_back(queries[index]);
+                    missing_indices.push_back(index);
+                }
+            }
+        }
+
+        if (!missing_queries.empty())
+        {
+            auto missing_results = nearest(missing_queries);
+            BOOST_ASSERT(missing_results.size() == missing_queries.size());
+
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto missing : util::irange<std::size_t>(0UL, missing_queries.size()))
+            {
+                cache.Insert(missing_queries[missing], missing_results[missing]);
+                results[missing_indices[missing]] = std::move(missing_results[missing]);
+            }
+        }
+
+        Count(queries.size() - missing_queries.size(), missing_queries.size());
+        return results;
+    }
+
+    std::uint64_t GetHits() const { return hits.load(std::memory_order_relaxed); }
+
+    std::uint64_t GetMisses() const { return misses.load(std::memory_order_relaxed); }
+
+    double GetHitRate() const
+    {
+        const auto lookups = GetHits() + GetMisses();
+        return lookups == 0 ? 0. : static_cast<double>(GetHits()) / lookups;
+    }
+
+  private:
+    void Count(const std::uint64_t new_hits, const std::uint64_t new_misses)
+    {
+        const auto lookups_before = hits.fetch_add(new_hits, std::memory_order_relaxed) +
+                                    misses.fetch_add(new_misses, std::memory_order_relaxed);
+        const auto lookups_after = lookups_before + new_hits + new_misses;
+        if (lookups_before / REPORT_INTERVAL != lookups_after / REPORT_INTERVAL)
+        {
+            util::Log(logDEBUG) << name << " cache: " << lookups_after << " lookups, hit rate "
+                                << GetHitRate() * 100. << "%";
+        }
+    }
+
+    const std::string name;
+    std::mutex mutex;
+    util::LRUCache<NearestQuery, ResultT, NearestQueryHash> cache;
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+};
+}
+}
+
+#endif // OSRM_ENGINE_PHANTOM_NODE_CACHE_HPP
@@ -3,6 +3,7 @@
 
 #include "engine/api/base_parameters.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
+#include "engine/nearest_query.hpp"
 #include "engine/phantom_node.hpp"
 #include "engine/status.hpp"
 
@@ -14,6 +15,7 @@
 #include <algorithm>
 #include <iterator>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -119,6 +121,9 @@ class BasePlugin
         const bool use_hints = !parameters.hints.empty();
         const bool use_bearings = !parameters.bearings.empty();
 
+        // all coordinates without a valid hint are looked up in one batch
+        std::vector<NearestQuery> queries;
+        std::vector<std::size_t> query_coordinates;
         for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
         {
             if (use_hints && parameters.hints[i] &&
@@ -131,19 +136,21 @@ class BasePlugin
                 });
                 continue;
             }
+
+            NearestQuery query{parameters.coordinates[i]};
+            query.max_distance = radiuses[i];
             if (use_bearings && parameters.bearings[i])
             {
-                phantom_nodes[i] =
-                    facade.NearestPhantomNodesInRange(parameters.coordinates[i],
-                                                      radiuses[i],
-                                                      parameters.bearings[i]->bearing,
-                                                      parameters.bearings[i]->range);
-            }
-            else
-            {
-                phantom_nodes[i] =
-                    facade.NearestPhantomNodesInRange(parameters.coordinates[i], radiuses[i]);
+                query.bearing = parameters.bearings[i];
             }
+            queries.push_back(query);
+            query_coordinates.push_back(i);
+        }
+
+        auto results = facade.NearestPhantomNodes(queries);
+        for (const auto query : util::irange<std::size_t>(0UL, queries.size()))
+        {
+            phantom_nodes[query_coordinates[query]] = std::move(results[query]);
         }
 
         return phantom_nodes;
@@ -158,10 +165,10 @@ class BasePlugin
             parameters.coordinates.size());
 
         const bool use_hints = !parameters.hints.empty();
-        const bool use_bearings = !parameters.bearings.empty();
-        const bool use_radiuses = !parameters.radiuses.empty();
 
         BOOST_ASSERT(parameters.IsValid());
+        std::vector<NearestQuery> queries;
+        std::vector<std::size_t> query_coordinates;
         for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
         {
             if (use_hints && parameters.hints[i] &&
@@ -175,40 +182,19 @@ class BasePlugin
                 continue;
             }
 
-            if (use_bearings && parameters.bearings[i])
-            {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_nodes[i] = facade.NearestPhantomNodes(parameters.coordinates[i],
-                                                                  number_of_results,
-                                                                  *parameters.radiuses[i],
-                                                                  parameters.bearings[i]->bearing,
-                                                                  parameters.bearings[i]->range);
-                }
-                else
-                {
-                    phantom_nodes[i] = facade.NearestPhantomNodes(parameters.coordinates[i],
-                                                                  number_of_results,
-                                                                  parameters.bearings[i]->bearing,
-                                                                  parameters.bearings[i]->range);
-                }
-            }
-            else
-            {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_nodes[i] = facade.NearestPhantomNodes(
-                        parameters.coordinates[i], number_of_results, *parameters.radiuses[i]);
-                }
-                else
-                {
-                    phantom_nodes[i] =
-                        facade.NearestPhantomNodes(parameters.coordinates[i], number_of_results);
-                }
-            }
+            auto query = MakeNearestQuery(parameters, i);
+            query.max_results = number_of_results;
+            queries.push_back(query);
+            query_coordinates.push_back(i);
+        }
+
+        auto results = facade.NearestPhantomNodes(queries);
+        for (const auto query : util::irange<std::size_t>(0UL, queries.size()))
+        {
+            phantom_nodes[query_coordinates[query]] = std::move(results[query]);
 
             // we didn't find a fitting node, return error
-            if (phantom_nodes[i].empty())
+            if (phantom_nodes[query_coordinates[query]].empty())
             {
                 break;
             }
@@ -222,10 +208,10 @@ class BasePlugin
         std::vector<PhantomNodePair> phantom_node_pairs(parameters.coordinates.size());
 
         const bool use_hints = !parameters.hints.empty();
-        const bool use_bearings = !parameters.bearings.empty();
-        const bool use_radiuses = !parameters.radiuses.empty();
 
         BOOST_ASSERT(parameters.IsValid());
+        std::vector<NearestQuery> queries;
+        std::vector<std::size_t> query_coordinates;
         for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
         {
             if (use_hints && parameters.hints[i] &&
@@ -236,41 +222,15 @@ class BasePlugin
                 continue;
             }
 
-            if (use_bearings && parameters.bearings[i])
-            {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i],
-                            *parameters.radiuses[i],
-                            parameters.bearings[i]->bearing,
-                            parameters.bearings[i]->range);
-                }
-                else
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i],
-                            parameters.bearings[i]->bearing,
-                            parameters.bearings[i]->range);
-                }
-            }
-            else
-            {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i], *parameters.radiuses[i]);
-                }
-                else
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i]);
-                }
-            }
+            queries.push_back(MakeNearestQuery(parameters, i));
+            query_coordinates.push_back(i);
+        }
+
+        const auto results = facade.NearestPhantomNodeWithAlternativeFromBigComponent(queries);
+        for (const auto query : util::irange<std::size_t>(0UL, queries.size()))
+        {
+            const auto i = query_coordinates[query];
+            phantom_node_pairs[i] = results[query];
 
             // we didn't find a fitting node, return error
             if (!phantom_node_pairs[i].first.IsValid(facade.GetNumberOfNodes()))
@@ -284,6 +244,22 @@ class BasePlugin
         }
         return phantom_node_pairs;
     }
+
+  private:
+    // The nearest query of coordinate i, restricted by its radius and bearing if there are any
+    NearestQuery MakeNearestQuery(const api::BaseParameters &parameters, const std::size_t i) const
+    {
+        NearestQuery query{parameters.coordinates[i]};
+        if (!parameters.radiuses.empty() && parameters.radiuses[i])
+        {
+            query.max_distance = *parameters.radiuses[i];
+        }
+        if (!parameters.bearings.empty() && parameters.bearings[i])
+        {
+            query.bearing = parameters.bearings[i];
+        }
+        return query;
+    }
 };
 }
 }
@@ -8,6 +8,8 @@
 #include "engine/search_engine_data.hpp"
 #include "util/json_container.hpp"
 
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -18,16 +20,29 @@ namespace plugins
 class TablePlugin final : public BasePlugin
 {
   public:
-    explicit TablePlugin(const int max_locations_distance_table);
+    explicit TablePlugin(const int max_locations_distance_table,
+                         const int max_threads_distance_table = 1,
+                         const int max_entries_table_tile = 1 << 20);
 
     Status HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
                          const api::TableParameters &params,
                          util::json::Object &result) const;
 
+    // Computes the table tile by tile and renders each tile's rows into result right away
+    Status HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
+                         const api::TableParameters &params,
+                         std::vector<char> &result) const;
+
   private:
+    Status CheckParameters(const datafacade::BaseDataFacade &facade,
+                           const api::TableParameters &params,
+                           util::json::Object &result) const;
+
     mutable SearchEngineData heaps;
     mutable routing_algorithms::ManyToManyRouting<datafacade::BaseDataFacade> distance_table;
     const int max_locations_distance_table;
+    const int max_threads_distance_table;
+    const int max_entries_table_tile;
 };
 }
 }
@@ -35,12 +35,23 @@ class ViaRoutePlugin final : public BasePlugin
         direct_shortest_path;
     const int max_locations_viaroute;
 
+    // Snaps the coordinates and runs the searches, errors are reported in json_result
+    Status ComputeRoute(const std::shared_ptr<datafacade::BaseDataFacade> facade,
+                        const api::RouteParameters &route_parameters,
+                        InternalRouteResult &raw_route,
+                        util::json::Object &json_result) const;
+
   public:
     explicit ViaRoutePlugin(int max_locations_viaroute);
 
     Status HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
                          const api::RouteParameters &route_parameters,
                          util::json::Object &json_result) const;
+
+    // Renders the response in the requested format, errors are always rendered as JSON
+    Status HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
+                         const api::RouteParameters &route_parameters,
+                         std::vector<char> &result) const;
 };
 }
 }
@@ -0,0 +1,120 @@
+#ifndef OSRM_ENGINE_ROUTING_ALGORITHMS_BUCKET_RELAXATION_HPP
+#define OSRM_ENGINE_ROUTING_ALGORITHMS_BUCKET_RELAXATION_HPP
+
+#include "util/cpu_features.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#if OSRM_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+// Relaxes the buckets of one settled node against one row of a distance table:
+//
+//   row[target_ids[i]] = min(row[target_ids[i]], source_weight + weights[i])
+//
+// The buckets of a node stem from distinct backward searches, so target_ids contains no
+// duplicates and the lanes of a vector never write to the same cell.
+// The caller has to make sure source_weight + weights[i] can not become negative.
+namespace bucket_relaxation
+{
+
+inline void RelaxScalar(EdgeWeight *row,
+                        const unsigned *target_ids,
+                        const EdgeWeight *weights,
+                        const std::size_t count,
+                        const EdgeWeight source_weight)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const EdgeWeight new_weight = source_weight + weights[i];
+        EdgeWeight &current_weight = row[target_ids[i]];
+        if (new_weight < current_weight)
+        {
+            current_weight = new_weight;
+        }
+    }
+}
+
+#if OSRM_X86_SIMD
+OSRM_TARGET_AVX2 inline void RelaxAVX2(EdgeWeight *row,
+                                       const unsigned *target_ids,
+                                       const EdgeWeight *weights,
+                                       const std::size_t count,
+                                       const EdgeWeight source_weight)
+{
+    const __m256i offset = _mm256_set1_epi32(source_weight);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i indices =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(target_ids + i));
+        const __m256i new_weights = _mm256_add_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(weights + i)), offset);
+        const __m256i current_weights =
+            _mm256_i32gather_epi32(reinterpret_cast<const int *>(row), indices, 4);
+        const __m256i min_weights = _mm256_min_epi32(current_weights, new_weights);
+
+        // there is no scatter before AVX-512, write the lanes back one by one
+        alignas(32) std::int32_t result[8];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(result), min_weights);
+        for (std::size_t lane = 0; lane < 8; ++lane)
+        {
+            row[target_ids[i + lane]] = result[lane];
+        }
+    }
+    RelaxScalar(row, target_ids + i, weights + i, count - i, source_weight);
+}
+#endif
+
+using RelaxFunction = void (*)(EdgeWeight *,
+                               const unsigned *,
+                               const EdgeWeight *,
+                               const std::size_t,
+                               const EdgeWeight);
+
+// Picks the gather kernel if the CPU we are running on supports AVX2. Without a gather the
+// loads and stores stay scalar, so there is nothing to gain over the plain loop.
+inline RelaxFunction SelectRelax()
+{
+#if OSRM_X86_SIMD
+    if (util::cpu::HasAVX2())
+        return &RelaxAVX2;
+#endif
+    return &RelaxScalar;
+}
+
+inline void Relax(EdgeWeight *row,
+                  const unsigned *target_ids,
+                  const EdgeWeight *weights,
+                  const std::size_t count,
+                  const EdgeWeight source_weight)
+{
+    // most nodes only carry a handful of buckets, not worth the indirect call
+    constexpr std::size_t MIN_VECTORIZED_BUCKETS = 8;
+    if (count < MIN_VECTORIZED_BUCKETS)
+    {
+        RelaxScalar(row, target_ids, weights, count, source_weight);
+        return;
+    }
+
+    static const RelaxFunction relax = SelectRelax();
+    relax(row, target_ids, weights, count, source_weight);
+}
+}
+}
+}
+}
+
+#endif // OSRM_ENGINE_ROUTING_ALGORITHMS_BUCKET_RELAXATION_HPP
@@ -93,7 +93,23 @@ class DirectShortestPathRouting final
         const bool constexpr DO_NOT_FORCE_LOOPS =
             false; // prevents forcing of loops, since offsets are set correctly
 
-        if (facade.GetCoreSize() > 0)
+        if (facade.GetMultiLevelPartition().GetNumberOfLevels() > 0)
+        {
+            engine_working_data.InitializeOrClearSecondThreadLocalStorage(
+                facade.GetNumberOfNodes());
+            QueryHeap &unpack_heap = *(engine_working_data.forward_heap_2);
+
+            super::SearchOnOverlay(facade,
+                                   forward_heap,
+                                   reverse_heap,
+                                   unpack_heap,
+                                   weight,
+                                   packed_leg,
+                                   DO_NOT_FORCE_LOOPS,
+                                   DO_NOT_FORCE_LOOPS,
+                                   phantom_node_pair);
+        }
+        else if (facade.GetCoreSize() > 0)
         {
             engine_working_data.InitializeOrClearSecondThreadLocalStorage(
                 facade.GetNumberOfNodes());
@@ -1,15 +1,25 @@
 #ifndef MANY_TO_MANY_ROUTING_HPP
 #define MANY_TO_MANY_ROUTING_HPP
 
+#include "engine/routing_algorithms/bucket_relaxation.hpp"
 #include "engine/routing_algorithms/routing_base.hpp"
 #include "engine/search_engine_data.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <cstddef>
 #include <limits>
 #include <memory>
-#include <unordered_map>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -24,21 +34,85 @@ class ManyToManyRouting final
     : public BasicRoutingInterface<DataFacadeT, ManyToManyRouting<DataFacadeT>>
 {
     using super = BasicRoutingInterface<DataFacadeT, ManyToManyRouting<DataFacadeT>>;
-    using QueryHeap = SearchEngineData::QueryHeap;
+    using QueryHeap = SearchEngineData::ManyToManyQueryHeap;
     SearchEngineData &engine_working_data;
 
     struct NodeBucket
     {
+        NodeID middle_node;
         unsigned target_id; // essentially a row in the weight matrix
         EdgeWeight weight;
-        NodeBucket(const unsigned target_id, const EdgeWeight weight)
-            : target_id(target_id), weight(weight)
+        NodeBucket(const NodeID middle_node, const unsigned target_id, const EdgeWeight weight)
+            : middle_node(middle_node), target_id(target_id), weight(weight)
+        {
+        }
+
+        // sort by node first, the target order keeps the result independent of the sort
+        bool operator<(const NodeBucket &rhs) const
+        {
+            return std::tie(middle_node, target_id) < std::tie(rhs.middle_node, rhs.target_id);
+        }
+    };
+
+    // All buckets of the backward searches in one contiguous array. It is appended to while
+    // the backward searches run and sorted by node once before the forward searches, which
+    // then only need to look up the range of a settled node and scan its buckets linearly.
+    using SearchSpaceWithBuckets = std::vector<NodeBucket>;
+
+    // Position of the buckets of one node in the sorted buckets
+    struct BucketRange
+    {
+        std::size_t first;
+        std::size_t count;
+    };
+
+    // The sorted buckets split into one array per member, indexed by the sorted distinct nodes
+    // and the offset of the first bucket of each, which is followed by the end of the last.
+    // Looking up a node only searches the distinct nodes, and the target ids and weights of a
+    // node are contiguous, so the forward step can relax them with vector instructions.
+    struct SortedBuckets
+    {
+        std::vector<NodeID> nodes;
+        std::vector<std::size_t> offsets;
+        std::vector<unsigned> target_ids;
+        std::vector<EdgeWeight> weights;
+
+        void Assign(const SearchSpaceWithBuckets &buckets)
+        {
+            nodes.clear();
+            offsets.clear();
+            target_ids.resize(buckets.size());
+            weights.resize(buckets.size());
+            for (std::size_t index = 0; index < buckets.size(); ++index)
+            {
+                const auto node = buckets[index].middle_node;
+                if (index == 0 || buckets[index - 1].middle_node != node)
+                {
+                    nodes.push_back(node);
+                    offsets.push_back(index);
+                }
+                target_ids[index] = buckets[index].target_id;
+                weights[index] = buckets[index].weight;
+            }
+            offsets.push_back(buckets.size());
+        }
+
+        // the range is empty if the node has no buckets
+        BucketRange GetRange(const NodeID node) const
         {
+            const auto position = std::lower_bound(nodes.begin(), nodes.end(), node);
+            if (position == nodes.end() || *position != node)
+            {
+                return {0, 0};
+            }
+            const auto index = static_cast<std::size_t>(position - nodes.begin());
+            return {offsets[index], offsets[index + 1] - offsets[index]};
         }
     };
 
-    // FIXME This should be replaced by an std::unordered_multimap, though this needs benchmarking
-    using SearchSpaceWithBuckets = std::unordered_map<NodeID, std::vector<NodeBucket>>;
+    // Tables with fewer entries are always computed on the calling thread, spawning the
+    // arena would cost more than it saves
+    static constexpr std::size_t MIN_PARALLEL_TABLE_ENTRIES = 64 * 64;
 
   public:
     ManyToManyRouting(SearchEngineData &engine_working_data)
@@ -46,142 +120,282 @@ class ManyToManyRouting final
     {
     }
 
+    // max_threads caps the number of threads one table may use. The searches are distributed
+    // over a task arena of that size and every task uses the thread local heap of the thread
+    // it runs on, so no heaps are allocated per request.
     std::vector<EdgeWeight> operator()(const DataFacadeT &facade,
                                        const std::vector<PhantomNode> &phantom_nodes,
                                        const std::vector<std::size_t> &source_indices,
-                                       const std::vector<std::size_t> &target_indices) const
+                                       const std::vector<std::size_t> &target_indices,
+                                       const unsigned max_threads = 1) const
     {
+        const auto number_of_sources =
+            source_indices.empty() ? phantom_nodes.size() : source_indices.size();
+
+        std::vector<EdgeWeight> result_table;
+        ComputeTiles(facade,
+                     phantom_nodes,
+                     source_indices,
+                     target_indices,
+                     max_threads,
+                     std::max<std::size_t>(number_of_sources, 1),
+                     [&result_table](const std::size_t, std::vector<EdgeWeight> &tile) {
+                         result_table = std::move(tile);
+                     });
+        return result_table;
+    }
+
+    // Computes the table in tiles of rows_per_tile rows. The backward searches run once for all
+    // targets, then the forward searches fill one tile at a time and hand it to
+    // handle_tile(first_row, tile) before the next tile reuses its memory. Apart from the
+    // buckets only one tile of durations is ever kept, handle_tile decides what to keep of it.
+    template <typename TileHandler>
+    void ComputeTiles(const DataFacadeT &facade,
+                      const std::vector<PhantomNode> &phantom_nodes,
+                      const std::vector<std::size_t> &source_indices,
+                      const std::vector<std::size_t> &target_indices,
+                      const unsigned max_threads,
+                      const std::size_t rows_per_tile,
+                      TileHandler &&handle_tile) const
+    {
+        BOOST_ASSERT(rows_per_tile > 0);
+
         const auto number_of_sources =
             source_indices.empty() ? phantom_nodes.size() : source_indices.size();
         const auto number_of_targets =
             target_indices.empty() ? phantom_nodes.size() : target_indices.size();
         const auto number_of_entries = number_of_sources * number_of_targets;
-        std::vector<EdgeWeight> result_table(number_of_entries,
-                                             std::numeric_limits<EdgeWeight>::max());
-
-        engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
+        const auto number_of_nodes = facade.GetNumberOfNodes();
 
-        QueryHeap &query_heap = *(engine_working_data.forward_heap_1);
+        const auto get_source = [&](const std::size_t row_idx) -> const PhantomNode & {
+            return source_indices.empty() ? phantom_nodes[row_idx]
+                                          : phantom_nodes[source_indices[row_idx]];
+        };
+        const auto get_target = [&](const std::size_t column_idx) -> const PhantomNode & {
+            return target_indices.empty() ? phantom_nodes[column_idx]
+                                          : phantom_nodes[target_indices[column_idx]];
+        };
 
-        SearchSpaceWithBuckets search_space_with_buckets;
+        const bool parallel = max_threads > 1 && number_of_entries >= MIN_PARALLEL_TABLE_ENTRIES;
 
-        unsigned column_idx = 0;
-        const auto search_target_phantom = [&](const PhantomNode &phantom) {
-            query_heap.Clear();
-            // insert target(s) at weight 0
+        SortedBuckets sorted_buckets;
+        std::vector<EdgeWeight> tile_table;
 
-            if (phantom.forward_segment_id.enabled)
-            {
-                query_heap.Insert(phantom.forward_segment_id.id,
-                                  phantom.GetForwardWeightPlusOffset(),
-                                  phantom.forward_segment_id.id);
-            }
-            if (phantom.reverse_segment_id.enabled)
+        const auto compute_tiles = [&] {
             {
-                query_heap.Insert(phantom.reverse_segment_id.id,
-                                  phantom.GetReverseWeightPlusOffset(),
-                                  phantom.reverse_segment_id.id);
+                SearchSpaceWithBuckets search_space_with_buckets;
+                if (parallel)
+                {
+                    ParallelBackwardSearches(
+                        facade, number_of_targets, get_target, search_space_with_buckets);
+                }
+                else
+                {
+                    engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+                        number_of_nodes);
+                    QueryHeap &query_heap = *(engine_working_data.many_to_many_heap);
+                    for (std::size_t column_idx = 0; column_idx < number_of_targets; ++column_idx)
+                    {
+                        BackwardSearch(facade,
+                                       column_idx,
+                                       get_target(column_idx),
+                                       query_heap,
+                                       search_space_with_buckets);
+                    }
+                    std::sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+                }
+                // the unsplit buckets are released at the end of this scope
+                sorted_buckets.Assign(search_space_with_buckets);
             }
 
-            // explore search space
-            while (!query_heap.Empty())
+            for (std::size_t first_row = 0; first_row < number_of_sources;
+                 first_row += rows_per_tile)
             {
-                BackwardRoutingStep(facade, column_idx, query_heap, search_space_with_buckets);
-            }
-            ++column_idx;
-        };
-
-        // for each source do forward search
-        unsigned row_idx = 0;
-        const auto search_source_phantom = [&](const PhantomNode &phantom) {
-            query_heap.Clear();
-            // insert target(s) at weight 0
+                const auto number_of_rows = std::min(rows_per_tile, number_of_sources - first_row);
+                tile_table.assign(number_of_rows * number_of_targets,
+                                  std::numeric_limits<EdgeWeight>::max());
+
+                const auto forward_searches = [&](const std::size_t begin, const std::size_t end) {
+                    engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+                        number_of_nodes);
+                    QueryHeap &query_heap = *(engine_working_data.many_to_many_heap);
+                    for (auto row_idx = begin; row_idx < end; ++row_idx)
+                    {
+                        ForwardSearch(facade,
+                                      row_idx,
+                                      number_of_targets,
+                                      get_source(first_row + row_idx),
+                                      query_heap,
+                                      sorted_buckets,
+                                      tile_table);
+                    }
+                };
 
-            if (phantom.forward_segment_id.enabled)
-            {
-                query_heap.Insert(phantom.forward_segment_id.id,
-                                  -phantom.GetForwardWeightPlusOffset(),
-                                  phantom.forward_segment_id.id);
-            }
-            if (phantom.reverse_segment_id.enabled)
-            {
-                query_heap.Insert(phantom.reverse_segment_id.id,
-                                  -phantom.GetReverseWeightPlusOffset(),
-                                  phantom.reverse_segment_id.id);
-            }
+                if (parallel)
+                {
+                    // every source writes its own row of the tile, so no synchronization is needed
+                    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_rows),
+                                      [&](const tbb::blocked_range<std::size_t> &range) {
+                                          forward_searches(range.begin(), range.end());
+                                      });
+                }
+                else
+                {
+                    forward_searches(0, number_of_rows);
+                }
 
-            // explore search space
-            while (!query_heap.Empty())
-            {
-                ForwardRoutingStep(facade,
-                                   row_idx,
-                                   number_of_targets,
-                                   query_heap,
-                                   search_space_with_buckets,
-                                   result_table);
+                handle_tile(first_row, tile_table);
             }
-            ++row_idx;
         };
 
-        if (target_indices.empty())
+        if (parallel)
         {
-            for (const auto &phantom : phantom_nodes)
-            {
-                search_target_phantom(phantom);
-            }
+            tbb::task_arena arena(static_cast<int>(max_threads));
+            arena.execute(compute_tiles);
         }
         else
         {
-            for (const auto index : target_indices)
-            {
-                const auto &phantom = phantom_nodes[index];
-                search_target_phantom(phantom);
-            }
+            compute_tiles();
         }
+    }
 
-        if (source_indices.empty())
+    template <typename GetTarget>
+    void ParallelBackwardSearches(const DataFacadeT &facade,
+                                  const std::size_t number_of_targets,
+                                  const GetTarget &get_target,
+                                  SearchSpaceWithBuckets &search_space_with_buckets) const
+    {
+        const auto number_of_nodes = facade.GetNumberOfNodes();
+
+        // every thread collects the buckets of its backward searches separately, the sort
+        // below makes the merged result independent of the scheduling
+        tbb::enumerable_thread_specific<SearchSpaceWithBuckets> local_buckets;
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_targets),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+                                  number_of_nodes);
+                              QueryHeap &query_heap = *(engine_working_data.many_to_many_heap);
+                              auto &buckets = local_buckets.local();
+                              for (auto column_idx = range.begin(); column_idx < range.end();
+                                   ++column_idx)
+                              {
+                                  BackwardSearch(facade,
+                                                 column_idx,
+                                                 get_target(column_idx),
+                                                 query_heap,
+                                                 buckets);
+                              }
+                          });
+
+        std::size_t number_of_buckets = 0;
+        for (const auto &buckets : local_buckets)
         {
-            for (const auto &phantom : phantom_nodes)
-            {
-                search_source_phantom(phantom);
-            }
+            number_of_buckets += buckets.size();
         }
-        else
+        search_space_with_buckets.reserve(number_of_buckets);
+        for (const auto &buckets : local_buckets)
         {
-            for (const auto index : source_indices)
-            {
-                const auto &phantom = phantom_nodes[index];
-                search_source_phantom(phantom);
-            }
+            search_space_with_buckets.insert(
+                search_space_with_buckets.end(), buckets.begin(), buckets.end());
         }
+        tbb::parallel_sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+    }
 
-        return result_table;
+    void BackwardSearch(const DataFacadeT &facade,
+                        const unsigned column_idx,
+                        const PhantomNode &phantom,
+                        QueryHeap &query_heap,
+                        SearchSpaceWithBuckets &search_space_with_buckets) const
+    {
+        query_heap.Clear();
+        // insert target(s) at weight 0
+
+        if (phantom.forward_segment_id.enabled)
+        {
+            query_heap.Insert(phantom.forward_segment_id.id,
+                              phantom.GetForwardWeightPlusOffset(),
+                              phantom.forward_segment_id.id);
+        }
+        if (phantom.reverse_segment_id.enabled)
+        {
+            query_heap.Insert(phantom.reverse_segment_id.id,
+                              phantom.GetReverseWeightPlusOffset(),
+                              phantom.reverse_segment_id.id);
+        }
+
+        // explore search space
+        while (!query_heap.Empty())
+        {
+            BackwardRoutingStep(facade, column_idx, query_heap, search_space_with_buckets);
+        }
+    }
+
+    void ForwardSearch(const DataFacadeT &facade,
+                       const unsigned row_idx,
+                       const unsigned number_of_targets,
+                       const PhantomNode &phantom,
+                       QueryHeap &query_heap,
+                       const SortedBuckets &sorted_buckets,
+                       std::vector<EdgeWeight> &result_table) const
+    {
+        query_heap.Clear();
+        // insert target(s) at weight 0
+
+        if (phantom.forward_segment_id.enabled)
+        {
+            query_heap.Insert(phantom.forward_segment_id.id,
+                              -phantom.GetForwardWeightPlusOffset(),
+                              phantom.forward_segment_id.id);
+        }
+        if (phantom.reverse_segment_id.enabled)
+        {
+            query_heap.Insert(phantom.reverse_segment_id.id,
+                              -phantom.GetReverseWeightPlusOffset(),
+                              phantom.reverse_segment_id.id);
+        }
+
+        // explore search space
+        while (!query_heap.Empty())
+        {
+            ForwardRoutingStep(facade,
+                               row_idx,
+                               number_of_targets,
+                               query_heap,
+                               sorted_buckets,
+                               result_table);
+        }
     }
 
     void ForwardRoutingStep(const DataFacadeT &facade,
                             const unsigned row_idx,
                             const unsigned number_of_targets,
                             QueryHeap &query_heap,
-                            const SearchSpaceWithBuckets &search_space_with_buckets,
+                            const SortedBuckets &sorted_buckets,
                             std::vector<EdgeWeight> &result_table) const
     {
         const NodeID node = query_heap.DeleteMin();
         const int source_weight = query_heap.GetKey(node);
 
-        // check if each encountered node has an entry
-        const auto bucket_iterator = search_space_with_buckets.find(node);
-        // iterate bucket if there exists one
-        if (bucket_iterator != search_space_with_buckets.end())
+        // find all buckets of the encountered node
+        const auto bucket_range = sorted_buckets.GetRange(node);
+        const auto count = bucket_range.count;
+        const unsigned *target_ids = sorted_buckets.target_ids.data() + bucket_range.first;
+        const EdgeWeight *weights = sorted_buckets.weights.data() + bucket_range.first;
+        EdgeWeight *row = result_table.data() + row_idx * number_of_targets;
+
+        // only the segments of the source phantom start with a negative offset, all other
+        // nodes can take the vectorized path
+        if (source_weight >= 0)
+        {
+            bucket_relaxation::Relax(row, target_ids, weights, count, source_weight);
+        }
+        else
         {
-            const std::vector<NodeBucket> &bucket_list = bucket_iterator->second;
-            for (const NodeBucket &current_bucket : bucket_list)
+            for (std::size_t index = 0; index < count; ++index)
             {
-                // get target id from bucket entry
-                const unsigned column_idx = current_bucket.target_id;
-                const int target_weight = current_bucket.weight;
-                auto &current_weight = result_table[row_idx * number_of_targets + column_idx];
+                auto &current_weight = row[target_ids[index]];
                 // check if new weight is better
-                const EdgeWeight new_weight = source_weight + target_weight;
+                const EdgeWeight new_weight = source_weight + weights[index];
                 if (new_weight < 0)
                 {
                     const EdgeWeight loop_weight = super::GetLoopWeight(facade, node);
@@ -193,7 +407,7 @@ class ManyToManyRouting final
                 }
                 else if (new_weight < current_weight)
                 {
-                    result_table[row_idx * number_of_targets + column_idx] = new_weight;
+                    current_weight = new_weight;
                 }
             }
         }
@@ -213,7 +427,7 @@ class ManyToManyRouting final
         const int target_weight = query_heap.GetKey(node);
 
         // store settled nodes in search space bucket
-        search_space_with_buckets[node].emplace_back(column_idx, target_weight);
+        search_space_with_buckets.emplace_back(node, column_idx, target_weight);
 
         if (StallAtNode<false>(facade, node, target_weight, query_heap))
         {
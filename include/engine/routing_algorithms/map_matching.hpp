@@ -233,7 +233,18 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
                         reverse_heap.Clear();
 
                         double network_distance;
-                        if (facade.GetCoreSize() > 0)
+                        if (facade.GetMultiLevelPartition().GetNumberOfLevels() > 0)
+                        {
+                            network_distance = super::GetNetworkDistanceOnOverlay(
+                                facade,
+                                forward_heap,
+                                reverse_heap,
+                                forward_core_heap,
+                                prev_unbroken_timestamps_list[s].phantom_node,
+                                current_timestamps_list[s_prime].phantom_node,
+                                duration_upper_bound);
+                        }
+                        else if (facade.GetCoreSize() > 0)
                         {
                             forward_core_heap.Clear();
                             reverse_core_heap.Clear();
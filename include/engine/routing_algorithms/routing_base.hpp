@@ -1,6 +1,7 @@
 #ifndef ROUTING_BASE_HPP
 #define ROUTING_BASE_HPP
 
+#include "customizer/cell_customizer.hpp"
 #include "extractor/guidance/turn_instruction.hpp"
 #include "engine/edge_unpacker.hpp"
 #include "engine/internal_route_result.hpp"
@@ -748,6 +749,263 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
         }
     }
 
+    // Returns the highest level on which node is in a different cell than all phantom nodes. The
+    // search uses the overlay graph of this level at the node.
+    template <typename PartitionT>
+    LevelID GetQueryLevel(const PartitionT &partition,
+                          const PhantomNodes &phantom_nodes,
+                          const NodeID node) const
+    {
+        auto level = partition.GetNumberOfLevels();
+        for (const auto *phantom : {&phantom_nodes.source_phantom, &phantom_nodes.target_phantom})
+        {
+            if (phantom->forward_segment_id.enabled)
+            {
+                level = std::min(level,
+                                 partition.GetHighestDifferentLevel(
+                                     phantom->forward_segment_id.id, node));
+            }
+            if (phantom->reverse_segment_id.enabled)
+            {
+                level = std::min(level,
+                                 partition.GetHighestDifferentLevel(
+                                     phantom->reverse_segment_id.id, node));
+            }
+        }
+        return level;
+    }
+
+    // Routing step of the multi-level Dijkstra: relaxes the clique arcs of the cell of node on its
+    // query level and the edges that leave this cell. All edges are relaxed on level 0.
+    void OverlayRoutingStep(const DataFacadeT &facade,
+                            SearchEngineData::QueryHeap &forward_heap,
+                            SearchEngineData::QueryHeap &reverse_heap,
+                            const PhantomNodes &phantom_nodes,
+                            NodeID &middle_node_id,
+                            std::int32_t &upper_bound,
+                            const bool forward_direction,
+                            const bool force_loop_forward,
+                            const bool force_loop_reverse) const
+    {
+        const NodeID node = forward_heap.DeleteMin();
+        const std::int32_t weight = forward_heap.GetKey(node);
+
+        if (reverse_heap.WasInserted(node))
+        {
+            const std::int32_t new_weight = reverse_heap.GetKey(node) + weight;
+            // The graph has no self-loops, so forced loops and paths that start behind the target
+            // on the same segment have to meet at another node
+            const bool is_loop =
+                (force_loop_forward && forward_heap.GetData(node).parent == node) ||
+                (force_loop_reverse && reverse_heap.GetData(node).parent == node);
+            if (!is_loop && new_weight >= 0 && new_weight < upper_bound)
+            {
+                middle_node_id = node;
+                upper_bound = new_weight;
+            }
+        }
+
+        const auto relax = [&forward_heap, node](const NodeID to, const std::int32_t to_weight) {
+            if (!forward_heap.WasInserted(to))
+            {
+                forward_heap.Insert(to, to_weight, node);
+            }
+            else if (to_weight < forward_heap.GetKey(to))
+            {
+                forward_heap.GetData(to).parent = node;
+                forward_heap.DecreaseKey(to, to_weight);
+            }
+        };
+
+        const auto &partition = facade.GetMultiLevelPartition();
+        const auto level = GetQueryLevel(partition, phantom_nodes, node);
+        if (level > 0)
+        {
+            const auto cell =
+                facade.GetCellStorage().GetCell(level, partition.GetCell(level, node));
+            if (forward_direction)
+            {
+                const auto row = cell.GetSourceIndex(node);
+                if (row != cell.INVALID_INDEX)
+                {
+                    for (std::uint32_t column = 0; column < cell.GetNumberOfDestinationNodes();
+                         ++column)
+                    {
+                        const auto clique_weight = cell.GetWeight(row, column);
+                        const auto to = cell.GetDestinationNode(column);
+                        if (to != node && clique_weight != INVALID_EDGE_WEIGHT)
+                        {
+                            relax(to, weight + clique_weight);
+                        }
+                    }
+                }
+            }
+            else
+            {
+                const auto column = cell.GetDestinationIndex(node);
+                if (column != cell.INVALID_INDEX)
+                {
+                    for (std::uint32_t row = 0; row < cell.GetNumberOfSourceNodes(); ++row)
+                    {
+                        const auto clique_weight = cell.GetWeight(row, column);
+                        const auto to = cell.GetSourceNode(row);
+                        if (to != node && clique_weight != INVALID_EDGE_WEIGHT)
+                        {
+                            relax(to, weight + clique_weight);
+                        }
+                    }
+                }
+            }
+        }
+
+        for (const auto edge : facade.GetAdjacentEdgeRange(node))
+        {
+            const EdgeData &data = facade.GetEdgeData(edge);
+            if (forward_direction ? data.forward : data.backward)
+            {
+                const NodeID to = facade.GetTarget(edge);
+                if (level == 0 || partition.GetCell(level, to) != partition.GetCell(level, node))
+                {
+                    BOOST_ASSERT_MSG(data.weight > 0, "edge_weight invalid");
+                    relax(to, weight + data.weight);
+                }
+            }
+        }
+    }
+
+    // Replaces the clique arc from -> to of the cell on level by the path inside the cell,
+    // recursively down to the edges of the graph. Appends the path without from.
+    void UnpackCliqueArc(const DataFacadeT &facade,
+                         SearchEngineData::QueryHeap &unpack_heap,
+                         const LevelID level,
+                         const NodeID from,
+                         const NodeID to,
+                         std::vector<NodeID> &unpacked_path) const
+    {
+        const auto &partition = facade.GetMultiLevelPartition();
+        const auto cell = partition.GetCell(level, from);
+        BOOST_ASSERT(partition.GetCell(level, to) == cell);
+
+        unpack_heap.Clear();
+        unpack_heap.Insert(from, 0, from);
+        while (!unpack_heap.Empty())
+        {
+            const auto weight = unpack_heap.MinKey();
+            const auto node = unpack_heap.DeleteMin();
+            if (node == to)
+            {
+                break;
+            }
+            customizer::relaxNodeInCell(partition,
+                                        facade.GetCellStorage(),
+                                        facade,
+                                        unpack_heap,
+                                        level,
+                                        cell,
+                                        node,
+                                        weight);
+        }
+        BOOST_ASSERT(unpack_heap.WasInserted(to));
+
+        std::vector<NodeID> path{to};
+        RetrievePackedPathFromSingleHeap(unpack_heap, to, path);
+        std::reverse(path.begin(), path.end());
+        BOOST_ASSERT(path.front() == from);
+
+        // arcs inside a cell of the level below are cliques, all others are edges
+        const LevelID sublevel = level - 1;
+        for (std::size_t index = 1; index < path.size(); ++index)
+        {
+            if (sublevel > 0 &&
+                partition.GetCell(sublevel, path[index - 1]) ==
+                    partition.GetCell(sublevel, path[index]))
+            {
+                UnpackCliqueArc(
+                    facade, unpack_heap, sublevel, path[index - 1], path[index], unpacked_path);
+            }
+            else
+            {
+                unpacked_path.push_back(path[index]);
+            }
+        }
+    }
+
+    // Multi-level Dijkstra on the overlay graph of osrm-partition and osrm-customize, the
+    // counterpart of Search for facades with a multi-level partition. The heaps have to be set up
+    // with the phantom nodes. The packed leg only contains nodes of the graph, clique arcs are
+    // unpacked with local searches inside their cells using the unpack heap.
+    void SearchOnOverlay(const DataFacadeT &facade,
+                         SearchEngineData::QueryHeap &forward_heap,
+                         SearchEngineData::QueryHeap &reverse_heap,
+                         SearchEngineData::QueryHeap &unpack_heap,
+                         std::int32_t &weight,
+                         std::vector<NodeID> &packed_leg,
+                         const bool force_loop_forward,
+                         const bool force_loop_reverse,
+                         const PhantomNodes &phantom_nodes,
+                         const int duration_upper_bound = INVALID_EDGE_WEIGHT) const
+    {
+        NodeID middle = SPECIAL_NODEID;
+        weight = duration_upper_bound;
+
+        // we only every insert negative offsets for nodes in the forward heap
+        BOOST_ASSERT(reverse_heap.Empty() || reverse_heap.MinKey() >= 0);
+
+        while (!forward_heap.Empty() && !reverse_heap.Empty() &&
+               forward_heap.MinKey() + reverse_heap.MinKey() < weight)
+        {
+            OverlayRoutingStep(facade,
+                               forward_heap,
+                               reverse_heap,
+                               phantom_nodes,
+                               middle,
+                               weight,
+                               true,
+                               force_loop_forward,
+                               force_loop_reverse);
+            if (!reverse_heap.Empty())
+            {
+                OverlayRoutingStep(facade,
+                                   reverse_heap,
+                                   forward_heap,
+                                   phantom_nodes,
+                                   middle,
+                                   weight,
+                                   false,
+                                   force_loop_reverse,
+                                   force_loop_forward);
+            }
+        }
+
+        // No path found for both target nodes?
+        if (duration_upper_bound <= weight || SPECIAL_NODEID == middle)
+        {
+            weight = INVALID_EDGE_WEIGHT;
+            return;
+        }
+
+        std::vector<NodeID> packed_overlay_path;
+        RetrievePackedPathFromHeap(forward_heap, reverse_heap, middle, packed_overlay_path);
+
+        const auto &partition = facade.GetMultiLevelPartition();
+        packed_leg.push_back(packed_overlay_path.front());
+        for (std::size_t index = 1; index < packed_overlay_path.size(); ++index)
+        {
+            const auto from = packed_overlay_path[index - 1];
+            const auto to = packed_overlay_path[index];
+            // edges are only relaxed between different cells of the query level
+            const auto level = GetQueryLevel(partition, phantom_nodes, from);
+            if (level > 0 && partition.GetCell(level, from) == partition.GetCell(level, to))
+            {
+                UnpackCliqueArc(facade, unpack_heap, level, from, to, packed_leg);
+            }
+            else
+            {
+                packed_leg.push_back(to);
+            }
+        }
+    }
+
     bool NeedsLoopForward(const PhantomNode &source_phantom,
                           const PhantomNode &target_phantom) const
     {
@@ -891,6 +1149,70 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
         return distance;
     }
 
+    // Requires the heaps for be empty
+    // If heaps should be adjusted to be initialized outside of this function,
+    // the addition of force_loop parameters might be required
+    double GetNetworkDistanceOnOverlay(const DataFacadeT &facade,
+                                       SearchEngineData::QueryHeap &forward_heap,
+                                       SearchEngineData::QueryHeap &reverse_heap,
+                                       SearchEngineData::QueryHeap &unpack_heap,
+                                       const PhantomNode &source_phantom,
+                                       const PhantomNode &target_phantom,
+                                       int duration_upper_bound = INVALID_EDGE_WEIGHT) const
+    {
+        BOOST_ASSERT(forward_heap.Empty());
+        BOOST_ASSERT(reverse_heap.Empty());
+
+        if (source_phantom.forward_segment_id.enabled)
+        {
+            forward_heap.Insert(source_phantom.forward_segment_id.id,
+                                -source_phantom.GetForwardWeightPlusOffset(),
+                                source_phantom.forward_segment_id.id);
+        }
+        if (source_phantom.reverse_segment_id.enabled)
+        {
+            forward_heap.Insert(source_phantom.reverse_segment_id.id,
+                                -source_phantom.GetReverseWeightPlusOffset(),
+                                source_phantom.reverse_segment_id.id);
+        }
+
+        if (target_phantom.forward_segment_id.enabled)
+        {
+            reverse_heap.Insert(target_phantom.forward_segment_id.id,
+                                target_phantom.GetForwardWeightPlusOffset(),
+                                target_phantom.forward_segment_id.id);
+        }
+        if (target_phantom.reverse_segment_id.enabled)
+        {
+            reverse_heap.Insert(target_phantom.reverse_segment_id.id,
+                                target_phantom.GetReverseWeightPlusOffset(),
+                                target_phantom.reverse_segment_id.id);
+        }
+
+        const bool constexpr DO_NOT_FORCE_LOOPS =
+            false; // prevents forcing of loops, since offsets are set correctly
+
+        int duration = INVALID_EDGE_WEIGHT;
+        std::vector<NodeID> packed_path;
+        SearchOnOverlay(facade,
+                        forward_heap,
+                        reverse_heap,
+                        unpack_heap,
+                        duration,
+                        packed_path,
+                        DO_NOT_FORCE_LOOPS,
+                        DO_NOT_FORCE_LOOPS,
+                        PhantomNodes{source_phantom, target_phantom},
+                        duration_upper_bound);
+
+        if (duration == INVALID_EDGE_WEIGHT)
+        {
+            return std::numeric_limits<double>::max();
+        }
+
+        return GetPathDistance(facade, packed_path, source_phantom, target_phantom);
+    }
+
     // Requires the heaps for be empty
     // If heaps should be adjusted to be initialized outside of this function,
     // the addition of force_loop parameters might be required
@@ -91,7 +91,19 @@ class ShortestPathRouting final
             is_oneway_source && super::NeedsLoopForward(source_phantom, target_phantom);
         auto needs_loop_backwards =
             is_oneway_target && super::NeedsLoopBackwards(source_phantom, target_phantom);
-        if (facade.GetCoreSize() > 0)
+        if (facade.GetMultiLevelPartition().GetNumberOfLevels() > 0)
+        {
+            super::SearchOnOverlay(facade,
+                                   forward_heap,
+                                   reverse_heap,
+                                   forward_core_heap,
+                                   new_total_weight,
+                                   leg_packed_path,
+                                   needs_loop_forwad,
+                                   needs_loop_backwards,
+                                   PhantomNodes{source_phantom, target_phantom});
+        }
+        else if (facade.GetCoreSize() > 0)
         {
             forward_core_heap.Clear();
             reverse_core_heap.Clear();
@@ -170,7 +182,19 @@ class ShortestPathRouting final
             BOOST_ASSERT(forward_heap.Size() > 0);
             BOOST_ASSERT(reverse_heap.Size() > 0);
 
-            if (facade.GetCoreSize() > 0)
+            if (facade.GetMultiLevelPartition().GetNumberOfLevels() > 0)
+            {
+                super::SearchOnOverlay(facade,
+                                       forward_heap,
+                                       reverse_heap,
+                                       forward_core_heap,
+                                       new_total_weight_to_forward,
+                                       leg_packed_path_forward,
+                                       super::NeedsLoopForward(source_phantom, target_phantom),
+                                       DO_NOT_FORCE_LOOP,
+                                       PhantomNodes{source_phantom, target_phantom});
+            }
+            else if (facade.GetCoreSize() > 0)
             {
                 forward_core_heap.Clear();
                 reverse_core_heap.Clear();
@@ -221,7 +245,19 @@ class ShortestPathRouting final
             }
             BOOST_ASSERT(forward_heap.Size() > 0);
             BOOST_ASSERT(reverse_heap.Size() > 0);
-            if (facade.GetCoreSize() > 0)
+            if (facade.GetMultiLevelPartition().GetNumberOfLevels() > 0)
+            {
+                super::SearchOnOverlay(facade,
+                                       forward_heap,
+                                       reverse_heap,
+                                       forward_core_heap,
+                                       new_total_weight_to_reverse,
+                                       leg_packed_path_reverse,
+                                       DO_NOT_FORCE_LOOP,
+                                       super::NeedsLoopBackwards(source_phantom, target_phantom),
+                                       PhantomNodes{source_phantom, target_phantom});
+            }
+            else if (facade.GetCoreSize() > 0)
             {
                 forward_core_heap.Clear();
                 reverse_core_heap.Clear();
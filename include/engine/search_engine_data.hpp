@@ -4,6 +4,7 @@
 #include <boost/thread/tss.hpp>
 
 #include "util/binary_heap.hpp"
+#include "util/radix_heap.hpp"
 #include "util/typedefs.hpp"
 
 namespace osrm
@@ -20,21 +21,29 @@ struct HeapData
 struct SearchEngineData
 {
     using QueryHeap =
-        util::BinaryHeap<NodeID, NodeID, int, HeapData, util::UnorderedMapStorage<NodeID, int>>;
+        util::BinaryHeap<NodeID, NodeID, int, HeapData, util::AdaptiveArrayStorage<NodeID, int>>;
     using SearchEngineHeapPtr = boost::thread_specific_ptr<QueryHeap>;
 
+    // The many-to-many searches are plain monotone Dijkstra searches, see heap-bench
+    using ManyToManyQueryHeap =
+        util::RadixHeap<NodeID, NodeID, int, HeapData, util::AdaptiveArrayStorage<NodeID, int>>;
+    using ManyToManyHeapPtr = boost::thread_specific_ptr<ManyToManyQueryHeap>;
+
     static SearchEngineHeapPtr forward_heap_1;
     static SearchEngineHeapPtr reverse_heap_1;
     static SearchEngineHeapPtr forward_heap_2;
     static SearchEngineHeapPtr reverse_heap_2;
     static SearchEngineHeapPtr forward_heap_3;
     static SearchEngineHeapPtr reverse_heap_3;
+    static ManyToManyHeapPtr many_to_many_heap;
 
     void InitializeOrClearFirstThreadLocalStorage(const unsigned number_of_nodes);
 
     void InitializeOrClearSecondThreadLocalStorage(const unsigned number_of_nodes);
 
     void InitializeOrClearThirdThreadLocalStorage(const unsigned number_of_nodes);
+
+    void InitializeOrClearManyToManyThreadLocalStorage(const unsigned number_of_nodes);
 };
 }
 }
@@ -0,0 +1,96 @@
+#ifndef EXTRACTION_BLOCK_HPP
+#define EXTRACTION_BLOCK_HPP
+
+#include "extractor/extraction_node.hpp"
+#include "extractor/extraction_way.hpp"
+#include "extractor/restriction.hpp"
+
+#include <boost/optional/optional.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * Results of the profile for a block of consecutive OSM elements of a buffer, in the order of
+ * the elements and each with the index of its element.
+ *
+ * Clearing a block keeps its ExtractionWay objects, so the strings set by the profile reuse
+ * their capacity for the ways of the next buffer.
+ */
+class ExtractionBlock
+{
+    using Clock = std::chrono::steady_clock;
+
+  public:
+    using NodeResult = std::pair<std::size_t, ExtractionNode>;
+    using WayResult = std::pair<std::size_t, ExtractionWay>;
+    using RestrictionResult = boost::optional<InputRestrictionContainer>;
+
+    void clear()
+    {
+        nodes.clear();
+        number_of_ways = 0;
+        restrictions.clear();
+        lua_time = Clock::duration::zero();
+        total_time = Clock::duration::zero();
+    }
+
+    ExtractionNode &AddNode(const std::size_t index)
+    {
+        nodes.emplace_back(index, ExtractionNode{});
+        return nodes.back().second;
+    }
+
+    ExtractionWay &AddWay(const std::size_t index)
+    {
+        if (number_of_ways == ways.size())
+        {
+            ways.emplace_back();
+        }
+        auto &result = ways[number_of_ways++];
+        result.first = index;
+        result.second.clear();
+        return result.second;
+    }
+
+    void AddRestriction(RestrictionResult restriction)
+    {
+        restrictions.push_back(std::move(restriction));
+    }
+
+    const std::vector<NodeResult> &GetNodes() const { return nodes; }
+
+    boost::iterator_range<std::vector<WayResult>::const_iterator> GetWays() const
+    {
+        return boost::make_iterator_range(ways.cbegin(), ways.cbegin() + number_of_ways);
+    }
+
+    const std::vector<RestrictionResult> &GetRestrictions() const { return restrictions; }
+
+    // Time spent in the lua profile and in total while processing the block
+    Clock::duration GetLuaTime() const { return lua_time; }
+    Clock::duration GetTotalTime() const { return total_time; }
+    void AddLuaTime(const Clock::duration time) { lua_time += time; }
+    void AddTotalTime(const Clock::duration time) { total_time += time; }
+
+  private:
+    std::vector<NodeResult> nodes;
+    // only the first number_of_ways entries belong to the block, the rest are kept for reuse
+    std::vector<WayResult> ways;
+    std::size_t number_of_ways = 0;
+    std::vector<RestrictionResult> restrictions;
+    Clock::duration lua_time = Clock::duration::zero();
+    Clock::duration total_time = Clock::duration::zero();
+};
+}
+}
+
+#endif // EXTRACTION_BLOCK_HPP
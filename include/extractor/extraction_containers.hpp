@@ -2,6 +2,7 @@
 #define EXTRACTION_CONTAINERS_HPP
 
 #include "extractor/external_memory_node.hpp"
+#include "extractor/extractor_config.hpp"
 #include "extractor/first_and_last_segment_of_way.hpp"
 #include "extractor/guidance/turn_lane_types.hpp"
 #include "extractor/internal_extractor_edge.hpp"
@@ -21,7 +22,8 @@ namespace extractor
  * Uses external memory containers from stxxl to store all the data that
  * is collected by the extractor callbacks.
  *
- * The data is the filtered, aggregated and finally written to disk.
+ * The data is the filtered, aggregated and finally written to disk. If the data fits into memory,
+ * it is sorted there on all threads instead of with stxxl.
  */
 class ExtractionContainers
 {
@@ -42,6 +44,12 @@ class ExtractionContainers
     void WriteEdges(std::ofstream &file_out_stream) const;
     void WriteCharData(const std::string &file_name);
 
+    // Sorts with stxxl or in memory on all threads, depending on sort_in_memory
+    template <typename VectorT, typename CompareT> void Sort(VectorT &vector, CompareT compare);
+
+    ExtractorConfig::SortMode sort_mode;
+    bool sort_in_memory;
+
   public:
     using STXXLNodeIDVector = stxxl::vector<OSMNodeID>;
     using STXXLNodeVector = stxxl::vector<ExternalMemoryNode>;
@@ -62,7 +70,7 @@ class ExtractionContainers
     std::unordered_map<OSMNodeID, NodeID> external_to_internal_node_id_map;
     unsigned max_internal_node_id;
 
-    ExtractionContainers();
+    explicit ExtractionContainers(ExtractorConfig::SortMode sort_mode);
 
     void PrepareData(ScriptingEnvironment &scripting_environment,
                      const std::string &output_file_name,
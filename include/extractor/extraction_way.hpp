@@ -23,7 +23,8 @@ inline void maybeSetString(std::string &str, const char *value)
     }
     else
     {
-        str = std::string(value);
+        // assign in place, so reused ways keep the capacity of their strings
+        str.assign(value);
     }
 }
 }
@@ -40,7 +40,15 @@ namespace extractor
 
 struct ExtractorConfig
 {
-    ExtractorConfig() noexcept : requested_num_threads(0) {}
+    // How the containers of the parsed data are sorted
+    enum class SortMode
+    {
+        Auto,     // in memory if the largest container fits into the available memory
+        InMemory, // in memory on all threads
+        External  // with stxxl
+    };
+
+    ExtractorConfig() noexcept : requested_num_threads(0), sort_mode(SortMode::Auto) {}
     void UseDefaultOutputNames()
     {
         std::string basepath = input_path.string();
@@ -98,6 +106,7 @@ struct ExtractorConfig
 
     unsigned requested_num_threads;
     unsigned small_component_size;
+    SortMode sort_mode;
 
     bool generate_edge_lookup;
     std::string edge_penalty_path;
@@ -1,6 +1,7 @@
 #ifndef SCRIPTING_ENVIRONMENT_HPP
 #define SCRIPTING_ENVIRONMENT_HPP
 
+#include "extractor/extraction_block.hpp"
 #include "extractor/guidance/turn_lane_types.hpp"
 #include "extractor/internal_extractor_edge.hpp"
 #include "extractor/profile_properties.hpp"
@@ -8,10 +9,6 @@
 
 #include <osmium/memory/buffer.hpp>
 
-#include <boost/optional/optional.hpp>
-
-#include <tbb/concurrent_vector.h>
-
 #include <string>
 #include <vector>
 
@@ -33,8 +30,6 @@ namespace extractor
 {
 
 class RestrictionParser;
-struct ExtractionNode;
-struct ExtractionWay;
 
 /**
  * Abstract class that handles processing osmium ways, nodes and relation objects by applying
@@ -54,17 +49,17 @@ class ScriptingEnvironment
     virtual std::vector<std::string> GetRestrictions() = 0;
     virtual void SetupSources() = 0;
     virtual int32_t GetTurnPenalty(double angle) = 0;
+    // Penalties of a batch of turns, e.g. all turns of an intersection, in the order of angles
+    virtual std::vector<int32_t> GetTurnPenalties(const std::vector<double> &angles) = 0;
     virtual void ProcessSegment(const osrm::util::Coordinate &source,
                                 const osrm::util::Coordinate &target,
                                 double distance,
                                 InternalExtractorEdge::WeightData &weight) = 0;
+    // Runs the profile on all elements, the results are stored in blocks of consecutive elements
     virtual void
     ProcessElements(const std::vector<osmium::memory::Buffer::const_iterator> &osm_elements,
                     const RestrictionParser &restriction_parser,
-                    tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> &resulting_nodes,
-                    tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> &resulting_ways,
-                    tbb::concurrent_vector<boost::optional<InputRestrictionContainer>>
-                        &resulting_restrictions) = 0;
+                    std::vector<ExtractionBlock> &resulting_blocks) = 0;
 };
 }
 }
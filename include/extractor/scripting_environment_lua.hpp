@@ -12,6 +12,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 struct lua_State;
 
@@ -56,6 +57,7 @@ class LuaScriptingEnvironment final : public ScriptingEnvironment
     std::vector<std::string> GetRestrictions() override;
     void SetupSources() override;
     int32_t GetTurnPenalty(double angle) override;
+    std::vector<int32_t> GetTurnPenalties(const std::vector<double> &angles) override;
     void ProcessSegment(const osrm::util::Coordinate &source,
                         const osrm::util::Coordinate &target,
                         double distance,
@@ -63,16 +65,20 @@ class LuaScriptingEnvironment final : public ScriptingEnvironment
     void
     ProcessElements(const std::vector<osmium::memory::Buffer::const_iterator> &osm_elements,
                     const RestrictionParser &restriction_parser,
-                    tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> &resulting_nodes,
-                    tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> &resulting_ways,
-                    tbb::concurrent_vector<boost::optional<InputRestrictionContainer>>
-                        &resulting_restrictions) override;
+                    std::vector<ExtractionBlock> &resulting_blocks) override;
 
   private:
     void InitContext(LuaScriptingContext &context);
+    void InitTurnPenaltyTable(LuaScriptingContext &context);
+    int32_t ComputeTurnPenalty(LuaScriptingContext &context, double angle) const;
+
     std::mutex init_mutex;
     std::string file_name;
     tbb::enumerable_thread_specific<std::unique_ptr<LuaScriptingContext>> script_contexts;
+
+    // turn_function sampled over all angles if it only depends on the angle, empty otherwise
+    std::vector<double> turn_penalty_table;
+    std::once_flag turn_penalty_table_flag;
 };
 }
 }
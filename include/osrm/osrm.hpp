@@ -33,6 +33,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -85,6 +86,16 @@ class OSRM final
      */
     Status Route(const RouteParameters &parameters, json::Object &result) const;
 
+    /**
+     * Shortest path queries for coordinates, rendered in the format requested by the
+     * parameters: JSON text or the compact binary format.
+     *
+     * \param parameters route query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, RouteParameters and BaseParameters::OutputFormatType
+     */
+    Status Route(const RouteParameters &parameters, std::vector<char> &result) const;
+
     /**
      * Distance tables for coordinates.
      *
@@ -94,6 +105,20 @@ class OSRM final
      */
     Status Table(const TableParameters &parameters, json::Object &result) const;
 
+    /**
+     * Distance tables for coordinates, rendered in the format requested by the parameters:
+     * JSON text or the compact binary format.
+     *
+     * The table is computed and rendered in tiles of rows (see EngineConfig). The whole response
+     * still ends up in result, but besides it only one tile of durations is kept instead of the
+     * full table and its json::Object tree.
+     *
+     * \param parameters table query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, TableParameters and EngineConfig
+     */
+    Status Table(const TableParameters &parameters, std::vector<char> &result) const;
+
     /**
      * Nearest street segment for coordinate.
      *
@@ -0,0 +1,46 @@
+#ifndef OSRM_PARTITION_IO_HPP
+#define OSRM_PARTITION_IO_HPP
+
+#include "partition/multi_level_partition.hpp"
+
+#include "storage/io.hpp"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace partition
+{
+namespace io
+{
+
+// The .partition file holds the number of cells per level and the cell ids of all nodes, level
+// after level
+
+inline void write(const std::string &path, const MultiLevelPartition &partition)
+{
+    storage::io::FileWriter writer(path, storage::io::FileWriter::GenerateFingerprint);
+
+    writer.SerializeVector(partition.cells_per_level);
+    writer.SerializeVector(partition.cell_ids);
+}
+
+inline MultiLevelPartition read(const std::string &path)
+{
+    storage::io::FileReader reader(path, storage::io::FileReader::VerifyFingerprint);
+
+    std::vector<std::uint32_t> cells_per_level;
+    std::vector<CellID> cell_ids;
+    reader.DeserializeVector(cells_per_level);
+    reader.DeserializeVector(cell_ids);
+
+    return MultiLevelPartition(std::move(cells_per_level), std::move(cell_ids));
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef OSRM_PARTITION_MULTI_LEVEL_PARTITION_HPP
+#define OSRM_PARTITION_MULTI_LEVEL_PARTITION_HPP
+
+#include "util/shared_memory_vector_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace partition
+{
+template <bool UseSharedMemory> class MultiLevelPartitionImpl;
+namespace io
+{
+inline void write(const std::string &path, const MultiLevelPartitionImpl<false> &partition);
+}
+
+/**
+ * Nested partition of the edge-based graph into cells on multiple levels.
+ *
+ * Level 0 is the graph itself, every cell of level l + 1 is the union of cells of level l.
+ * The cell ids of all nodes are stored level after level, so a lookup is one array access.
+ *
+ * The shared memory version is a view on the data loaded by osrm-datastore.
+ */
+template <bool UseSharedMemory> class MultiLevelPartitionImpl
+{
+    template <typename T> using Vector = typename util::ShM<T, UseSharedMemory>::vector;
+
+  public:
+    MultiLevelPartitionImpl() : number_of_nodes(0) {}
+
+    // Takes the cell ids of all nodes per level, starting with level 1
+    template <bool Q = UseSharedMemory, typename = typename std::enable_if<!Q>::type>
+    explicit MultiLevelPartitionImpl(const std::vector<std::vector<CellID>> &level_cell_ids)
+        : number_of_nodes(level_cell_ids.empty() ? 0 : level_cell_ids.front().size())
+    {
+        for (const auto &cell_ids_on_level : level_cell_ids)
+        {
+            BOOST_ASSERT(cell_ids_on_level.size() == number_of_nodes);
+            CellID number_of_cells = 0;
+            for (const auto cell : cell_ids_on_level)
+            {
+                number_of_cells = std::max<CellID>(number_of_cells, cell + 1);
+            }
+            cells_per_level.push_back(number_of_cells);
+            cell_ids.insert(cell_ids.end(), cell_ids_on_level.begin(), cell_ids_on_level.end());
+        }
+    }
+
+    MultiLevelPartitionImpl(Vector<std::uint32_t> cells_per_level_, Vector<CellID> cell_ids_)
+        : cells_per_level(std::move(cells_per_level_)), cell_ids(std::move(cell_ids_)),
+          number_of_nodes(cells_per_level.empty() ? 0 : cell_ids.size() / cells_per_level.size())
+    {
+        BOOST_ASSERT(number_of_nodes * cells_per_level.size() == cell_ids.size());
+    }
+
+    // Number of levels above the base graph
+    LevelID GetNumberOfLevels() const { return static_cast<LevelID>(cells_per_level.size()); }
+
+    std::uint32_t GetNumberOfCells(const LevelID level) const
+    {
+        BOOST_ASSERT(level > 0 && level <= GetNumberOfLevels());
+        return cells_per_level[level - 1];
+    }
+
+    std::size_t GetNumberOfNodes() const { return number_of_nodes; }
+
+    CellID GetCell(const LevelID level, const NodeID node) const
+    {
+        BOOST_ASSERT(level > 0 && level <= GetNumberOfLevels());
+        BOOST_ASSERT(node < number_of_nodes);
+        return cell_ids[(level - 1) * number_of_nodes + node];
+    }
+
+    // Returns the highest level on which both nodes are in different cells, 0 if they share a cell
+    // on all levels
+    LevelID GetHighestDifferentLevel(const NodeID first, const NodeID second) const
+    {
+        for (auto level = GetNumberOfLevels(); level > 0; --level)
+        {
+            if (GetCell(level, first) != GetCell(level, second))
+            {
+                return level;
+            }
+        }
+        return 0;
+    }
+
+  private:
+    friend void io::write(const std::string &path, const MultiLevelPartitionImpl<false> &partition);
+
+    Vector<std::uint32_t> cells_per_level;
+    Vector<CellID> cell_ids;
+    std::size_t number_of_nodes;
+};
+
+using MultiLevelPartition = MultiLevelPartitionImpl<false>;
+using MultiLevelPartitionView = MultiLevelPartitionImpl<true>;
+}
+}
+
+#endif
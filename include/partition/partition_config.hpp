@@ -0,0 +1,39 @@
+#ifndef OSRM_PARTITION_PARTITION_CONFIG_HPP
+#define OSRM_PARTITION_PARTITION_CONFIG_HPP
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace partition
+{
+
+struct PartitionConfig
+{
+    PartitionConfig() : requested_num_threads(0), max_cell_sizes{128, 4096, 65536, 2097152} {}
+
+    // Infer the input and output names from the path of the .osrm file
+    void UseDefaultOutputNames()
+    {
+        edge_based_graph_path = osrm_input_path.string() + ".ebg";
+        partition_path = osrm_input_path.string() + ".partition";
+    }
+
+    boost::filesystem::path osrm_input_path;
+
+    std::string edge_based_graph_path;
+    std::string partition_path;
+
+    unsigned requested_num_threads;
+
+    // The maximal number of nodes in a cell, per level starting with the smallest cells
+    std::vector<std::size_t> max_cell_sizes;
+};
+}
+}
+
+#endif
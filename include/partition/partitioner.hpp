@@ -0,0 +1,28 @@
+#ifndef OSRM_PARTITION_PARTITIONER_HPP
+#define OSRM_PARTITION_PARTITIONER_HPP
+
+#include "partition/partition_config.hpp"
+
+namespace osrm
+{
+namespace partition
+{
+
+// Computes the multi-level partition of the edge-based graph for osrm-customize
+class Partitioner
+{
+  public:
+    explicit Partitioner(const PartitionConfig &config_) : config{config_} {}
+
+    Partitioner(const Partitioner &) = delete;
+    Partitioner &operator=(const Partitioner &) = delete;
+
+    int Run();
+
+  private:
+    PartitionConfig config;
+};
+}
+}
+
+#endif
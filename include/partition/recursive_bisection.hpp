@@ -0,0 +1,62 @@
+#ifndef OSRM_PARTITION_RECURSIVE_BISECTION_HPP
+#define OSRM_PARTITION_RECURSIVE_BISECTION_HPP
+
+#include "util/typedefs.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace partition
+{
+
+/**
+ * Computes a nested partition of a graph by recursive bisection.
+ *
+ * A set of nodes is split by growing a breadth-first search from a pseudo-peripheral node and
+ * putting the first half of the reached nodes into one part. This keeps the parts balanced and
+ * mostly connected, which is all the overlay needs to be correct; better cuts only make the
+ * cells' boundaries and thus the customization and queries cheaper.
+ */
+class RecursiveBisection
+{
+  public:
+    // The edges are treated as undirected, duplicates and self loops are ignored
+    RecursiveBisection(const NodeID number_of_nodes,
+                       const std::vector<std::pair<NodeID, NodeID>> &edges);
+
+    // Returns the cell ids of all nodes per level, starting with the smallest cells. Cells on
+    // level l are split until they have at most max_cell_sizes[l] nodes, so the sizes need to be
+    // increasing. Levels that would only have a single cell are left out, except for the first.
+    std::vector<std::vector<CellID>>
+    ComputeCells(const std::vector<std::size_t> &max_cell_sizes) const;
+
+  private:
+    struct CellRange
+    {
+        std::size_t level;
+        NodeID begin;
+        NodeID end;
+    };
+
+    struct BisectionState;
+
+    void Bisect(BisectionState &state,
+                const NodeID begin,
+                const NodeID end,
+                std::size_t unassigned_levels,
+                std::vector<CellRange> &cells) const;
+
+    // Fills order[begin, end) with the nodes of the range in breadth first order
+    void OrderBreadthFirst(BisectionState &state, const NodeID begin, const NodeID end) const;
+
+    NodeID number_of_nodes;
+    std::vector<EdgeID> first_edge;
+    std::vector<NodeID> targets;
+};
+}
+}
+
+#endif
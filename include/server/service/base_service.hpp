@@ -17,10 +17,19 @@ namespace server
 namespace service
 {
 
+// Response the engine already rendered, either as JSON text or in the binary format
+struct RenderedResult
+{
+    std::vector<char> content;
+    bool binary = false;
+};
+
 class BaseService
 {
   public:
-    using ResultT = mapbox::util::variant<util::json::Object, std::string>;
+    // json::Object results are rendered by the request handler, std::string holds vector
+    // tiles (protobuf)
+    using ResultT = mapbox::util::variant<util::json::Object, std::string, RenderedResult>;
 
     BaseService(OSRM &routing_machine) : routing_machine(routing_machine) {}
     virtual ~BaseService() = default;
@@ -213,7 +213,8 @@ class FileWriter
         if (count == 0)
             return true;
 
-        const auto &result = output_stream.write(reinterpret_cast<char *>(src), count * sizeof(T));
+        const auto &result =
+            output_stream.write(reinterpret_cast<const char *>(src), count * sizeof(T));
         if (!result)
         {
             throw util::exception("Error writing to " + filepath.string());
@@ -229,7 +230,7 @@ class FileWriter
     bool WriteElementCount32(const std::uint32_t count) { return WriteOne<std::uint32_t>(count); }
     bool WriteElementCount64(const std::uint64_t count) { return WriteOne<std::uint64_t>(count); }
 
-    template <typename T> bool SerializeVector(std::vector<T> &data)
+    template <typename T> bool SerializeVector(const std::vector<T> &data)
     {
         const auto count = data.size();
         WriteElementCount64(count);
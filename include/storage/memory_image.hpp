@@ -0,0 +1,72 @@
+#ifndef OSRM_STORAGE_MEMORY_IMAGE_HPP
+#define OSRM_STORAGE_MEMORY_IMAGE_HPP
+
+#include "storage/shared_datatype.hpp"
+#include "util/fingerprint.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace osrm
+{
+namespace storage
+{
+
+/**
+ * The memory image is a single file that contains all data of a dataset.
+ *
+ * It starts with a MemoryImageHeader: the fingerprint, the DataLayout, a table of contents with
+ * the name, position, size and checksum of every block of the layout and the size and
+ * modification time of every data file it was written from. The data follows at
+ * MEMORY_IMAGE_DATA_OFFSET, in the layout of the shared memory block. The file can therefore
+ * either be mapped as a whole, or every block can be read with a single large read.
+ */
+// two pages, the data of a mapped image starts page aligned
+const constexpr std::size_t MEMORY_IMAGE_DATA_OFFSET = 8192;
+// number of data files the memory image is written from, see StorageConfig
+const constexpr std::size_t MEMORY_IMAGE_NUM_SOURCES = 18;
+
+struct MemoryImageBlock
+{
+    char name[32];
+    // position of the block in the file, aligned like the block in memory
+    std::uint64_t offset;
+    std::uint64_t size;
+    // CRC-32 of the data of the block
+    std::uint32_t checksum;
+};
+
+// The image is current as long as all data files have the size and time they had when it was
+// written. Files that don't exist have the size INVALID_SIZE.
+struct MemoryImageSource
+{
+    static const constexpr std::uint64_t INVALID_SIZE = std::numeric_limits<std::uint64_t>::max();
+
+    std::uint64_t size;
+    std::int64_t modification_time;
+
+    bool operator==(const MemoryImageSource &other) const
+    {
+        return size == other.size && modification_time == other.modification_time;
+    }
+};
+
+struct MemoryImageHeader
+{
+    util::FingerPrint fingerprint;
+    DataLayout layout;
+    std::array<MemoryImageBlock, DataLayout::NUM_BLOCKS> blocks;
+    std::array<MemoryImageSource, MEMORY_IMAGE_NUM_SOURCES> sources;
+};
+
+static_assert(sizeof(MemoryImageHeader) <= MEMORY_IMAGE_DATA_OFFSET,
+              "The header of the memory image is too large");
+static_assert(std::is_trivially_copyable<MemoryImageHeader>::value,
+              "The header of the memory image is written as is");
+}
+}
+
+#endif
@@ -52,7 +52,16 @@ const constexpr char *block_id_to_name[] = {"NAME_OFFSETS",
                                             "POST_TURN_BEARING",
                                             "TURN_LANE_DATA",
                                             "LANE_DESCRIPTION_OFFSETS",
-                                            "LANE_DESCRIPTION_MASKS"};
+                                            "LANE_DESCRIPTION_MASKS",
+                                            "MLD_GRAPH_NODE_LIST",
+                                            "MLD_GRAPH_EDGE_LIST",
+                                            "MLD_CELLS_PER_LEVEL",
+                                            "MLD_CELL_IDS",
+                                            "MLD_CELL_LEVEL_OFFSETS",
+                                            "MLD_CELLS",
+                                            "MLD_CELL_SOURCE_BOUNDARY",
+                                            "MLD_CELL_DESTINATION_BOUNDARY",
+                                            "MLD_CELL_WEIGHTS"};
 
 struct DataLayout
 {
@@ -95,6 +104,15 @@ struct DataLayout
         TURN_LANE_DATA,
         LANE_DESCRIPTION_OFFSETS,
         LANE_DESCRIPTION_MASKS,
+        MLD_GRAPH_NODE_LIST,
+        MLD_GRAPH_EDGE_LIST,
+        MLD_CELLS_PER_LEVEL,
+        MLD_CELL_IDS,
+        MLD_CELL_LEVEL_OFFSETS,
+        MLD_CELLS,
+        MLD_CELL_SOURCE_BOUNDARY,
+        MLD_CELL_DESTINATION_BOUNDARY,
+        MLD_CELL_WEIGHTS,
         NUM_BLOCKS
     };
 
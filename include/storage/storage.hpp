@@ -28,11 +28,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef STORAGE_HPP
 #define STORAGE_HPP
 
+#include "storage/memory_image.hpp"
 #include "storage/shared_datatype.hpp"
 #include "storage/storage_config.hpp"
 
 #include <boost/filesystem/path.hpp>
 
+#include <array>
+#include <cstdint>
 #include <string>
 
 namespace osrm
@@ -53,11 +56,33 @@ class Storage
 
     ReturnCode Run(int max_wait);
 
+    // Both read the memory image if it is current and the data files otherwise
     void PopulateLayout(DataLayout &layout);
     void PopulateData(const DataLayout &layout, char *memory_ptr);
 
+    // True if the memory image is valid and was written from the data files as they are now
+    bool IsMemoryImageCurrent() const;
+    // Writes the memory image from the data files, it is replaced atomically if it exists
+    void WriteMemoryImage();
+    // Writes the memory image unless it is current, false if it can't be written, for example
+    // because its directory is read-only. Writing it loads all data files like PopulateData.
+    bool UpdateMemoryImage();
+
+    // Throws if the table of contents of a memory image of file_size bytes doesn't match its
+    // layout or points outside of the file
+    static void CheckMemoryImageHeader(const MemoryImageHeader &header,
+                                       const std::uint64_t file_size,
+                                       const boost::filesystem::path &path);
+
   private:
+    void PopulateLayoutFromFiles(DataLayout &layout);
+    void PopulateDataFromFiles(const DataLayout &layout, char *memory_ptr);
+    std::array<MemoryImageSource, MEMORY_IMAGE_NUM_SOURCES> GetMemoryImageSources() const;
+    MemoryImageHeader ReadMemoryImageHeader() const;
+    void ReadMemoryImage(const DataLayout &layout, char *memory_ptr) const;
+
     StorageConfig config;
+    bool layout_from_memory_image = false;
 };
 }
 }
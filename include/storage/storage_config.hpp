@@ -50,6 +50,9 @@ struct StorageConfig final
      * \param base The base path (e.g. france.pbf.osrm) to derive auxiliary file suffixes from.
      */
     StorageConfig(const boost::filesystem::path &base);
+
+    // Checks that all files are there, either with the files of osrm-contract or of
+    // osrm-partition and osrm-customize
     bool IsValid() const;
 
     boost::filesystem::path ram_index_path;
@@ -67,6 +70,11 @@ struct StorageConfig final
     boost::filesystem::path intersection_class_path;
     boost::filesystem::path turn_lane_data_path;
     boost::filesystem::path turn_lane_description_path;
+    boost::filesystem::path mld_graph_path;
+    boost::filesystem::path partition_path;
+    boost::filesystem::path cells_path;
+    // image of the data in the layout of shared memory, written on first use
+    boost::filesystem::path memory_image_path;
 };
 }
 }
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <limits>
 #include <map>
+#include <memory>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -84,6 +85,114 @@ template <typename NodeID, typename Key> class UnorderedMapStorage
     std::unordered_map<NodeID, Key> nodes;
 };
 
+// Dense node -> key array like ArrayStorage, but every cell is stamped with the generation
+// it was written in. Clear() only bumps the generation, so resetting the heap between
+// queries is O(1) instead of touching (or rehashing) every node that was reached.
+template <typename NodeID, typename Key> class GenerationArrayStorage
+{
+  public:
+    explicit GenerationArrayStorage(size_t size) : positions(size), generation(1) {}
+
+    Key &operator[](const NodeID node)
+    {
+        BOOST_ASSERT(node < positions.size());
+        auto &cell = positions[node];
+        cell.generation = generation;
+        return cell.key;
+    }
+
+    Key peek_index(const NodeID node) const
+    {
+        BOOST_ASSERT(node < positions.size());
+        const auto &cell = positions[node];
+        if (cell.generation != generation)
+        {
+            return std::numeric_limits<Key>::max();
+        }
+        return cell.key;
+    }
+
+    void Clear()
+    {
+        ++generation;
+        // on wrap-around stale stamps could become valid again, so do the full reset once
+        if (std::numeric_limits<unsigned>::max() == generation)
+        {
+            std::fill(positions.begin(), positions.end(), Cell{});
+            generation = 1;
+        }
+    }
+
+  private:
+    struct Cell
+    {
+        unsigned generation = 0;
+        Key key = 0;
+    };
+
+    std::vector<Cell> positions;
+    unsigned generation;
+};
+
+// Starts out as a hash map and switches to a GenerationArrayStorage for the rest of its
+// lifetime once a single query reached more than PromotionThreshold nodes. Heaps that
+// only ever see short queries (e.g. map matching between close candidates) never pay
+// for the dense array of `size` entries, while long routes and table searches get
+// hash-free lookups after the first expensive query.
+template <typename NodeID, typename Key, std::size_t PromotionThreshold = (1u << 14u)>
+class AdaptiveArrayStorage
+{
+  public:
+    explicit AdaptiveArrayStorage(size_t size) : size(size) { sparse.rehash(1000); }
+
+    Key &operator[](const NodeID node)
+    {
+        if (dense)
+        {
+            return (*dense)[node];
+        }
+        return sparse[node];
+    }
+
+    Key peek_index(const NodeID node) const
+    {
+        if (dense)
+        {
+            return dense->peek_index(node);
+        }
+        const auto iter = sparse.find(node);
+        if (std::end(sparse) != iter)
+        {
+            return iter->second;
+        }
+        return std::numeric_limits<Key>::max();
+    }
+
+    void Clear()
+    {
+        if (dense)
+        {
+            dense->Clear();
+        }
+        else if (sparse.size() > PromotionThreshold)
+        {
+            dense = std::make_unique<GenerationArrayStorage<NodeID, Key>>(size);
+            std::unordered_map<NodeID, Key>().swap(sparse);
+        }
+        else
+        {
+            sparse.clear();
+        }
+    }
+
+    bool IsDense() const { return static_cast<bool>(dense); }
+
+  private:
+    std::size_t size;
+    std::unordered_map<NodeID, Key> sparse;
+    std::unique_ptr<GenerationArrayStorage<NodeID, Key>> dense;
+};
+
 template <typename NodeID,
           typename Key,
           typename Weight,
@@ -99,7 +208,10 @@ class BinaryHeap
     using WeightType = Weight;
     using DataType = Data;
 
-    explicit BinaryHeap(size_t maxID) : node_index(maxID) { Clear(); }
+    explicit BinaryHeap(size_t maxID) : capacity(maxID), node_index(maxID) { Clear(); }
+
+    // number of node ids the heap was created for, larger ids must not be inserted
+    std::size_t Capacity() const { return capacity; }
 
     void Clear()
     {
@@ -231,6 +343,7 @@ class BinaryHeap
         Weight weight;
     };
 
+    std::size_t capacity;
     std::vector<HeapNode> inserted_nodes;
     std::vector<HeapElement> heap;
     IndexStorage node_index;
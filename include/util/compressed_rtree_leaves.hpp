@@ -0,0 +1,257 @@
+#ifndef OSRM_UTIL_COMPRESSED_RTREE_LEAVES_HPP
+#define OSRM_UTIL_COMPRESSED_RTREE_LEAVES_HPP
+
+#include "util/integer_range.hpp"
+#include "util/rectangle.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace detail
+{
+inline std::uint64_t zigzagEncode(const std::int64_t value)
+{
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+inline std::int64_t zigzagDecode(const std::uint64_t value)
+{
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+inline void writeVarint(std::uint64_t value, std::vector<std::uint8_t> &buffer)
+{
+    while (value >= 0x80)
+    {
+        buffer.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<std::uint8_t>(value));
+}
+
+inline std::uint64_t readVarint(const std::uint8_t *&position)
+{
+    std::uint64_t value = 0;
+    unsigned shift = 0;
+    while (*position & 0x80)
+    {
+        value |= static_cast<std::uint64_t>(*position++ & 0x7f) << shift;
+        shift += 7;
+    }
+    value |= static_cast<std::uint64_t>(*position++) << shift;
+    return value;
+}
+}
+
+/**
+ * The leaves of a StaticRTree, with the objects of every leaf delta encoded into varints.
+ *
+ * The objects of a leaf are close to each other, so are their node, segment, name and geometry
+ * ids. Every id is stored as the zigzag encoded difference to the same id of the previous object
+ * of the leaf, v relative to u and the reverse segment id relative to the forward segment id. The
+ * flags and travel modes share a single varint. Depending on how well the node ids correlate
+ * with the location this takes half the size of the LeafNode pages of the .fileIndex file or
+ * less, which allows to keep all leaves in memory.
+ *
+ * A leaf is decoded as a whole when the search explores it, a single object is decoded by
+ * skipping the objects in front of it.
+ */
+template <typename EdgeDataT> class CompressedRTreeLeaves
+{
+    // number of leaves encoded into one buffer by a single task
+    static constexpr std::size_t LEAVES_PER_TASK = 1024;
+
+    struct LeafHeader
+    {
+        std::uint64_t offset;
+        std::uint32_t object_count;
+        RectangleInt2D minimum_bounding_rectangle;
+    };
+
+    // the ids an object is encoded relative to, all zero for the first object of a leaf
+    struct Reference
+    {
+        std::int64_t u = 0;
+        std::int64_t forward_segment_id = 0;
+        std::int64_t name_id = 0;
+        std::int64_t packed_geometry_id = 0;
+        std::int64_t component_id = 0;
+        std::int64_t fwd_segment_position = 0;
+    };
+
+  public:
+    CompressedRTreeLeaves() = default;
+
+    // Encodes leaves with an object_count, a minimum_bounding_rectangle and objects
+    template <typename LeafNodeT>
+    CompressedRTreeLeaves(const LeafNodeT *leaves, const std::size_t number_of_leaves)
+        : headers(number_of_leaves)
+    {
+        const auto number_of_tasks = (number_of_leaves + LEAVES_PER_TASK - 1) / LEAVES_PER_TASK;
+        std::vector<std::vector<std::uint8_t>> buffers(number_of_tasks);
+
+        // offsets are relative to the buffer of the task first
+        tbb::parallel_for(std::size_t{0}, number_of_tasks, [&](const std::size_t task) {
+            auto &buffer = buffers[task];
+            const auto end = std::min(number_of_leaves, (task + 1) * LEAVES_PER_TASK);
+            for (const auto leaf_index : irange(task * LEAVES_PER_TASK, end))
+            {
+                const auto &leaf = leaves[leaf_index];
+                headers[leaf_index] = {buffer.size(), leaf.object_count,
+                                       leaf.minimum_bounding_rectangle};
+
+                Reference reference;
+                for (const auto i : irange(0u, leaf.object_count))
+                {
+                    EncodeObject(leaf.objects[i], reference, buffer);
+                }
+            }
+        });
+
+        std::size_t size = 0;
+        for (const auto &buffer : buffers)
+        {
+            size += buffer.size();
+        }
+        data.reserve(size);
+
+        for (const auto task : irange<std::size_t>(0, number_of_tasks))
+        {
+            const auto end = std::min(number_of_leaves, (task + 1) * LEAVES_PER_TASK);
+            for (const auto leaf_index : irange(task * LEAVES_PER_TASK, end))
+            {
+                headers[leaf_index].offset += data.size();
+            }
+            data.insert(data.end(), buffers[task].begin(), buffers[task].end());
+            std::vector<std::uint8_t>().swap(buffers[task]);
+        }
+    }
+
+    std::size_t GetNumberOfLeaves() const { return headers.size(); }
+
+    std::uint32_t GetObjectCount(const std::size_t leaf_index) const
+    {
+        return headers[leaf_index].object_count;
+    }
+
+    const RectangleInt2D &GetRectangle(const std::size_t leaf_index) const
+    {
+        return headers[leaf_index].minimum_bounding_rectangle;
+    }
+
+    // Decodes all objects of a leaf into objects, which needs room for GetObjectCount objects
+    void Decode(const std::size_t leaf_index, EdgeDataT *objects) const
+    {
+        const auto &header = headers[leaf_index];
+        const std::uint8_t *position = data.data() + header.offset;
+        Reference reference;
+        for (const auto i : irange(0u, header.object_count))
+        {
+            position = DecodeObject(position, reference, objects[i]);
+        }
+    }
+
+    EdgeDataT GetObject(const std::size_t leaf_index, const std::uint32_t object_index) const
+    {
+        const auto &header = headers[leaf_index];
+        BOOST_ASSERT(object_index < header.object_count);
+        const std::uint8_t *position = data.data() + header.offset;
+        Reference reference;
+        EdgeDataT object;
+        for (std::uint32_t i = 0; i <= object_index; ++i)
+        {
+            position = DecodeObject(position, reference, object);
+        }
+        return object;
+    }
+
+    std::size_t GetSizeInBytes() const
+    {
+        return headers.size() * sizeof(LeafHeader) + data.size() * sizeof(std::uint8_t);
+    }
+
+  private:
+    static void EncodeObject(const EdgeDataT &object,
+                             Reference &reference,
+                             std::vector<std::uint8_t> &buffer)
+    {
+        const auto encode = [&buffer](const std::int64_t value, const std::int64_t base) {
+            detail::writeVarint(detail::zigzagEncode(value - base), buffer);
+        };
+
+        const std::int64_t u = object.u;
+        const std::int64_t forward_segment_id = object.forward_segment_id.id;
+        encode(u, reference.u);
+        encode(object.v, u);
+        encode(forward_segment_id, reference.forward_segment_id);
+        encode(object.reverse_segment_id.id, forward_segment_id);
+        encode(object.name_id, reference.name_id);
+        encode(object.packed_geometry_id, reference.packed_geometry_id);
+        encode(object.component.id, reference.component_id);
+        encode(object.fwd_segment_position, reference.fwd_segment_position);
+
+        std::uint64_t flags = object.forward_segment_id.enabled ? 1 : 0;
+        flags |= object.reverse_segment_id.enabled ? 2 : 0;
+        flags |= object.component.is_tiny ? 4 : 0;
+        flags |= static_cast<std::uint64_t>(object.forward_travel_mode) << 3;
+        flags |= static_cast<std::uint64_t>(object.backward_travel_mode) << 7;
+        detail::writeVarint(flags, buffer);
+
+        reference.u = u;
+        reference.forward_segment_id = forward_segment_id;
+        reference.name_id = object.name_id;
+        reference.packed_geometry_id = object.packed_geometry_id;
+        reference.component_id = object.component.id;
+        reference.fwd_segment_position = object.fwd_segment_position;
+    }
+
+    static const std::uint8_t *
+    DecodeObject(const std::uint8_t *position, Reference &reference, EdgeDataT &object)
+    {
+        const auto decode = [&position](const std::int64_t base) {
+            return base + detail::zigzagDecode(detail::readVarint(position));
+        };
+
+        reference.u = decode(reference.u);
+        object.u = static_cast<decltype(object.u)>(reference.u);
+        object.v = static_cast<decltype(object.v)>(decode(reference.u));
+        reference.forward_segment_id = decode(reference.forward_segment_id);
+        object.forward_segment_id.id = reference.forward_segment_id;
+        object.reverse_segment_id.id = decode(reference.forward_segment_id);
+        reference.name_id = decode(reference.name_id);
+        object.name_id = reference.name_id;
+        reference.packed_geometry_id = decode(reference.packed_geometry_id);
+        object.packed_geometry_id = reference.packed_geometry_id;
+        reference.component_id = decode(reference.component_id);
+        object.component.id = reference.component_id;
+        reference.fwd_segment_position = decode(reference.fwd_segment_position);
+        object.fwd_segment_position = reference.fwd_segment_position;
+
+        const auto flags = detail::readVarint(position);
+        object.forward_segment_id.enabled = flags & 1;
+        object.reverse_segment_id.enabled = (flags >> 1) & 1;
+        object.component.is_tiny = (flags >> 2) & 1;
+        object.forward_travel_mode = (flags >> 3) & 0xf;
+        object.backward_travel_mode = (flags >> 7) & 0xf;
+
+        return position;
+    }
+
+    std::vector<LeafHeader> headers;
+    std::vector<std::uint8_t> data;
+};
+}
+}
+
+#endif
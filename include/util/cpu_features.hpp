@@ -0,0 +1,45 @@
+#ifndef OSRM_UTIL_CPU_FEATURES_HPP
+#define OSRM_UTIL_CPU_FEATURES_HPP
+
+// Runtime detection of the x86 vector extensions used by the hand-vectorized kernels.
+// Kernels are compiled for their instruction set with function level target attributes,
+// so the binary itself does not require any extension and falls back to scalar code.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define OSRM_X86_SIMD 1
+#define OSRM_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define OSRM_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define OSRM_X86_SIMD 0
+#endif
+
+namespace osrm
+{
+namespace util
+{
+namespace cpu
+{
+
+inline bool HasSSE41()
+{
+#if OSRM_X86_SIMD
+    static const bool supported = __builtin_cpu_supports("sse4.1");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+inline bool HasAVX2()
+{
+#if OSRM_X86_SIMD
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+}
+}
+}
+
+#endif // OSRM_UTIL_CPU_FEATURES_HPP
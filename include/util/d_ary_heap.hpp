@@ -0,0 +1,247 @@
+#ifndef D_ARY_HEAP_HPP
+#define D_ARY_HEAP_HPP
+
+#include "util/binary_heap.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Drop-in replacement for BinaryHeap (same interface and IndexStorage policies) that uses
+// a d-ary tree. The children of an element are adjacent in memory, so a Downheap step
+// compares Arity weights from one or two cache lines and the tree is log2(Arity) times
+// shallower. This pays off for Dijkstra-like searches, which insert and decrease far more
+// often than they delete.
+template <typename NodeID,
+          typename Key,
+          typename Weight,
+          typename Data,
+          typename IndexStorage = ArrayStorage<NodeID, NodeID>,
+          std::size_t Arity = 4>
+class DAryHeap
+{
+    static_assert(Arity >= 2, "a heap needs at least two children per node");
+
+  private:
+    DAryHeap(const DAryHeap &right);
+    void operator=(const DAryHeap &right);
+
+  public:
+    using WeightType = Weight;
+    using DataType = Data;
+
+    explicit DAryHeap(size_t maxID) : capacity(maxID), node_index(maxID) { Clear(); }
+
+    // number of node ids the heap was created for, larger ids must not be inserted
+    std::size_t Capacity() const { return capacity; }
+
+    void Clear()
+    {
+        // slot 0 is never used so that key 0 can mark removed nodes
+        heap.resize(1);
+        inserted_nodes.clear();
+        node_index.Clear();
+    }
+
+    std::size_t Size() const { return (heap.size() - 1); }
+
+    bool Empty() const { return 0 == Size(); }
+
+    void Insert(NodeID node, Weight weight, const Data &data)
+    {
+        HeapElement element;
+        element.index = static_cast<NodeID>(inserted_nodes.size());
+        element.weight = weight;
+        const Key key = static_cast<Key>(heap.size());
+        heap.emplace_back(element);
+        inserted_nodes.emplace_back(node, key, weight, data);
+        node_index[node] = element.index;
+        Upheap(key);
+        CheckHeap();
+    }
+
+    Data &GetData(NodeID node)
+    {
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].data;
+    }
+
+    Data const &GetData(NodeID node) const
+    {
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].data;
+    }
+
+    Weight &GetKey(NodeID node)
+    {
+        const Key index = node_index[node];
+        return inserted_nodes[index].weight;
+    }
+
+    bool WasRemoved(const NodeID node) const
+    {
+        BOOST_ASSERT(WasInserted(node));
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].key == 0;
+    }
+
+    bool WasInserted(const NodeID node) const
+    {
+        const auto index = node_index.peek_index(node);
+        if (index >= static_cast<decltype(index)>(inserted_nodes.size()))
+        {
+            return false;
+        }
+        return inserted_nodes[index].node == node;
+    }
+
+    NodeID Min() const
+    {
+        BOOST_ASSERT(heap.size() > 1);
+        return inserted_nodes[heap[1].index].node;
+    }
+
+    Weight MinKey() const
+    {
+        BOOST_ASSERT(heap.size() > 1);
+        return heap[1].weight;
+    }
+
+    NodeID DeleteMin()
+    {
+        BOOST_ASSERT(heap.size() > 1);
+        const Key removedIndex = heap[1].index;
+        heap[1] = heap[heap.size() - 1];
+        heap.pop_back();
+        if (heap.size() > 1)
+        {
+            Downheap(1);
+        }
+        inserted_nodes[removedIndex].key = 0;
+        CheckHeap();
+        return inserted_nodes[removedIndex].node;
+    }
+
+    void DeleteAll()
+    {
+        auto iend = heap.end();
+        for (auto i = heap.begin() + 1; i != iend; ++i)
+        {
+            inserted_nodes[i->index].key = 0;
+        }
+        heap.resize(1);
+    }
+
+    void DecreaseKey(NodeID node, Weight weight)
+    {
+        BOOST_ASSERT(std::numeric_limits<NodeID>::max() != node);
+        const Key index = node_index.peek_index(node);
+        const Key key = inserted_nodes[index].key;
+        BOOST_ASSERT(key > 0);
+
+        inserted_nodes[index].weight = weight;
+        heap[key].weight = weight;
+        Upheap(key);
+        CheckHeap();
+    }
+
+  private:
+    class HeapNode
+    {
+      public:
+        HeapNode(NodeID n, Key k, Weight w, Data d) : node(n), key(k), weight(w), data(std::move(d))
+        {
+        }
+
+        NodeID node;
+        Key key;
+        Weight weight;
+        Data data;
+    };
+    struct HeapElement
+    {
+        Key index;
+        Weight weight;
+    };
+
+    std::size_t capacity;
+    std::vector<HeapNode> inserted_nodes;
+    std::vector<HeapElement> heap;
+    IndexStorage node_index;
+
+    // 1-based layout: the children of key k are Arity * (k - 1) + 2 ... Arity * k + 1
+    static Key FirstChild(const Key key) { return static_cast<Key>(Arity * (key - 1) + 2); }
+    static Key Parent(const Key key) { return static_cast<Key>((key - 2) / Arity + 1); }
+
+    void Downheap(Key key)
+    {
+        const Key droppingIndex = heap[key].index;
+        const Weight weight = heap[key].weight;
+        const Key heap_size = static_cast<Key>(heap.size());
+        Key nextKey = FirstChild(key);
+        while (nextKey < heap_size)
+        {
+            const Key lastKey = std::min<Key>(nextKey + Arity, heap_size);
+            for (Key other = nextKey + 1; other < lastKey; ++other)
+            {
+                if (heap[other].weight < heap[nextKey].weight)
+                {
+                    nextKey = other;
+                }
+            }
+            if (weight <= heap[nextKey].weight)
+            {
+                break;
+            }
+            heap[key] = heap[nextKey];
+            inserted_nodes[heap[key].index].key = key;
+            key = nextKey;
+            nextKey = FirstChild(key);
+        }
+        heap[key].index = droppingIndex;
+        heap[key].weight = weight;
+        inserted_nodes[droppingIndex].key = key;
+    }
+
+    void Upheap(Key key)
+    {
+        const Key risingIndex = heap[key].index;
+        const Weight weight = heap[key].weight;
+        while (key > 1)
+        {
+            const Key nextKey = Parent(key);
+            if (heap[nextKey].weight <= weight)
+            {
+                break;
+            }
+            heap[key] = heap[nextKey];
+            inserted_nodes[heap[key].index].key = key;
+            key = nextKey;
+        }
+        heap[key].index = risingIndex;
+        heap[key].weight = weight;
+        inserted_nodes[risingIndex].key = key;
+    }
+
+    void CheckHeap()
+    {
+#ifndef NDEBUG
+        for (std::size_t i = 2; i < heap.size(); ++i)
+        {
+            BOOST_ASSERT(heap[i].weight >= heap[Parent(static_cast<Key>(i))].weight);
+        }
+#endif
+    }
+};
+}
+}
+
+#endif // D_ARY_HEAP_HPP
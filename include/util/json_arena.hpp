@@ -0,0 +1,310 @@
+/*
+
+Copyright (c) 2016, Project OSRM contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef JSON_ARENA_HPP
+#define JSON_ARENA_HPP
+
+#include <boost/assert.hpp>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+namespace json
+{
+
+namespace detail
+{
+constexpr std::size_t ARENA_BLOCK_SIZE = 64 * 1024;
+// blocks kept per thread for the next arena, so that requests reuse warm memory
+constexpr std::size_t MAX_SPARE_ARENA_BLOCKS = 64;
+// alignment of all arena memory and of Object and Array nodes on the heap, see AllocateNode
+constexpr std::size_t ARENA_ALIGNMENT =
+    alignof(std::max_align_t) < 16 ? 16 : alignof(std::max_align_t);
+static_assert((ARENA_ALIGNMENT & (ARENA_ALIGNMENT - 1)) == 0 &&
+                  ARENA_ALIGNMENT % sizeof(void *) == 0,
+              "aligned allocations need a power of two multiple of the pointer size");
+
+// Memory aligned to ARENA_ALIGNMENT by the allocation function itself, the global operator new
+// only guarantees the alignment of the largest fundamental type it may be replaced with
+inline void *AllocateAligned(const std::size_t bytes)
+{
+#if defined(_WIN32)
+    void *pointer = _aligned_malloc(bytes, ARENA_ALIGNMENT);
+#else
+    void *pointer = nullptr;
+    if (posix_memalign(&pointer, ARENA_ALIGNMENT, bytes) != 0)
+    {
+        pointer = nullptr;
+    }
+#endif
+    if (pointer == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+inline void DeallocateAligned(void *pointer)
+{
+#if defined(_WIN32)
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+struct AlignedDeleter
+{
+    void operator()(char *pointer) const { DeallocateAligned(pointer); }
+};
+using AlignedBlock = std::unique_ptr<char, AlignedDeleter>;
+
+inline AlignedBlock MakeAlignedBlock(const std::size_t bytes)
+{
+    return AlignedBlock(static_cast<char *>(AllocateAligned(bytes)));
+}
+
+inline std::vector<AlignedBlock> &SpareArenaBlocks()
+{
+    static thread_local std::vector<AlignedBlock> blocks;
+    return blocks;
+}
+}
+
+/**
+ * Monotonic memory arena for JSON responses.
+ *
+ * While an ArenaScope is active on a thread, all json::Object and json::Array nodes and their
+ * element storage created on that thread are carved out of the arena instead of being allocated
+ * one by one. Freeing it is a no-op, the memory is released in one shot when the arena
+ * is destroyed. Values created outside of a scope use the global heap as before.
+ *
+ * The arena must outlive every value created in its scope.
+ *
+ * \see ArenaScope
+ */
+class Arena
+{
+  public:
+    Arena() = default;
+
+    ~Arena()
+    {
+        auto &spare_blocks = detail::SpareArenaBlocks();
+        for (auto &block : blocks)
+        {
+            if (spare_blocks.size() >= detail::MAX_SPARE_ARENA_BLOCKS)
+            {
+                break;
+            }
+            spare_blocks.push_back(std::move(block));
+        }
+    }
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *Allocate(std::size_t bytes)
+    {
+        bytes = (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        ++number_of_allocations;
+
+        // large arrays get memory of their own instead of wasting the rest of a block
+        if (bytes > detail::ARENA_BLOCK_SIZE / 4)
+        {
+            large_allocations.push_back(detail::MakeAlignedBlock(bytes));
+            ++number_of_heap_allocations;
+            return large_allocations.back().get();
+        }
+
+        if (bytes > static_cast<std::size_t>(block_end - block_position))
+        {
+            AddBlock();
+        }
+        void *pointer = block_position;
+        block_position += bytes;
+        return pointer;
+    }
+
+    // Number of allocations served by the arena
+    std::size_t NumberOfAllocations() const { return number_of_allocations; }
+
+    // Number of allocations the arena itself made on the heap
+    std::size_t NumberOfHeapAllocations() const { return number_of_heap_allocations; }
+
+    static constexpr std::size_t ALIGNMENT = detail::ARENA_ALIGNMENT;
+
+  private:
+    void AddBlock()
+    {
+        auto &spare_blocks = detail::SpareArenaBlocks();
+        if (spare_blocks.empty())
+        {
+            blocks.push_back(detail::MakeAlignedBlock(detail::ARENA_BLOCK_SIZE));
+            ++number_of_heap_allocations;
+        }
+        else
+        {
+            blocks.push_back(std::move(spare_blocks.back()));
+            spare_blocks.pop_back();
+        }
+        block_position = blocks.back().get();
+        block_end = block_position + detail::ARENA_BLOCK_SIZE;
+    }
+
+    std::vector<detail::AlignedBlock> blocks;
+    std::vector<detail::AlignedBlock> large_allocations;
+    char *block_position = nullptr;
+    char *block_end = nullptr;
+    std::size_t number_of_allocations = 0;
+    std::size_t number_of_heap_allocations = 0;
+};
+
+namespace detail
+{
+inline Arena *&CurrentArena()
+{
+    static thread_local Arena *arena = nullptr;
+    return arena;
+}
+
+// Object and Array nodes from an arena start half way between two alignment boundaries, while
+// heap nodes are allocated on a boundary. Both alignments are guaranteed by the allocation
+// functions, not by the global heap, so freeing a node finds its source from the address alone
+// and heap nodes need no header.
+constexpr std::size_t ARENA_NODE_OFFSET = Arena::ALIGNMENT / 2;
+
+inline void *AllocateNode(const std::size_t bytes)
+{
+    if (Arena *arena = CurrentArena())
+    {
+        return static_cast<char *>(arena->Allocate(bytes + ARENA_NODE_OFFSET)) +
+               ARENA_NODE_OFFSET;
+    }
+    return AllocateAligned(bytes);
+}
+
+inline void DeallocateNode(void *pointer)
+{
+    if (reinterpret_cast<std::uintptr_t>(pointer) % Arena::ALIGNMENT == 0)
+    {
+        DeallocateAligned(pointer);
+    }
+}
+}
+
+/**
+ * Makes the given arena the allocation source of JSON values on this thread until the scope
+ * ends. Scopes can be nested, the previous arena is restored on destruction.
+ */
+class ArenaScope
+{
+  public:
+    explicit ArenaScope(Arena &arena) : previous(detail::CurrentArena())
+    {
+        detail::CurrentArena() = &arena;
+    }
+
+    ~ArenaScope() { detail::CurrentArena() = previous; }
+
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+
+  private:
+    Arena *previous;
+};
+
+/**
+ * Allocator for the containers of JSON values. It allocates from the arena of the ArenaScope
+ * that was active when the container was created, or from the heap if there was none. The
+ * container keeps its allocator, so memory is always freed by the source it came from.
+ */
+template <typename T> struct ArenaAllocator
+{
+    using value_type = T;
+    // moved and swapped storage keeps its source, copies use the scope active at that time
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator() : arena(detail::CurrentArena()) {}
+    template <typename U> ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    ArenaAllocator select_on_container_copy_construction() const { return ArenaAllocator(); }
+
+    T *allocate(const std::size_t n)
+    {
+        static_assert(alignof(T) <= Arena::ALIGNMENT, "over-aligned types are not supported");
+        if (arena != nullptr)
+        {
+            return static_cast<T *>(arena->Allocate(n * sizeof(T)));
+        }
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *pointer, std::size_t)
+    {
+        if (arena == nullptr)
+        {
+            ::operator delete(pointer);
+        }
+    }
+
+    Arena *arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs)
+{
+    return lhs.arena == rhs.arena;
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs)
+{
+    return lhs.arena != rhs.arena;
+}
+
+} // namespace json
+} // namespace util
+} // namespace osrm
+
+#endif // JSON_ARENA_HPP
@@ -31,10 +31,16 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef JSON_CONTAINER_HPP
 #define JSON_CONTAINER_HPP
 
+#include "util/json_arena.hpp"
+
 #include <mapbox/variant.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
 #include <string>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -59,6 +65,9 @@ namespace util
  *
  * And take a look at the example we provide.
  *
+ * Objects and arrays are allocated from the json::Arena of an active json::ArenaScope if there
+ * is one, see json_arena.hpp.
+ *
  * \see OSRM
  */
 namespace json
@@ -127,6 +136,111 @@ using Value = mapbox::util::variant<String,
                                     False,
                                     Null>;
 
+/**
+ * Flat key-value store for the members of an Object.
+ *
+ * Members are kept in insertion order in a single contiguous vector, which is also the order
+ * in which they are rendered. Lookups are linear, which beats hashing for the handful of keys
+ * OSRM responses have per object. Supports the subset of the std::unordered_map interface
+ * that is used with JSON objects.
+ */
+class ObjectValues
+{
+  public:
+    using key_type = std::string;
+    using mapped_type = Value;
+    using value_type = std::pair<std::string, Value>;
+    using container_type = std::vector<value_type, ArenaAllocator<value_type>>;
+    using iterator = container_type::iterator;
+    using const_iterator = container_type::const_iterator;
+    using size_type = container_type::size_type;
+
+    ObjectValues() = default;
+    ObjectValues(std::initializer_list<value_type> values_) : values(values_) {}
+
+    iterator begin() { return values.begin(); }
+    iterator end() { return values.end(); }
+    const_iterator begin() const { return values.begin(); }
+    const_iterator end() const { return values.end(); }
+    const_iterator cbegin() const { return values.cbegin(); }
+    const_iterator cend() const { return values.cend(); }
+
+    size_type size() const { return values.size(); }
+    bool empty() const { return values.empty(); }
+    void reserve(const size_type size) { values.reserve(size); }
+    void clear() { values.clear(); }
+
+    iterator find(const std::string &key)
+    {
+        return std::find_if(values.begin(), values.end(), [&key](const value_type &value) {
+            return value.first == key;
+        });
+    }
+
+    const_iterator find(const std::string &key) const
+    {
+        return std::find_if(values.begin(), values.end(), [&key](const value_type &value) {
+            return value.first == key;
+        });
+    }
+
+    size_type count(const std::string &key) const { return find(key) == end() ? 0 : 1; }
+
+    Value &at(const std::string &key)
+    {
+        const auto iter = find(key);
+        if (iter == end())
+        {
+            throw std::out_of_range("no such key in JSON object: " + key);
+        }
+        return iter->second;
+    }
+
+    const Value &at(const std::string &key) const
+    {
+        const auto iter = find(key);
+        if (iter == end())
+        {
+            throw std::out_of_range("no such key in JSON object: " + key);
+        }
+        return iter->second;
+    }
+
+    Value &operator[](const std::string &key) { return emplace(key, Value{}).first->second; }
+
+    template <typename V> std::pair<iterator, bool> emplace(std::string key, V &&value)
+    {
+        const auto iter = find(key);
+        if (iter != end())
+        {
+            return {iter, false};
+        }
+        if (values.empty())
+        {
+            // most response objects have a handful of members, don't grow them one by one
+            values.reserve(INITIAL_CAPACITY);
+        }
+        values.emplace_back(std::move(key), std::forward<V>(value));
+        return {std::prev(values.end()), true};
+    }
+
+    size_type erase(const std::string &key)
+    {
+        const auto iter = find(key);
+        if (iter == end())
+        {
+            return 0;
+        }
+        values.erase(iter);
+        return 1;
+    }
+
+  private:
+    static constexpr size_type INITIAL_CAPACITY = 8;
+
+    container_type values;
+};
+
 /**
  * Typed Object.
  *
@@ -134,9 +248,16 @@ using Value = mapbox::util::variant<String,
  */
 struct Object
 {
-    std::unordered_map<std::string, Value> values;
+    ObjectValues values;
+
+    static void *operator new(std::size_t size) { return detail::AllocateNode(size); }
+    static void *operator new(std::size_t, void *place) { return place; }
+    static void operator delete(void *pointer) { detail::DeallocateNode(pointer); }
+    static void operator delete(void *, void *) {}
 };
 
+static_assert(alignof(Object) <= detail::ARENA_NODE_OFFSET, "Object nodes can't be told apart");
+
 /**
  * Typed Array.
  *
@@ -144,9 +265,16 @@ struct Object
  */
 struct Array
 {
-    std::vector<Value> values;
+    std::vector<Value, ArenaAllocator<Value>> values;
+
+    static void *operator new(std::size_t size) { return detail::AllocateNode(size); }
+    static void *operator new(std::size_t, void *place) { return place; }
+    static void operator delete(void *pointer) { detail::DeallocateNode(pointer); }
+    static void operator delete(void *, void *) {}
 };
 
+static_assert(alignof(Array) <= detail::ARENA_NODE_OFFSET, "Array nodes can't be told apart");
+
 } // namespace json
 } // namespace util
 } // namespace osrm
@@ -4,7 +4,7 @@
 #ifndef JSON_RENDERER_HPP
 #define JSON_RENDERER_HPP
 
-#include "util/cast.hpp"
+#include "util/number_format.hpp"
 #include "util/string_util.hpp"
 
 #include "osrm/json_container.hpp"
@@ -84,15 +84,14 @@ struct ArrayRenderer
     void operator()(const String &string) const
     {
         out.push_back('\"');
-        const auto string_to_insert = escape_JSON(string.value);
-        out.insert(std::end(out), std::begin(string_to_insert), std::end(string_to_insert));
+        escape_JSON(string.value, out);
         out.push_back('\"');
     }
 
     void operator()(const Number &number) const
     {
-        const std::string number_string = cast::to_string_with_precision(number.value);
-        out.insert(out.end(), number_string.begin(), number_string.end());
+        char buffer[FixedPointLength<6>::value];
+        out.insert(out.end(), buffer, formatFixedPoint(buffer, number.value));
     }
 
     void operator()(const Object &object) const
@@ -128,39 +127,24 @@ struct ArrayRenderer
         out.push_back(']');
     }
 
-    void operator()(const True &) const
-    {
-        const std::string temp("true");
-        out.insert(out.end(), temp.begin(), temp.end());
-    }
+    void operator()(const True &) const { Append("true"); }
 
-    void operator()(const False &) const
-    {
-        const std::string temp("false");
-        out.insert(out.end(), temp.begin(), temp.end());
-    }
+    void operator()(const False &) const { Append("false"); }
+
+    void operator()(const Null &) const { Append("null"); }
 
-    void operator()(const Null &) const
+  private:
+    template <std::size_t N> void Append(const char (&literal)[N]) const
     {
-        const std::string temp("null");
-        out.insert(out.end(), temp.begin(), temp.end());
+        out.insert(out.end(), literal, literal + N - 1);
     }
 
-  private:
     std::vector<char> &out;
 };
 
-inline void render(std::ostream &out, const Object &object)
-{
-    Value value = object;
-    mapbox::util::apply_visitor(Renderer(out), value);
-}
+inline void render(std::ostream &out, const Object &object) { Renderer{out}(object); }
 
-inline void render(std::vector<char> &out, const Object &object)
-{
-    Value value = object;
-    mapbox::util::apply_visitor(ArrayRenderer(out), value);
-}
+inline void render(std::vector<char> &out, const Object &object) { ArrayRenderer{out}(object); }
 
 } // namespace json
 } // namespace util
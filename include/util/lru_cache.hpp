@@ -0,0 +1,82 @@
+#ifndef OSRM_UTIL_LRU_CACHE_HPP
+#define OSRM_UTIL_LRU_CACHE_HPP
+
+#include <boost/assert.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * Holds up to capacity values, when it is full inserting evicts the least recently used one.
+ *
+ * The values are kept in a list ordered by their last use, the most recently used first, and
+ * found through a hash map of iterators into the list. Not thread safe.
+ */
+template <typename KeyT, typename ValueT, typename HashT = std::hash<KeyT>> class LRUCache
+{
+    using Entry = std::pair<KeyT, ValueT>;
+    using EntryList = std::list<Entry>;
+
+  public:
+    explicit LRUCache(const std::size_t capacity) : capacity(capacity)
+    {
+        BOOST_ASSERT(capacity > 0);
+        index.reserve(capacity);
+    }
+
+    // Copies the value of key into value and marks it as most recently used
+    bool Get(const KeyT &key, ValueT &value)
+    {
+        const auto position = index.find(key);
+        if (position == index.end())
+        {
+            return false;
+        }
+
+        entries.splice(entries.begin(), entries, position->second);
+        value = position->second->second;
+        return true;
+    }
+
+    // Inserts or replaces the value of key as most recently used
+    void Insert(const KeyT &key, ValueT value)
+    {
+        const auto position = index.find(key);
+        if (position != index.end())
+        {
+            position->second->second = std::move(value);
+            entries.splice(entries.begin(), entries, position->second);
+            return;
+        }
+
+        if (entries.size() == capacity)
+        {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+
+        entries.emplace_front(key, std::move(value));
+        index.emplace(key, entries.begin());
+    }
+
+    std::size_t Size() const { return entries.size(); }
+
+    std::size_t Capacity() const { return capacity; }
+
+  private:
+    const std::size_t capacity;
+    EntryList entries;
+    std::unordered_map<KeyT, typename EntryList::iterator, HashT> index;
+};
+}
+}
+
+#endif // OSRM_UTIL_LRU_CACHE_HPP
@@ -0,0 +1,200 @@
+#ifndef OSRM_UTIL_NUMBER_FORMAT_HPP
+#define OSRM_UTIL_NUMBER_FORMAT_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace detail
+{
+constexpr char DIGIT_PAIRS[] = "00010203040506070809"
+                               "10111213141516171819"
+                               "20212223242526272829"
+                               "30313233343536373839"
+                               "40414243444546474849"
+                               "50515253545556575859"
+                               "60616263646566676869"
+                               "70717273747576777879"
+                               "80818283848586878889"
+                               "90919293949596979899";
+
+constexpr std::uint64_t pow10(const int exponent)
+{
+    return exponent == 0 ? 1 : 10 * pow10(exponent - 1);
+}
+
+// Writes exactly `count` digits of value, zero padded, backwards from end
+inline void writeDigitsBackwards(char *end, std::uint64_t value, int count)
+{
+    while (count >= 2)
+    {
+        const auto pair = static_cast<std::size_t>(value % 100) * 2;
+        value /= 100;
+        *--end = DIGIT_PAIRS[pair + 1];
+        *--end = DIGIT_PAIRS[pair];
+        count -= 2;
+    }
+    if (count == 1)
+    {
+        *--end = static_cast<char>('0' + value % 10);
+    }
+}
+
+inline int countDigits(const std::uint64_t value)
+{
+    int count = 1;
+    for (std::uint64_t bound = 10; count < 20 && value >= bound; bound *= 10)
+    {
+        ++count;
+    }
+    return count;
+}
+
+// Removes trailing zeros and then a trailing dot of a fixed point number
+inline char *trimFraction(char *begin, char *end)
+{
+    if (std::memchr(begin, '.', end - begin) == nullptr)
+    {
+        return end;
+    }
+    while (end[-1] == '0')
+    {
+        --end;
+    }
+    if (end[-1] == '.')
+    {
+        --end;
+    }
+    return end;
+}
+}
+
+// Buffer size needed by formatFixedPoint: sign, 309 integral digits, dot, fraction and the
+// terminator snprintf writes
+template <int Precision> struct FixedPointLength
+{
+    static constexpr std::size_t value = 1 + 309 + 1 + Precision + 1;
+};
+
+// Writes the decimal digits of value to buffer and returns the end of the written range
+inline char *formatInteger(char *buffer, const std::uint64_t value)
+{
+    const auto count = detail::countDigits(value);
+    detail::writeDigitsBackwards(buffer + count, value, count);
+    return buffer + count;
+}
+
+/**
+ * Writes value with Precision digits after the decimal point, dropping trailing zeros and a
+ * trailing dot, and returns the end of the written range. Doesn't zero-terminate.
+ *
+ * The output is identical to std::fixed with std::setprecision(Precision) followed by trimming,
+ * the format of all numbers in our JSON responses (see cast::to_string_with_precision), but
+ * doesn't go through iostreams: the double's mantissa is scaled by 10^Precision in 128 bit
+ * integer arithmetic and rounded half to even, which is exact. Numbers that don't fit into 64
+ * bit after scaling fall back to snprintf. NaN and infinity are written as null.
+ *
+ * The buffer must hold at least FixedPointLength<Precision>::value characters.
+ */
+template <int Precision = 6> char *formatFixedPoint(char *buffer, const double value)
+{
+    static_assert(Precision > 0 && Precision <= 9, "precision out of range");
+
+    if (!std::isfinite(value))
+    {
+        std::memcpy(buffer, "null", 4);
+        return buffer + 4;
+    }
+
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const bool negative = (bits >> 63) != 0;
+    const auto biased_exponent = static_cast<int>((bits >> 52) & 0x7ff);
+    const auto fraction = bits & ((std::uint64_t{1} << 52) - 1);
+    // value is mantissa * 2^exponent exactly
+    const auto mantissa = biased_exponent == 0 ? fraction : (fraction | std::uint64_t{1} << 52);
+    const auto exponent = (biased_exponent == 0 ? 1 : biased_exponent) - 1075;
+
+    char *out = buffer;
+    // like printf, the sign is kept even if the number rounds to zero
+    if (negative)
+    {
+        *out++ = '-';
+    }
+
+    if (mantissa == 0)
+    {
+        *out++ = '0';
+        return out;
+    }
+
+    if (exponent >= 0)
+    {
+        // integral, mantissa has 53 bits so anything shifted by up to 10 bits fits
+        if (exponent <= 10)
+        {
+            return formatInteger(out, mantissa << exponent);
+        }
+    }
+#if defined(__SIZEOF_INT128__)
+    else
+    {
+        constexpr auto SCALE = detail::pow10(Precision);
+        const auto shift = -exponent;
+        // the scaled mantissa has less than 53 + 30 bits, so larger shifts round to zero
+        if (shift > 84)
+        {
+            *out++ = '0';
+            return out;
+        }
+
+        using uint128_t = unsigned __int128;
+        const auto scaled = static_cast<uint128_t>(mantissa) * SCALE;
+        auto rounded = scaled >> shift;
+        const auto remainder = scaled - (rounded << shift);
+        const auto half = static_cast<uint128_t>(1) << (shift - 1);
+        if (remainder > half || (remainder == half && (rounded & 1) == 1))
+        {
+            ++rounded;
+        }
+
+        if (rounded <= std::numeric_limits<std::uint64_t>::max())
+        {
+            const auto fixed = static_cast<std::uint64_t>(rounded);
+            out = formatInteger(out, fixed / SCALE);
+            auto decimals = fixed % SCALE;
+            if (decimals == 0)
+            {
+                return out;
+            }
+
+            int number_of_decimals = Precision;
+            while (decimals % 10 == 0)
+            {
+                decimals /= 10;
+                --number_of_decimals;
+            }
+            *out++ = '.';
+            detail::writeDigitsBackwards(out + number_of_decimals, decimals, number_of_decimals);
+            return out + number_of_decimals;
+        }
+    }
+#endif
+
+    // very large numbers (or no 128 bit integers), not seen in practice
+    const auto length =
+        std::snprintf(buffer, FixedPointLength<Precision>::value, "%.*f", Precision, value);
+    return detail::trimFraction(buffer, buffer + length);
+}
+}
+}
+
+#endif
@@ -0,0 +1,286 @@
+#ifndef RADIX_HEAP_HPP
+#define RADIX_HEAP_HPP
+
+#include "util/binary_heap.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace detail
+{
+// Position of the highest set bit, value must not be zero
+inline unsigned HighestBit(const std::uint64_t value)
+{
+    BOOST_ASSERT(value != 0);
+#if defined(__GNUC__)
+    return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+    unsigned bit = 0;
+    for (auto shifted = value >> 1; shifted != 0; shifted >>= 1)
+    {
+        ++bit;
+    }
+    return bit;
+#endif
+}
+}
+
+// Monotone radix heap with the BinaryHeap interface. Elements are kept in buckets by the
+// highest bit in which their weight differs from the last extracted minimum, so Insert and
+// DecreaseKey are O(1) appends and each element is moved at most once per bit on its way to
+// the front. DecreaseKey leaves the old entry behind, it is skipped when it surfaces.
+//
+// The heap is only correct for monotone use as in Dijkstra's algorithm: no weight passed to
+// Insert or DecreaseKey may be smaller than the last weight returned by MinKey/DeleteMin.
+template <typename NodeID,
+          typename Key,
+          typename Weight,
+          typename Data,
+          typename IndexStorage = ArrayStorage<NodeID, NodeID>>
+class RadixHeap
+{
+    static_assert(std::is_integral<Weight>::value, "radix heaps need integral weights");
+
+    using RadixType = typename std::make_unsigned<Weight>::type;
+    static constexpr std::size_t NUMBER_OF_BUCKETS = sizeof(Weight) * 8 + 1;
+
+  private:
+    RadixHeap(const RadixHeap &right);
+    void operator=(const RadixHeap &right);
+
+  public:
+    using WeightType = Weight;
+    using DataType = Data;
+
+    explicit RadixHeap(size_t maxID) : capacity(maxID), node_index(maxID) { Clear(); }
+
+    // number of node ids the heap was created for, larger ids must not be inserted
+    std::size_t Capacity() const { return capacity; }
+
+    void Clear()
+    {
+        for (auto &bucket : buckets)
+        {
+            bucket.clear();
+        }
+        inserted_nodes.clear();
+        node_index.Clear();
+        number_of_elements = 0;
+        last = 0;
+    }
+
+    std::size_t Size() const { return number_of_elements; }
+
+    bool Empty() const { return 0 == Size(); }
+
+    void Insert(NodeID node, Weight weight, const Data &data)
+    {
+        const Key index = static_cast<Key>(inserted_nodes.size());
+        inserted_nodes.emplace_back(node, weight, data);
+        node_index[node] = index;
+        Push(index, weight);
+        ++number_of_elements;
+    }
+
+    Data &GetData(NodeID node)
+    {
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].data;
+    }
+
+    Data const &GetData(NodeID node) const
+    {
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].data;
+    }
+
+    Weight &GetKey(NodeID node)
+    {
+        const Key index = node_index[node];
+        return inserted_nodes[index].weight;
+    }
+
+    bool WasRemoved(const NodeID node) const
+    {
+        BOOST_ASSERT(WasInserted(node));
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].removed;
+    }
+
+    bool WasInserted(const NodeID node) const
+    {
+        const auto index = node_index.peek_index(node);
+        if (index >= static_cast<decltype(index)>(inserted_nodes.size()))
+        {
+            return false;
+        }
+        return inserted_nodes[index].node == node;
+    }
+
+    NodeID Min() const
+    {
+        BOOST_ASSERT(!Empty());
+        Normalize();
+        return inserted_nodes[buckets[0].back().index].node;
+    }
+
+    Weight MinKey() const
+    {
+        BOOST_ASSERT(!Empty());
+        Normalize();
+        return inserted_nodes[buckets[0].back().index].weight;
+    }
+
+    NodeID DeleteMin()
+    {
+        BOOST_ASSERT(!Empty());
+        Normalize();
+        const Key removed_index = buckets[0].back().index;
+        buckets[0].pop_back();
+        inserted_nodes[removed_index].removed = true;
+        --number_of_elements;
+        return inserted_nodes[removed_index].node;
+    }
+
+    void DeleteAll()
+    {
+        for (auto &bucket : buckets)
+        {
+            for (const auto &element : bucket)
+            {
+                inserted_nodes[element.index].removed = true;
+            }
+            bucket.clear();
+        }
+        number_of_elements = 0;
+    }
+
+    void DecreaseKey(NodeID node, Weight weight)
+    {
+        BOOST_ASSERT(std::numeric_limits<NodeID>::max() != node);
+        const Key index = node_index.peek_index(node);
+        BOOST_ASSERT(!inserted_nodes[index].removed);
+        BOOST_ASSERT(weight <= inserted_nodes[index].weight);
+
+        // the old bucket entry becomes stale and is dropped once it is looked at again
+        inserted_nodes[index].weight = weight;
+        Push(index, weight);
+    }
+
+  private:
+    class HeapNode
+    {
+      public:
+        HeapNode(NodeID n, Weight w, Data d) : node(n), weight(w), data(std::move(d)) {}
+
+        NodeID node;
+        bool removed = false;
+        Weight weight;
+        Data data;
+    };
+    struct HeapElement
+    {
+        Key index;
+        RadixType radix;
+    };
+
+    std::size_t capacity;
+    std::vector<HeapNode> inserted_nodes;
+    // buckets and the last minimum are only reorganized, never changed in content, by the
+    // logically const Min/MinKey
+    mutable std::array<std::vector<HeapElement>, NUMBER_OF_BUCKETS> buckets;
+    mutable RadixType last;
+    std::size_t number_of_elements;
+    IndexStorage node_index;
+
+    // Order preserving mapping of (possibly negative) weights to unsigned integers
+    static RadixType ToRadix(const Weight weight)
+    {
+        return static_cast<RadixType>(weight) ^
+               (std::is_signed<Weight>::value ? (RadixType{1} << (sizeof(Weight) * 8 - 1))
+                                              : RadixType{0});
+    }
+
+    static std::size_t BucketIndex(const RadixType radix, const RadixType reference)
+    {
+        return radix == reference ? 0 : detail::HighestBit(radix ^ reference) + 1;
+    }
+
+    bool IsStale(const HeapElement &element) const
+    {
+        const auto &heap_node = inserted_nodes[element.index];
+        return heap_node.removed || ToRadix(heap_node.weight) != element.radix;
+    }
+
+    void Push(const Key index, const Weight weight)
+    {
+        const auto radix = ToRadix(weight);
+        BOOST_ASSERT_MSG(radix >= last, "radix heap is only valid for monotone use");
+        buckets[BucketIndex(radix, last)].push_back(HeapElement{index, radix});
+    }
+
+    // Makes sure the minimum is at the back of the first bucket
+    void Normalize() const
+    {
+        auto &front = buckets[0];
+        while (!front.empty() && IsStale(front.back()))
+        {
+            front.pop_back();
+        }
+        if (!front.empty())
+        {
+            return;
+        }
+
+        for (std::size_t bucket_index = 1; bucket_index < NUMBER_OF_BUCKETS; ++bucket_index)
+        {
+            auto &bucket = buckets[bucket_index];
+            bool has_live_element = false;
+            RadixType new_last = std::numeric_limits<RadixType>::max();
+            for (const auto &element : bucket)
+            {
+                if (!IsStale(element))
+                {
+                    has_live_element = true;
+                    new_last = std::min(new_last, element.radix);
+                }
+            }
+
+            if (!has_live_element)
+            {
+                bucket.clear();
+                continue;
+            }
+
+            // all elements of this bucket move to strictly smaller buckets
+            last = new_last;
+            for (const auto &element : bucket)
+            {
+                if (!IsStale(element))
+                {
+                    buckets[BucketIndex(element.radix, last)].push_back(element);
+                }
+            }
+            bucket.clear();
+            BOOST_ASSERT(!front.empty());
+            return;
+        }
+        BOOST_ASSERT_MSG(false, "no live element found in non-empty radix heap");
+    }
+};
+}
+}
+
+#endif // RADIX_HEAP_HPP
@@ -0,0 +1,235 @@
+#ifndef OSRM_UTIL_SEGMENT_PROJECTION_HPP
+#define OSRM_UTIL_SEGMENT_PROJECTION_HPP
+
+#include "util/coordinate.hpp"
+#include "util/coordinate_calculation.hpp"
+#include "util/cpu_features.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+
+#if OSRM_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+
+// Projects a query onto a run of segments given as a structure of arrays of their Web Mercator
+// projected end points, the kernels compute for every segment i:
+//
+//   nearest[i] = Coordinate{projectPointOnSegment(source[i], target[i], query)}
+//   squared_distance[i] = squaredEuclideanDistance(fixed_query, nearest[i])
+//
+// The vector kernels do the same floating point operations in the same order as the scalar
+// kernel, so all kernels return identical results.
+namespace segment_projection
+{
+
+struct Segments
+{
+    const double *source_lon;
+    const double *source_lat;
+    const double *target_lon;
+    const double *target_lat;
+};
+
+struct Results
+{
+    std::int32_t *nearest_lon;
+    std::int32_t *nearest_lat;
+    std::uint64_t *squared_distance;
+};
+
+inline void ProjectScalar(const Segments &segments,
+                          const std::size_t count,
+                          const FloatCoordinate &query,
+                          const Coordinate &fixed_query,
+                          const Results &results)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        FloatCoordinate projected_nearest;
+        std::tie(std::ignore, projected_nearest) = coordinate_calculation::projectPointOnSegment(
+            {FloatLongitude{segments.source_lon[i]}, FloatLatitude{segments.source_lat[i]}},
+            {FloatLongitude{segments.target_lon[i]}, FloatLatitude{segments.target_lat[i]}},
+            query);
+        const Coordinate nearest{projected_nearest};
+        results.nearest_lon[i] = static_cast<std::int32_t>(nearest.lon);
+        results.nearest_lat[i] = static_cast<std::int32_t>(nearest.lat);
+        results.squared_distance[i] =
+            coordinate_calculation::squaredEuclideanDistance(fixed_query, nearest);
+    }
+}
+
+#if OSRM_X86_SIMD
+OSRM_TARGET_SSE41 inline void ProjectSSE41(const Segments &segments,
+                                           const std::size_t count,
+                                           const FloatCoordinate &query,
+                                           const Coordinate &fixed_query,
+                                           const Results &results)
+{
+    const __m128d query_lon = _mm_set1_pd(static_cast<double>(query.lon));
+    const __m128d query_lat = _mm_set1_pd(static_cast<double>(query.lat));
+    const __m128i fixed_query_lon = _mm_set1_epi32(static_cast<std::int32_t>(fixed_query.lon));
+    const __m128i fixed_query_lat = _mm_set1_epi32(static_cast<std::int32_t>(fixed_query.lat));
+    const __m128d epsilon = _mm_set1_pd(std::numeric_limits<double>::epsilon());
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d one = _mm_set1_pd(1.);
+    const __m128d precision = _mm_set1_pd(COORDINATE_PRECISION);
+
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        const __m128d source_lon = _mm_loadu_pd(segments.source_lon + i);
+        const __m128d source_lat = _mm_loadu_pd(segments.source_lat + i);
+        const __m128d target_lon = _mm_loadu_pd(segments.target_lon + i);
+        const __m128d target_lat = _mm_loadu_pd(segments.target_lat + i);
+
+        const __m128d slope_lon = _mm_sub_pd(target_lon, source_lon);
+        const __m128d slope_lat = _mm_sub_pd(target_lat, source_lat);
+        const __m128d relative_lon = _mm_sub_pd(query_lon, source_lon);
+        const __m128d relative_lat = _mm_sub_pd(query_lat, source_lat);
+        const __m128d unnormed_ratio = _mm_add_pd(_mm_mul_pd(slope_lon, relative_lon),
+                                                  _mm_mul_pd(slope_lat, relative_lat));
+        const __m128d squared_length =
+            _mm_add_pd(_mm_mul_pd(slope_lon, slope_lon), _mm_mul_pd(slope_lat, slope_lat));
+
+        // degenerated segments project onto their source
+        const __m128d degenerated = _mm_cmplt_pd(squared_length, epsilon);
+        const __m128d clamped_ratio =
+            _mm_min_pd(_mm_max_pd(_mm_div_pd(unnormed_ratio, squared_length), zero), one);
+        const __m128d ratio = _mm_andnot_pd(degenerated, clamped_ratio);
+        const __m128d inverse_ratio = _mm_sub_pd(one, ratio);
+
+        const __m128d nearest_lon = _mm_add_pd(_mm_mul_pd(inverse_ratio, source_lon),
+                                               _mm_mul_pd(target_lon, ratio));
+        const __m128d nearest_lat = _mm_add_pd(_mm_mul_pd(inverse_ratio, source_lat),
+                                               _mm_mul_pd(target_lat, ratio));
+        const __m128i fixed_lon = _mm_cvttpd_epi32(_mm_mul_pd(nearest_lon, precision));
+        const __m128i fixed_lat = _mm_cvttpd_epi32(_mm_mul_pd(nearest_lat, precision));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(results.nearest_lon + i), fixed_lon);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(results.nearest_lat + i), fixed_lat);
+
+        const __m128i delta_lon = _mm_cvtepi32_epi64(_mm_sub_epi32(fixed_query_lon, fixed_lon));
+        const __m128i delta_lat = _mm_cvtepi32_epi64(_mm_sub_epi32(fixed_query_lat, fixed_lat));
+        const __m128i squared_distance = _mm_add_epi64(_mm_mul_epi32(delta_lon, delta_lon),
+                                                       _mm_mul_epi32(delta_lat, delta_lat));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(results.squared_distance + i),
+                         squared_distance);
+    }
+    ProjectScalar({segments.source_lon + i,
+                   segments.source_lat + i,
+                   segments.target_lon + i,
+                   segments.target_lat + i},
+                  count - i,
+                  query,
+                  fixed_query,
+                  {results.nearest_lon + i, results.nearest_lat + i, results.squared_distance + i});
+}
+
+OSRM_TARGET_AVX2 inline void ProjectAVX2(const Segments &segments,
+                                         const std::size_t count,
+                                         const FloatCoordinate &query,
+                                         const Coordinate &fixed_query,
+                                         const Results &results)
+{
+    const __m256d query_lon = _mm256_set1_pd(static_cast<double>(query.lon));
+    const __m256d query_lat = _mm256_set1_pd(static_cast<double>(query.lat));
+    const __m128i fixed_query_lon = _mm_set1_epi32(static_cast<std::int32_t>(fixed_query.lon));
+    const __m128i fixed_query_lat = _mm_set1_epi32(static_cast<std::int32_t>(fixed_query.lat));
+    const __m256d epsilon = _mm256_set1_pd(std::numeric_limits<double>::epsilon());
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.);
+    const __m256d precision = _mm256_set1_pd(COORDINATE_PRECISION);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256d source_lon = _mm256_loadu_pd(segments.source_lon + i);
+        const __m256d source_lat = _mm256_loadu_pd(segments.source_lat + i);
+        const __m256d target_lon = _mm256_loadu_pd(segments.target_lon + i);
+        const __m256d target_lat = _mm256_loadu_pd(segments.target_lat + i);
+
+        const __m256d slope_lon = _mm256_sub_pd(target_lon, source_lon);
+        const __m256d slope_lat = _mm256_sub_pd(target_lat, source_lat);
+        const __m256d relative_lon = _mm256_sub_pd(query_lon, source_lon);
+        const __m256d relative_lat = _mm256_sub_pd(query_lat, source_lat);
+        const __m256d unnormed_ratio = _mm256_add_pd(_mm256_mul_pd(slope_lon, relative_lon),
+                                                     _mm256_mul_pd(slope_lat, relative_lat));
+        const __m256d squared_length = _mm256_add_pd(_mm256_mul_pd(slope_lon, slope_lon),
+                                                     _mm256_mul_pd(slope_lat, slope_lat));
+
+        // degenerated segments project onto their source
+        const __m256d degenerated = _mm256_cmp_pd(squared_length, epsilon, _CMP_LT_OQ);
+        const __m256d clamped_ratio = _mm256_min_pd(
+            _mm256_max_pd(_mm256_div_pd(unnormed_ratio, squared_length), zero), one);
+        const __m256d ratio = _mm256_andnot_pd(degenerated, clamped_ratio);
+        const __m256d inverse_ratio = _mm256_sub_pd(one, ratio);
+
+        const __m256d nearest_lon = _mm256_add_pd(_mm256_mul_pd(inverse_ratio, source_lon),
+                                                  _mm256_mul_pd(target_lon, ratio));
+        const __m256d nearest_lat = _mm256_add_pd(_mm256_mul_pd(inverse_ratio, source_lat),
+                                                  _mm256_mul_pd(target_lat, ratio));
+        const __m128i fixed_lon = _mm256_cvttpd_epi32(_mm256_mul_pd(nearest_lon, precision));
+        const __m128i fixed_lat = _mm256_cvttpd_epi32(_mm256_mul_pd(nearest_lat, precision));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(results.nearest_lon + i), fixed_lon);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(results.nearest_lat + i), fixed_lat);
+
+        const __m256i delta_lon =
+            _mm256_cvtepi32_epi64(_mm_sub_epi32(fixed_query_lon, fixed_lon));
+        const __m256i delta_lat =
+            _mm256_cvtepi32_epi64(_mm_sub_epi32(fixed_query_lat, fixed_lat));
+        const __m256i squared_distance =
+            _mm256_add_epi64(_mm256_mul_epi32(delta_lon, delta_lon),
+                             _mm256_mul_epi32(delta_lat, delta_lat));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(results.squared_distance + i),
+                            squared_distance);
+    }
+    ProjectScalar({segments.source_lon + i,
+                   segments.source_lat + i,
+                   segments.target_lon + i,
+                   segments.target_lat + i},
+                  count - i,
+                  query,
+                  fixed_query,
+                  {results.nearest_lon + i, results.nearest_lat + i, results.squared_distance + i});
+}
+#endif
+
+using ProjectFunction = void (*)(const Segments &,
+                                 const std::size_t,
+                                 const FloatCoordinate &,
+                                 const Coordinate &,
+                                 const Results &);
+
+// Picks the widest kernel the CPU we are running on supports
+inline ProjectFunction SelectProject()
+{
+#if OSRM_X86_SIMD
+    if (util::cpu::HasAVX2())
+        return &ProjectAVX2;
+    if (util::cpu::HasSSE41())
+        return &ProjectSSE41;
+#endif
+    return &ProjectScalar;
+}
+
+inline void Project(const Segments &segments,
+                    const std::size_t count,
+                    const FloatCoordinate &query,
+                    const Coordinate &fixed_query,
+                    const Results &results)
+{
+    static const ProjectFunction project = SelectProject();
+    project(segments, count, query, fixed_query, results);
+}
+}
+}
+}
+
+#endif // OSRM_UTIL_SEGMENT_PROJECTION_HPP
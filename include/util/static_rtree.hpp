@@ -3,13 +3,17 @@
 
 #include "storage/io.hpp"
 #include "util/bearing.hpp"
+#include "util/compressed_rtree_leaves.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/deallocating_vector.hpp"
 #include "util/exception.hpp"
 #include "util/hilbert_value.hpp"
 #include "util/integer_range.hpp"
+#include "util/log.hpp"
 #include "util/rectangle.hpp"
+#include "util/segment_projection.hpp"
 #include "util/shared_memory_vector_wrapper.hpp"
+#include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 #include "util/web_mercator.hpp"
 
@@ -26,10 +30,12 @@
 
 #include <algorithm>
 #include <array>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 // An extended alignment is implementation-defined, so use compiler attributes
@@ -99,6 +105,36 @@ class StaticRTree
     static_assert(sizeof(LeafNode) == LEAF_PAGE_SIZE, "LeafNode size does not fit the page size");
 
   private:
+    // Web Mercator projections of the end points of the segments of a leaf, as a structure of
+    // arrays for the segment_projection kernels. The objects point into the mapped leaf, or to
+    // decoded_objects for compressed leaves.
+    struct ProjectedLeaf
+    {
+        std::uint32_t object_count = 0;
+        const EdgeDataT *objects = nullptr;
+        std::array<EdgeDataT, LEAF_NODE_SIZE> decoded_objects;
+        std::array<double, LEAF_NODE_SIZE> u_lon;
+        std::array<double, LEAF_NODE_SIZE> u_lat;
+        std::array<double, LEAF_NODE_SIZE> v_lon;
+        std::array<double, LEAF_NODE_SIZE> v_lat;
+    };
+
+    // A segment of an explored leaf with its distance to the query. The segments of a leaf are
+    // stored sorted by distance, and only the nearest one not taken yet is in the queue.
+    struct SegmentCandidate
+    {
+        std::uint64_t squared_distance;
+        std::uint32_t segment_index;
+        bool is_last_of_leaf;
+        Coordinate fixed_projected_coordinate;
+    };
+
+    // Number of projected leaves a batch of nearest queries keeps, as a direct-mapped cache
+    static constexpr std::size_t PROJECTED_LEAF_CACHE_SIZE = 16;
+
+    // Number of leaves the construction packs in parallel before writing them to the leaf file
+    static constexpr std::uint64_t LEAVES_PER_BATCH = 1 << 14;
+
     struct WrappedInputElement
     {
         explicit WrappedInputElement(const uint64_t _hilbert_value,
@@ -122,22 +158,21 @@ class StaticRTree
     {
         QueryCandidate(std::uint64_t squared_min_dist, TreeIndex tree_index)
             : squared_min_dist(squared_min_dist), tree_index(tree_index),
-              segment_index(std::numeric_limits<std::uint32_t>::max())
+              candidate_index(std::numeric_limits<std::uint32_t>::max())
         {
         }
 
         QueryCandidate(std::uint64_t squared_min_dist,
                        TreeIndex tree_index,
-                       std::uint32_t segment_index,
-                       const Coordinate &coordinate)
+                       std::uint32_t candidate_index)
             : squared_min_dist(squared_min_dist), tree_index(tree_index),
-              segment_index(segment_index), fixed_projected_coordinate(coordinate)
+              candidate_index(candidate_index)
         {
         }
 
         inline bool is_segment() const
         {
-            return segment_index != std::numeric_limits<std::uint32_t>::max();
+            return candidate_index != std::numeric_limits<std::uint32_t>::max();
         }
 
         inline bool operator<(const QueryCandidate &other) const
@@ -148,8 +183,8 @@ class StaticRTree
 
         std::uint64_t squared_min_dist;
         TreeIndex tree_index;
-        std::uint32_t segment_index;
-        Coordinate fixed_projected_coordinate;
+        // position in the segment candidates of the search
+        std::uint32_t candidate_index;
     };
 
     typename ShM<TreeNode, UseSharedMemory>::vector m_search_tree;
@@ -158,6 +193,9 @@ class StaticRTree
     boost::iostreams::mapped_file_source m_leaves_region;
     // read-only view of leaves
     typename ShM<const LeafNode, true>::vector m_leaves;
+    // replaces the mapped leaves after CompressLeaves
+    CompressedRTreeLeaves<EdgeDataT> m_compressed_leaves;
+    bool m_use_compressed_leaves = false;
 
   public:
     StaticRTree(const StaticRTree &) = delete;
@@ -175,6 +213,7 @@ class StaticRTree
         std::vector<WrappedInputElement> input_wrapper_vector(element_count);
 
         // generate auxiliary vector of hilbert-values
+        TIMER_START(hilbert_values);
         tbb::parallel_for(
             tbb::blocked_range<uint64_t>(0, element_count),
             [&input_data_vector, &input_wrapper_vector, this](
@@ -201,108 +240,109 @@ class StaticRTree
                     current_wrapper.m_hilbert_value = GetHilbertCode(current_centroid);
                 }
             });
+        TIMER_STOP(hilbert_values);
+        util::Log() << "r-tree: computed " << element_count << " Hilbert values in "
+                    << TIMER_SEC(hilbert_values) << " seconds";
 
         // open leaf file
         boost::filesystem::ofstream leaf_node_file(leaf_node_filename, std::ios::binary);
 
         // sort the hilbert-value representatives
+        TIMER_START(sort);
         tbb::parallel_sort(input_wrapper_vector.begin(), input_wrapper_vector.end());
-        std::vector<TreeNode> tree_nodes_in_level;
-
-        // pack M elements into leaf node, write to leaf file and add child index to the parent node
-        uint64_t wrapped_element_index = 0;
-        for (std::uint32_t node_index = 0; wrapped_element_index < element_count; ++node_index)
+        TIMER_STOP(sort);
+        util::Log() << "r-tree: sorted by Hilbert value in " << TIMER_SEC(sort) << " seconds";
+
+        // pack M elements into every leaf node, the leaves are packed in parallel in batches that
+        // are written to the leaf file in order
+        TIMER_START(leaves);
+        const std::uint64_t number_of_leaves =
+            (element_count + LEAF_NODE_SIZE - 1) / LEAF_NODE_SIZE;
+        std::vector<Rectangle> leaf_rectangles(number_of_leaves);
+        std::vector<char> leaf_buffer(
+            std::min(number_of_leaves, std::uint64_t{LEAVES_PER_BATCH}) * sizeof(LeafNode));
+        for (std::uint64_t first_leaf = 0; first_leaf < number_of_leaves;
+             first_leaf += LEAVES_PER_BATCH)
         {
-            TreeNode current_node;
-            for (std::uint32_t leaf_index = 0;
-                 leaf_index < BRANCHING_FACTOR && wrapped_element_index < element_count;
-                 ++leaf_index)
-            {
-                LeafNode current_leaf;
-                Rectangle &rectangle = current_leaf.minimum_bounding_rectangle;
-                for (std::uint32_t object_index = 0;
-                     object_index < LEAF_NODE_SIZE && wrapped_element_index < element_count;
-                     ++object_index, ++wrapped_element_index)
-                {
-                    const std::uint32_t input_object_index =
-                        input_wrapper_vector[wrapped_element_index].m_array_index;
-                    const EdgeDataT &object = input_data_vector[input_object_index];
-
-                    current_leaf.object_count += 1;
-                    current_leaf.objects[object_index] = object;
-
-                    Coordinate projected_u{
-                        web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.u]})};
-                    Coordinate projected_v{
-                        web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.v]})};
-
-                    BOOST_ASSERT(std::abs(toFloating(projected_u.lon).operator double()) <= 180.);
-                    BOOST_ASSERT(std::abs(toFloating(projected_u.lat).operator double()) <= 180.);
-                    BOOST_ASSERT(std::abs(toFloating(projected_v.lon).operator double()) <= 180.);
-                    BOOST_ASSERT(std::abs(toFloating(projected_v.lat).operator double()) <= 180.);
-
-                    rectangle.min_lon =
-                        std::min(rectangle.min_lon, std::min(projected_u.lon, projected_v.lon));
-                    rectangle.max_lon =
-                        std::max(rectangle.max_lon, std::max(projected_u.lon, projected_v.lon));
-
-                    rectangle.min_lat =
-                        std::min(rectangle.min_lat, std::min(projected_u.lat, projected_v.lat));
-                    rectangle.max_lat =
-                        std::max(rectangle.max_lat, std::max(projected_u.lat, projected_v.lat));
-
-                    BOOST_ASSERT(rectangle.IsValid());
-                }
-
-                // append the leaf node to the current tree node
-                current_node.child_count += 1;
-                current_node.children[leaf_index] =
-                    TreeIndex{node_index * BRANCHING_FACTOR + leaf_index, true};
-                current_node.minimum_bounding_rectangle.MergeBoundingBoxes(
-                    current_leaf.minimum_bounding_rectangle);
-
-                // write leaf_node to leaf node file
-                leaf_node_file.write((char *)&current_leaf, sizeof(current_leaf));
-            }
+            const auto last_leaf = std::min(number_of_leaves, first_leaf + LEAVES_PER_BATCH);
+            tbb::parallel_for(
+                tbb::blocked_range<std::uint64_t>(first_leaf, last_leaf),
+                [&](const tbb::blocked_range<std::uint64_t> &range) {
+                    LeafNode current_leaf;
+                    for (auto leaf_index = range.begin(); leaf_index != range.end(); ++leaf_index)
+                    {
+                        PackLeaf(input_data_vector, input_wrapper_vector, leaf_index, current_leaf);
+                        leaf_rectangles[leaf_index] = current_leaf.minimum_bounding_rectangle;
+                        std::memcpy(&leaf_buffer[(leaf_index - first_leaf) * sizeof(LeafNode)],
+                                    &current_leaf,
+                                    sizeof(LeafNode));
+                    }
+                });
 
-            tree_nodes_in_level.emplace_back(current_node);
+            // write leaf nodes to leaf node file
+            leaf_node_file.write(leaf_buffer.data(), (last_leaf - first_leaf) * sizeof(LeafNode));
         }
         leaf_node_file.flush();
         leaf_node_file.close();
+        TIMER_STOP(leaves);
+        util::Log() << "r-tree: packed " << number_of_leaves << " leaves in " << TIMER_SEC(leaves)
+                    << " seconds";
+
+        // the leaves are the children of the lowest level of tree nodes
+        TIMER_START(tree_nodes);
+        std::vector<TreeNode> tree_nodes_in_level((number_of_leaves + BRANCHING_FACTOR - 1) /
+                                                  BRANCHING_FACTOR);
+        tbb::parallel_for(
+            tbb::blocked_range<std::uint64_t>(0, tree_nodes_in_level.size()),
+            [&](const tbb::blocked_range<std::uint64_t> &range) {
+                for (auto node_index = range.begin(); node_index != range.end(); ++node_index)
+                {
+                    TreeNode &current_node = tree_nodes_in_level[node_index];
+                    const std::uint64_t first_child = node_index * BRANCHING_FACTOR;
+                    const auto last_child =
+                        std::min(number_of_leaves, first_child + BRANCHING_FACTOR);
+                    for (const auto leaf_index : irange(first_child, last_child))
+                    {
+                        // append the leaf node to the current tree node
+                        current_node.children[current_node.child_count++] =
+                            TreeIndex{leaf_index, true};
+                        current_node.minimum_bounding_rectangle.MergeBoundingBoxes(
+                            leaf_rectangles[leaf_index]);
+                    }
+                }
+            });
 
-        std::uint32_t processing_level = 0;
+        // every level is stored in m_search_tree in order, the parents of a level reference their
+        // children by that position before the tree is reversed below
         while (1 < tree_nodes_in_level.size())
         {
-            std::vector<TreeNode> tree_nodes_in_next_level;
-            std::uint32_t processed_tree_nodes_in_level = 0;
-            while (processed_tree_nodes_in_level < tree_nodes_in_level.size())
-            {
-                TreeNode parent_node;
-                // pack BRANCHING_FACTOR elements into tree_nodes each
-                for (std::uint32_t current_child_node_index = 0;
-                     current_child_node_index < BRANCHING_FACTOR;
-                     ++current_child_node_index)
-                {
-                    if (processed_tree_nodes_in_level < tree_nodes_in_level.size())
+            const std::uint64_t level_begin = m_search_tree.size();
+            m_search_tree.insert(
+                m_search_tree.end(), tree_nodes_in_level.begin(), tree_nodes_in_level.end());
+
+            // pack BRANCHING_FACTOR elements into tree_nodes each
+            std::vector<TreeNode> tree_nodes_in_next_level(
+                (tree_nodes_in_level.size() + BRANCHING_FACTOR - 1) / BRANCHING_FACTOR);
+            tbb::parallel_for(
+                tbb::blocked_range<std::uint64_t>(0, tree_nodes_in_next_level.size()),
+                [&](const tbb::blocked_range<std::uint64_t> &range) {
+                    for (auto node_index = range.begin(); node_index != range.end(); ++node_index)
                     {
-                        TreeNode &current_child_node =
-                            tree_nodes_in_level[processed_tree_nodes_in_level];
-                        // add tree node to parent entry
-                        parent_node.children[current_child_node_index] =
-                            TreeIndex{m_search_tree.size(), false};
-                        m_search_tree.emplace_back(current_child_node);
-                        // merge MBRs
-                        parent_node.minimum_bounding_rectangle.MergeBoundingBoxes(
-                            current_child_node.minimum_bounding_rectangle);
-                        // increase counters
-                        ++parent_node.child_count;
-                        ++processed_tree_nodes_in_level;
+                        TreeNode &parent_node = tree_nodes_in_next_level[node_index];
+                        const std::uint64_t first_child = node_index * BRANCHING_FACTOR;
+                        const auto last_child = std::min<std::uint64_t>(
+                            tree_nodes_in_level.size(), first_child + BRANCHING_FACTOR);
+                        for (const auto child_index : irange(first_child, last_child))
+                        {
+                            // add tree node to parent entry and merge MBRs
+                            parent_node.children[parent_node.child_count++] =
+                                TreeIndex{level_begin + child_index, false};
+                            parent_node.minimum_bounding_rectangle.MergeBoundingBoxes(
+                                tree_nodes_in_level[child_index].minimum_bounding_rectangle);
+                        }
                     }
-                }
-                tree_nodes_in_next_level.emplace_back(parent_node);
-            }
+                });
             tree_nodes_in_level.swap(tree_nodes_in_next_level);
-            ++processing_level;
         }
         BOOST_ASSERT_MSG(tree_nodes_in_level.size() == 1, "tree broken, more than one root node");
         // last remaining entry is the root node, store it
@@ -337,6 +377,10 @@ class StaticRTree
         BOOST_ASSERT_MSG(0 < size_of_tree, "tree empty");
         tree_node_file.write((char *)&size_of_tree, sizeof(size_of_tree));
         tree_node_file.write((char *)&m_search_tree[0], sizeof(TreeNode) * size_of_tree);
+        tree_node_file.close();
+        TIMER_STOP(tree_nodes);
+        util::Log() << "r-tree: built " << size_of_tree << " tree nodes in "
+                    << TIMER_SEC(tree_nodes) << " seconds";
 
         MapLeafNodesFile(leaf_node_filename);
     }
@@ -383,6 +427,30 @@ class StaticRTree
         }
     }
 
+    // Replaces the mapped leaves by their delta encoding in memory and unmaps the leaf file.
+    // Every leaf is read once, afterwards queries don't touch the leaf file anymore.
+    void CompressLeaves()
+    {
+        if (m_use_compressed_leaves)
+        {
+            return;
+        }
+
+        m_compressed_leaves = CompressedRTreeLeaves<EdgeDataT>(&m_leaves[0], m_leaves.size());
+        m_use_compressed_leaves = true;
+        m_leaves.reset(nullptr, 0);
+        m_leaves_region.close();
+    }
+
+    bool HasCompressedLeaves() const { return m_use_compressed_leaves; }
+
+    // Size of the leaves in bytes, either of the mapped leaf file or of the compressed leaves
+    std::size_t GetLeavesSize() const
+    {
+        return m_use_compressed_leaves ? m_compressed_leaves.GetSizeInBytes()
+                                       : m_leaves.size() * sizeof(LeafNode);
+    }
+
     /* Returns all features inside the bounding box.
        Rectangle needs to be projected!*/
     std::vector<EdgeDataT> SearchInBox(const Rectangle &search_rectangle) const
@@ -395,6 +463,7 @@ class StaticRTree
             toFixed(FloatLatitude{
                 web_mercator::latToY(toFloating(FixedLatitude(search_rectangle.max_lat)))})};
         std::vector<EdgeDataT> results;
+        std::array<EdgeDataT, LEAF_NODE_SIZE> decoded_objects;
 
         std::queue<TreeIndex> traversal_queue;
         traversal_queue.push(TreeIndex{});
@@ -406,11 +475,12 @@ class StaticRTree
 
             if (current_tree_index.is_leaf)
             {
-                const LeafNode &current_leaf_node = m_leaves[current_tree_index.index];
+                const auto leaf_index = current_tree_index.index;
+                const auto objects = GetLeafObjects(leaf_index, decoded_objects);
 
-                for (const auto i : irange(0u, current_leaf_node.object_count))
+                for (const auto i : irange(0u, GetLeafObjectCount(leaf_index)))
                 {
-                    const auto &current_edge = current_leaf_node.objects[i];
+                    const auto &current_edge = objects[i];
 
                     // we don't need to project the coordinates here,
                     // because we use the unprojected rectangle to test against
@@ -440,7 +510,7 @@ class StaticRTree
                 {
                     const TreeIndex child_id = current_tree_node.children[i];
                     const auto &child_rectangle =
-                        child_id.is_leaf ? m_leaves[child_id.index].minimum_bounding_rectangle
+                        child_id.is_leaf ? GetLeafRectangle(child_id.index)
                                          : m_search_tree[child_id.index].minimum_bounding_rectangle;
 
                     if (child_rectangle.Intersects(projected_rectangle))
@@ -469,6 +539,95 @@ class StaticRTree
     std::vector<EdgeDataT> Nearest(const Coordinate input_coordinate,
                                    const FilterT filter,
                                    const TerminationT terminate) const
+    {
+        ProjectedLeaf projected_leaf;
+        return SearchNearest(input_coordinate,
+                             filter,
+                             terminate,
+                             [this, &projected_leaf](const std::uint32_t leaf_index)
+                                 -> const ProjectedLeaf & {
+                                     ProjectLeaf(leaf_index, projected_leaf);
+                                     return projected_leaf;
+                                 });
+    }
+
+    // Runs a nearest query for every input coordinate, the results are in the order of the input
+    std::vector<std::vector<EdgeDataT>> Nearest(const std::vector<Coordinate> &input_coordinates,
+                                                const std::size_t max_results) const
+    {
+        return Nearest(
+            input_coordinates,
+            [](const std::size_t, const CandidateSegment &) { return std::make_pair(true, true); },
+            [max_results](const std::size_t,
+                          const std::size_t num_results,
+                          const CandidateSegment &) { return num_results >= max_results; });
+    }
+
+    // Runs a nearest query for every input coordinate, the filter and terminator get the index of
+    // the query as first argument. The queries run in the order of the Hilbert values of their
+    // coordinates, so consecutive queries visit the same nodes and leaves, and the projections of
+    // the leaves are shared between them.
+    template <typename FilterT, typename TerminationT>
+    std::vector<std::vector<EdgeDataT>> Nearest(const std::vector<Coordinate> &input_coordinates,
+                                                const FilterT filter,
+                                                const TerminationT terminate) const
+    {
+        std::vector<std::pair<std::uint64_t, std::size_t>> query_order;
+        query_order.reserve(input_coordinates.size());
+        for (const auto query : irange<std::size_t>(0, input_coordinates.size()))
+        {
+            auto projected_coordinate = input_coordinates[query];
+            projected_coordinate.lat = FixedLatitude{static_cast<std::int32_t>(
+                COORDINATE_PRECISION *
+                web_mercator::latToY(toFloating(projected_coordinate.lat)))};
+            query_order.emplace_back(GetHilbertCode(projected_coordinate), query);
+        }
+        std::sort(query_order.begin(), query_order.end());
+
+        std::array<std::uint32_t, PROJECTED_LEAF_CACHE_SIZE> cached_leaf_indices;
+        cached_leaf_indices.fill(std::numeric_limits<std::uint32_t>::max());
+        std::array<std::unique_ptr<ProjectedLeaf>, PROJECTED_LEAF_CACHE_SIZE> cached_leaves;
+        const auto get_projected_leaf =
+            [&](const std::uint32_t leaf_index) -> const ProjectedLeaf & {
+            const auto slot = leaf_index % PROJECTED_LEAF_CACHE_SIZE;
+            if (!cached_leaves[slot])
+            {
+                cached_leaves[slot] = std::make_unique<ProjectedLeaf>();
+            }
+            if (cached_leaf_indices[slot] != leaf_index)
+            {
+                ProjectLeaf(leaf_index, *cached_leaves[slot]);
+                cached_leaf_indices[slot] = leaf_index;
+            }
+            return *cached_leaves[slot];
+        };
+
+        std::vector<std::vector<EdgeDataT>> results(input_coordinates.size());
+        for (const auto &entry : query_order)
+        {
+            const auto query = entry.second;
+            results[query] = SearchNearest(
+                input_coordinates[query],
+                [&filter, query](const CandidateSegment &segment) {
+                    return filter(query, segment);
+                },
+                [&terminate, query](const std::size_t num_results,
+                                    const CandidateSegment &segment) {
+                    return terminate(query, num_results, segment);
+                },
+                get_projected_leaf);
+        }
+
+        return results;
+    }
+
+  private:
+    // Best-first search of [2], get_projected_leaf returns the projection of a leaf
+    template <typename FilterT, typename TerminationT, typename ProjectedLeafT>
+    std::vector<EdgeDataT> SearchNearest(const Coordinate input_coordinate,
+                                         const FilterT &filter,
+                                         const TerminationT &terminate,
+                                         const ProjectedLeafT &get_projected_leaf) const
     {
         std::vector<EdgeDataT> results;
         auto projected_coordinate = web_mercator::fromWGS84(input_coordinate);
@@ -477,6 +636,7 @@ class StaticRTree
         // initialize queue with root element
         std::priority_queue<QueryCandidate> traversal_queue;
         traversal_queue.push(QueryCandidate{0, TreeIndex{}});
+        std::vector<SegmentCandidate> segment_candidates;
 
         while (!traversal_queue.empty())
         {
@@ -489,9 +649,11 @@ class StaticRTree
                 if (current_tree_index.is_leaf)
                 {
                     ExploreLeafNode(current_tree_index,
+                                    get_projected_leaf(current_tree_index.index),
                                     fixed_projected_coordinate,
                                     projected_coordinate,
-                                    traversal_queue);
+                                    traversal_queue,
+                                    segment_candidates);
                 }
                 else
                 {
@@ -501,10 +663,21 @@ class StaticRTree
             }
             else
             { // current candidate is an actual road segment
+                const auto candidate_index = current_query_node.candidate_index;
+                const auto segment_candidate = segment_candidates[candidate_index];
+                if (!segment_candidate.is_last_of_leaf)
+                {
+                    // the next segment of the leaf can be taken now
+                    traversal_queue.push(
+                        QueryCandidate{segment_candidates[candidate_index + 1].squared_distance,
+                                       current_tree_index,
+                                       candidate_index + 1});
+                }
+
                 auto edge_data =
-                    m_leaves[current_tree_index.index].objects[current_query_node.segment_index];
+                    GetLeafObject(current_tree_index.index, segment_candidate.segment_index);
                 const auto &current_candidate =
-                    CandidateSegment{current_query_node.fixed_projected_coordinate, edge_data};
+                    CandidateSegment{segment_candidate.fixed_projected_coordinate, edge_data};
 
                 // to allow returns of no-results if too restrictive filtering, this needs to be
                 // done here even though performance would indicate that we want to stop after
@@ -530,34 +703,155 @@ class StaticRTree
         return results;
     }
 
-  private:
+    std::uint32_t GetLeafObjectCount(const std::uint32_t leaf_index) const
+    {
+        return m_use_compressed_leaves ? m_compressed_leaves.GetObjectCount(leaf_index)
+                                       : m_leaves[leaf_index].object_count;
+    }
+
+    const Rectangle &GetLeafRectangle(const std::uint32_t leaf_index) const
+    {
+        return m_use_compressed_leaves ? m_compressed_leaves.GetRectangle(leaf_index)
+                                       : m_leaves[leaf_index].minimum_bounding_rectangle;
+    }
+
+    // Returns the objects of a leaf, compressed leaves are decoded into decoded_objects
+    const EdgeDataT *
+    GetLeafObjects(const std::uint32_t leaf_index,
+                   std::array<EdgeDataT, LEAF_NODE_SIZE> &decoded_objects) const
+    {
+        if (!m_use_compressed_leaves)
+        {
+            return m_leaves[leaf_index].objects.data();
+        }
+        m_compressed_leaves.Decode(leaf_index, decoded_objects.data());
+        return decoded_objects.data();
+    }
+
+    EdgeDataT GetLeafObject(const std::uint32_t leaf_index, const std::uint32_t object_index) const
+    {
+        return m_use_compressed_leaves ? m_compressed_leaves.GetObject(leaf_index, object_index)
+                                       : m_leaves[leaf_index].objects[object_index];
+    }
+
+    // Fills the leaf with the elements of the given leaf index in Hilbert order. The leaf is
+    // cleared first, which makes the leaf file independent of the order the leaves are packed in.
+    void PackLeaf(const std::vector<EdgeDataT> &input_data_vector,
+                  const std::vector<WrappedInputElement> &input_wrapper_vector,
+                  const std::uint64_t leaf_index,
+                  LeafNode &leaf) const
+    {
+        static const EdgeDataT empty_object;
+
+        std::memset(static_cast<void *>(&leaf), 0, sizeof(LeafNode));
+        leaf.minimum_bounding_rectangle = Rectangle{};
+        leaf.objects.fill(empty_object);
+
+        const std::uint64_t first_element = leaf_index * LEAF_NODE_SIZE;
+        const auto last_element = std::min<std::uint64_t>(input_wrapper_vector.size(),
+                                                          first_element + LEAF_NODE_SIZE);
+        leaf.object_count = last_element - first_element;
+
+        Rectangle &rectangle = leaf.minimum_bounding_rectangle;
+        for (const auto wrapped_element_index : irange(first_element, last_element))
+        {
+            const std::uint32_t input_object_index =
+                input_wrapper_vector[wrapped_element_index].m_array_index;
+            const EdgeDataT &object = input_data_vector[input_object_index];
+
+            leaf.objects[wrapped_element_index - first_element] = object;
+
+            Coordinate projected_u{
+                web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.u]})};
+            Coordinate projected_v{
+                web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.v]})};
+
+            BOOST_ASSERT(std::abs(toFloating(projected_u.lon).operator double()) <= 180.);
+            BOOST_ASSERT(std::abs(toFloating(projected_u.lat).operator double()) <= 180.);
+            BOOST_ASSERT(std::abs(toFloating(projected_v.lon).operator double()) <= 180.);
+            BOOST_ASSERT(std::abs(toFloating(projected_v.lat).operator double()) <= 180.);
+
+            rectangle.min_lon =
+                std::min(rectangle.min_lon, std::min(projected_u.lon, projected_v.lon));
+            rectangle.max_lon =
+                std::max(rectangle.max_lon, std::max(projected_u.lon, projected_v.lon));
+
+            rectangle.min_lat =
+                std::min(rectangle.min_lat, std::min(projected_u.lat, projected_v.lat));
+            rectangle.max_lat =
+                std::max(rectangle.max_lat, std::max(projected_u.lat, projected_v.lat));
+
+            BOOST_ASSERT(rectangle.IsValid());
+        }
+    }
+
+    void ProjectLeaf(const std::uint32_t leaf_index, ProjectedLeaf &projected_leaf) const
+    {
+        projected_leaf.object_count = GetLeafObjectCount(leaf_index);
+        projected_leaf.objects = GetLeafObjects(leaf_index, projected_leaf.decoded_objects);
+        for (const auto i : irange(0u, projected_leaf.object_count))
+        {
+            const auto &current_edge = projected_leaf.objects[i];
+            const auto u = web_mercator::fromWGS84(m_coordinate_list[current_edge.u]);
+            const auto v = web_mercator::fromWGS84(m_coordinate_list[current_edge.v]);
+            projected_leaf.u_lon[i] = static_cast<double>(u.lon);
+            projected_leaf.u_lat[i] = static_cast<double>(u.lat);
+            projected_leaf.v_lon[i] = static_cast<double>(v.lon);
+            projected_leaf.v_lat[i] = static_cast<double>(v.lat);
+        }
+    }
+
+    // Projects the query onto all segments of the leaf at once. Instead of pushing every segment
+    // into the queue, the segments are sorted by distance and only the nearest one enters the
+    // queue, each segment taken out of the queue brings in the next one of its leaf.
     template <typename QueueT>
     void ExploreLeafNode(const TreeIndex &leaf_id,
+                         const ProjectedLeaf &projected_leaf,
                          const Coordinate &projected_input_coordinate_fixed,
                          const FloatCoordinate &projected_input_coordinate,
-                         QueueT &traversal_queue) const
+                         QueueT &traversal_queue,
+                         std::vector<SegmentCandidate> &segment_candidates) const
     {
-        const LeafNode &current_leaf_node = m_leaves[leaf_id.index];
+        const auto object_count = projected_leaf.object_count;
+        if (object_count == 0)
+        {
+            return;
+        }
 
-        // current object represents a block on disk
-        for (const auto i : irange(0u, current_leaf_node.object_count))
+        std::array<std::int32_t, LEAF_NODE_SIZE> nearest_lon;
+        std::array<std::int32_t, LEAF_NODE_SIZE> nearest_lat;
+        std::array<std::uint64_t, LEAF_NODE_SIZE> squared_distances;
+        const segment_projection::Segments segments{projected_leaf.u_lon.data(),
+                                                    projected_leaf.u_lat.data(),
+                                                    projected_leaf.v_lon.data(),
+                                                    projected_leaf.v_lat.data()};
+        const segment_projection::Results results{
+            nearest_lon.data(), nearest_lat.data(), squared_distances.data()};
+        segment_projection::Project(segments,
+                                    object_count,
+                                    projected_input_coordinate,
+                                    projected_input_coordinate_fixed,
+                                    results);
+
+        const auto first_candidate = static_cast<std::uint32_t>(segment_candidates.size());
+        for (const auto i : irange(0u, object_count))
         {
-            const auto &current_edge = current_leaf_node.objects[i];
-            const auto projected_u = web_mercator::fromWGS84(m_coordinate_list[current_edge.u]);
-            const auto projected_v = web_mercator::fromWGS84(m_coordinate_list[current_edge.v]);
-
-            FloatCoordinate projected_nearest;
-            std::tie(std::ignore, projected_nearest) =
-                coordinate_calculation::projectPointOnSegment(
-                    projected_u, projected_v, projected_input_coordinate);
-
-            const auto squared_distance = coordinate_calculation::squaredEuclideanDistance(
-                projected_input_coordinate_fixed, projected_nearest);
-            // distance must be non-negative
-            BOOST_ASSERT(0. <= squared_distance);
-            traversal_queue.push(
-                QueryCandidate{squared_distance, leaf_id, i, Coordinate{projected_nearest}});
+            segment_candidates.push_back({squared_distances[i],
+                                          i,
+                                          false,
+                                          Coordinate{FixedLongitude{nearest_lon[i]},
+                                                     FixedLatitude{nearest_lat[i]}}});
         }
+        std::sort(segment_candidates.begin() + first_candidate,
+                  segment_candidates.end(),
+                  [](const SegmentCandidate &lhs, const SegmentCandidate &rhs) {
+                      return std::tie(lhs.squared_distance, lhs.segment_index) <
+                             std::tie(rhs.squared_distance, rhs.segment_index);
+                  });
+        segment_candidates.back().is_last_of_leaf = true;
+
+        traversal_queue.push(QueryCandidate{
+            segment_candidates[first_candidate].squared_distance, leaf_id, first_candidate});
     }
 
     template <class QueueT>
@@ -570,7 +864,7 @@ class StaticRTree
         {
             const TreeIndex child_id = parent.children[i];
             const auto &child_rectangle =
-                child_id.is_leaf ? m_leaves[child_id.index].minimum_bounding_rectangle
+                child_id.is_leaf ? GetLeafRectangle(child_id.index)
                                  : m_search_tree[child_id.index].minimum_bounding_rectangle;
             const auto squared_lower_bound_to_element =
                 child_rectangle.GetMinSquaredDist(fixed_projected_input_coordinate);
@@ -3,6 +3,7 @@
 
 #include <cctype>
 
+#include <iterator>
 #include <random>
 #include <string>
 #include <vector>
@@ -99,6 +100,29 @@ inline std::string escape_JSON(const std::string &input)
     return output;
 }
 
+// Appends the escaped input to output, copies runs without special characters in one go
+inline void escape_JSON(const std::string &input, std::vector<char> &output)
+{
+    const auto needs_escaping = [](const char letter) {
+        return letter == '\\' || letter == '"' || letter == '/' || letter == '\b' ||
+               letter == '\f' || letter == '\n' || letter == '\r' || letter == '\t';
+    };
+
+    auto run_begin = input.begin();
+    for (auto iter = input.begin(); iter != input.end(); ++iter)
+    {
+        if (!needs_escaping(*iter))
+        {
+            continue;
+        }
+        output.insert(output.end(), run_begin, iter);
+        const auto escaped = escape_JSON(std::string(1, *iter));
+        output.insert(output.end(), escaped.begin(), escaped.end());
+        run_begin = std::next(iter);
+    }
+    output.insert(output.end(), run_begin, input.end());
+}
+
 inline std::size_t URIDecode(const std::string &input, std::string &output)
 {
     auto src_iter = std::begin(input);
@@ -86,6 +86,11 @@ static const EdgeWeight INVALID_EDGE_WEIGHT = std::numeric_limits<EdgeWeight>::m
 
 using DatasourceID = std::uint8_t;
 
+// levels and cells of a multi-level partition, level 0 is the base graph
+using LevelID = std::uint8_t;
+using CellID = std::uint32_t;
+static const CellID INVALID_CELL_ID = std::numeric_limits<CellID>::max();
+
 struct SegmentID
 {
     SegmentID(const NodeID id_, const bool enabled_) : id{id_}, enabled{enabled_}
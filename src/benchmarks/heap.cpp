@@ -0,0 +1,188 @@
+#include "util/binary_heap.hpp"
+#include "util/d_ary_heap.hpp"
+#include "util/radix_heap.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+#include "util/xor_fast_hash_storage.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+constexpr unsigned GRID_SIZE = 500;
+constexpr unsigned NUM_QUERIES = 20;
+// roughly the size of a witness search in the contractor
+constexpr unsigned NUM_LOCAL_QUERIES = 5000;
+constexpr unsigned LOCAL_SEARCH_SPACE_SIZE = 2000;
+
+struct HeapData
+{
+    NodeID parent;
+    /* explicit */ HeapData(NodeID p) : parent(p) {}
+};
+
+struct Edge
+{
+    NodeID target;
+    EdgeWeight weight;
+};
+
+// Grid graph with random weights, resembling the degree distribution of road networks
+struct Graph
+{
+    Graph(const unsigned size) : offsets(size * size + 1)
+    {
+        std::mt19937 generator(RANDOM_SEED);
+        std::uniform_int_distribution<EdgeWeight> weight_distribution(1, 1000);
+
+        for (unsigned y = 0; y < size; ++y)
+        {
+            for (unsigned x = 0; x < size; ++x)
+            {
+                const NodeID node = y * size + x;
+                offsets[node] = static_cast<unsigned>(edges.size());
+                if (x > 0)
+                    edges.push_back({node - 1, weight_distribution(generator)});
+                if (x + 1 < size)
+                    edges.push_back({node + 1, weight_distribution(generator)});
+                if (y > 0)
+                    edges.push_back({node - size, weight_distribution(generator)});
+                if (y + 1 < size)
+                    edges.push_back({node + size, weight_distribution(generator)});
+            }
+        }
+        offsets.back() = static_cast<unsigned>(edges.size());
+    }
+
+    unsigned GetNumberOfNodes() const { return static_cast<unsigned>(offsets.size() - 1); }
+
+    std::vector<unsigned> offsets;
+    std::vector<Edge> edges;
+};
+
+template <typename HeapT>
+std::uint64_t
+Dijkstra(const Graph &graph, HeapT &heap, const NodeID source, const unsigned max_settled)
+{
+    heap.Clear();
+    heap.Insert(source, 0, source);
+    std::uint64_t checksum = 0;
+    unsigned settled = 0;
+    while (!heap.Empty() && settled++ < max_settled)
+    {
+        const NodeID node = heap.DeleteMin();
+        const EdgeWeight weight = heap.GetKey(node);
+        checksum += weight;
+        for (auto edge = graph.offsets[node]; edge < graph.offsets[node + 1]; ++edge)
+        {
+            const NodeID to = graph.edges[edge].target;
+            const EdgeWeight to_weight = weight + graph.edges[edge].weight;
+            if (!heap.WasInserted(to))
+            {
+                heap.Insert(to, to_weight, node);
+            }
+            else if (to_weight < heap.GetKey(to))
+            {
+                heap.GetData(to).parent = node;
+                heap.DecreaseKey(to, to_weight);
+            }
+        }
+    }
+    return checksum;
+}
+
+template <typename HeapT>
+void benchmarkHeap(const Graph &graph,
+                   const std::vector<NodeID> &sources,
+                   const unsigned num_queries,
+                   const unsigned max_settled,
+                   const std::string &name)
+{
+    HeapT heap(graph.GetNumberOfNodes());
+
+    std::cout << "Running " << name << " with " << num_queries << " queries: " << std::flush;
+    std::uint64_t checksum = 0;
+    TIMER_START(query);
+    for (unsigned i = 0; i < num_queries; ++i)
+    {
+        checksum += Dijkstra(graph, heap, sources[i % sources.size()], max_settled);
+    }
+    TIMER_STOP(query);
+    std::cout << "Took " << TIMER_MSEC(query) << " msec (" << TIMER_MSEC(query) / num_queries
+              << " msec/query, checksum " << checksum << ")" << std::endl;
+}
+
+template <template <typename> class HeapT>
+void benchmarkStorages(const Graph &graph,
+                       const std::vector<NodeID> &sources,
+                       const unsigned num_queries,
+                       const unsigned max_settled,
+                       const std::string &name)
+{
+    benchmarkHeap<HeapT<util::ArrayStorage<NodeID, NodeID>>>(
+        graph, sources, num_queries, max_settled, name + " ArrayStorage");
+    benchmarkHeap<HeapT<util::UnorderedMapStorage<NodeID, int>>>(
+        graph, sources, num_queries, max_settled, name + " UnorderedMapStorage");
+    benchmarkHeap<HeapT<util::GenerationArrayStorage<NodeID, int>>>(
+        graph, sources, num_queries, max_settled, name + " GenerationArrayStorage");
+    // the hash table has a fixed capacity, only use it for searches with a bounded size
+    if (max_settled <= LOCAL_SEARCH_SPACE_SIZE)
+    {
+        benchmarkHeap<HeapT<util::XORFastHashStorage<NodeID, NodeID>>>(
+            graph, sources, num_queries, max_settled, name + " XORFastHashStorage");
+    }
+}
+
+template <typename Storage>
+using BinaryHeap = util::BinaryHeap<NodeID, NodeID, int, HeapData, Storage>;
+template <typename Storage>
+using QuaternaryHeap = util::DAryHeap<NodeID, NodeID, int, HeapData, Storage, 4>;
+template <typename Storage>
+using OctaryHeap = util::DAryHeap<NodeID, NodeID, int, HeapData, Storage, 8>;
+template <typename Storage>
+using RadixHeap = util::RadixHeap<NodeID, NodeID, int, HeapData, Storage>;
+}
+}
+
+int main(int argc, char **argv)
+{
+    using namespace osrm::benchmarks;
+
+    const unsigned grid_size = argc > 1 ? std::stoul(argv[1]) : GRID_SIZE;
+    const Graph graph(grid_size);
+
+    std::mt19937 generator(RANDOM_SEED);
+    std::uniform_int_distribution<NodeID> node_distribution(0, graph.GetNumberOfNodes() - 1);
+    std::vector<NodeID> sources(NUM_QUERIES);
+    std::generate(sources.begin(), sources.end(), [&] { return node_distribution(generator); });
+
+    std::cout << "Full searches on a " << grid_size << "x" << grid_size << " grid" << std::endl;
+    const auto all = std::numeric_limits<unsigned>::max();
+    benchmarkStorages<BinaryHeap>(graph, sources, NUM_QUERIES, all, "BinaryHeap");
+    benchmarkStorages<QuaternaryHeap>(graph, sources, NUM_QUERIES, all, "DAryHeap<4>");
+    benchmarkStorages<OctaryHeap>(graph, sources, NUM_QUERIES, all, "DAryHeap<8>");
+    benchmarkStorages<RadixHeap>(graph, sources, NUM_QUERIES, all, "RadixHeap");
+
+    std::cout << "Local searches settling " << LOCAL_SEARCH_SPACE_SIZE << " nodes" << std::endl;
+    const auto local = LOCAL_SEARCH_SPACE_SIZE;
+    benchmarkStorages<BinaryHeap>(graph, sources, NUM_LOCAL_QUERIES, local, "BinaryHeap");
+    benchmarkStorages<QuaternaryHeap>(graph, sources, NUM_LOCAL_QUERIES, local, "DAryHeap<4>");
+    benchmarkStorages<OctaryHeap>(graph, sources, NUM_LOCAL_QUERIES, local, "DAryHeap<8>");
+    benchmarkStorages<RadixHeap>(graph, sources, NUM_LOCAL_QUERIES, local, "RadixHeap");
+
+    return EXIT_SUCCESS;
+}
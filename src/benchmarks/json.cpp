@@ -0,0 +1,298 @@
+#include "util/cast.hpp"
+#include "util/json_arena.hpp"
+#include "util/json_container.hpp"
+#include "util/json_renderer.hpp"
+#include "util/timing_util.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Counts the heap allocations through the global operator new, the benchmark is single threaded.
+// Object and Array nodes outside of an arena come from json::detail::AllocateAligned and are
+// not included.
+static std::size_t number_of_heap_allocations = 0;
+
+void *operator new(std::size_t size)
+{
+    ++number_of_heap_allocations;
+    if (void *pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+constexpr unsigned NUM_RESPONSES = 200;
+// roughly a long car route with steps and annotations
+constexpr unsigned NUM_LEGS = 3;
+constexpr unsigned NUM_STEPS = 150;
+constexpr unsigned NUM_SEGMENTS = 1000;
+constexpr unsigned TABLE_SIZE = 1000;
+constexpr unsigned GEOMETRY_SIZE = 10000;
+
+using namespace util;
+
+json::Object makeStep(const unsigned index)
+{
+    json::Object maneuver;
+    maneuver.values["type"] = "turn";
+    maneuver.values["modifier"] = "left";
+    maneuver.values["bearing_before"] = 90.;
+    maneuver.values["bearing_after"] = 0.;
+    maneuver.values["location"] = json::Array{{7.4 + index * 1e-4, 43.7}};
+
+    json::Array intersections;
+    for (unsigned i = 0; i < 2; ++i)
+    {
+        json::Object intersection;
+        intersection.values["location"] = json::Array{{7.4 + index * 1e-4, 43.7}};
+        intersection.values["bearings"] = json::Array{{0., 90., 180., 270.}};
+        intersection.values["entry"] = json::Array{{json::True(), json::False(), json::True()}};
+        intersection.values["in"] = 1.;
+        intersection.values["out"] = 2.;
+        intersections.values.push_back(std::move(intersection));
+    }
+
+    json::Object step;
+    step.values["distance"] = 152.3;
+    step.values["duration"] = 17.1;
+    step.values["name"] = "Boulevard";
+    step.values["mode"] = "driving";
+    step.values["geometry"] = "}_ygFsfkl@cDhCmB|AkC|B";
+    step.values["maneuver"] = std::move(maneuver);
+    step.values["intersections"] = std::move(intersections);
+    return step;
+}
+
+json::Object makeResponse()
+{
+    json::Array legs;
+    for (unsigned leg_index = 0; leg_index < NUM_LEGS; ++leg_index)
+    {
+        json::Array steps;
+        steps.values.reserve(NUM_STEPS);
+        for (unsigned step_index = 0; step_index < NUM_STEPS; ++step_index)
+        {
+            steps.values.push_back(makeStep(step_index));
+        }
+
+        json::Array distances;
+        json::Array durations;
+        json::Array nodes;
+        for (unsigned segment = 0; segment < NUM_SEGMENTS; ++segment)
+        {
+            distances.values.push_back(12.5);
+            durations.values.push_back(1.3);
+            nodes.values.push_back(static_cast<double>(segment));
+        }
+        json::Object annotation;
+        annotation.values["distance"] = std::move(distances);
+        annotation.values["duration"] = std::move(durations);
+        annotation.values["nodes"] = std::move(nodes);
+
+        json::Object leg;
+        leg.values["distance"] = 20000.;
+        leg.values["duration"] = 1500.;
+        leg.values["summary"] = "Boulevard, Avenue";
+        leg.values["steps"] = std::move(steps);
+        leg.values["annotation"] = std::move(annotation);
+        legs.values.push_back(std::move(leg));
+    }
+
+    json::Object route;
+    route.values["distance"] = 60000.;
+    route.values["duration"] = 4500.;
+    route.values["legs"] = std::move(legs);
+
+    json::Object response;
+    response.values["code"] = "Ok";
+    response.values["routes"] = json::Array{{std::move(route)}};
+    return response;
+}
+
+json::Object makeTable()
+{
+    json::Array durations;
+    durations.values.reserve(TABLE_SIZE);
+    for (unsigned row = 0; row < TABLE_SIZE; ++row)
+    {
+        json::Array json_row;
+        json_row.values.reserve(TABLE_SIZE);
+        for (unsigned column = 0; column < TABLE_SIZE; ++column)
+        {
+            // deciseconds like the table plugin
+            json_row.values.push_back(((row * 7919 + column * 104729) % 36000) / 10.);
+        }
+        durations.values.push_back(std::move(json_row));
+    }
+
+    json::Object response;
+    response.values["code"] = "Ok";
+    response.values["durations"] = std::move(durations);
+    return response;
+}
+
+json::Object makeGeometry()
+{
+    json::Array coordinates;
+    coordinates.values.reserve(GEOMETRY_SIZE);
+    for (unsigned i = 0; i < GEOMETRY_SIZE; ++i)
+    {
+        // fixed point coordinates like util::Coordinate
+        coordinates.values.push_back(json::Array{{static_cast<int>(7409170 + 3 * i) / 1e6,
+                                                  static_cast<int>(43724470 + 2 * i) / 1e6}});
+    }
+
+    json::Object geometry;
+    geometry.values["type"] = "LineString";
+    geometry.values["coordinates"] = std::move(coordinates);
+    return geometry;
+}
+
+// The number formatting ArrayRenderer used before, for comparison
+struct IostreamNumberRenderer
+{
+    explicit IostreamNumberRenderer(std::vector<char> &out_) : out(out_) {}
+
+    void operator()(const json::Number &number) const
+    {
+        const auto number_string = cast::to_string_with_precision(number.value);
+        out.insert(out.end(), number_string.begin(), number_string.end());
+    }
+
+    void operator()(const json::Array &array) const
+    {
+        out.push_back('[');
+        for (auto it = array.values.cbegin(), end = array.values.cend(); it != end;)
+        {
+            mapbox::util::apply_visitor(*this, *it);
+            if (++it != end)
+            {
+                out.push_back(',');
+            }
+        }
+        out.push_back(']');
+    }
+
+    template <typename T> void operator()(const T &value) const { json::ArrayRenderer{out}(value); }
+
+    void render(const json::Object &object) const
+    {
+        out.push_back('{');
+        for (auto it = object.values.begin(), end = object.values.end(); it != end;)
+        {
+            out.push_back('\"');
+            out.insert(out.end(), it->first.begin(), it->first.end());
+            out.insert(out.end(), {'\"', ':'});
+            mapbox::util::apply_visitor(*this, it->second);
+            if (++it != end)
+            {
+                out.push_back(',');
+            }
+        }
+        out.push_back('}');
+    }
+
+    std::vector<char> &out;
+};
+
+// Renders a number heavy response into a preallocated buffer
+void benchmarkRendering(const std::string &name, const json::Object &response)
+{
+    const unsigned NUM_RENDERS = 5;
+
+    std::vector<char> legacy_output;
+    TIMER_START(legacy);
+    for (unsigned i = 0; i < NUM_RENDERS; ++i)
+    {
+        legacy_output.clear();
+        IostreamNumberRenderer{legacy_output}.render(response);
+    }
+    TIMER_STOP(legacy);
+
+    std::vector<char> output;
+    output.reserve(legacy_output.size());
+    TIMER_START(render);
+    for (unsigned i = 0; i < NUM_RENDERS; ++i)
+    {
+        output.clear();
+        json::render(output, response);
+    }
+    TIMER_STOP(render);
+
+    if (output != legacy_output)
+    {
+        throw std::runtime_error(name + " renders differently than before");
+    }
+
+    std::cout << name << ": " << (TIMER_MSEC(render) / NUM_RENDERS) << "ms/render ("
+              << (TIMER_MSEC(legacy) / NUM_RENDERS) << "ms with iostreams) for "
+              << output.size() << " bytes" << std::endl;
+}
+
+// Builds and renders responses like the RequestHandler does, with or without an arena
+void benchmark(const bool use_arena)
+{
+    std::size_t number_of_arena_allocations = 0;
+    std::size_t number_of_bytes = 0;
+    const auto heap_allocations_before = number_of_heap_allocations;
+
+    TIMER_START(responses);
+    for (unsigned i = 0; i < NUM_RESPONSES; ++i)
+    {
+        std::vector<char> output;
+        json::Arena arena;
+        {
+            std::unique_ptr<json::ArenaScope> scope;
+            if (use_arena)
+            {
+                scope.reset(new json::ArenaScope(arena));
+            }
+            const auto response = makeResponse();
+            json::render(output, response);
+        }
+        number_of_arena_allocations += arena.NumberOfAllocations();
+        number_of_bytes += output.size();
+    }
+    TIMER_STOP(responses);
+
+    const auto heap_allocations = number_of_heap_allocations - heap_allocations_before;
+    std::cout << (use_arena ? "arena" : "heap ") << ": " << (TIMER_MSEC(responses) / NUM_RESPONSES)
+              << "ms/response, " << (heap_allocations / NUM_RESPONSES) << " heap allocations and "
+              << (number_of_arena_allocations / NUM_RESPONSES) << " arena allocations/response, "
+              << (number_of_bytes / NUM_RESPONSES) << " bytes/response" << std::endl;
+}
+}
+}
+
+int main(int, char **) try
+{
+    osrm::benchmarks::benchmark(false);
+    osrm::benchmarks::benchmark(true);
+    osrm::benchmarks::benchmarkRendering("1000x1000 table", osrm::benchmarks::makeTable());
+    osrm::benchmarks::benchmarkRendering("10k point GeoJSON geometry",
+                                         osrm::benchmarks::makeGeometry());
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,84 @@
+#include "util/timing_util.hpp"
+
+#include "osrm/route_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <boost/assert.hpp>
+
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+
+#include <cstdlib>
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm\n";
+        return EXIT_FAILURE;
+    }
+
+    using namespace osrm;
+
+    // Configure based on a .osrm base path, and no datasets in shared mem from osrm-datastore
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+
+    // Routing machine with several services (such as Route, Table, Nearest, Trip, Match)
+    OSRM osrm{config};
+
+    using osrm::util::FloatCoordinate;
+    using osrm::util::FloatLatitude;
+    using osrm::util::FloatLongitude;
+
+    // Random routes in monaco, the bounding box is chosen to cover the whole extract
+    // Choosen by a fair W20 dice roll (this value is completely arbitrary)
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> lon_distribution(7.40917, 7.43883);
+    std::uniform_real_distribution<double> lat_distribution(43.72447, 43.75218);
+
+    const auto NUM = 1000;
+    std::vector<RouteParameters> queries(NUM);
+    for (auto &params : queries)
+    {
+        params.overview = RouteParameters::OverviewType::False;
+        params.steps = false;
+        params.alternatives = false;
+        for (auto i = 0; i < 2; ++i)
+        {
+            params.coordinates.push_back(
+                FloatCoordinate{FloatLongitude{lon_distribution(generator)},
+                                FloatLatitude{lat_distribution(generator)}});
+        }
+    }
+
+    TIMER_START(routes);
+    for (const auto &params : queries)
+    {
+        json::Object result;
+        const auto rc = osrm.Route(params, result);
+        if (rc != Status::Ok)
+        {
+            return EXIT_FAILURE;
+        }
+    }
+    TIMER_STOP(routes);
+    std::cout << (TIMER_MSEC(routes) / NUM) << "ms/req at " << NUM << " routes" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -70,6 +70,10 @@ void benchmarkQuery(const std::vector<util::Coordinate> &queries,
 
 void benchmark(BenchStaticRTree &rtree, unsigned num_queries)
 {
+    std::cout << "Leaves: " << rtree.GetLeavesSize() / (1024. * 1024.) << " MiB "
+              << (rtree.HasCompressedLeaves() ? "compressed in memory" : "mapped from file")
+              << std::endl;
+
     std::mt19937 mt_rand(RANDOM_SEED);
     std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
     std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
@@ -109,5 +113,12 @@ int main(int argc, char **argv)
 
     osrm::benchmarks::benchmark(rtree, 10000);
 
+    TIMER_START(compress);
+    rtree.CompressLeaves();
+    TIMER_STOP(compress);
+    std::cout << "Compressed the leaves in " << TIMER_SEC(compress) << " seconds" << std::endl;
+
+    osrm::benchmarks::benchmark(rtree, 10000);
+
     return 0;
 }
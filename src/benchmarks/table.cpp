@@ -0,0 +1,89 @@
+#include "util/timing_util.hpp"
+
+#include "osrm/table_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <boost/assert.hpp>
+
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+
+#include <cstdlib>
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2 || (argc > 3 && argc != 7))
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " data.osrm [size] [min_lon min_lat max_lon max_lat]\n";
+        return EXIT_FAILURE;
+    }
+
+    using namespace osrm;
+
+    const std::size_t size = argc > 2 ? std::stoul(argv[2]) : 100;
+
+    // Configure based on a .osrm base path, and no datasets in shared mem from osrm-datastore
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+
+    // Routing machine with several services (such as Route, Table, Nearest, Trip, Match)
+    OSRM osrm{config};
+
+    using osrm::util::FloatCoordinate;
+    using osrm::util::FloatLatitude;
+    using osrm::util::FloatLongitude;
+
+    // Random size x size table, by default the bounding box covers the whole monaco extract.
+    // Pass the bounding box of a bigger extract (e.g. a city) for realistic large tables.
+    const bool has_bbox = argc == 7;
+    const double min_lon = has_bbox ? std::stod(argv[3]) : 7.40917;
+    const double min_lat = has_bbox ? std::stod(argv[4]) : 43.72447;
+    const double max_lon = has_bbox ? std::stod(argv[5]) : 7.43883;
+    const double max_lat = has_bbox ? std::stod(argv[6]) : 43.75218;
+
+    // Choosen by a fair W20 dice roll (this value is completely arbitrary)
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> lon_distribution(min_lon, max_lon);
+    std::uniform_real_distribution<double> lat_distribution(min_lat, max_lat);
+
+    TableParameters params;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        params.coordinates.push_back(FloatCoordinate{FloatLongitude{lon_distribution(generator)},
+                                                     FloatLatitude{lat_distribution(generator)}});
+    }
+
+    TIMER_START(tables);
+    auto NUM = 10;
+    for (int i = 0; i < NUM; ++i)
+    {
+        json::Object result;
+        const auto rc = osrm.Table(params, result);
+        if (rc != Status::Ok ||
+            result.values.at("durations").get<json::Array>().values.size() != size)
+        {
+            return EXIT_FAILURE;
+        }
+    }
+    TIMER_STOP(tables);
+    std::cout << (TIMER_MSEC(tables) / NUM) << "ms/req at " << size << "x" << size << " table"
+              << std::endl;
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -7,6 +7,7 @@
 #include "extractor/node_based_edge.hpp"
 
 #include "storage/io.hpp"
+#include "storage/serialization.hpp"
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
 #include "util/graph_loader.hpp"
@@ -133,6 +134,10 @@ int Contractor::Run()
     {
         throw util::exception("Core factor must be between 0.0 to 1.0 (inclusive)" + SOURCE_REF);
     }
+    if (config.use_previous_hierarchy && config.core_factor != 1.0)
+    {
+        throw util::exception("Incremental contraction needs a core factor of 1.0" + SOURCE_REF);
+    }
 
     TIMER_START(preparing);
 
@@ -170,25 +175,37 @@ int Contractor::Run()
     TIMER_START(contraction);
     std::vector<bool> is_core_node;
     std::vector<float> node_levels;
-    if (config.use_cached_priority)
+    if (config.use_cached_priority || config.use_previous_hierarchy)
     {
         ReadNodeLevels(node_levels);
     }
 
     util::DeallocatingVector<QueryEdge> contracted_edge_list;
-    ContractGraph(max_edge_id,
-                  edge_based_edge_list,
-                  contracted_edge_list,
-                  std::move(node_weights),
-                  is_core_node,
-                  node_levels);
+    if (config.use_previous_hierarchy)
+    {
+        ContractGraphIncremental(max_edge_id,
+                                 edge_based_edge_list,
+                                 contracted_edge_list,
+                                 std::move(node_weights),
+                                 node_levels);
+    }
+    else
+    {
+        ContractGraph(max_edge_id,
+                      edge_based_edge_list,
+                      contracted_edge_list,
+                      std::move(node_weights),
+                      is_core_node,
+                      node_levels);
+    }
     TIMER_STOP(contraction);
 
     util::Log() << "Contraction took " << TIMER_SEC(contraction) << " sec";
 
     std::size_t number_of_used_edges = WriteContractedGraph(max_edge_id, contracted_edge_list);
     WriteCoreNodeMarker(std::move(is_core_node));
-    if (!config.use_cached_priority)
+    // the levels of an incremental run belong to the new hierarchy
+    if (!config.use_cached_priority || config.use_previous_hierarchy)
     {
         WriteNodeLevels(std::move(node_levels));
     }
@@ -1139,5 +1156,46 @@ void Contractor::ContractGraph(
     graph_contractor.GetCoreMarker(is_core_node);
     graph_contractor.GetNodeLevels(inout_node_levels);
 }
+
+void Contractor::ContractGraphIncremental(
+    const EdgeID max_edge_id,
+    util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+    util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+    std::vector<EdgeWeight> &&node_weights,
+    std::vector<float> &inout_node_levels) const
+{
+    using QueryGraph = util::StaticGraph<QueryEdge::EdgeData>;
+
+    util::Log() << "Loading previous hierarchy from " << config.graph_output_path;
+    std::vector<QueryGraph::NodeArrayEntry> node_list;
+    std::vector<QueryGraph::EdgeArrayEntry> edge_list;
+    {
+        storage::io::FileReader hsgr_file(config.graph_output_path,
+                                          storage::io::FileReader::HasNoFingerprint);
+        const auto hsgr_header = storage::serialization::readHSGRHeader(hsgr_file);
+        node_list.resize(hsgr_header.number_of_nodes);
+        edge_list.resize(hsgr_header.number_of_edges);
+        storage::serialization::readHSGR(hsgr_file,
+                                         node_list.data(),
+                                         hsgr_header.number_of_nodes,
+                                         edge_list.data(),
+                                         hsgr_header.number_of_edges);
+    }
+    if (node_list.empty())
+    {
+        throw util::exception("The previous hierarchy in " + config.graph_output_path +
+                              " is empty" + SOURCE_REF);
+    }
+    const QueryGraph previous_hierarchy(node_list, edge_list);
+
+    std::vector<float> node_levels;
+    node_levels.swap(inout_node_levels);
+
+    GraphContractor graph_contractor(
+        max_edge_id + 1, edge_based_edge_list, std::move(node_levels), std::move(node_weights));
+    graph_contractor.RunIncremental(previous_hierarchy);
+    graph_contractor.GetEdges(contracted_edge_list);
+    graph_contractor.GetNodeLevels(inout_node_levels);
+}
 }
 }
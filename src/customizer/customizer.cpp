@@ -0,0 +1,188 @@
+#include "customizer/customizer.hpp"
+#include "customizer/cell_customizer.hpp"
+#include "customizer/cell_storage.hpp"
+#include "customizer/io.hpp"
+
+#include "contractor/contractor.hpp"
+#include "contractor/crc32_processor.hpp"
+#include "contractor/query_edge.hpp"
+#include "extractor/edge_based_edge.hpp"
+#include "partition/io.hpp"
+#include "partition/multi_level_partition.hpp"
+#include "storage/io.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/log.hpp"
+#include "util/static_graph.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+
+namespace
+{
+using EdgeData = contractor::QueryEdge::EdgeData;
+using Graph = util::StaticGraph<EdgeData>;
+
+// Stores every edge as forward edge at its source and as backward edge at its target, which
+// is what the query and the customization expect, like the .hsgr of osrm-contract does.
+std::vector<contractor::QueryEdge>
+makeQueryEdges(const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list)
+{
+    std::vector<contractor::QueryEdge> edges;
+    edges.reserve(edge_based_edge_list.size() * 2);
+    for (const auto &edge : edge_based_edge_list)
+    {
+        // eigenloops are never part of a shortest path
+        if (edge.source == edge.target)
+        {
+            continue;
+        }
+
+        EdgeData data;
+        data.id = edge.edge_id;
+        data.shortcut = false;
+        data.weight = std::max<EdgeWeight>(edge.weight, 1);
+
+        data.forward = edge.forward;
+        data.backward = edge.backward;
+        edges.emplace_back(edge.source, edge.target, data);
+
+        data.forward = edge.backward;
+        data.backward = edge.forward;
+        edges.emplace_back(edge.target, edge.source, data);
+    }
+    tbb::parallel_sort(edges.begin(), edges.end());
+    return edges;
+}
+
+// Writes the graph in the format of a .hsgr and returns it
+Graph writeGraph(const std::string &path,
+                 const NodeID number_of_nodes,
+                 const std::vector<contractor::QueryEdge> &edges)
+{
+    std::vector<Graph::NodeArrayEntry> node_array(number_of_nodes + 1);
+    std::vector<Graph::EdgeArrayEntry> edge_array(edges.size());
+
+    std::size_t edge = 0;
+    for (NodeID node = 0; node < number_of_nodes; ++node)
+    {
+        node_array[node].first_edge = static_cast<EdgeID>(edge);
+        while (edge < edges.size() && edges[edge].source == node)
+        {
+            edge_array[edge].target = edges[edge].target;
+            edge_array[edge].data = edges[edge].data;
+            ++edge;
+        }
+    }
+    node_array.back().first_edge = static_cast<EdgeID>(edges.size());
+
+    contractor::RangebasedCRC32 crc32_calculator;
+    const unsigned edges_crc32 = crc32_calculator(edges);
+    util::Log() << "Writing CRC32: " << edges_crc32;
+
+    storage::io::FileWriter writer(path, storage::io::FileWriter::GenerateFingerprint);
+    writer.WriteOne(edges_crc32);
+    writer.WriteElementCount64(node_array.size());
+    writer.WriteElementCount64(edge_array.size());
+    writer.WriteFrom(node_array.data(), node_array.size());
+    writer.WriteFrom(edge_array.data(), edge_array.size());
+
+    return Graph(node_array, edge_array);
+}
+}
+
+int Customizer::Run()
+{
+    TIMER_START(preparing);
+
+    util::Log() << "Reading node weights.";
+    std::vector<EdgeWeight> node_weights;
+    {
+        storage::io::FileReader node_file(config.edge_based_node_weights_path,
+                                          storage::io::FileReader::VerifyFingerprint);
+        node_file.DeserializeVector(node_weights);
+    }
+
+    util::Log() << "Loading edge-expanded graph representation";
+    util::DeallocatingVector<extractor::EdgeBasedEdge> edge_based_edge_list;
+    const EdgeID max_edge_id =
+        contractor::Contractor::LoadEdgeExpandedGraph(config.edge_based_graph_path,
+                                                      edge_based_edge_list,
+                                                      node_weights,
+                                                      config.edge_segment_lookup_path,
+                                                      config.edge_penalty_path,
+                                                      config.segment_speed_lookup_paths,
+                                                      config.turn_penalty_lookup_paths,
+                                                      config.node_based_graph_path,
+                                                      config.geometry_path,
+                                                      config.datasource_names_path,
+                                                      config.datasource_indexes_path,
+                                                      config.rtree_leaf_path,
+                                                      config.log_edge_updates_factor);
+    const NodeID number_of_nodes = max_edge_id + 1;
+
+    const auto partition = partition::io::read(config.partition_path);
+    if (partition.GetNumberOfNodes() != number_of_nodes)
+    {
+        throw util::exception("The partition in " + config.partition_path +
+                              " doesn't match the edge-based graph, rerun osrm-partition" +
+                              SOURCE_REF);
+    }
+
+    util::Log() << "Serializing graph of " << (edge_based_edge_list.size() * 2) << " edges";
+    const auto graph = [&] {
+        const auto edges = makeQueryEdges(edge_based_edge_list);
+        edge_based_edge_list.clear();
+        return writeGraph(config.graph_output_path, number_of_nodes, edges);
+    }();
+
+    TIMER_START(customization);
+    CellStorage cell_storage(partition, graph);
+    const CellCustomizer customizer(partition);
+    tbb::enumerable_thread_specific<std::unique_ptr<CellCustomizer::Heap>> heaps;
+    for (LevelID level = 1; level <= partition.GetNumberOfLevels(); ++level)
+    {
+        // the cells of a level only depend on the cells of the level below
+        tbb::parallel_for(tbb::blocked_range<CellID>(0, partition.GetNumberOfCells(level)),
+                          [&](const tbb::blocked_range<CellID> &range) {
+                              auto &heap = heaps.local();
+                              if (!heap)
+                              {
+                                  heap = std::make_unique<CellCustomizer::Heap>(number_of_nodes);
+                              }
+                              for (auto id = range.begin(); id != range.end(); ++id)
+                              {
+                                  customizer.Customize(graph, *heap, cell_storage, level, id);
+                              }
+                          });
+        util::Log() << "Customized " << partition.GetNumberOfCells(level) << " cells of level "
+                    << static_cast<unsigned>(level);
+    }
+    TIMER_STOP(customization);
+    util::Log() << "Customization took " << TIMER_SEC(customization) << " sec";
+
+    io::write(config.cells_output_path, cell_storage);
+
+    TIMER_STOP(preparing);
+    util::Log() << "Preprocessing : " << TIMER_SEC(preparing) << " seconds";
+    util::Log() << "finished customization";
+
+    return 0;
+}
+}
+}
@@ -54,7 +54,7 @@ const constexpr char *turn_type_names[] = {
 const constexpr char *waypoint_type_names[] = {"invalid", "arrive", "depart"};
 
 // Check whether to include a modifier in the result of the API
-inline bool isValidModifier(const guidance::StepManeuver maneuver)
+bool isValidModifier(const guidance::StepManeuver maneuver)
 {
     return (maneuver.waypoint_type == guidance::WaypointType::None ||
             maneuver.instruction.direction_modifier != DirectionModifier::UTurn);
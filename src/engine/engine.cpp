@@ -3,10 +3,12 @@
 #include "engine/engine_config.hpp"
 #include "engine/status.hpp"
 
+#include "engine/datafacade/mmap_memory_datafacade.hpp"
 #include "engine/datafacade/process_memory_datafacade.hpp"
 #include "engine/datafacade/shared_memory_datafacade.hpp"
 
 #include "storage/shared_barriers.hpp"
+#include "storage/storage.hpp"
 #include "util/log.hpp"
 
 #include <boost/assert.hpp>
@@ -35,9 +37,9 @@ RunQuery(const std::unique_ptr<osrm::engine::DataWatchdog> &watchdog,
     if (watchdog)
     {
         BOOST_ASSERT(!facade);
-        auto lock_and_facade = watchdog->GetDataFacade();
+        const auto facade_handle = watchdog->GetDataFacade();
 
-        return plugin.HandleRequest(lock_and_facade.second, parameters, result);
+        return plugin.HandleRequest(facade_handle.GetFacade(), parameters, result);
     }
 
     BOOST_ASSERT(facade);
@@ -55,12 +57,14 @@ namespace engine
 Engine::Engine(const EngineConfig &config)
     : lock(config.use_shared_memory ? std::make_unique<storage::SharedBarriers>()
                                     : std::unique_ptr<storage::SharedBarriers>()),
-      route_plugin(config.max_locations_viaroute),       //
-      table_plugin(config.max_locations_distance_table), //
-      nearest_plugin(config.max_results_nearest),        //
-      trip_plugin(config.max_locations_trip),            //
-      match_plugin(config.max_locations_map_matching),   //
-      tile_plugin()                                      //
+      route_plugin(config.max_locations_viaroute), //
+      table_plugin(config.max_locations_distance_table,
+                   config.max_threads_distance_table,
+                   config.max_entries_table_tile),     //
+      nearest_plugin(config.max_results_nearest),      //
+      trip_plugin(config.max_locations_trip),          //
+      match_plugin(config.max_locations_map_matching), //
+      tile_plugin()                                    //
 
 {
     if (config.use_shared_memory)
@@ -73,7 +77,9 @@ Engine::Engine(const EngineConfig &config)
                 SOURCE_REF);
         }
 
-        watchdog = std::make_unique<DataWatchdog>();
+        watchdog = std::make_unique<DataWatchdog>(config.algorithm,
+                                                  config.compress_rtree_leaves,
+                                                  config.phantom_node_cache_size);
         BOOST_ASSERT(watchdog);
     }
     else
@@ -82,8 +88,23 @@ Engine::Engine(const EngineConfig &config)
         {
             throw util::exception("Invalid file paths given!" + SOURCE_REF);
         }
-        immutable_data_facade =
-            std::make_shared<datafacade::ProcessMemoryDataFacade>(config.storage_config);
+        // without a writable image, for example in a read-only directory, the data is loaded
+        if (config.use_mmap && storage::Storage(config.storage_config).UpdateMemoryImage())
+        {
+            immutable_data_facade =
+                std::make_shared<datafacade::MMapMemoryDataFacade>(config.storage_config,
+                                                                   config.algorithm,
+                                                                   config.compress_rtree_leaves,
+                                                                   config.phantom_node_cache_size);
+        }
+        else
+        {
+            immutable_data_facade = std::make_shared<datafacade::ProcessMemoryDataFacade>(
+                config.storage_config,
+                config.algorithm,
+                config.compress_rtree_leaves,
+                config.phantom_node_cache_size);
+        }
     }
 }
 
@@ -92,11 +113,21 @@ Status Engine::Route(const api::RouteParameters &params, util::json::Object &res
     return RunQuery(watchdog, immutable_data_facade, params, route_plugin, result);
 }
 
+Status Engine::Route(const api::RouteParameters &params, std::vector<char> &result) const
+{
+    return RunQuery(watchdog, immutable_data_facade, params, route_plugin, result);
+}
+
 Status Engine::Table(const api::TableParameters &params, util::json::Object &result) const
 {
     return RunQuery(watchdog, immutable_data_facade, params, table_plugin, result);
 }
 
+Status Engine::Table(const api::TableParameters &params, std::vector<char> &result) const
+{
+    return RunQuery(watchdog, immutable_data_facade, params, table_plugin, result);
+}
+
 Status Engine::Nearest(const api::NearestParameters &params, util::json::Object &result) const
 {
     return RunQuery(watchdog, immutable_data_facade, params, nearest_plugin, result);
@@ -5,6 +5,7 @@
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/search_engine_data.hpp"
 #include "util/json_container.hpp"
+#include "util/json_renderer.hpp"
 #include "util/string_util.hpp"
 
 #include <cstdlib>
@@ -23,17 +24,27 @@ namespace engine
 namespace plugins
 {
 
-TablePlugin::TablePlugin(const int max_locations_distance_table)
-    : distance_table(heaps), max_locations_distance_table(max_locations_distance_table)
+TablePlugin::TablePlugin(const int max_locations_distance_table,
+                         const int max_threads_distance_table,
+                         const int max_entries_table_tile)
+    : distance_table(heaps), max_locations_distance_table(max_locations_distance_table),
+      max_threads_distance_table(max_threads_distance_table),
+      max_entries_table_tile(max_entries_table_tile)
 {
 }
 
-Status TablePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
-                                  const api::TableParameters &params,
-                                  util::json::Object &result) const
+Status TablePlugin::CheckParameters(const datafacade::BaseDataFacade &facade,
+                                    const api::TableParameters &params,
+                                    util::json::Object &result) const
 {
     BOOST_ASSERT(params.IsValid());
 
+    // the many-to-many search needs the contraction hierarchy
+    if (facade.GetMultiLevelPartition().GetNumberOfLevels() > 0)
+    {
+        return Error("NotImplemented", "Table is not implemented for the MLD algorithm", result);
+    }
+
     if (!CheckAllCoordinates(params.coordinates))
     {
         return Error("InvalidOptions", "Coordinates are invalid", result);
@@ -59,9 +70,25 @@ Status TablePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFaca
         return Error("TooBig", "Too many table coordinates", result);
     }
 
+    return Status::Ok;
+}
+
+Status TablePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
+                                  const api::TableParameters &params,
+                                  util::json::Object &result) const
+{
+    const auto status = CheckParameters(*facade, params, result);
+    if (status != Status::Ok)
+    {
+        return status;
+    }
+
     auto snapped_phantoms = SnapPhantomNodes(GetPhantomNodes(*facade, params));
-    auto result_table =
-        distance_table(*facade, snapped_phantoms, params.sources, params.destinations);
+    auto result_table = distance_table(*facade,
+                                       snapped_phantoms,
+                                       params.sources,
+                                       params.destinations,
+                                       static_cast<unsigned>(max_threads_distance_table));
 
     if (result_table.empty())
     {
@@ -73,6 +100,52 @@ Status TablePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFaca
 
     return Status::Ok;
 }
+
+Status TablePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
+                                  const api::TableParameters &params,
+                                  std::vector<char> &result) const
+{
+    util::json::Object error_result;
+    const auto status = CheckParameters(*facade, params, error_result);
+    if (status != Status::Ok)
+    {
+        util::json::render(result, error_result);
+        return status;
+    }
+
+    const auto num_sources =
+        params.sources.empty() ? params.coordinates.size() : params.sources.size();
+    const auto num_destinations =
+        params.destinations.empty() ? params.coordinates.size() : params.destinations.size();
+    if (num_sources * num_destinations == 0)
+    {
+        Error("NoTable", "No table found", error_result);
+        util::json::render(result, error_result);
+        return Status::Error;
+    }
+
+    auto snapped_phantoms = SnapPhantomNodes(GetPhantomNodes(*facade, params));
+
+    // every tile spans full rows, so huge numbers of destinations still get one row per tile
+    const auto rows_per_tile = std::max<std::size_t>(
+        1, static_cast<std::size_t>(max_entries_table_tile) / num_destinations);
+
+    api::TableAPI table_api{*facade, params};
+    table_api.MakeResponseBegin(snapped_phantoms, result);
+    distance_table.ComputeTiles(
+        *facade,
+        snapped_phantoms,
+        params.sources,
+        params.destinations,
+        static_cast<unsigned>(max_threads_distance_table),
+        rows_per_tile,
+        [&](const std::size_t first_row, const std::vector<EdgeWeight> &tile) {
+            table_api.MakeResponseRows(tile, first_row, num_destinations, result);
+        });
+    table_api.MakeResponseEnd(result);
+
+    return Status::Ok;
+}
 }
 }
 }
@@ -147,6 +147,13 @@ Status TripPlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFacad
 {
     BOOST_ASSERT(parameters.IsValid());
 
+    // the trips are computed from a distance table
+    if (facade->GetMultiLevelPartition().GetNumberOfLevels() > 0)
+    {
+        return Error(
+            "NotImplemented", "Trip is not implemented for the MLD algorithm", json_result);
+    }
+
     // enforce maximum number of locations for performance reasons
     if (max_locations_trip > 0 &&
         static_cast<int>(parameters.coordinates.size()) > max_locations_trip)
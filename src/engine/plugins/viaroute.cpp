@@ -6,6 +6,7 @@
 #include "util/for_each_pair.hpp"
 #include "util/integer_range.hpp"
 #include "util/json_container.hpp"
+#include "util/json_renderer.hpp"
 
 #include <cstdlib>
 
@@ -30,6 +31,47 @@ ViaRoutePlugin::ViaRoutePlugin(int max_locations_viaroute)
 Status ViaRoutePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
                                      const api::RouteParameters &route_parameters,
                                      util::json::Object &json_result) const
+{
+    InternalRouteResult raw_route;
+    const auto status = ComputeRoute(facade, route_parameters, raw_route, json_result);
+    if (status == Status::Ok)
+    {
+        api::RouteAPI route_api{*facade, route_parameters};
+        route_api.MakeResponse(raw_route, json_result);
+    }
+    return status;
+}
+
+Status ViaRoutePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
+                                     const api::RouteParameters &route_parameters,
+                                     std::vector<char> &result) const
+{
+    util::json::Object json_result;
+    if (route_parameters.format != api::RouteParameters::OutputFormatType::Binary)
+    {
+        const auto status = HandleRequest(facade, route_parameters, json_result);
+        util::json::render(result, json_result);
+        return status;
+    }
+
+    // errors are reported as JSON in both formats
+    InternalRouteResult raw_route;
+    const auto status = ComputeRoute(facade, route_parameters, raw_route, json_result);
+    if (status != Status::Ok)
+    {
+        util::json::render(result, json_result);
+        return status;
+    }
+
+    api::RouteAPI route_api{*facade, route_parameters};
+    route_api.MakeBinaryResponse(raw_route, result);
+    return Status::Ok;
+}
+
+Status ViaRoutePlugin::ComputeRoute(const std::shared_ptr<datafacade::BaseDataFacade> facade,
+                                    const api::RouteParameters &route_parameters,
+                                    InternalRouteResult &raw_route,
+                                    util::json::Object &json_result) const
 {
     BOOST_ASSERT(route_parameters.IsValid());
 
@@ -64,7 +106,6 @@ Status ViaRoutePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataF
                                                    ? *route_parameters.continue_straight
                                                    : facade->GetContinueStraightDefault();
 
-    InternalRouteResult raw_route;
     auto build_phantom_pairs = [&raw_route, continue_straight_at_waypoint](
         const PhantomNode &first_node, const PhantomNode &second_node) {
         raw_route.segment_end_coordinates.push_back(PhantomNodes{first_node, second_node});
@@ -86,7 +127,9 @@ Status ViaRoutePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataF
 
     if (1 == raw_route.segment_end_coordinates.size())
     {
-        if (route_parameters.alternatives && facade->GetCoreSize() == 0)
+        // alternatives need the contraction hierarchy without core
+        if (route_parameters.alternatives && facade->GetCoreSize() == 0 &&
+            facade->GetMultiLevelPartition().GetNumberOfLevels() == 0)
         {
             alternative_path(*facade, raw_route.segment_end_coordinates.front(), raw_route);
         }
@@ -105,12 +148,7 @@ Status ViaRoutePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataF
 
     // we can only know this after the fact, different SCC ids still
     // allow for connection in one direction.
-    if (raw_route.is_valid())
-    {
-        api::RouteAPI route_api{*facade, route_parameters};
-        route_api.MakeResponse(raw_route, json_result);
-    }
-    else
+    if (!raw_route.is_valid())
     {
         auto first_component_id = snapped_phantoms.front().component.id;
         auto not_in_same_component = std::any_of(snapped_phantoms.begin(),
@@ -13,68 +13,48 @@ SearchEngineData::SearchEngineHeapPtr SearchEngineData::forward_heap_2;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_2;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::forward_heap_3;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_3;
+SearchEngineData::ManyToManyHeapPtr SearchEngineData::many_to_many_heap;
 
-void SearchEngineData::InitializeOrClearFirstThreadLocalStorage(const unsigned number_of_nodes)
+namespace
+{
+// The heaps of a thread outlive the facade they were created for, a dataset with more nodes
+// needs a new heap since the dense index storage only has room for the old number of nodes.
+template <typename HeapPtr>
+void InitializeOrClearHeap(HeapPtr &heap, const unsigned number_of_nodes)
 {
-    if (forward_heap_1.get())
+    using Heap = typename HeapPtr::element_type;
+    if (heap.get() && heap->Capacity() >= number_of_nodes)
     {
-        forward_heap_1->Clear();
+        heap->Clear();
     }
     else
     {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes));
+        heap.reset(new Heap(number_of_nodes));
     }
+}
+}
 
-    if (reverse_heap_1.get())
-    {
-        reverse_heap_1->Clear();
-    }
-    else
-    {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
+void SearchEngineData::InitializeOrClearFirstThreadLocalStorage(const unsigned number_of_nodes)
+{
+    InitializeOrClearHeap(forward_heap_1, number_of_nodes);
+    InitializeOrClearHeap(reverse_heap_1, number_of_nodes);
 }
 
 void SearchEngineData::InitializeOrClearSecondThreadLocalStorage(const unsigned number_of_nodes)
 {
-    if (forward_heap_2.get())
-    {
-        forward_heap_2->Clear();
-    }
-    else
-    {
-        forward_heap_2.reset(new QueryHeap(number_of_nodes));
-    }
-
-    if (reverse_heap_2.get())
-    {
-        reverse_heap_2->Clear();
-    }
-    else
-    {
-        reverse_heap_2.reset(new QueryHeap(number_of_nodes));
-    }
+    InitializeOrClearHeap(forward_heap_2, number_of_nodes);
+    InitializeOrClearHeap(reverse_heap_2, number_of_nodes);
 }
 
 void SearchEngineData::InitializeOrClearThirdThreadLocalStorage(const unsigned number_of_nodes)
 {
-    if (forward_heap_3.get())
-    {
-        forward_heap_3->Clear();
-    }
-    else
-    {
-        forward_heap_3.reset(new QueryHeap(number_of_nodes));
-    }
+    InitializeOrClearHeap(forward_heap_3, number_of_nodes);
+    InitializeOrClearHeap(reverse_heap_3, number_of_nodes);
+}
 
-    if (reverse_heap_3.get())
-    {
-        reverse_heap_3->Clear();
-    }
-    else
-    {
-        reverse_heap_3.reset(new QueryHeap(number_of_nodes));
-    }
+void SearchEngineData::InitializeOrClearManyToManyThreadLocalStorage(const unsigned number_of_nodes)
+{
+    InitializeOrClearHeap(many_to_many_heap, number_of_nodes);
 }
 }
 }
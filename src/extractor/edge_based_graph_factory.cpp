@@ -18,6 +18,9 @@
 #include <boost/assert.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include <algorithm>
 #include <cmath>
 #include <fstream>
@@ -364,268 +367,362 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
     bearing_class_by_node_based_node.resize(m_node_based_graph->GetNumberOfNodes(),
                                             std::numeric_limits<std::uint32_t>::max());
 
+    // An intersection as seen from one of its incoming edges, with the penalties of its turns
+    struct IncomingIntersection
     {
-        util::UnbufferedLog log;
+        NodeID node_at_center_of_intersection;
+        NodeID node_along_road_entering;
+        EdgeID incoming_edge;
+        guidance::Intersection intersection;
+        std::vector<std::int32_t> turn_penalties;
+    };
 
-        util::Percent progress(log, m_node_based_graph->GetNumberOfNodes());
-        // going over all nodes (which form the center of an intersection), we compute all
-        // possible turns along these intersections.
-        for (const auto node_at_center_of_intersection :
-             util::irange(0u, m_node_based_graph->GetNumberOfNodes()))
+    // Computes the turns from every road entering the intersection, together with their penalties
+    const auto analyze_intersection = [&](const NodeID node_at_center_of_intersection,
+                                          std::vector<IncomingIntersection> &intersections) {
+        const auto shape_result =
+            turn_analysis.ComputeIntersectionShapes(node_at_center_of_intersection);
+
+        // all nodes in the graph are connected in both directions. We check all outgoing nodes to
+        // find the incoming edge. This is a larger search overhead, but the cost we need to pay to
+        // generate edges here is worth the additional search overhead.
+        //
+        // a -> b <-> c
+        //      |
+        //      v
+        //      d
+        //
+        // will have:
+        // a: b,rev=0
+        // b: a,rev=1 c,rev=0 d,rev=0
+        // c: b,rev=0
+        //
+        // From the flags alone, we cannot determine which nodes are connected to `b` by an outgoing
+        // edge. Therefore, we have to search all connected edges for edges entering `b`
+        for (const EdgeID outgoing_edge :
+             m_node_based_graph->GetAdjacentEdgeRange(node_at_center_of_intersection))
         {
-            progress.PrintStatus(node_at_center_of_intersection);
-
-            const auto shape_result =
-                turn_analysis.ComputeIntersectionShapes(node_at_center_of_intersection);
-
-            // all nodes in the graph are connected in both directions. We check all outgoing nodes
-            // to
-            // find the incoming edge. This is a larger search overhead, but the cost we need to pay
-            // to
-            // generate edges here is worth the additional search overhead.
-            //
-            // a -> b <-> c
-            //      |
-            //      v
-            //      d
-            //
-            // will have:
-            // a: b,rev=0
-            // b: a,rev=1 c,rev=0 d,rev=0
-            // c: b,rev=0
-            //
-            // From the flags alone, we cannot determine which nodes are connected to `b` by an
-            // outgoing
-            // edge. Therefore, we have to search all connected edges for edges entering `b`
-            for (const EdgeID outgoing_edge :
-                 m_node_based_graph->GetAdjacentEdgeRange(node_at_center_of_intersection))
-            {
-                const NodeID node_along_road_entering =
-                    m_node_based_graph->GetTarget(outgoing_edge);
-
-                const auto incoming_edge = m_node_based_graph->FindEdge(
-                    node_along_road_entering, node_at_center_of_intersection);
+            const NodeID node_along_road_entering = m_node_based_graph->GetTarget(outgoing_edge);
 
-                if (m_node_based_graph->GetEdgeData(incoming_edge).reversed)
-                    continue;
+            const auto incoming_edge = m_node_based_graph->FindEdge(node_along_road_entering,
+                                                                    node_at_center_of_intersection);
 
-                ++node_based_edge_counter;
+            if (m_node_based_graph->GetEdgeData(incoming_edge).reversed)
+                continue;
 
-                auto intersection_with_flags_and_angles =
-                    turn_analysis.GetIntersectionGenerator().TransformIntersectionShapeIntoView(
-                        node_along_road_entering,
-                        incoming_edge,
-                        shape_result.normalised_intersection_shape,
-                        shape_result.intersection_shape,
-                        shape_result.merging_map);
+            auto intersection_with_flags_and_angles =
+                turn_analysis.GetIntersectionGenerator().TransformIntersectionShapeIntoView(
+                    node_along_road_entering,
+                    incoming_edge,
+                    shape_result.normalised_intersection_shape,
+                    shape_result.intersection_shape,
+                    shape_result.merging_map);
 
-                auto intersection = turn_analysis.AssignTurnTypes(
-                    node_along_road_entering, incoming_edge, intersection_with_flags_and_angles);
+            auto intersection = turn_analysis.AssignTurnTypes(
+                node_along_road_entering, incoming_edge, intersection_with_flags_and_angles);
 
-                BOOST_ASSERT(intersection.valid());
+            BOOST_ASSERT(intersection.valid());
 
-                intersection = turn_lane_handler.assignTurnLanes(
-                    node_along_road_entering, incoming_edge, std::move(intersection));
+            // turn lanes only change the instructions, the angles stay the same. The penalties
+            // of all allowed turns are evaluated by the profile in a single call.
+            std::vector<double> turn_angles;
+            for (const auto &turn : intersection)
+            {
+                if (turn.entry_allowed)
+                {
+                    turn_angles.push_back(180. - turn.angle);
+                }
+            }
+            const auto allowed_turn_penalties =
+                scripting_environment.GetTurnPenalties(turn_angles);
+            BOOST_ASSERT(allowed_turn_penalties.size() == turn_angles.size());
 
-                // the entry class depends on the turn, so we have to classify the interesction for
-                // every edge
-                const auto turn_classification = classifyIntersection(intersection);
+            std::vector<std::int32_t> turn_penalties(intersection.size(), 0);
+            auto allowed_turn_penalty = allowed_turn_penalties.begin();
+            for (const auto turn_index : util::irange<std::size_t>(0, intersection.size()))
+            {
+                if (intersection[turn_index].entry_allowed)
+                {
+                    turn_penalties[turn_index] = *allowed_turn_penalty++;
+                }
+            }
 
-                const auto entry_class_id = [&](const util::guidance::EntryClass entry_class) {
-                    if (0 == entry_class_hash.count(entry_class))
-                    {
-                        const auto id = static_cast<std::uint16_t>(entry_class_hash.size());
-                        entry_class_hash[entry_class] = id;
-                        return id;
-                    }
-                    else
-                    {
-                        return entry_class_hash.find(entry_class)->second;
-                    }
-                }(turn_classification.first);
+            intersections.push_back({node_at_center_of_intersection,
+                                     node_along_road_entering,
+                                     incoming_edge,
+                                     std::move(intersection),
+                                     std::move(turn_penalties)});
+        }
+    };
 
-                const auto bearing_class_id =
-                    [&](const util::guidance::BearingClass bearing_class) {
-                        if (0 == bearing_class_hash.count(bearing_class))
-                        {
-                            const auto id = static_cast<std::uint32_t>(bearing_class_hash.size());
-                            bearing_class_hash[bearing_class] = id;
-                            return id;
-                        }
-                        else
-                        {
-                            return bearing_class_hash.find(bearing_class)->second;
-                        }
-                    }(turn_classification.second);
-                bearing_class_by_node_based_node[node_at_center_of_intersection] = bearing_class_id;
+    {
+        util::UnbufferedLog log;
 
-                for (const auto &turn : intersection)
-                {
-                    // only keep valid turns
-                    if (!turn.entry_allowed)
-                        continue;
-
-                    // only add an edge if turn is not prohibited
-                    const EdgeData &edge_data1 = m_node_based_graph->GetEdgeData(incoming_edge);
-                    const EdgeData &edge_data2 = m_node_based_graph->GetEdgeData(turn.eid);
-
-                    BOOST_ASSERT(edge_data1.edge_id != edge_data2.edge_id);
-                    BOOST_ASSERT(!edge_data1.reversed);
-                    BOOST_ASSERT(!edge_data2.reversed);
-
-                    // the following is the core of the loop.
-                    unsigned distance = edge_data1.distance;
-                    if (m_traffic_lights.find(node_at_center_of_intersection) !=
-                        m_traffic_lights.end())
-                    {
-                        distance += profile_properties.traffic_signal_penalty;
-                    }
+        const NodeID number_of_nodes = m_node_based_graph->GetNumberOfNodes();
+        util::Percent progress(log, number_of_nodes);
 
-                    const int32_t turn_penalty =
-                        scripting_environment.GetTurnPenalty(180. - turn.angle);
+        // The intersections are analysed in parallel, for blocks of nodes split into ranges with
+        // a buffer each. The turns are then added in the order of the nodes, so that the ids of
+        // entry classes, bearing classes and lane data as well as all written files are the same
+        // as in a serial run. Assigning turn lanes creates ids as well and is part of that step.
+        const constexpr NodeID RANGE_SIZE = 128;
+        const constexpr NodeID BLOCK_SIZE = 512 * RANGE_SIZE;
+        std::vector<std::vector<IncomingIntersection>> range_intersections;
 
-                    const auto turn_instruction = turn.instruction;
-                    if (turn_instruction.direction_modifier == guidance::DirectionModifier::UTurn)
+        for (NodeID block_begin = 0; block_begin < number_of_nodes; block_begin += BLOCK_SIZE)
+        {
+            const NodeID block_end = std::min(number_of_nodes, block_begin + BLOCK_SIZE);
+            const std::size_t number_of_ranges = (block_end - block_begin - 1) / RANGE_SIZE + 1;
+            range_intersections.resize(number_of_ranges);
+
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, number_of_ranges),
+                [&](const tbb::blocked_range<std::size_t> &ranges) {
+                    for (const auto range : util::irange(ranges.begin(), ranges.end()))
                     {
-                        distance += profile_properties.u_turn_penalty;
+                        auto &intersections = range_intersections[range];
+                        intersections.clear();
+                        const NodeID range_begin = block_begin + range * RANGE_SIZE;
+                        const NodeID range_end = std::min(block_end, range_begin + RANGE_SIZE);
+                        for (const auto node_at_center_of_intersection :
+                             util::irange(range_begin, range_end))
+                        {
+                            analyze_intersection(node_at_center_of_intersection,
+                                                 intersections);
+                        }
                     }
+                });
 
-                    // don't add turn penalty if it is not an actual turn. This heuristic is
-                    // necessary
-                    // since OSRM cannot handle looping roads/parallel roads
-                    if (turn_instruction.type != guidance::TurnType::NoTurn)
-                        distance += turn_penalty;
-
-                    const bool is_encoded_forwards =
-                        m_compressed_edge_container.HasZippedEntryForForwardID(incoming_edge);
-                    const bool is_encoded_backwards =
-                        m_compressed_edge_container.HasZippedEntryForReverseID(incoming_edge);
-                    BOOST_ASSERT(is_encoded_forwards || is_encoded_backwards);
-                    if (is_encoded_forwards)
-                    {
-                        original_edge_data_vector.emplace_back(
-                            GeometryID{m_compressed_edge_container.GetZippedPositionForForwardID(
-                                           incoming_edge),
-                                       true},
-                            edge_data1.name_id,
-                            turn.lane_data_id,
-                            turn_instruction,
-                            entry_class_id,
-                            edge_data1.travel_mode,
-                            util::guidance::TurnBearing(intersection[0].bearing),
-                            util::guidance::TurnBearing(turn.bearing));
-                    }
-                    else if (is_encoded_backwards)
+            for (auto &intersections : range_intersections)
+            {
+                for (auto &incoming : intersections)
+                {
+                    const auto node_at_center_of_intersection =
+                        incoming.node_at_center_of_intersection;
+                    const auto node_along_road_entering = incoming.node_along_road_entering;
+                    const auto incoming_edge = incoming.incoming_edge;
+                    const auto &turn_penalties = incoming.turn_penalties;
+
+                    ++node_based_edge_counter;
+
+                    auto intersection = turn_lane_handler.assignTurnLanes(
+                        node_along_road_entering, incoming_edge, std::move(incoming.intersection));
+                    BOOST_ASSERT(intersection.size() == turn_penalties.size());
+
+                    // the entry class depends on the turn, so we have to classify the
+                    // interesction for every edge
+                    const auto turn_classification = classifyIntersection(intersection);
+
+                    const auto entry_class_id =
+                        [&](const util::guidance::EntryClass entry_class) {
+                            if (0 == entry_class_hash.count(entry_class))
+                            {
+                                const auto id =
+                                    static_cast<std::uint16_t>(entry_class_hash.size());
+                                entry_class_hash[entry_class] = id;
+                                return id;
+                            }
+                            else
+                            {
+                                return entry_class_hash.find(entry_class)->second;
+                            }
+                        }(turn_classification.first);
+
+                    const auto bearing_class_id =
+                        [&](const util::guidance::BearingClass bearing_class) {
+                            if (0 == bearing_class_hash.count(bearing_class))
+                            {
+                                const auto id =
+                                    static_cast<std::uint32_t>(bearing_class_hash.size());
+                                bearing_class_hash[bearing_class] = id;
+                                return id;
+                            }
+                            else
+                            {
+                                return bearing_class_hash.find(bearing_class)->second;
+                            }
+                        }(turn_classification.second);
+                    bearing_class_by_node_based_node[node_at_center_of_intersection] =
+                        bearing_class_id;
+
+                    for (const auto turn_index : util::irange<std::size_t>(0, intersection.size()))
                     {
-                        original_edge_data_vector.emplace_back(
-                            GeometryID{m_compressed_edge_container.GetZippedPositionForReverseID(
-                                           incoming_edge),
-                                       false},
-                            edge_data1.name_id,
-                            turn.lane_data_id,
-                            turn_instruction,
-                            entry_class_id,
-                            edge_data1.travel_mode,
-                            util::guidance::TurnBearing(intersection[0].bearing),
-                            util::guidance::TurnBearing(turn.bearing));
-                    }
+                        const auto &turn = intersection[turn_index];
 
-                    ++original_edges_counter;
+                        // only keep valid turns
+                        if (!turn.entry_allowed)
+                            continue;
 
-                    if (original_edge_data_vector.size() > 1024 * 1024 * 10)
-                    {
-                        FlushVectorToStream(edge_data_file, original_edge_data_vector);
-                    }
+                        // only add an edge if turn is not prohibited
+                        const EdgeData &edge_data1 =
+                            m_node_based_graph->GetEdgeData(incoming_edge);
+                        const EdgeData &edge_data2 = m_node_based_graph->GetEdgeData(turn.eid);
 
-                    BOOST_ASSERT(SPECIAL_NODEID != edge_data1.edge_id);
-                    BOOST_ASSERT(SPECIAL_NODEID != edge_data2.edge_id);
-
-                    // NOTE: potential overflow here if we hit 2^32 routable edges
-                    BOOST_ASSERT(m_edge_based_edge_list.size() <=
-                                 std::numeric_limits<NodeID>::max());
-                    m_edge_based_edge_list.emplace_back(edge_data1.edge_id,
-                                                        edge_data2.edge_id,
-                                                        m_edge_based_edge_list.size(),
-                                                        distance,
-                                                        true,
-                                                        false);
-                    BOOST_ASSERT(original_edges_counter == m_edge_based_edge_list.size());
-
-                    // Here is where we write out the mapping between the edge-expanded edges, and
-                    // the node-based edges that are originally used to calculate the `distance`
-                    // for the edge-expanded edges.  About 40 lines back, there is:
-                    //
-                    //                 unsigned distance = edge_data1.distance;
-                    //
-                    // This tells us that the weight for an edge-expanded-edge is based on the
-                    // weight
-                    // of the *source* node-based edge.  Therefore, we will look up the individual
-                    // segments of the source node-based edge, and write out a mapping between
-                    // those and the edge-based-edge ID.
-                    // External programs can then use this mapping to quickly perform
-                    // updates to the edge-expanded-edge based directly on its ID.
-                    if (generate_edge_lookup)
-                    {
-                        const auto node_based_edges =
-                            m_compressed_edge_container.GetBucketReference(incoming_edge);
-                        NodeID previous = node_along_road_entering;
+                        BOOST_ASSERT(edge_data1.edge_id != edge_data2.edge_id);
+                        BOOST_ASSERT(!edge_data1.reversed);
+                        BOOST_ASSERT(!edge_data2.reversed);
 
-                        const unsigned node_count = node_based_edges.size() + 1;
-                        const QueryNode &first_node = m_node_info_list[previous];
+                        // the following is the core of the loop.
+                        unsigned distance = edge_data1.distance;
+                        if (m_traffic_lights.find(node_at_center_of_intersection) !=
+                            m_traffic_lights.end())
+                        {
+                            distance += profile_properties.traffic_signal_penalty;
+                        }
 
-                        lookup::SegmentHeaderBlock header = {node_count, first_node.node_id};
+                        const int32_t turn_penalty = turn_penalties[turn_index];
 
-                        edge_segment_file.write(reinterpret_cast<const char *>(&header),
-                                                sizeof(header));
+                        const auto turn_instruction = turn.instruction;
+                        if (turn_instruction.direction_modifier ==
+                            guidance::DirectionModifier::UTurn)
+                        {
+                            distance += profile_properties.u_turn_penalty;
+                        }
 
-                        for (auto target_node : node_based_edges)
+                        // don't add turn penalty if it is not an actual turn. This heuristic is
+                        // necessary
+                        // since OSRM cannot handle looping roads/parallel roads
+                        if (turn_instruction.type != guidance::TurnType::NoTurn)
+                            distance += turn_penalty;
+
+                        const bool is_encoded_forwards =
+                            m_compressed_edge_container.HasZippedEntryForForwardID(incoming_edge);
+                        const bool is_encoded_backwards =
+                            m_compressed_edge_container.HasZippedEntryForReverseID(incoming_edge);
+                        BOOST_ASSERT(is_encoded_forwards || is_encoded_backwards);
+                        if (is_encoded_forwards)
                         {
-                            const QueryNode &from = m_node_info_list[previous];
-                            const QueryNode &to = m_node_info_list[target_node.node_id];
-                            const double segment_length =
-                                util::coordinate_calculation::greatCircleDistance(from, to);
+                            original_edge_data_vector.emplace_back(
+                                GeometryID{
+                                    m_compressed_edge_container.GetZippedPositionForForwardID(
+                                        incoming_edge),
+                                    true},
+                                edge_data1.name_id,
+                                turn.lane_data_id,
+                                turn_instruction,
+                                entry_class_id,
+                                edge_data1.travel_mode,
+                                util::guidance::TurnBearing(intersection[0].bearing),
+                                util::guidance::TurnBearing(turn.bearing));
+                        }
+                        else if (is_encoded_backwards)
+                        {
+                            original_edge_data_vector.emplace_back(
+                                GeometryID{
+                                    m_compressed_edge_container.GetZippedPositionForReverseID(
+                                        incoming_edge),
+                                    false},
+                                edge_data1.name_id,
+                                turn.lane_data_id,
+                                turn_instruction,
+                                entry_class_id,
+                                edge_data1.travel_mode,
+                                util::guidance::TurnBearing(intersection[0].bearing),
+                                util::guidance::TurnBearing(turn.bearing));
+                        }
 
-                            lookup::SegmentBlock nodeblock = {
-                                to.node_id, segment_length, target_node.weight};
+                        ++original_edges_counter;
 
-                            edge_segment_file.write(reinterpret_cast<const char *>(&nodeblock),
-                                                    sizeof(nodeblock));
-                            previous = target_node.node_id;
+                        if (original_edge_data_vector.size() > 1024 * 1024 * 10)
+                        {
+                            FlushVectorToStream(edge_data_file, original_edge_data_vector);
                         }
 
-                        // We also now write out the mapping between the edge-expanded edges and the
-                        // original nodes. Since each edge represents a possible maneuver, external
-                        // programs can use this to quickly perform updates to edge weights in order
-                        // to penalize certain turns.
-
-                        // If this edge is 'trivial' -- where the compressed edge corresponds
-                        // exactly to an original OSM segment -- we can pull the turn's preceding
-                        // node ID directly with `node_along_road_entering`; otherwise, we need to
-                        // look
-                        // up the node
-                        // immediately preceding the turn from the compressed edge container.
-                        const bool isTrivial = m_compressed_edge_container.IsTrivial(incoming_edge);
-
-                        const auto &from_node =
-                            isTrivial
-                                ? m_node_info_list[node_along_road_entering]
-                                : m_node_info_list[m_compressed_edge_container.GetLastEdgeSourceID(
-                                      incoming_edge)];
-                        const auto &via_node =
-                            m_node_info_list[m_compressed_edge_container.GetLastEdgeTargetID(
-                                incoming_edge)];
-                        const auto &to_node =
-                            m_node_info_list[m_compressed_edge_container.GetFirstEdgeTargetID(
-                                turn.eid)];
-
-                        const unsigned fixed_penalty = distance - edge_data1.distance;
-                        lookup::PenaltyBlock penaltyblock = {
-                            fixed_penalty, from_node.node_id, via_node.node_id, to_node.node_id};
-                        edge_penalty_file.write(reinterpret_cast<const char *>(&penaltyblock),
-                                                sizeof(penaltyblock));
+                        BOOST_ASSERT(SPECIAL_NODEID != edge_data1.edge_id);
+                        BOOST_ASSERT(SPECIAL_NODEID != edge_data2.edge_id);
+
+                        // NOTE: potential overflow here if we hit 2^32 routable edges
+                        BOOST_ASSERT(m_edge_based_edge_list.size() <=
+                                     std::numeric_limits<NodeID>::max());
+                        m_edge_based_edge_list.emplace_back(edge_data1.edge_id,
+                                                            edge_data2.edge_id,
+                                                            m_edge_based_edge_list.size(),
+                                                            distance,
+                                                            true,
+                                                            false);
+                        BOOST_ASSERT(original_edges_counter == m_edge_based_edge_list.size());
+
+                        // Here is where we write out the mapping between the edge-expanded edges,
+                        // and the node-based edges that are originally used to calculate the
+                        // `distance` for the edge-expanded edges.  About 40 lines back, there is:
+                        //
+                        //                 unsigned distance = edge_data1.distance;
+                        //
+                        // This tells us that the weight for an edge-expanded-edge is based on the
+                        // weight
+                        // of the *source* node-based edge.  Therefore, we will look up the
+                        // individual segments of the source node-based edge, and write out a
+                        // mapping between those and the edge-based-edge ID.
+                        // External programs can then use this mapping to quickly perform
+                        // updates to the edge-expanded-edge based directly on its ID.
+                        if (generate_edge_lookup)
+                        {
+                            const auto node_based_edges =
+                                m_compressed_edge_container.GetBucketReference(incoming_edge);
+                            NodeID previous = node_along_road_entering;
+
+                            const unsigned node_count = node_based_edges.size() + 1;
+                            const QueryNode &first_node = m_node_info_list[previous];
+
+                            lookup::SegmentHeaderBlock header = {node_count, first_node.node_id};
+
+                            edge_segment_file.write(reinterpret_cast<const char *>(&header),
+                                                    sizeof(header));
+
+                            for (auto target_node : node_based_edges)
+                            {
+                                const QueryNode &from = m_node_info_list[previous];
+                                const QueryNode &to = m_node_info_list[target_node.node_id];
+                                const double segment_length =
+                                    util::coordinate_calculation::greatCircleDistance(from, to);
+
+                                lookup::SegmentBlock nodeblock = {
+                                    to.node_id, segment_length, target_node.weight};
+
+                                edge_segment_file.write(
+                                    reinterpret_cast<const char *>(&nodeblock), sizeof(nodeblock));
+                                previous = target_node.node_id;
+                            }
+
+                            // We also now write out the mapping between the edge-expanded edges and
+                            // the original nodes. Since each edge represents a possible maneuver,
+                            // external programs can use this to quickly perform updates to edge
+                            // weights in order to penalize certain turns.
+
+                            // If this edge is 'trivial' -- where the compressed edge corresponds
+                            // exactly to an original OSM segment -- we can pull the turn's
+                            // preceding node ID directly with `node_along_road_entering`;
+                            // otherwise, we need to look
+                            // up the node
+                            // immediately preceding the turn from the compressed edge container.
+                            const bool isTrivial =
+                                m_compressed_edge_container.IsTrivial(incoming_edge);
+
+                            const auto &from_node =
+                                isTrivial ? m_node_info_list[node_along_road_entering]
+                                          : m_node_info_list[m_compressed_edge_container
+                                                                 .GetLastEdgeSourceID(
+                                                                     incoming_edge)];
+                            const auto &via_node =
+                                m_node_info_list[m_compressed_edge_container.GetLastEdgeTargetID(
+                                    incoming_edge)];
+                            const auto &to_node =
+                                m_node_info_list[m_compressed_edge_container.GetFirstEdgeTargetID(
+                                    turn.eid)];
+
+                            const unsigned fixed_penalty = distance - edge_data1.distance;
+                            lookup::PenaltyBlock penaltyblock = {fixed_penalty,
+                                                                 from_node.node_id,
+                                                                 via_node.node_id,
+                                                                 to_node.node_id};
+                            edge_penalty_file.write(
+                                reinterpret_cast<const char *>(&penaltyblock),
+                                sizeof(penaltyblock));
+                        }
                     }
                 }
             }
+            progress.PrintStatus(block_end);
         }
     }
 
@@ -19,15 +19,88 @@
 
 #include <stxxl/sort>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+#include <unistd.h>
+#endif
+
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
 #include <limits>
 #include <mutex>
 #include <sstream>
+#include <string>
+#include <vector>
 
 namespace
 {
 namespace oe = osrm::extractor;
 
+// Number of elements that are sorted by one task before the sorted chunks are merged
+const constexpr std::size_t PARALLEL_SORT_CHUNK_SIZE = 1 << 16;
+
+// Stable sort on all threads. Chunks of a fixed size are sorted in parallel and merged pairwise,
+// so the order of equal elements doesn't depend on the scheduling.
+template <typename RandomIt, typename CompareT>
+void parallelStableSort(const RandomIt first, const RandomIt last, const CompareT &compare)
+{
+    const std::size_t size = std::distance(first, last);
+    const auto for_each_range = [size](const std::size_t width, const auto &function) {
+        const auto number_of_ranges = (size + width - 1) / width;
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_ranges, 1),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              for (auto index = range.begin(); index != range.end(); ++index)
+                              {
+                                  function(index * width, std::min(size, (index + 1) * width));
+                              }
+                          });
+    };
+
+    for_each_range(PARALLEL_SORT_CHUNK_SIZE, [&](const std::size_t begin, const std::size_t end) {
+        std::stable_sort(first + begin, first + end, compare);
+    });
+    for (std::size_t width = PARALLEL_SORT_CHUNK_SIZE; width < size; width *= 2)
+    {
+        for_each_range(2 * width, [&](const std::size_t begin, const std::size_t end) {
+            const auto middle = std::min(end, begin + width);
+            std::inplace_merge(first + begin, first + middle, first + end, compare);
+        });
+    }
+}
+
+// Memory that can be allocated without swapping, or 0 if it is unknown. On Linux this is
+// MemAvailable, which unlike the free pages includes the page cache that can be reclaimed.
+std::uint64_t availableMemory()
+{
+    std::ifstream meminfo("/proc/meminfo");
+    std::string line;
+    while (std::getline(meminfo, line))
+    {
+        std::istringstream fields(line);
+        std::string key;
+        std::uint64_t kibibytes;
+        if (fields >> key >> kibibytes && key == "MemAvailable:")
+        {
+            return kibibytes * 1024;
+        }
+    }
+
+#if defined(_SC_AVPHYS_PAGES) && defined(_SC_PAGESIZE)
+    const auto pages = sysconf(_SC_AVPHYS_PAGES);
+    const auto page_size = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && page_size > 0)
+    {
+        return static_cast<std::uint64_t>(pages) * static_cast<std::uint64_t>(page_size);
+    }
+#endif
+    return 0;
+}
+
 // Needed for STXXL comparison - STXXL requires max_value(), min_value(), so we can not use
 // std::less<OSMNodeId>{}. Anonymous namespace to keep translation unit local.
 struct OSMNodeIDSTXXLLess
@@ -113,7 +186,8 @@ namespace extractor
 
 static const int WRITE_BLOCK_BUFFER_SIZE = 8000;
 
-ExtractionContainers::ExtractionContainers()
+ExtractionContainers::ExtractionContainers(const ExtractorConfig::SortMode sort_mode)
+    : sort_mode(sort_mode), sort_in_memory(sort_mode == ExtractorConfig::SortMode::InMemory)
 {
     // Check if stxxl can be instantiated
     stxxl::vector<unsigned> dummy_vector;
@@ -160,6 +234,22 @@ void ExtractionContainers::PrepareData(ScriptingEnvironment &scripting_environme
 
     FlushVectors();
 
+    if (sort_mode == ExtractorConfig::SortMode::Auto)
+    {
+        // a container is copied into memory to sort it, stxxl keeps its own cache meanwhile
+        const std::uint64_t largest_container_size =
+            std::max({static_cast<std::uint64_t>(used_node_id_list.size() * sizeof(OSMNodeID)),
+                      static_cast<std::uint64_t>(all_nodes_list.size() *
+                                                 sizeof(ExternalMemoryNode)),
+                      static_cast<std::uint64_t>(all_edges_list.size() *
+                                                 sizeof(InternalExtractorEdge))});
+        const auto available_memory = availableMemory();
+        sort_in_memory = 2 * largest_container_size < available_memory;
+        util::Log() << "Sorting " << (largest_container_size >> 20) << " MiB of data "
+                    << (sort_in_memory ? "in memory" : "with stxxl") << ", "
+                    << (available_memory >> 20) << " MiB of memory are available";
+    }
+
     PrepareNodes();
     WriteNodes(file_out_stream);
     PrepareEdges(scripting_environment);
@@ -170,6 +260,22 @@ void ExtractionContainers::PrepareData(ScriptingEnvironment &scripting_environme
     WriteCharData(name_file_name);
 }
 
+template <typename VectorT, typename CompareT>
+void ExtractionContainers::Sort(VectorT &vector, CompareT compare)
+{
+    if (!sort_in_memory)
+    {
+        stxxl::sort(vector.begin(), vector.end(), compare, stxxl_memory);
+        return;
+    }
+
+    std::vector<typename VectorT::value_type> buffer;
+    buffer.reserve(vector.size());
+    std::copy(vector.cbegin(), vector.cend(), std::back_inserter(buffer));
+    parallelStableSort(buffer.begin(), buffer.end(), compare);
+    std::copy(buffer.begin(), buffer.end(), vector.begin());
+}
+
 void ExtractionContainers::WriteCharData(const std::string &file_name)
 {
     util::UnbufferedLog log;
@@ -223,8 +329,7 @@ void ExtractionContainers::PrepareNodes()
         util::UnbufferedLog log;
         log << "Sorting used nodes        ... " << std::flush;
         TIMER_START(sorting_used_nodes);
-        stxxl::sort(
-            used_node_id_list.begin(), used_node_id_list.end(), OSMNodeIDSTXXLLess(), stxxl_memory);
+        Sort(used_node_id_list, OSMNodeIDSTXXLLess());
         TIMER_STOP(sorting_used_nodes);
         log << "ok, after " << TIMER_SEC(sorting_used_nodes) << "s";
     }
@@ -243,10 +348,7 @@ void ExtractionContainers::PrepareNodes()
         util::UnbufferedLog log;
         log << "Sorting all nodes         ... " << std::flush;
         TIMER_START(sorting_nodes);
-        stxxl::sort(all_nodes_list.begin(),
-                    all_nodes_list.end(),
-                    ExternalMemoryNodeSTXXLCompare(),
-                    stxxl_memory);
+        Sort(all_nodes_list, ExternalMemoryNodeSTXXLCompare());
         TIMER_STOP(sorting_nodes);
         log << "ok, after " << TIMER_SEC(sorting_nodes) << "s";
     }
@@ -303,8 +405,7 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
         util::UnbufferedLog log;
         log << "Sorting edges by start    ... " << std::flush;
         TIMER_START(sort_edges_by_start);
-        stxxl::sort(
-            all_edges_list.begin(), all_edges_list.end(), CmpEdgeByOSMStartID(), stxxl_memory);
+        Sort(all_edges_list, CmpEdgeByOSMStartID());
         TIMER_STOP(sort_edges_by_start);
         log << "ok, after " << TIMER_SEC(sort_edges_by_start) << "s";
     }
@@ -374,8 +475,7 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
         util::UnbufferedLog log;
         log << "Sorting edges by target   ... " << std::flush;
         TIMER_START(sort_edges_by_target);
-        stxxl::sort(
-            all_edges_list.begin(), all_edges_list.end(), CmpEdgeByOSMTargetID(), stxxl_memory);
+        Sort(all_edges_list, CmpEdgeByOSMTargetID());
         TIMER_STOP(sort_edges_by_target);
         log << "ok, after " << TIMER_SEC(sort_edges_by_target) << "s";
     }
@@ -489,11 +589,8 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
         log << "Sorting edges by renumbered start ... ";
         TIMER_START(sort_edges_by_renumbered_start);
         std::mutex name_data_mutex;
-        stxxl::sort(
-            all_edges_list.begin(),
-            all_edges_list.end(),
-            CmpEdgeByInternalSourceTargetAndName{name_data_mutex, name_char_data, name_offsets},
-            stxxl_memory);
+        Sort(all_edges_list,
+             CmpEdgeByInternalSourceTargetAndName{name_data_mutex, name_char_data, name_offsets});
         TIMER_STOP(sort_edges_by_renumbered_start);
         log << "ok, after " << TIMER_SEC(sort_edges_by_renumbered_start) << "s";
     }
@@ -721,10 +818,7 @@ void ExtractionContainers::PrepareRestrictions()
         util::UnbufferedLog log;
         log << "Sorting used ways         ... ";
         TIMER_START(sort_ways);
-        stxxl::sort(way_start_end_id_list.begin(),
-                    way_start_end_id_list.end(),
-                    FirstAndLastSegmentOfWayStxxlCompare(),
-                    stxxl_memory);
+        Sort(way_start_end_id_list, FirstAndLastSegmentOfWayStxxlCompare());
         TIMER_STOP(sort_ways);
         log << "ok, after " << TIMER_SEC(sort_ways) << "s";
     }
@@ -733,10 +827,7 @@ void ExtractionContainers::PrepareRestrictions()
         util::UnbufferedLog log;
         log << "Sorting " << restrictions_list.size() << " restriction. by from... ";
         TIMER_START(sort_restrictions);
-        stxxl::sort(restrictions_list.begin(),
-                    restrictions_list.end(),
-                    CmpRestrictionContainerByFrom(),
-                    stxxl_memory);
+        Sort(restrictions_list, CmpRestrictionContainerByFrom());
         TIMER_STOP(sort_restrictions);
         log << "ok, after " << TIMER_SEC(sort_restrictions) << "s";
     }
@@ -830,10 +921,7 @@ void ExtractionContainers::PrepareRestrictions()
         util::UnbufferedLog log;
         log << "Sorting restrictions. by to  ... " << std::flush;
         TIMER_START(sort_restrictions_to);
-        stxxl::sort(restrictions_list.begin(),
-                    restrictions_list.end(),
-                    CmpRestrictionContainerByTo(),
-                    stxxl_memory);
+        Sort(restrictions_list, CmpRestrictionContainerByTo());
         TIMER_STOP(sort_restrictions_to);
         log << "ok, after " << TIMER_SEC(sort_restrictions_to) << "s";
     }
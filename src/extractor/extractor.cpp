@@ -1,6 +1,7 @@
 #include "extractor/extractor.hpp"
 
 #include "extractor/edge_based_edge.hpp"
+#include "extractor/extraction_block.hpp"
 #include "extractor/extraction_containers.hpp"
 #include "extractor/extraction_node.hpp"
 #include "extractor/extraction_way.hpp"
@@ -35,7 +36,7 @@
 
 #include <osmium/io/any_input.hpp>
 
-#include <tbb/concurrent_vector.h>
+#include <tbb/pipeline.h>
 #include <tbb/task_scheduler_init.h>
 
 #include <cstdlib>
@@ -62,6 +63,19 @@ namespace extractor
 
 namespace
 {
+// Maximal number of input buffers that are decoded, processed or consumed at the same time
+const constexpr std::size_t MAX_PARSING_BUFFERS_IN_FLIGHT = 4;
+
+// An input buffer on its way through the parsing pipeline
+struct ParsingBuffer
+{
+    osmium::memory::Buffer buffer;
+    std::vector<osmium::memory::Buffer::const_iterator> osm_elements;
+    // reused for all buffers that go through this slot
+    std::vector<ExtractionBlock> resulting_blocks;
+    std::chrono::steady_clock::duration profile_time;
+};
+
 std::tuple<std::vector<std::uint32_t>, std::vector<guidance::TurnLaneType::Mask>>
 transformTurnLaneMapIntoArrays(const guidance::LaneDescriptionMap &turn_lane_map)
 {
@@ -126,7 +140,7 @@ int Extractor::run(ScriptingEnvironment &scripting_environment)
         }
         util::Log() << "Threads: " << number_of_threads;
 
-        ExtractionContainers extraction_containers;
+        ExtractionContainers extraction_containers(config.sort_mode);
         auto extractor_callbacks = std::make_unique<ExtractorCallbacks>(extraction_containers);
 
         const osmium::io::File input_file(config.input_path.string());
@@ -161,57 +175,134 @@ int Extractor::run(ScriptingEnvironment &scripting_environment)
         boost::filesystem::ofstream timestamp_out(config.timestamp_file_name);
         timestamp_out.write(timestamp.c_str(), timestamp.length());
 
-        // initialize vectors holding parsed objects
-        tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> resulting_nodes;
-        tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> resulting_ways;
-        tbb::concurrent_vector<boost::optional<InputRestrictionContainer>> resulting_restrictions;
+        // Decoding the input, running the profile and the extractor callbacks are the stages of
+        // a pipeline, so they overlap for consecutive buffers. The profile runs on several
+        // buffers at once, the other stages see the buffers in input order.
+        using Clock = std::chrono::steady_clock;
+        std::vector<ParsingBuffer> parsing_buffers(MAX_PARSING_BUFFERS_IN_FLIGHT);
+        std::size_t number_of_buffers = 0;
+        Clock::duration reading_time = Clock::duration::zero();
+        Clock::duration profile_stage_time = Clock::duration::zero();
+        Clock::duration callbacks_time = Clock::duration::zero();
+        Clock::duration lua_time = Clock::duration::zero();
+        Clock::duration processing_time = Clock::duration::zero();
 
         // setup restriction parser
         const RestrictionParser restriction_parser(scripting_environment);
 
-        while (const osmium::memory::Buffer buffer = reader.read())
-        {
+        // There are never more buffers in flight than slots, so the buffer that used a slot
+        // before has left the pipeline when the slot is filled again
+        const auto read_buffer = [&](tbb::flow_control &control) -> ParsingBuffer * {
+            const auto start = Clock::now();
+            auto &parsing_buffer = parsing_buffers[number_of_buffers % parsing_buffers.size()];
+            parsing_buffer.buffer = reader.read();
+            if (!parsing_buffer.buffer)
+            {
+                control.stop();
+                return nullptr;
+            }
+            ++number_of_buffers;
+
             // create a vector of iterators into the buffer
-            std::vector<osmium::memory::Buffer::const_iterator> osm_elements;
+            const auto &buffer = parsing_buffer.buffer;
+            auto &osm_elements = parsing_buffer.osm_elements;
+            osm_elements.clear();
             for (auto iter = std::begin(buffer), end = std::end(buffer); iter != end; ++iter)
             {
                 osm_elements.push_back(iter);
             }
+            reading_time += Clock::now() - start;
+            return &parsing_buffer;
+        };
 
-            // clear resulting vectors
-            resulting_nodes.clear();
-            resulting_ways.clear();
-            resulting_restrictions.clear();
-
-            scripting_environment.ProcessElements(osm_elements,
+        const auto process_buffer = [&](ParsingBuffer *parsing_buffer) {
+            const auto start = Clock::now();
+            scripting_environment.ProcessElements(parsing_buffer->osm_elements,
                                                   restriction_parser,
-                                                  resulting_nodes,
-                                                  resulting_ways,
-                                                  resulting_restrictions);
-
-            number_of_nodes += resulting_nodes.size();
-            // put parsed objects thru extractor callbacks
-            for (const auto &result : resulting_nodes)
+                                                  parsing_buffer->resulting_blocks);
+            parsing_buffer->profile_time = Clock::now() - start;
+            return parsing_buffer;
+        };
+
+        const auto consume_buffer = [&](ParsingBuffer *parsing_buffer) {
+            const auto start = Clock::now();
+            const auto &osm_elements = parsing_buffer->osm_elements;
+            const auto &resulting_blocks = parsing_buffer->resulting_blocks;
+
+            // put parsed objects thru extractor callbacks in the order of the buffer
+            for (const auto &block : resulting_blocks)
             {
-                extractor_callbacks->ProcessNode(
-                    static_cast<const osmium::Node &>(*(osm_elements[result.first])),
-                    result.second);
+                number_of_nodes += block.GetNodes().size();
+                for (const auto &result : block.GetNodes())
+                {
+                    extractor_callbacks->ProcessNode(
+                        static_cast<const osmium::Node &>(*(osm_elements[result.first])),
+                        result.second);
+                }
             }
-            number_of_ways += resulting_ways.size();
-            for (const auto &result : resulting_ways)
+            for (const auto &block : resulting_blocks)
             {
-                extractor_callbacks->ProcessWay(
-                    static_cast<const osmium::Way &>(*(osm_elements[result.first])), result.second);
+                number_of_ways += block.GetWays().size();
+                for (const auto &result : block.GetWays())
+                {
+                    extractor_callbacks->ProcessWay(
+                        static_cast<const osmium::Way &>(*(osm_elements[result.first])),
+                        result.second);
+                }
             }
-            number_of_relations += resulting_restrictions.size();
-            for (const auto &result : resulting_restrictions)
+            for (const auto &block : resulting_blocks)
             {
-                extractor_callbacks->ProcessRestriction(result);
+                number_of_relations += block.GetRestrictions().size();
+                for (const auto &result : block.GetRestrictions())
+                {
+                    extractor_callbacks->ProcessRestriction(result);
+                }
             }
-        }
+
+            for (const auto &block : resulting_blocks)
+            {
+                util::Log(logDEBUG) << "Processed a block in "
+                                    << std::chrono::duration<double>(block.GetTotalTime()).count()
+                                    << "s, of which "
+                                    << std::chrono::duration<double>(block.GetLuaTime()).count()
+                                    << "s in the profile";
+                lua_time += block.GetLuaTime();
+                processing_time += block.GetTotalTime();
+            }
+            profile_stage_time += parsing_buffer->profile_time;
+            callbacks_time += Clock::now() - start;
+        };
+
+        const auto pipeline_start = Clock::now();
+        tbb::parallel_pipeline(
+            MAX_PARSING_BUFFERS_IN_FLIGHT,
+            tbb::make_filter<void, ParsingBuffer *>(tbb::filter::serial_in_order, read_buffer) &
+                tbb::make_filter<ParsingBuffer *, ParsingBuffer *>(tbb::filter::parallel,
+                                                                   process_buffer) &
+                tbb::make_filter<ParsingBuffer *, void>(tbb::filter::serial_in_order,
+                                                        consume_buffer));
+        const auto pipeline_time = Clock::now() - pipeline_start;
+
         TIMER_STOP(parsing);
         util::Log() << "Parsing finished after " << TIMER_SEC(parsing) << " seconds";
 
+        // the profile stage can be busy with several buffers at once and exceed 100%
+        const auto utilization = [pipeline_time](const Clock::duration stage_time) {
+            return pipeline_time.count() > 0 ? 100. * stage_time.count() / pipeline_time.count()
+                                             : 0.;
+        };
+        util::Log() << "Parsed " << number_of_buffers << " buffers, stage utilization: reading "
+                    << utilization(reading_time) << "%, profile "
+                    << utilization(profile_stage_time) << "%, callbacks "
+                    << utilization(callbacks_time) << "%";
+        // summed over all threads
+        util::Log() << "Processing the elements took "
+                    << std::chrono::duration<double>(processing_time).count() << "s, "
+                    << std::chrono::duration<double>(lua_time).count()
+                    << "s in the profile and "
+                    << std::chrono::duration<double>(processing_time - lua_time).count()
+                    << "s in C++";
+
         util::Log() << "Raw input contains " << number_of_nodes << " nodes, " << number_of_ways
                     << " ways, and " << number_of_relations << " relations";
 
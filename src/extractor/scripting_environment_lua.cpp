@@ -10,6 +10,7 @@
 #include "extractor/restriction_parser.hpp"
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
+#include "util/integer_range.hpp"
 #include "util/log.hpp"
 #include "util/lua_util.hpp"
 #include "util/typedefs.hpp"
@@ -22,8 +23,13 @@
 
 #include <tbb/parallel_for.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 namespace osrm
 {
@@ -31,6 +37,15 @@ namespace extractor
 {
 namespace
 {
+// The turn penalty table samples turn_function every 1/64 degree. The sampled angles are exact
+// in floating point, and turns get the value of the profile at their angle rounded to the grid.
+const constexpr double MIN_TURN_ANGLE = -180.;
+const constexpr double MAX_TURN_ANGLE = 180.;
+const constexpr double TURN_PENALTY_TABLE_RESOLUTION = 64.;
+
+// Number of OSM elements that are processed and stored together by ProcessElements
+const constexpr std::size_t ELEMENTS_PER_BLOCK = 1024;
+
 // wrapper method as luabind doesn't automatically overload funcs w/ default parameters
 template <class T>
 auto get_value_by_key(T const &object, const char *key) -> decltype(object.get_value_by_key(key))
@@ -283,15 +298,16 @@ const ProfileProperties &LuaScriptingEnvironment::GetProfileProperties()
 
 LuaScriptingContext &LuaScriptingEnvironment::GetLuaContext()
 {
-    std::lock_guard<std::mutex> lock(init_mutex);
-    bool initialized = false;
-    auto &ref = script_contexts.local(initialized);
-    if (!initialized)
+    // the context of a thread is only created once, later calls don't need the lock
+    auto &ref = script_contexts.local();
+    if (!ref)
     {
-        ref = std::make_unique<LuaScriptingContext>();
-        InitContext(*ref);
+        std::lock_guard<std::mutex> lock(init_mutex);
+        auto context = std::make_unique<LuaScriptingContext>();
+        InitContext(*context);
+        luabind::set_pcall_callback(&luaErrorCallback);
+        ref = std::move(context);
     }
-    luabind::set_pcall_callback(&luaErrorCallback);
 
     return *ref;
 }
@@ -299,49 +315,70 @@ LuaScriptingContext &LuaScriptingEnvironment::GetLuaContext()
 void LuaScriptingEnvironment::ProcessElements(
     const std::vector<osmium::memory::Buffer::const_iterator> &osm_elements,
     const RestrictionParser &restriction_parser,
-    tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> &resulting_nodes,
-    tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> &resulting_ways,
-    tbb::concurrent_vector<boost::optional<InputRestrictionContainer>> &resulting_restrictions)
+    std::vector<ExtractionBlock> &resulting_blocks)
 {
-    // parse OSM entities in parallel, store in resulting vectors
+    using Clock = std::chrono::steady_clock;
+
+    // The blocks only depend on the number of elements, so the results don't depend on the
+    // scheduling and the blocks are reused with their ways for every buffer
+    const auto number_of_blocks =
+        (osm_elements.size() + ELEMENTS_PER_BLOCK - 1) / ELEMENTS_PER_BLOCK;
+    resulting_blocks.resize(number_of_blocks);
+
+    // parse OSM entities in parallel, every block stores its results in element order
     tbb::parallel_for(
-        tbb::blocked_range<std::size_t>(0, osm_elements.size()),
+        tbb::blocked_range<std::size_t>(0, number_of_blocks, 1),
         [&](const tbb::blocked_range<std::size_t> &range) {
-            ExtractionNode result_node;
-            ExtractionWay result_way;
             auto &local_context = this->GetLuaContext();
 
-            for (auto x = range.begin(), end = range.end(); x != end; ++x)
+            for (const auto block_index : util::irange(range.begin(), range.end()))
             {
-                const auto entity = osm_elements[x];
+                const auto block_start = Clock::now();
+                auto &block = resulting_blocks[block_index];
+                block.clear();
 
-                switch (entity->type())
+                const auto end =
+                    std::min(osm_elements.size(), (block_index + 1) * ELEMENTS_PER_BLOCK);
+                for (auto x = block_index * ELEMENTS_PER_BLOCK; x != end; ++x)
                 {
-                case osmium::item_type::node:
-                    result_node.clear();
-                    if (local_context.has_node_function)
+                    const auto entity = osm_elements[x];
+
+                    switch (entity->type())
+                    {
+                    case osmium::item_type::node:
                     {
-                        local_context.processNode(static_cast<const osmium::Node &>(*entity),
-                                                  result_node);
+                        auto &result_node = block.AddNode(x);
+                        if (local_context.has_node_function)
+                        {
+                            const auto lua_start = Clock::now();
+                            local_context.processNode(static_cast<const osmium::Node &>(*entity),
+                                                      result_node);
+                            block.AddLuaTime(Clock::now() - lua_start);
+                        }
+                        break;
                     }
-                    resulting_nodes.push_back(std::make_pair(x, std::move(result_node)));
-                    break;
-                case osmium::item_type::way:
-                    result_way.clear();
-                    if (local_context.has_way_function)
+                    case osmium::item_type::way:
                     {
-                        local_context.processWay(static_cast<const osmium::Way &>(*entity),
-                                                 result_way);
+                        auto &result_way = block.AddWay(x);
+                        if (local_context.has_way_function)
+                        {
+                            const auto lua_start = Clock::now();
+                            local_context.processWay(static_cast<const osmium::Way &>(*entity),
+                                                     result_way);
+                            block.AddLuaTime(Clock::now() - lua_start);
+                        }
+                        break;
+                    }
+                    case osmium::item_type::relation:
+                        block.AddRestriction(restriction_parser.TryParse(
+                            static_cast<const osmium::Relation &>(*entity)));
+                        break;
+                    default:
+                        break;
                     }
-                    resulting_ways.push_back(std::make_pair(x, std::move(result_way)));
-                    break;
-                case osmium::item_type::relation:
-                    resulting_restrictions.push_back(restriction_parser.TryParse(
-                        static_cast<const osmium::Relation &>(*entity)));
-                    break;
-                default:
-                    break;
                 }
+
+                block.AddTotalTime(Clock::now() - block_start);
             }
         });
 }
@@ -391,29 +428,112 @@ void LuaScriptingEnvironment::SetupSources()
     }
 }
 
-int32_t LuaScriptingEnvironment::GetTurnPenalty(const double angle)
+void LuaScriptingEnvironment::InitTurnPenaltyTable(LuaScriptingContext &context)
 {
-    auto &context = GetLuaContext();
-    if (context.has_turn_penalty_function)
+    if (!context.has_turn_penalty_function)
     {
-        BOOST_ASSERT(context.state != nullptr);
-        try
+        return;
+    }
+    BOOST_ASSERT(context.state != nullptr);
+
+    const auto table_size = static_cast<std::size_t>((MAX_TURN_ANGLE - MIN_TURN_ANGLE) *
+                                                     TURN_PENALTY_TABLE_RESOLUTION) +
+                            1;
+    const auto call_turn_function = [&context](const std::size_t index) {
+        return luabind::call_function<double>(context.state,
+                                              "turn_function",
+                                              MIN_TURN_ANGLE +
+                                                  index / TURN_PENALTY_TABLE_RESOLUTION);
+    };
+
+    try
+    {
+        std::vector<double> table(table_size);
+        for (const auto index : util::irange<std::size_t>(0, table_size))
         {
-            // call lua profile to compute turn penalty
-            const double penalty =
-                luabind::call_function<double>(context.state, "turn_function", angle);
-            BOOST_ASSERT(penalty < std::numeric_limits<int32_t>::max());
-            BOOST_ASSERT(penalty > std::numeric_limits<int32_t>::min());
-            return boost::numeric_cast<int32_t>(penalty);
+            table[index] = call_turn_function(index);
+            if (!std::isfinite(table[index]) ||
+                std::abs(table[index]) >= std::numeric_limits<int32_t>::max())
+            {
+                return;
+            }
         }
-        catch (const luabind::error &er)
+
+        // A profile that keeps state between calls or depends on anything but the angle does not
+        // give the same penalties the second time around, in a different order
+        for (const auto count : util::irange<std::size_t>(0, table_size))
         {
-            util::Log(logWARNING) << er.what();
+            const auto index = table_size - 1 - count;
+            if (call_turn_function(index) != table[index])
+            {
+                return;
+            }
         }
+
+        turn_penalty_table = std::move(table);
+        util::Log() << "Using a lookup table for turn_function";
+    }
+    catch (const luabind::error &)
+    {
+        // turn penalties are computed by the profile and errors reported for every turn
+    }
+}
+
+int32_t LuaScriptingEnvironment::ComputeTurnPenalty(LuaScriptingContext &context,
+                                                    const double angle) const
+{
+    if (!context.has_turn_penalty_function)
+    {
+        return 0;
+    }
+
+    if (!turn_penalty_table.empty() && angle >= MIN_TURN_ANGLE && angle <= MAX_TURN_ANGLE)
+    {
+        // the profile value at the nearest sampled angle, never a mix of two of them
+        const auto index = static_cast<std::size_t>(
+            std::lround((angle - MIN_TURN_ANGLE) * TURN_PENALTY_TABLE_RESOLUTION));
+        BOOST_ASSERT(index < turn_penalty_table.size());
+        return boost::numeric_cast<int32_t>(turn_penalty_table[index]);
+    }
+
+    BOOST_ASSERT(context.state != nullptr);
+    try
+    {
+        // call lua profile to compute turn penalty
+        const double penalty =
+            luabind::call_function<double>(context.state, "turn_function", angle);
+        BOOST_ASSERT(penalty < std::numeric_limits<int32_t>::max());
+        BOOST_ASSERT(penalty > std::numeric_limits<int32_t>::min());
+        return boost::numeric_cast<int32_t>(penalty);
+    }
+    catch (const luabind::error &er)
+    {
+        util::Log(logWARNING) << er.what();
     }
     return 0;
 }
 
+int32_t LuaScriptingEnvironment::GetTurnPenalty(const double angle)
+{
+    auto &context = GetLuaContext();
+    std::call_once(turn_penalty_table_flag, [&] { InitTurnPenaltyTable(context); });
+    return ComputeTurnPenalty(context, angle);
+}
+
+std::vector<int32_t> LuaScriptingEnvironment::GetTurnPenalties(const std::vector<double> &angles)
+{
+    auto &context = GetLuaContext();
+    std::call_once(turn_penalty_table_flag, [&] { InitTurnPenaltyTable(context); });
+
+    std::vector<int32_t> penalties;
+    penalties.reserve(angles.size());
+    for (const auto angle : angles)
+    {
+        penalties.push_back(ComputeTurnPenalty(context, angle));
+    }
+    return penalties;
+}
+
 void LuaScriptingEnvironment::ProcessSegment(const osrm::util::Coordinate &source,
                                              const osrm::util::Coordinate &target,
                                              double distance,
@@ -28,11 +28,23 @@ engine::Status OSRM::Route(const engine::api::RouteParameters &params,
     return engine_->Route(params, result);
 }
 
+engine::Status OSRM::Route(const engine::api::RouteParameters &params,
+                           std::vector<char> &result) const
+{
+    return engine_->Route(params, result);
+}
+
 engine::Status OSRM::Table(const engine::api::TableParameters &params, json::Object &result) const
 {
     return engine_->Table(params, result);
 }
 
+engine::Status OSRM::Table(const engine::api::TableParameters &params,
+                           std::vector<char> &result) const
+{
+    return engine_->Table(params, result);
+}
+
 engine::Status OSRM::Nearest(const engine::api::NearestParameters &params,
                              json::Object &result) const
 {
@@ -0,0 +1,70 @@
+#include "partition/partitioner.hpp"
+#include "partition/io.hpp"
+#include "partition/multi_level_partition.hpp"
+#include "partition/recursive_bisection.hpp"
+
+#include "extractor/edge_based_edge.hpp"
+#include "storage/io.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace partition
+{
+
+int Partitioner::Run()
+{
+    TIMER_START(partitioning);
+
+    util::Log() << "Loading edge-expanded graph representation";
+    NodeID number_of_nodes = 0;
+    std::vector<std::pair<NodeID, NodeID>> edges;
+    {
+        // the .ebg is read directly, as the contractor's loader rewrites the datasource files
+        storage::io::FileReader reader(config.edge_based_graph_path,
+                                       storage::io::FileReader::VerifyFingerprint);
+        const auto number_of_edges = reader.ReadElementCount64();
+        const auto max_edge_id = reader.ReadOne<EdgeID>();
+        number_of_nodes = max_edge_id + 1;
+
+        std::vector<extractor::EdgeBasedEdge> edge_based_edges(number_of_edges);
+        reader.ReadInto(edge_based_edges);
+
+        edges.reserve(edge_based_edges.size());
+        for (const auto &edge : edge_based_edges)
+        {
+            edges.emplace_back(edge.source, edge.target);
+        }
+    }
+    util::Log() << "Partitioning " << number_of_nodes << " nodes and " << edges.size()
+                << " edges";
+
+    TIMER_START(bisection);
+    const RecursiveBisection bisection(number_of_nodes, edges);
+    edges.clear();
+    edges.shrink_to_fit();
+    const MultiLevelPartition partition(bisection.ComputeCells(config.max_cell_sizes));
+    TIMER_STOP(bisection);
+
+    for (LevelID level = 1; level <= partition.GetNumberOfLevels(); ++level)
+    {
+        util::Log() << "Level " << static_cast<unsigned>(level) << ": "
+                    << partition.GetNumberOfCells(level) << " cells";
+    }
+    util::Log() << "Bisection took " << TIMER_SEC(bisection) << " sec";
+
+    io::write(config.partition_path, partition);
+
+    TIMER_STOP(partitioning);
+    util::Log() << "Partitioning: " << TIMER_SEC(partitioning) << " seconds";
+
+    return 0;
+}
+}
+}
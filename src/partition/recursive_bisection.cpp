@@ -0,0 +1,232 @@
+#include "partition/recursive_bisection.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/parallel_invoke.h>
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <tuple>
+
+namespace osrm
+{
+namespace partition
+{
+
+namespace
+{
+// ranges smaller than this are bisected on the current thread
+const constexpr NodeID PARALLEL_BISECTION_THRESHOLD = 1 << 14;
+}
+
+struct RecursiveBisection::BisectionState
+{
+    BisectionState(const NodeID number_of_nodes, const std::vector<std::size_t> &max_cell_sizes_)
+        : max_cell_sizes(max_cell_sizes_), order(number_of_nodes), range_begin(number_of_nodes),
+          visited(number_of_nodes, false)
+    {
+        std::iota(order.begin(), order.end(), 0);
+        for (auto &begin : range_begin)
+        {
+            begin.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    const std::vector<std::size_t> &max_cell_sizes;
+    // every range [begin, end) of order holds the nodes of one part
+    std::vector<NodeID> order;
+    // the begin of the range each node belongs to, read concurrently for the neighbours
+    std::vector<std::atomic<NodeID>> range_begin;
+    // only accessed by the task owning the node's range
+    std::vector<char> visited;
+};
+
+RecursiveBisection::RecursiveBisection(const NodeID number_of_nodes_,
+                                       const std::vector<std::pair<NodeID, NodeID>> &edges)
+    : number_of_nodes(number_of_nodes_), first_edge(number_of_nodes_ + 1, 0)
+{
+    for (const auto &edge : edges)
+    {
+        BOOST_ASSERT(edge.first < number_of_nodes && edge.second < number_of_nodes);
+        if (edge.first != edge.second)
+        {
+            ++first_edge[edge.first + 1];
+            ++first_edge[edge.second + 1];
+        }
+    }
+    std::partial_sum(first_edge.begin(), first_edge.end(), first_edge.begin());
+
+    targets.resize(first_edge.back());
+    auto insert_position = first_edge;
+    for (const auto &edge : edges)
+    {
+        if (edge.first != edge.second)
+        {
+            targets[insert_position[edge.first]++] = edge.second;
+            targets[insert_position[edge.second]++] = edge.first;
+        }
+    }
+
+    // remove the duplicates of edges that were given in both directions
+    EdgeID compacted_end = 0;
+    for (NodeID node = 0; node < number_of_nodes; ++node)
+    {
+        const auto begin = targets.begin() + first_edge[node];
+        const auto end = targets.begin() + first_edge[node + 1];
+        std::sort(begin, end);
+        const auto unique_end = std::unique(begin, end);
+
+        first_edge[node] = compacted_end;
+        compacted_end = std::copy(begin, unique_end, targets.begin() + compacted_end) -
+                        targets.begin();
+    }
+    first_edge[number_of_nodes] = compacted_end;
+    targets.resize(compacted_end);
+    targets.shrink_to_fit();
+}
+
+std::vector<std::vector<CellID>>
+RecursiveBisection::ComputeCells(const std::vector<std::size_t> &max_cell_sizes) const
+{
+    if (max_cell_sizes.empty() || max_cell_sizes.front() == 0 ||
+        !std::is_sorted(max_cell_sizes.begin(), max_cell_sizes.end()))
+    {
+        throw util::exception("The maximal cell sizes need to be positive and increasing" +
+                              SOURCE_REF);
+    }
+
+    const auto number_of_levels = max_cell_sizes.size();
+    std::vector<std::vector<CellID>> level_cell_ids(number_of_levels,
+                                                    std::vector<CellID>(number_of_nodes));
+    if (number_of_nodes == 0)
+    {
+        level_cell_ids.resize(1);
+        return level_cell_ids;
+    }
+
+    BisectionState state(number_of_nodes, max_cell_sizes);
+    std::vector<CellRange> cells;
+    Bisect(state, 0, number_of_nodes, number_of_levels, cells);
+
+    // number the cells of each level in the order of the nodes
+    std::sort(cells.begin(), cells.end(), [](const CellRange &lhs, const CellRange &rhs) {
+        return std::tie(lhs.level, lhs.begin) < std::tie(rhs.level, rhs.begin);
+    });
+    std::vector<CellID> number_of_cells(number_of_levels, 0);
+    for (const auto &cell : cells)
+    {
+        const auto cell_id = number_of_cells[cell.level]++;
+        for (auto index = cell.begin; index < cell.end; ++index)
+        {
+            level_cell_ids[cell.level][state.order[index]] = cell_id;
+        }
+    }
+
+    while (level_cell_ids.size() > 1 && number_of_cells[level_cell_ids.size() - 1] == 1)
+    {
+        level_cell_ids.pop_back();
+    }
+
+    return level_cell_ids;
+}
+
+void RecursiveBisection::Bisect(BisectionState &state,
+                                const NodeID begin,
+                                const NodeID end,
+                                std::size_t unassigned_levels,
+                                std::vector<CellRange> &cells) const
+{
+    BOOST_ASSERT(begin < end);
+
+    // a range is a cell on all levels above its parent's that it is small enough for
+    while (unassigned_levels > 0 && end - begin <= state.max_cell_sizes[unassigned_levels - 1])
+    {
+        cells.push_back(CellRange{unassigned_levels - 1, begin, end});
+        --unassigned_levels;
+    }
+    if (unassigned_levels == 0)
+    {
+        return;
+    }
+
+    OrderBreadthFirst(state, begin, end);
+    const NodeID middle = begin + (end - begin) / 2;
+    for (auto index = middle; index < end; ++index)
+    {
+        state.range_begin[state.order[index]].store(middle, std::memory_order_relaxed);
+    }
+
+    if (end - begin > PARALLEL_BISECTION_THRESHOLD)
+    {
+        std::vector<CellRange> second_cells;
+        tbb::parallel_invoke(
+            [&] { Bisect(state, begin, middle, unassigned_levels, cells); },
+            [&] { Bisect(state, middle, end, unassigned_levels, second_cells); });
+        cells.insert(cells.end(), second_cells.begin(), second_cells.end());
+    }
+    else
+    {
+        Bisect(state, begin, middle, unassigned_levels, cells);
+        Bisect(state, middle, end, unassigned_levels, cells);
+    }
+}
+
+void RecursiveBisection::OrderBreadthFirst(BisectionState &state,
+                                           const NodeID begin,
+                                           const NodeID end) const
+{
+    std::vector<NodeID> sequence;
+    sequence.reserve(end - begin);
+
+    // appends all nodes of the range reachable from start to the sequence
+    const auto search = [&](const NodeID start) {
+        auto head = sequence.size();
+        state.visited[start] = true;
+        sequence.push_back(start);
+        while (head < sequence.size())
+        {
+            const auto node = sequence[head++];
+            for (auto edge = first_edge[node]; edge < first_edge[node + 1]; ++edge)
+            {
+                const auto target = targets[edge];
+                if (state.range_begin[target].load(std::memory_order_relaxed) == begin &&
+                    !state.visited[target])
+                {
+                    state.visited[target] = true;
+                    sequence.push_back(target);
+                }
+            }
+        }
+    };
+    const auto reset_visited = [&] {
+        for (const auto node : sequence)
+        {
+            state.visited[node] = false;
+        }
+    };
+
+    // the last node reached is far away from the start, which makes a good start itself
+    search(state.order[begin]);
+    const auto start = sequence.back();
+    reset_visited();
+    sequence.clear();
+
+    search(start);
+    for (auto index = begin; index < end && sequence.size() < end - begin; ++index)
+    {
+        if (!state.visited[state.order[index]])
+        {
+            search(state.order[index]);
+        }
+    }
+    BOOST_ASSERT(sequence.size() == end - begin);
+
+    reset_visited();
+    std::copy(sequence.begin(), sequence.end(), state.order.begin() + begin);
+}
+}
+}
@@ -25,6 +25,8 @@
 #include <iostream>
 #include <iterator>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace osrm
 {
@@ -56,6 +58,11 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
 
         auto api_iterator = request_string.begin();
         auto maybe_parsed_url = api::parseURL(api_iterator, request_string.end());
+
+        // the response objects are carved out of the arena, which has to outlive the result
+        // and releases all of them at once at the end of the request
+        util::json::Arena arena;
+        util::json::ArenaScope arena_scope(arena);
         ServiceHandler::ResultT result;
 
         // check if the was an error with the request
@@ -106,6 +113,23 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
 
             util::json::render(current_reply.content, result.get<util::json::Object>());
         }
+        else if (result.is<service::RenderedResult>())
+        {
+            auto &rendered_result = result.get<service::RenderedResult>();
+            if (rendered_result.binary)
+            {
+                current_reply.headers.emplace_back("Content-Type", "application/octet-stream");
+            }
+            else
+            {
+                current_reply.headers.emplace_back("Content-Type",
+                                                   "application/json; charset=UTF-8");
+                current_reply.headers.emplace_back("Content-Disposition",
+                                                   "inline; filename=\"response.json\"");
+            }
+
+            current_reply.content = std::move(rendered_result.content);
+        }
         else
         {
             BOOST_ASSERT(result.is<std::string>());
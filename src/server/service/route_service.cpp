@@ -64,6 +64,17 @@ RouteService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &r
     }
     BOOST_ASSERT(parameters->IsValid());
 
+    if (parameters->format == engine::api::RouteParameters::OutputFormatType::Binary)
+    {
+        result = RenderedResult();
+        auto &rendered_result = result.get<RenderedResult>();
+        const auto status =
+            BaseService::routing_machine.Route(*parameters, rendered_result.content);
+        // errors are always rendered as JSON
+        rendered_result.binary = status == engine::Status::Ok;
+        return status;
+    }
+
     return BaseService::routing_machine.Route(*parameters, json_result);
 }
 }
@@ -85,7 +85,15 @@ TableService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &r
     }
     BOOST_ASSERT(parameters->IsValid());
 
-    return BaseService::routing_machine.Table(*parameters, json_result);
+    // tables can get huge, let the engine render them tile by tile
+    result = RenderedResult();
+    auto &rendered_result = result.get<RenderedResult>();
+    const auto status = BaseService::routing_machine.Table(*parameters, rendered_result.content);
+    // errors are always rendered as JSON
+    rendered_result.binary =
+        status == engine::Status::Ok &&
+        parameters->format == engine::api::TableParameters::OutputFormatType::Binary;
+    return status;
 }
 }
 }
@@ -1,5 +1,6 @@
 #include "storage/storage.hpp"
 #include "contractor/query_edge.hpp"
+#include "customizer/cell_storage.hpp"
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/guidance/turn_instruction.hpp"
 #include "extractor/original_edge_data.hpp"
@@ -7,6 +8,7 @@
 #include "extractor/query_node.hpp"
 #include "extractor/travel_mode.hpp"
 #include "storage/io.hpp"
+#include "storage/memory_image.hpp"
 #include "storage/serialization.hpp"
 #include "storage/shared_barriers.hpp"
 #include "storage/shared_datatype.hpp"
@@ -16,6 +18,7 @@
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
 #include "util/fingerprint.hpp"
+#include "util/integer_range.hpp"
 #include "util/io.hpp"
 #include "util/log.hpp"
 #include "util/packed_vector.hpp"
@@ -23,26 +26,37 @@
 #include "util/shared_memory_vector_wrapper.hpp"
 #include "util/static_graph.hpp"
 #include "util/static_rtree.hpp"
+#include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 
 #ifdef __linux__
 #include <sys/mman.h>
 #endif
 
+#include <boost/crc.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <boost/interprocess/exceptions.hpp>
 #include <boost/interprocess/sync/named_sharable_mutex.hpp>
 #include <boost/interprocess/sync/named_upgradable_mutex.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
 #include <boost/interprocess/sync/upgradable_lock.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <tbb/parallel_for.h>
 
 #include <cstdint>
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <functional>
+#include <ios>
 #include <iostream>
 #include <iterator>
 #include <new>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -53,6 +67,69 @@ using RTreeLeaf = engine::datafacade::BaseDataFacade::RTreeLeaf;
 using RTreeNode =
     util::StaticRTree<RTreeLeaf, util::ShM<util::Coordinate, true>::vector, true>::TreeNode;
 using QueryGraph = util::StaticGraph<contractor::QueryEdge::EdgeData>;
+using CellData = customizer::CellStorage::CellData;
+
+namespace
+{
+// Number of core markers that are read at once, they are stored as a byte per node
+const constexpr std::uint32_t CORE_MARKER_CHUNK_SIZE = 1u << 16;
+
+// Reads a part of the dataset, usually a file, into the blocks it lists and into no others
+struct BlockLoader
+{
+    std::string name;
+    std::vector<DataLayout::BlockID> blocks;
+    std::function<void()> load;
+};
+
+// The files may have changed since the layout was computed from them, the blocks would overflow
+void checkEntryCount(const DataLayout &layout,
+                     const DataLayout::BlockID block_id,
+                     const std::uint64_t count)
+{
+    if (count != layout.num_entries[block_id])
+    {
+        throw util::exception("Block " + std::string(block_id_to_name[block_id]) + " has " +
+                              std::to_string(count) + " entries instead of " +
+                              std::to_string(layout.num_entries[block_id]) +
+                              ", the data files changed while loading them" + SOURCE_REF);
+    }
+}
+
+// Runs the loaders concurrently and logs the time and throughput of each of them
+void runBlockLoaders(const DataLayout &layout, const std::vector<BlockLoader> &loaders)
+{
+    TIMER_START(load_blocks);
+    std::vector<double> durations(loaders.size());
+    tbb::parallel_for(std::size_t{0}, loaders.size(), [&](const std::size_t index) {
+        TIMER_START(load_block);
+        loaders[index].load();
+        TIMER_STOP(load_block);
+        durations[index] = TIMER_SEC(load_block);
+    });
+    TIMER_STOP(load_blocks);
+
+    const auto throughput = [](const std::uint64_t size, const double seconds) {
+        return size / (1024. * 1024.) / std::max(seconds, 0.000001);
+    };
+
+    std::uint64_t total_size = 0;
+    for (const auto index : util::irange<std::size_t>(0, loaders.size()))
+    {
+        std::uint64_t size = 0;
+        for (const auto block_id : loaders[index].blocks)
+        {
+            size += layout.GetBlockSize(block_id);
+        }
+        total_size += size;
+        util::Log(logDEBUG) << "loaded " << loaders[index].name << ": " << size << " bytes in "
+                            << durations[index] << "s ("
+                            << throughput(size, durations[index]) << " MiB/s)";
+    }
+    util::Log() << "loaded " << total_size << " bytes in " << TIMER_SEC(load_blocks) << "s ("
+                << throughput(total_size, TIMER_SEC(load_blocks)) << " MiB/s)";
+}
+}
 
 Storage::Storage(StorageConfig config_) : config(std::move(config_)) {}
 
@@ -250,7 +327,7 @@ Storage::ReturnCode Storage::Run(int max_wait)
  * memory needs to be allocated, and the position of each data structure
  * in that big block.  It updates the fields in the DataLayout parameter.
  */
-void Storage::PopulateLayout(DataLayout &layout)
+void Storage::PopulateLayoutFromFiles(DataLayout &layout)
 {
     {
         auto absolute_file_index_path = boost::filesystem::absolute(config.file_index_path);
@@ -307,16 +384,28 @@ void Storage::PopulateLayout(DataLayout &layout)
         layout.SetBlockSize<EntryClassID>(DataLayout::ENTRY_CLASSID, number_of_original_edges);
     }
 
-    {
-        io::FileReader hsgr_file(config.hsgr_data_path, io::FileReader::HasNoFingerprint);
+    // the graphs of osrm-contract and osrm-customize, at least one of them is there
+    layout.SetBlockSize<unsigned>(DataLayout::HSGR_CHECKSUM, 1);
+    const auto set_graph_size = [&layout](const boost::filesystem::path &path,
+                                          const DataLayout::BlockID node_block,
+                                          const DataLayout::BlockID edge_block) {
+        layout.SetBlockSize<QueryGraph::NodeArrayEntry>(node_block, 0);
+        layout.SetBlockSize<QueryGraph::EdgeArrayEntry>(edge_block, 0);
+        if (boost::filesystem::exists(path))
+        {
+            io::FileReader graph_file(path, io::FileReader::HasNoFingerprint);
 
-        const auto hsgr_header = serialization::readHSGRHeader(hsgr_file);
-        layout.SetBlockSize<unsigned>(DataLayout::HSGR_CHECKSUM, 1);
-        layout.SetBlockSize<QueryGraph::NodeArrayEntry>(DataLayout::GRAPH_NODE_LIST,
-                                                        hsgr_header.number_of_nodes);
-        layout.SetBlockSize<QueryGraph::EdgeArrayEntry>(DataLayout::GRAPH_EDGE_LIST,
-                                                        hsgr_header.number_of_edges);
-    }
+            const auto graph_header = serialization::readHSGRHeader(graph_file);
+            layout.SetBlockSize<QueryGraph::NodeArrayEntry>(node_block,
+                                                            graph_header.number_of_nodes);
+            layout.SetBlockSize<QueryGraph::EdgeArrayEntry>(edge_block,
+                                                            graph_header.number_of_edges);
+        }
+    };
+    set_graph_size(
+        config.hsgr_data_path, DataLayout::GRAPH_NODE_LIST, DataLayout::GRAPH_EDGE_LIST);
+    set_graph_size(
+        config.mld_graph_path, DataLayout::MLD_GRAPH_NODE_LIST, DataLayout::MLD_GRAPH_EDGE_LIST);
 
     // load rsearch tree size
     {
@@ -340,12 +429,52 @@ void Storage::PopulateLayout(DataLayout &layout)
     }
 
     // load core marker size
+    layout.SetBlockSize<unsigned>(DataLayout::CORE_MARKER, 0);
+    if (boost::filesystem::exists(config.core_data_path))
     {
         io::FileReader core_marker_file(config.core_data_path, io::FileReader::HasNoFingerprint);
         const auto number_of_core_markers = core_marker_file.ReadElementCount32();
         layout.SetBlockSize<unsigned>(DataLayout::CORE_MARKER, number_of_core_markers);
     }
 
+    // load the sizes of the multi-level partition and its cells
+    layout.SetBlockSize<std::uint32_t>(DataLayout::MLD_CELLS_PER_LEVEL, 0);
+    layout.SetBlockSize<CellID>(DataLayout::MLD_CELL_IDS, 0);
+    if (boost::filesystem::exists(config.partition_path))
+    {
+        io::FileReader partition_file(config.partition_path, io::FileReader::VerifyFingerprint);
+        const auto number_of_levels = partition_file.ReadElementCount64();
+        layout.SetBlockSize<std::uint32_t>(DataLayout::MLD_CELLS_PER_LEVEL, number_of_levels);
+        partition_file.Skip<std::uint32_t>(number_of_levels);
+        layout.SetBlockSize<CellID>(DataLayout::MLD_CELL_IDS, partition_file.ReadElementCount64());
+    }
+
+    layout.SetBlockSize<std::uint32_t>(DataLayout::MLD_CELL_LEVEL_OFFSETS, 0);
+    layout.SetBlockSize<CellData>(DataLayout::MLD_CELLS, 0);
+    layout.SetBlockSize<NodeID>(DataLayout::MLD_CELL_SOURCE_BOUNDARY, 0);
+    layout.SetBlockSize<NodeID>(DataLayout::MLD_CELL_DESTINATION_BOUNDARY, 0);
+    layout.SetBlockSize<EdgeWeight>(DataLayout::MLD_CELL_WEIGHTS, 0);
+    if (boost::filesystem::exists(config.cells_path))
+    {
+        io::FileReader cells_file(config.cells_path, io::FileReader::VerifyFingerprint);
+        const auto number_of_level_offsets = cells_file.ReadElementCount64();
+        layout.SetBlockSize<std::uint32_t>(DataLayout::MLD_CELL_LEVEL_OFFSETS,
+                                           number_of_level_offsets);
+        cells_file.Skip<std::uint32_t>(number_of_level_offsets);
+        const auto number_of_cells = cells_file.ReadElementCount64();
+        layout.SetBlockSize<CellData>(DataLayout::MLD_CELLS, number_of_cells);
+        cells_file.Skip<CellData>(number_of_cells);
+        const auto number_of_sources = cells_file.ReadElementCount64();
+        layout.SetBlockSize<NodeID>(DataLayout::MLD_CELL_SOURCE_BOUNDARY, number_of_sources);
+        cells_file.Skip<NodeID>(number_of_sources);
+        const auto number_of_destinations = cells_file.ReadElementCount64();
+        layout.SetBlockSize<NodeID>(DataLayout::MLD_CELL_DESTINATION_BOUNDARY,
+                                    number_of_destinations);
+        cells_file.Skip<NodeID>(number_of_destinations);
+        layout.SetBlockSize<EdgeWeight>(DataLayout::MLD_CELL_WEIGHTS,
+                                        cells_file.ReadElementCount64());
+    }
+
     // load coordinate size
     {
         io::FileReader node_file(config.nodes_data_path, io::FileReader::HasNoFingerprint);
@@ -447,441 +576,768 @@ void Storage::PopulateLayout(DataLayout &layout)
     }
 }
 
-void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
+void Storage::PopulateDataFromFiles(const DataLayout &layout, char *memory_ptr)
 {
     BOOST_ASSERT(memory_ptr != nullptr);
 
     // read actual data into shared memory object //
 
-    // Load the HSGR file
-    {
-        io::FileReader hsgr_file(config.hsgr_data_path, io::FileReader::HasNoFingerprint);
-        auto hsgr_header = serialization::readHSGRHeader(hsgr_file);
-        unsigned *checksum_ptr =
-            layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::HSGR_CHECKSUM);
-        *checksum_ptr = hsgr_header.checksum;
-
+    // The checksum is the one of the contracted graph of osrm-contract if there is one, else the
+    // one of the graph of osrm-customize
+    std::uint32_t hsgr_checksum = 0;
+    std::uint32_t mld_checksum = 0;
+    const auto load_graph = [&](const boost::filesystem::path &path,
+                                const DataLayout::BlockID node_block,
+                                const DataLayout::BlockID edge_block,
+                                std::uint32_t &checksum) {
         // load the nodes of the search graph
         QueryGraph::NodeArrayEntry *graph_node_list_ptr =
-            layout.GetBlockPtr<QueryGraph::NodeArrayEntry, true>(memory_ptr,
-                                                                 DataLayout::GRAPH_NODE_LIST);
+            layout.GetBlockPtr<QueryGraph::NodeArrayEntry, true>(memory_ptr, node_block);
 
         // load the edges of the search graph
         QueryGraph::EdgeArrayEntry *graph_edge_list_ptr =
-            layout.GetBlockPtr<QueryGraph::EdgeArrayEntry, true>(memory_ptr,
-                                                                 DataLayout::GRAPH_EDGE_LIST);
+            layout.GetBlockPtr<QueryGraph::EdgeArrayEntry, true>(memory_ptr, edge_block);
+
+        if (!boost::filesystem::exists(path))
+        {
+            return;
+        }
+
+        io::FileReader hsgr_file(path, io::FileReader::HasNoFingerprint);
+        auto hsgr_header = serialization::readHSGRHeader(hsgr_file);
+        checksum = hsgr_header.checksum;
+        checkEntryCount(layout, node_block, hsgr_header.number_of_nodes);
+        checkEntryCount(layout, edge_block, hsgr_header.number_of_edges);
 
         serialization::readHSGR(hsgr_file,
                                 graph_node_list_ptr,
                                 hsgr_header.number_of_nodes,
                                 graph_edge_list_ptr,
                                 hsgr_header.number_of_edges);
-    }
-
-    // store the filename of the on-disk portion of the RTree
-    {
-        const auto file_index_path_ptr =
-            layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::FILE_INDEX_PATH);
-        // make sure we have 0 ending
-        std::fill(file_index_path_ptr,
-                  file_index_path_ptr + layout.GetBlockSize(DataLayout::FILE_INDEX_PATH),
-                  0);
-        const auto absolute_file_index_path =
-            boost::filesystem::absolute(config.file_index_path).string();
-        BOOST_ASSERT(static_cast<std::size_t>(layout.GetBlockSize(DataLayout::FILE_INDEX_PATH)) >=
-                     absolute_file_index_path.size());
-        std::copy(
-            absolute_file_index_path.begin(), absolute_file_index_path.end(), file_index_path_ptr);
-    }
+    };
+
+    // Every loader only writes to the blocks it lists, so they can run concurrently
+    std::vector<BlockLoader> loaders;
+
+    loaders.push_back({"contracted graph",
+                       {DataLayout::GRAPH_NODE_LIST, DataLayout::GRAPH_EDGE_LIST},
+                       [&] {
+                           load_graph(config.hsgr_data_path,
+                                      DataLayout::GRAPH_NODE_LIST,
+                                      DataLayout::GRAPH_EDGE_LIST,
+                                      hsgr_checksum);
+                       }});
+
+    loaders.push_back({"multi-level graph",
+                       {DataLayout::MLD_GRAPH_NODE_LIST, DataLayout::MLD_GRAPH_EDGE_LIST},
+                       [&] {
+                           load_graph(config.mld_graph_path,
+                                      DataLayout::MLD_GRAPH_NODE_LIST,
+                                      DataLayout::MLD_GRAPH_EDGE_LIST,
+                                      mld_checksum);
+                       }});
 
     // Name data
-    {
-        io::FileReader name_file(config.names_data_path, io::FileReader::HasNoFingerprint);
-        const auto name_blocks_count = name_file.ReadElementCount32();
-        name_file.Skip<std::uint32_t>(1); // name_char_list_count
+    loaders.push_back(
+        {"names",
+         {DataLayout::NAME_OFFSETS, DataLayout::NAME_BLOCKS, DataLayout::NAME_CHAR_LIST},
+         [&] {
+             io::FileReader name_file(config.names_data_path, io::FileReader::HasNoFingerprint);
+             const auto name_blocks_count = name_file.ReadElementCount32();
+             name_file.Skip<std::uint32_t>(1); // name_char_list_count
 
-        BOOST_ASSERT(name_blocks_count * sizeof(unsigned) ==
-                     layout.GetBlockSize(DataLayout::NAME_OFFSETS));
-        BOOST_ASSERT(name_blocks_count * sizeof(typename util::RangeTable<16, true>::BlockT) ==
-                     layout.GetBlockSize(DataLayout::NAME_BLOCKS));
+             checkEntryCount(layout, DataLayout::NAME_OFFSETS, name_blocks_count);
+             checkEntryCount(layout, DataLayout::NAME_BLOCKS, name_blocks_count);
 
-        // Loading street names
-        const auto name_offsets_ptr =
-            layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::NAME_OFFSETS);
-        name_file.ReadInto(name_offsets_ptr, name_blocks_count);
+             // Loading street names
+             const auto name_offsets_ptr =
+                 layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::NAME_OFFSETS);
+             name_file.ReadInto(name_offsets_ptr, name_blocks_count);
 
-        const auto name_blocks_ptr =
-            layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::NAME_BLOCKS);
-        name_file.ReadInto(reinterpret_cast<char *>(name_blocks_ptr),
-                           layout.GetBlockSize(DataLayout::NAME_BLOCKS));
+             const auto name_blocks_ptr =
+                 layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::NAME_BLOCKS);
+             name_file.ReadInto(reinterpret_cast<char *>(name_blocks_ptr),
+                                layout.GetBlockSize(DataLayout::NAME_BLOCKS));
 
-        // The file format contains the element count a second time.  Don't know why,
-        // but we need to read it here to progress the file pointer to the correct spot
-        const auto temp_count = name_file.ReadElementCount32();
+             // The file format contains the element count a second time.  Don't know why,
+             // but we need to read it here to progress the file pointer to the correct spot
+             const auto temp_count = name_file.ReadElementCount32();
 
-        const auto name_char_ptr =
-            layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::NAME_CHAR_LIST);
+             const auto name_char_ptr =
+                 layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::NAME_CHAR_LIST);
 
-        BOOST_ASSERT_MSG(temp_count == layout.GetBlockSize(DataLayout::NAME_CHAR_LIST),
-                         "Name file corrupted!");
+             checkEntryCount(layout, DataLayout::NAME_CHAR_LIST, temp_count);
 
-        name_file.ReadInto(name_char_ptr, temp_count);
-    }
+             name_file.ReadInto(name_char_ptr, temp_count);
+         }});
 
     // Turn lane data
-    {
-        io::FileReader lane_data_file(config.turn_lane_data_path, io::FileReader::HasNoFingerprint);
+    loaders.push_back({"turn lane data", {DataLayout::TURN_LANE_DATA}, [&] {
+                           io::FileReader lane_data_file(config.turn_lane_data_path,
+                                                         io::FileReader::HasNoFingerprint);
+
+                           const auto lane_tuple_count = lane_data_file.ReadElementCount64();
+
+                           // Need to call GetBlockPtr -> it write the memory canary, even if no
+                           // data needs to be loaded.
+                           const auto turn_lane_data_ptr =
+                               layout.GetBlockPtr<util::guidance::LaneTupleIdPair, true>(
+                                   memory_ptr, DataLayout::TURN_LANE_DATA);
+                           checkEntryCount(layout, DataLayout::TURN_LANE_DATA, lane_tuple_count);
+                           lane_data_file.ReadInto(turn_lane_data_ptr, lane_tuple_count);
+                       }});
+
+    // Turn lane descriptions, an adjacency array of offsets and masks
+    loaders.push_back(
+        {"turn lane descriptions",
+         {DataLayout::LANE_DESCRIPTION_OFFSETS, DataLayout::LANE_DESCRIPTION_MASKS},
+         [&] {
+             io::FileReader lane_description_file(config.turn_lane_description_path,
+                                                  io::FileReader::HasNoFingerprint);
+
+             const auto turn_lane_offset_ptr = layout.GetBlockPtr<std::uint32_t, true>(
+                 memory_ptr, DataLayout::LANE_DESCRIPTION_OFFSETS);
+             const auto offsets_count = lane_description_file.ReadElementCount64();
+             checkEntryCount(layout, DataLayout::LANE_DESCRIPTION_OFFSETS, offsets_count);
+             lane_description_file.ReadInto(turn_lane_offset_ptr, offsets_count);
+
+             const auto turn_lane_mask_ptr =
+                 layout.GetBlockPtr<extractor::guidance::TurnLaneType::Mask, true>(
+                     memory_ptr, DataLayout::LANE_DESCRIPTION_MASKS);
+             const auto masks_count = lane_description_file.ReadElementCount64();
+             checkEntryCount(layout, DataLayout::LANE_DESCRIPTION_MASKS, masks_count);
+             lane_description_file.ReadInto(turn_lane_mask_ptr, masks_count);
+         }});
 
-        const auto lane_tuple_count = lane_data_file.ReadElementCount64();
+    // Load original edge data
+    loaders.push_back(
+        {"original edges",
+         {DataLayout::VIA_NODE_LIST,
+          DataLayout::NAME_ID_LIST,
+          DataLayout::TRAVEL_MODE,
+          DataLayout::PRE_TURN_BEARING,
+          DataLayout::POST_TURN_BEARING,
+          DataLayout::LANE_DATA_ID,
+          DataLayout::TURN_INSTRUCTION,
+          DataLayout::ENTRY_CLASSID},
+         [&] {
+             io::FileReader edges_input_file(config.edges_data_path,
+                                             io::FileReader::HasNoFingerprint);
 
-        // Need to call GetBlockPtr -> it write the memory canary, even if no data needs to be
-        // loaded.
-        const auto turn_lane_data_ptr = layout.GetBlockPtr<util::guidance::LaneTupleIdPair, true>(
-            memory_ptr, DataLayout::TURN_LANE_DATA);
-        BOOST_ASSERT(lane_tuple_count * sizeof(util::guidance::LaneTupleIdPair) ==
-                     layout.GetBlockSize(DataLayout::TURN_LANE_DATA));
-        lane_data_file.ReadInto(turn_lane_data_ptr, lane_tuple_count);
-    }
+             const auto number_of_original_edges = edges_input_file.ReadElementCount64();
+             checkEntryCount(layout, DataLayout::VIA_NODE_LIST, number_of_original_edges);
+
+             const auto via_geometry_ptr =
+                 layout.GetBlockPtr<GeometryID, true>(memory_ptr, DataLayout::VIA_NODE_LIST);
+
+             const auto name_id_ptr =
+                 layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::NAME_ID_LIST);
+
+             const auto travel_mode_ptr = layout.GetBlockPtr<extractor::TravelMode, true>(
+                 memory_ptr, DataLayout::TRAVEL_MODE);
+             const auto pre_turn_bearing_ptr =
+                 layout.GetBlockPtr<util::guidance::TurnBearing, true>(
+                     memory_ptr, DataLayout::PRE_TURN_BEARING);
+             const auto post_turn_bearing_ptr =
+                 layout.GetBlockPtr<util::guidance::TurnBearing, true>(
+                     memory_ptr, DataLayout::POST_TURN_BEARING);
+
+             const auto lane_data_id_ptr =
+                 layout.GetBlockPtr<LaneDataID, true>(memory_ptr, DataLayout::LANE_DATA_ID);
+
+             const auto turn_instructions_ptr =
+                 layout.GetBlockPtr<extractor::guidance::TurnInstruction, true>(
+                     memory_ptr, DataLayout::TURN_INSTRUCTION);
+
+             const auto entry_class_id_ptr =
+                 layout.GetBlockPtr<EntryClassID, true>(memory_ptr, DataLayout::ENTRY_CLASSID);
+
+             serialization::readEdges(edges_input_file,
+                                      via_geometry_ptr,
+                                      name_id_ptr,
+                                      turn_instructions_ptr,
+                                      lane_data_id_ptr,
+                                      travel_mode_ptr,
+                                      entry_class_id_ptr,
+                                      pre_turn_bearing_ptr,
+                                      post_turn_bearing_ptr,
+                                      number_of_original_edges);
+         }});
 
-    // Turn lane descriptions
-    {
-        std::vector<std::uint32_t> lane_description_offsets;
-        std::vector<extractor::guidance::TurnLaneType::Mask> lane_description_masks;
-        util::deserializeAdjacencyArray(config.turn_lane_description_path.string(),
-                                        lane_description_offsets,
-                                        lane_description_masks);
+    // load compressed geometry
+    loaders.push_back(
+        {"geometries",
+         {DataLayout::GEOMETRIES_INDEX,
+          DataLayout::GEOMETRIES_NODE_LIST,
+          DataLayout::GEOMETRIES_FWD_WEIGHT_LIST,
+          DataLayout::GEOMETRIES_REV_WEIGHT_LIST},
+         [&] {
+             io::FileReader geometry_input_file(config.geometries_path,
+                                                io::FileReader::HasNoFingerprint);
 
-        const auto turn_lane_offset_ptr = layout.GetBlockPtr<std::uint32_t, true>(
-            memory_ptr, DataLayout::LANE_DESCRIPTION_OFFSETS);
-        if (!lane_description_offsets.empty())
-        {
-            BOOST_ASSERT(
-                static_cast<std::size_t>(
-                    layout.GetBlockSize(DataLayout::LANE_DESCRIPTION_OFFSETS)) >=
-                std::distance(lane_description_offsets.begin(), lane_description_offsets.end()) *
-                    sizeof(decltype(lane_description_offsets)::value_type));
-            std::copy(lane_description_offsets.begin(),
-                      lane_description_offsets.end(),
-                      turn_lane_offset_ptr);
-        }
+             const auto geometry_index_count = geometry_input_file.ReadElementCount32();
+             const auto geometries_index_ptr =
+                 layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::GEOMETRIES_INDEX);
+             checkEntryCount(layout, DataLayout::GEOMETRIES_INDEX, geometry_index_count);
+             geometry_input_file.ReadInto(geometries_index_ptr, geometry_index_count);
+
+             const auto geometries_node_id_list_ptr =
+                 layout.GetBlockPtr<NodeID, true>(memory_ptr, DataLayout::GEOMETRIES_NODE_LIST);
+             const auto geometry_node_lists_count = geometry_input_file.ReadElementCount32();
+             checkEntryCount(layout, DataLayout::GEOMETRIES_NODE_LIST, geometry_node_lists_count);
+             geometry_input_file.ReadInto(geometries_node_id_list_ptr,
+                                          geometry_node_lists_count);
+
+             const auto geometries_fwd_weight_list_ptr = layout.GetBlockPtr<EdgeWeight, true>(
+                 memory_ptr, DataLayout::GEOMETRIES_FWD_WEIGHT_LIST);
+             checkEntryCount(
+                 layout, DataLayout::GEOMETRIES_FWD_WEIGHT_LIST, geometry_node_lists_count);
+             geometry_input_file.ReadInto(geometries_fwd_weight_list_ptr,
+                                          geometry_node_lists_count);
+
+             const auto geometries_rev_weight_list_ptr = layout.GetBlockPtr<EdgeWeight, true>(
+                 memory_ptr, DataLayout::GEOMETRIES_REV_WEIGHT_LIST);
+             checkEntryCount(
+                 layout, DataLayout::GEOMETRIES_REV_WEIGHT_LIST, geometry_node_lists_count);
+             geometry_input_file.ReadInto(geometries_rev_weight_list_ptr,
+                                          geometry_node_lists_count);
+         }});
+
+    loaders.push_back({"datasource indexes", {DataLayout::DATASOURCES_LIST}, [&] {
+                           io::FileReader geometry_datasource_file(
+                               config.datasource_indexes_path, io::FileReader::HasNoFingerprint);
+                           const auto number_of_compressed_datasources =
+                               geometry_datasource_file.ReadElementCount64();
+                           checkEntryCount(layout,
+                                           DataLayout::DATASOURCES_LIST,
+                                           number_of_compressed_datasources);
+
+                           // load datasource information (if it exists)
+                           const auto datasources_list_ptr = layout.GetBlockPtr<uint8_t, true>(
+                               memory_ptr, DataLayout::DATASOURCES_LIST);
+                           if (number_of_compressed_datasources > 0)
+                           {
+                               serialization::readDatasourceIndexes(
+                                   geometry_datasource_file,
+                                   datasources_list_ptr,
+                                   number_of_compressed_datasources);
+                           }
+                       }});
+
+    // The names are a text file with a line per datasource, which is parsed and copied
+    loaders.push_back(
+        {"datasource names",
+         {DataLayout::DATASOURCE_NAME_DATA,
+          DataLayout::DATASOURCE_NAME_OFFSETS,
+          DataLayout::DATASOURCE_NAME_LENGTHS},
+         [&] {
+             io::FileReader datasource_names_file(config.datasource_names_path,
+                                                  io::FileReader::HasNoFingerprint);
+
+             const auto datasource_names_data =
+                 serialization::readDatasourceNames(datasource_names_file);
+
+             // load datasource name information (if it exists)
+             const auto datasource_name_data_ptr =
+                 layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::DATASOURCE_NAME_DATA);
+             checkEntryCount(
+                 layout, DataLayout::DATASOURCE_NAME_DATA, datasource_names_data.names.size());
+             std::copy(datasource_names_data.names.begin(),
+                       datasource_names_data.names.end(),
+                       datasource_name_data_ptr);
+
+             const auto datasource_name_offsets_ptr = layout.GetBlockPtr<std::size_t, true>(
+                 memory_ptr, DataLayout::DATASOURCE_NAME_OFFSETS);
+             checkEntryCount(
+                 layout, DataLayout::DATASOURCE_NAME_OFFSETS, datasource_names_data.offsets.size());
+             std::copy(datasource_names_data.offsets.begin(),
+                       datasource_names_data.offsets.end(),
+                       datasource_name_offsets_ptr);
+
+             const auto datasource_name_lengths_ptr = layout.GetBlockPtr<std::size_t, true>(
+                 memory_ptr, DataLayout::DATASOURCE_NAME_LENGTHS);
+             checkEntryCount(
+                 layout, DataLayout::DATASOURCE_NAME_LENGTHS, datasource_names_data.lengths.size());
+             std::copy(datasource_names_data.lengths.begin(),
+                       datasource_names_data.lengths.end(),
+                       datasource_name_lengths_ptr);
+         }});
 
-        const auto turn_lane_mask_ptr =
-            layout.GetBlockPtr<extractor::guidance::TurnLaneType::Mask, true>(
-                memory_ptr, DataLayout::LANE_DESCRIPTION_MASKS);
-        if (!lane_description_masks.empty())
-        {
-            BOOST_ASSERT(
-                static_cast<std::size_t>(layout.GetBlockSize(DataLayout::LANE_DESCRIPTION_MASKS)) >=
-                std::distance(lane_description_masks.begin(), lane_description_masks.end()) *
-                    sizeof(decltype(lane_description_masks)::value_type));
-            std::copy(
-                lane_description_masks.begin(), lane_description_masks.end(), turn_lane_mask_ptr);
-        }
-    }
+    // Loading list of coordinates
+    loaders.push_back(
+        {"nodes", {DataLayout::COORDINATE_LIST, DataLayout::OSM_NODE_ID_LIST}, [&] {
+             io::FileReader nodes_file(config.nodes_data_path, io::FileReader::HasNoFingerprint);
+             nodes_file.Skip<std::uint64_t>(1); // node_count
+             const auto coordinates_ptr = layout.GetBlockPtr<util::Coordinate, true>(
+                 memory_ptr, DataLayout::COORDINATE_LIST);
+             const auto osmnodeid_ptr = layout.GetBlockPtr<std::uint64_t, true>(
+                 memory_ptr, DataLayout::OSM_NODE_ID_LIST);
+             util::PackedVector<OSMNodeID, true> osmnodeid_list;
+
+             osmnodeid_list.reset(osmnodeid_ptr,
+                                  layout.num_entries[DataLayout::OSM_NODE_ID_LIST]);
+
+             serialization::readNodes(nodes_file,
+                                      coordinates_ptr,
+                                      osmnodeid_list,
+                                      layout.num_entries[DataLayout::COORDINATE_LIST]);
+         }});
 
-    // Load original edge data
-    {
-        io::FileReader edges_input_file(config.edges_data_path, io::FileReader::HasNoFingerprint);
+    // store timestamp
+    loaders.push_back({"timestamp", {DataLayout::TIMESTAMP}, [&] {
+                           io::FileReader timestamp_file(config.timestamp_path,
+                                                         io::FileReader::HasNoFingerprint);
+                           const auto timestamp_size = timestamp_file.Size();
 
-        const auto number_of_original_edges = edges_input_file.ReadElementCount64();
+                           const auto timestamp_ptr =
+                               layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::TIMESTAMP);
+                           checkEntryCount(layout, DataLayout::TIMESTAMP, timestamp_size);
+                           timestamp_file.ReadInto(timestamp_ptr, timestamp_size);
+                       }});
 
-        const auto via_geometry_ptr =
-            layout.GetBlockPtr<GeometryID, true>(memory_ptr, DataLayout::VIA_NODE_LIST);
+    // store search tree portion of rtree
+    loaders.push_back({"rtree", {DataLayout::R_SEARCH_TREE}, [&] {
+                           io::FileReader tree_node_file(config.ram_index_path,
+                                                         io::FileReader::HasNoFingerprint);
+                           // perform this read so that we're at the right stream position for
+                           // the next read.
+                           tree_node_file.Skip<std::uint64_t>(1);
+                           const auto rtree_ptr = layout.GetBlockPtr<RTreeNode, true>(
+                               memory_ptr, DataLayout::R_SEARCH_TREE);
+
+                           tree_node_file.ReadInto(rtree_ptr,
+                                                   layout.num_entries[DataLayout::R_SEARCH_TREE]);
+                       }});
+
+    // The core markers are stored as a byte per node and packed into bits while reading them
+    loaders.push_back({"core markers", {DataLayout::CORE_MARKER}, [&] {
+                           const auto core_marker_ptr = layout.GetBlockPtr<unsigned, true>(
+                               memory_ptr, DataLayout::CORE_MARKER);
+                           std::fill(core_marker_ptr,
+                                     core_marker_ptr + layout.num_entries[DataLayout::CORE_MARKER],
+                                     0u);
+
+                           if (!boost::filesystem::exists(config.core_data_path))
+                           {
+                               return;
+                           }
+
+                           io::FileReader core_marker_file(config.core_data_path,
+                                                           io::FileReader::HasNoFingerprint);
+                           const auto number_of_core_markers =
+                               core_marker_file.ReadElementCount32();
+                           checkEntryCount(
+                               layout, DataLayout::CORE_MARKER, number_of_core_markers);
+
+                           std::vector<char> core_markers(CORE_MARKER_CHUNK_SIZE);
+                           for (std::uint32_t begin = 0; begin < number_of_core_markers;
+                                begin += CORE_MARKER_CHUNK_SIZE)
+                           {
+                               const auto count = std::min<std::uint32_t>(
+                                   CORE_MARKER_CHUNK_SIZE, number_of_core_markers - begin);
+                               core_marker_file.ReadInto(core_markers.data(), count);
+
+                               for (const auto i : util::irange<std::uint32_t>(0, count))
+                               {
+                                   BOOST_ASSERT(core_markers[i] == 0 || core_markers[i] == 1);
+                                   if (core_markers[i] == 1)
+                                   {
+                                       const auto node = begin + i;
+                                       core_marker_ptr[node / 32] |= 1u << (node % 32);
+                                   }
+                               }
+                           }
+                       }});
+
+    // load the multi-level partition
+    loaders.push_back(
+        {"partition", {DataLayout::MLD_CELLS_PER_LEVEL, DataLayout::MLD_CELL_IDS}, [&] {
+             const auto cells_per_level_ptr = layout.GetBlockPtr<std::uint32_t, true>(
+                 memory_ptr, DataLayout::MLD_CELLS_PER_LEVEL);
+             const auto cell_ids_ptr =
+                 layout.GetBlockPtr<CellID, true>(memory_ptr, DataLayout::MLD_CELL_IDS);
+
+             if (boost::filesystem::exists(config.partition_path))
+             {
+                 io::FileReader partition_file(config.partition_path,
+                                               io::FileReader::VerifyFingerprint);
+                 const auto read_block = [&](const DataLayout::BlockID block_id, auto *ptr) {
+                     const auto count = partition_file.ReadElementCount64();
+                     checkEntryCount(layout, block_id, count);
+                     partition_file.ReadInto(ptr, count);
+                 };
+                 read_block(DataLayout::MLD_CELLS_PER_LEVEL, cells_per_level_ptr);
+                 read_block(DataLayout::MLD_CELL_IDS, cell_ids_ptr);
+             }
+         }});
+
+    // load the boundary nodes and cliques of the cells
+    loaders.push_back(
+        {"cells",
+         {DataLayout::MLD_CELL_LEVEL_OFFSETS,
+          DataLayout::MLD_CELLS,
+          DataLayout::MLD_CELL_SOURCE_BOUNDARY,
+          DataLayout::MLD_CELL_DESTINATION_BOUNDARY,
+          DataLayout::MLD_CELL_WEIGHTS},
+         [&] {
+             const auto level_offsets_ptr = layout.GetBlockPtr<std::uint32_t, true>(
+                 memory_ptr, DataLayout::MLD_CELL_LEVEL_OFFSETS);
+             const auto cells_ptr =
+                 layout.GetBlockPtr<CellData, true>(memory_ptr, DataLayout::MLD_CELLS);
+             const auto source_boundary_ptr = layout.GetBlockPtr<NodeID, true>(
+                 memory_ptr, DataLayout::MLD_CELL_SOURCE_BOUNDARY);
+             const auto destination_boundary_ptr = layout.GetBlockPtr<NodeID, true>(
+                 memory_ptr, DataLayout::MLD_CELL_DESTINATION_BOUNDARY);
+             const auto weights_ptr =
+                 layout.GetBlockPtr<EdgeWeight, true>(memory_ptr, DataLayout::MLD_CELL_WEIGHTS);
+
+             if (boost::filesystem::exists(config.cells_path))
+             {
+                 io::FileReader cells_file(config.cells_path, io::FileReader::VerifyFingerprint);
+                 const auto read_block = [&](const DataLayout::BlockID block_id, auto *ptr) {
+                     const auto count = cells_file.ReadElementCount64();
+                     checkEntryCount(layout, block_id, count);
+                     cells_file.ReadInto(ptr, count);
+                 };
+                 read_block(DataLayout::MLD_CELL_LEVEL_OFFSETS, level_offsets_ptr);
+                 read_block(DataLayout::MLD_CELLS, cells_ptr);
+                 read_block(DataLayout::MLD_CELL_SOURCE_BOUNDARY, source_boundary_ptr);
+                 read_block(DataLayout::MLD_CELL_DESTINATION_BOUNDARY, destination_boundary_ptr);
+                 read_block(DataLayout::MLD_CELL_WEIGHTS, weights_ptr);
+             }
+         }});
 
-        const auto name_id_ptr =
-            layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::NAME_ID_LIST);
+    // load profile properties
+    loaders.push_back({"profile properties", {DataLayout::PROPERTIES}, [&] {
+                           io::FileReader profile_properties_file(
+                               config.properties_path, io::FileReader::HasNoFingerprint);
+                           const auto profile_properties_ptr =
+                               layout.GetBlockPtr<extractor::ProfileProperties, true>(
+                                   memory_ptr, DataLayout::PROPERTIES);
+                           profile_properties_file.ReadInto(
+                               profile_properties_ptr, layout.num_entries[DataLayout::PROPERTIES]);
+                       }});
 
-        const auto travel_mode_ptr =
-            layout.GetBlockPtr<extractor::TravelMode, true>(memory_ptr, DataLayout::TRAVEL_MODE);
-        const auto pre_turn_bearing_ptr = layout.GetBlockPtr<util::guidance::TurnBearing, true>(
-            memory_ptr, DataLayout::PRE_TURN_BEARING);
-        const auto post_turn_bearing_ptr = layout.GetBlockPtr<util::guidance::TurnBearing, true>(
-            memory_ptr, DataLayout::POST_TURN_BEARING);
+    // Load intersection data
+    loaders.push_back(
+        {"intersection classes",
+         {DataLayout::BEARING_CLASSID,
+          DataLayout::BEARING_OFFSETS,
+          DataLayout::BEARING_BLOCKS,
+          DataLayout::BEARING_VALUES,
+          DataLayout::ENTRY_CLASS},
+         [&] {
+             io::FileReader intersection_file(config.intersection_class_path,
+                                              io::FileReader::VerifyFingerprint);
+
+             const auto bearing_id_ptr =
+                 layout.GetBlockPtr<BearingClassID, true>(memory_ptr, DataLayout::BEARING_CLASSID);
+             const auto bearing_class_id_count = intersection_file.ReadElementCount64();
+             checkEntryCount(layout, DataLayout::BEARING_CLASSID, bearing_class_id_count);
+             intersection_file.ReadInto(bearing_id_ptr, bearing_class_id_count);
+
+             const auto bearing_blocks = intersection_file.ReadElementCount32();
+             intersection_file.Skip<std::uint32_t>(1); // sum_lengths
+
+             const auto bearing_offsets_ptr =
+                 layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::BEARING_OFFSETS);
+             checkEntryCount(layout, DataLayout::BEARING_OFFSETS, bearing_blocks);
+             intersection_file.ReadInto(bearing_offsets_ptr, bearing_blocks);
+
+             const auto bearing_blocks_ptr =
+                 layout.GetBlockPtr<typename util::RangeTable<16, true>::BlockT, true>(
+                     memory_ptr, DataLayout::BEARING_BLOCKS);
+             checkEntryCount(layout, DataLayout::BEARING_BLOCKS, bearing_blocks);
+             intersection_file.ReadInto(bearing_blocks_ptr, bearing_blocks);
+
+             const auto bearing_class_ptr =
+                 layout.GetBlockPtr<DiscreteBearing, true>(memory_ptr, DataLayout::BEARING_VALUES);
+             const auto num_bearings = intersection_file.ReadElementCount64();
+             checkEntryCount(layout, DataLayout::BEARING_VALUES, num_bearings);
+             intersection_file.ReadInto(bearing_class_ptr, num_bearings);
+
+             const auto entry_class_ptr = layout.GetBlockPtr<util::guidance::EntryClass, true>(
+                 memory_ptr, DataLayout::ENTRY_CLASS);
+             const auto entry_class_count = intersection_file.ReadElementCount64();
+             checkEntryCount(layout, DataLayout::ENTRY_CLASS, entry_class_count);
+             intersection_file.ReadInto(entry_class_ptr, entry_class_count);
+         }});
 
-        const auto lane_data_id_ptr =
-            layout.GetBlockPtr<LaneDataID, true>(memory_ptr, DataLayout::LANE_DATA_ID);
+    // store the filename of the on-disk portion of the RTree
+    {
+        const auto file_index_path_ptr =
+            layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::FILE_INDEX_PATH);
+        // make sure we have 0 ending
+        std::fill(file_index_path_ptr,
+                  file_index_path_ptr + layout.GetBlockSize(DataLayout::FILE_INDEX_PATH),
+                  0);
+        const auto absolute_file_index_path =
+            boost::filesystem::absolute(config.file_index_path).string();
+        BOOST_ASSERT(static_cast<std::size_t>(layout.GetBlockSize(DataLayout::FILE_INDEX_PATH)) >=
+                     absolute_file_index_path.size());
+        std::copy(
+            absolute_file_index_path.begin(), absolute_file_index_path.end(), file_index_path_ptr);
+    }
 
-        const auto turn_instructions_ptr =
-            layout.GetBlockPtr<extractor::guidance::TurnInstruction, true>(
-                memory_ptr, DataLayout::TURN_INSTRUCTION);
+    runBlockLoaders(layout, loaders);
 
-        const auto entry_class_id_ptr =
-            layout.GetBlockPtr<EntryClassID, true>(memory_ptr, DataLayout::ENTRY_CLASSID);
+    unsigned *checksum_ptr =
+        layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::HSGR_CHECKSUM);
+    *checksum_ptr = hsgr_checksum != 0 ? hsgr_checksum : mld_checksum;
+}
 
-        serialization::readEdges(edges_input_file,
-                                 via_geometry_ptr,
-                                 name_id_ptr,
-                                 turn_instructions_ptr,
-                                 lane_data_id_ptr,
-                                 travel_mode_ptr,
-                                 entry_class_id_ptr,
-                                 pre_turn_bearing_ptr,
-                                 post_turn_bearing_ptr,
-                                 number_of_original_edges);
+void Storage::PopulateLayout(DataLayout &layout)
+{
+    layout_from_memory_image = IsMemoryImageCurrent();
+    if (layout_from_memory_image)
+    {
+        util::Log() << "load layout from memory image " << config.memory_image_path;
+        layout = ReadMemoryImageHeader().layout;
+        return;
     }
+    PopulateLayoutFromFiles(layout);
+}
 
-    // load compressed geometry
+void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
+{
+    BOOST_ASSERT(memory_ptr != nullptr);
+    if (layout_from_memory_image)
     {
-        io::FileReader geometry_input_file(config.geometries_path,
-                                           io::FileReader::HasNoFingerprint);
-
-        const auto geometry_index_count = geometry_input_file.ReadElementCount32();
-        const auto geometries_index_ptr =
-            layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::GEOMETRIES_INDEX);
-        BOOST_ASSERT(geometry_index_count == layout.num_entries[DataLayout::GEOMETRIES_INDEX]);
-        geometry_input_file.ReadInto(geometries_index_ptr, geometry_index_count);
-
-        const auto geometries_node_id_list_ptr =
-            layout.GetBlockPtr<NodeID, true>(memory_ptr, DataLayout::GEOMETRIES_NODE_LIST);
-        const auto geometry_node_lists_count = geometry_input_file.ReadElementCount32();
-        BOOST_ASSERT(geometry_node_lists_count ==
-                     layout.num_entries[DataLayout::GEOMETRIES_NODE_LIST]);
-        geometry_input_file.ReadInto(geometries_node_id_list_ptr, geometry_node_lists_count);
-
-        const auto geometries_fwd_weight_list_ptr = layout.GetBlockPtr<EdgeWeight, true>(
-            memory_ptr, DataLayout::GEOMETRIES_FWD_WEIGHT_LIST);
-        BOOST_ASSERT(geometry_node_lists_count ==
-                     layout.num_entries[DataLayout::GEOMETRIES_FWD_WEIGHT_LIST]);
-        geometry_input_file.ReadInto(geometries_fwd_weight_list_ptr, geometry_node_lists_count);
-
-        const auto geometries_rev_weight_list_ptr = layout.GetBlockPtr<EdgeWeight, true>(
-            memory_ptr, DataLayout::GEOMETRIES_REV_WEIGHT_LIST);
-        BOOST_ASSERT(geometry_node_lists_count ==
-                     layout.num_entries[DataLayout::GEOMETRIES_REV_WEIGHT_LIST]);
-        geometry_input_file.ReadInto(geometries_rev_weight_list_ptr, geometry_node_lists_count);
+        ReadMemoryImage(layout, memory_ptr);
+        return;
     }
+    PopulateDataFromFiles(layout, memory_ptr);
+}
 
+void Storage::CheckMemoryImageHeader(const MemoryImageHeader &header,
+                                     const std::uint64_t file_size,
+                                     const boost::filesystem::path &path)
+{
+    if (!header.fingerprint.IsMagicNumberOK(util::FingerPrint::GetValid()) ||
+        !header.fingerprint.TestGraphUtil(util::FingerPrint::GetValid()))
     {
-        io::FileReader geometry_datasource_file(config.datasource_indexes_path,
-                                                io::FileReader::HasNoFingerprint);
-        const auto number_of_compressed_datasources = geometry_datasource_file.ReadElementCount64();
-
-        // load datasource information (if it exists)
-        const auto datasources_list_ptr =
-            layout.GetBlockPtr<uint8_t, true>(memory_ptr, DataLayout::DATASOURCES_LIST);
-        if (number_of_compressed_datasources > 0)
-        {
-            serialization::readDatasourceIndexes(
-                geometry_datasource_file, datasources_list_ptr, number_of_compressed_datasources);
-        }
+        throw util::exception("Memory image " + path.string() +
+                              " was written by an incompatible version" + SOURCE_REF);
     }
-
+    if (file_size != MEMORY_IMAGE_DATA_OFFSET + header.layout.GetSizeOfLayout())
     {
-        /* Load names */
-        io::FileReader datasource_names_file(config.datasource_names_path,
-                                             io::FileReader::HasNoFingerprint);
-
-        const auto datasource_names_data =
-            serialization::readDatasourceNames(datasource_names_file);
+        throw util::exception("Memory image " + path.string() + " has " +
+                              std::to_string(file_size) + " bytes instead of " +
+                              std::to_string(MEMORY_IMAGE_DATA_OFFSET +
+                                             header.layout.GetSizeOfLayout()) +
+                              SOURCE_REF);
+    }
 
-        // load datasource name information (if it exists)
-        const auto datasource_name_data_ptr =
-            layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::DATASOURCE_NAME_DATA);
-        if (layout.GetBlockSize(DataLayout::DATASOURCE_NAME_DATA) > 0)
+    for (const auto block_id : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
+    {
+        const auto id = static_cast<DataLayout::BlockID>(block_id);
+        const auto &block = header.blocks[block_id];
+        const auto block_name = std::string(block.name, strnlen(block.name, sizeof(block.name)));
+        if (block.size != header.layout.GetBlockSize(id))
         {
-            BOOST_ASSERT(std::distance(datasource_names_data.names.begin(),
-                                       datasource_names_data.names.end()) *
-                             sizeof(decltype(datasource_names_data.names)::value_type) <=
-                         layout.GetBlockSize(DataLayout::DATASOURCE_NAME_DATA));
-            std::copy(datasource_names_data.names.begin(),
-                      datasource_names_data.names.end(),
-                      datasource_name_data_ptr);
+            throw util::exception("Block " + block_name + " of memory image " + path.string() +
+                                  " has " + std::to_string(block.size) + " bytes instead of " +
+                                  std::to_string(header.layout.GetBlockSize(id)) + SOURCE_REF);
         }
-
-        const auto datasource_name_offsets_ptr =
-            layout.GetBlockPtr<std::size_t, true>(memory_ptr, DataLayout::DATASOURCE_NAME_OFFSETS);
-        if (layout.GetBlockSize(DataLayout::DATASOURCE_NAME_OFFSETS) > 0)
+        if (block.offset < MEMORY_IMAGE_DATA_OFFSET || block.offset > file_size ||
+            block.size > file_size - block.offset)
         {
-            BOOST_ASSERT(std::distance(datasource_names_data.offsets.begin(),
-                                       datasource_names_data.offsets.end()) *
-                             sizeof(decltype(datasource_names_data.offsets)::value_type) <=
-                         layout.GetBlockSize(DataLayout::DATASOURCE_NAME_OFFSETS));
-            std::copy(datasource_names_data.offsets.begin(),
-                      datasource_names_data.offsets.end(),
-                      datasource_name_offsets_ptr);
+            throw util::exception("Block " + block_name + " of memory image " + path.string() +
+                                  " is outside of the data" + SOURCE_REF);
         }
+    }
+}
 
-        const auto datasource_name_lengths_ptr =
-            layout.GetBlockPtr<std::size_t, true>(memory_ptr, DataLayout::DATASOURCE_NAME_LENGTHS);
-        if (layout.GetBlockSize(DataLayout::DATASOURCE_NAME_LENGTHS) > 0)
+// The data files in a fixed order, the memory image stores their sizes and times in this order
+std::array<MemoryImageSource, MEMORY_IMAGE_NUM_SOURCES> Storage::GetMemoryImageSources() const
+{
+    const std::array<const boost::filesystem::path *, MEMORY_IMAGE_NUM_SOURCES> paths = {
+        {&config.ram_index_path,
+         &config.file_index_path,
+         &config.hsgr_data_path,
+         &config.nodes_data_path,
+         &config.edges_data_path,
+         &config.core_data_path,
+         &config.geometries_path,
+         &config.timestamp_path,
+         &config.datasource_names_path,
+         &config.datasource_indexes_path,
+         &config.names_data_path,
+         &config.properties_path,
+         &config.intersection_class_path,
+         &config.turn_lane_data_path,
+         &config.turn_lane_description_path,
+         &config.mld_graph_path,
+         &config.partition_path,
+         &config.cells_path}};
+
+    std::array<MemoryImageSource, MEMORY_IMAGE_NUM_SOURCES> sources;
+    std::transform(paths.begin(), paths.end(), sources.begin(), [](const auto *path) {
+        if (!boost::filesystem::is_regular_file(*path))
         {
-            BOOST_ASSERT(std::distance(datasource_names_data.lengths.begin(),
-                                       datasource_names_data.lengths.end()) *
-                             sizeof(decltype(datasource_names_data.lengths)::value_type) <=
-                         layout.GetBlockSize(DataLayout::DATASOURCE_NAME_LENGTHS));
-            std::copy(datasource_names_data.lengths.begin(),
-                      datasource_names_data.lengths.end(),
-                      datasource_name_lengths_ptr);
+            return MemoryImageSource{MemoryImageSource::INVALID_SIZE, 0};
         }
-    }
+        const auto modification_time = boost::filesystem::last_write_time(*path);
+        return MemoryImageSource{boost::filesystem::file_size(*path),
+                                 static_cast<std::int64_t>(modification_time)};
+    });
+    return sources;
+}
 
-    // Loading list of coordinates
+MemoryImageHeader Storage::ReadMemoryImageHeader() const
+{
+    io::FileReader image_file(config.memory_image_path, io::FileReader::HasNoFingerprint);
+    if (image_file.Size() < MEMORY_IMAGE_DATA_OFFSET)
     {
-        io::FileReader nodes_file(config.nodes_data_path, io::FileReader::HasNoFingerprint);
-        nodes_file.Skip<std::uint64_t>(1); // node_count
-        const auto coordinates_ptr =
-            layout.GetBlockPtr<util::Coordinate, true>(memory_ptr, DataLayout::COORDINATE_LIST);
-        const auto osmnodeid_ptr =
-            layout.GetBlockPtr<std::uint64_t, true>(memory_ptr, DataLayout::OSM_NODE_ID_LIST);
-        util::PackedVector<OSMNodeID, true> osmnodeid_list;
-
-        osmnodeid_list.reset(osmnodeid_ptr, layout.num_entries[DataLayout::OSM_NODE_ID_LIST]);
-
-        serialization::readNodes(nodes_file,
-                                 coordinates_ptr,
-                                 osmnodeid_list,
-                                 layout.num_entries[DataLayout::COORDINATE_LIST]);
+        throw util::exception("Memory image " + config.memory_image_path.string() +
+                              " is truncated" + SOURCE_REF);
     }
+    MemoryImageHeader header;
+    image_file.ReadInto(header);
+    CheckMemoryImageHeader(header, image_file.Size(), config.memory_image_path);
+    return header;
+}
 
-    // store timestamp
+bool Storage::IsMemoryImageCurrent() const
+{
+    if (!boost::filesystem::is_regular_file(config.memory_image_path))
     {
-        io::FileReader timestamp_file(config.timestamp_path, io::FileReader::HasNoFingerprint);
-        const auto timestamp_size = timestamp_file.Size();
-
-        const auto timestamp_ptr =
-            layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::TIMESTAMP);
-        BOOST_ASSERT(timestamp_size == layout.num_entries[DataLayout::TIMESTAMP]);
-        timestamp_file.ReadInto(timestamp_ptr, timestamp_size);
+        return false;
     }
 
-    // store search tree portion of rtree
+    MemoryImageHeader header;
+    try
     {
-        io::FileReader tree_node_file(config.ram_index_path, io::FileReader::HasNoFingerprint);
-        // perform this read so that we're at the right stream position for the next
-        // read.
-        tree_node_file.Skip<std::uint64_t>(1);
-        const auto rtree_ptr =
-            layout.GetBlockPtr<RTreeNode, true>(memory_ptr, DataLayout::R_SEARCH_TREE);
-
-        tree_node_file.ReadInto(rtree_ptr, layout.num_entries[DataLayout::R_SEARCH_TREE]);
+        header = ReadMemoryImageHeader();
     }
-
+    catch (const util::exception &exception)
     {
-        io::FileReader core_marker_file(config.core_data_path, io::FileReader::HasNoFingerprint);
-        const auto number_of_core_markers = core_marker_file.ReadElementCount32();
-
-        // load core markers
-        std::vector<char> unpacked_core_markers(number_of_core_markers);
-        core_marker_file.ReadInto(unpacked_core_markers.data(), number_of_core_markers);
-
-        const auto core_marker_ptr =
-            layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::CORE_MARKER);
-
-        for (auto i = 0u; i < number_of_core_markers; ++i)
-        {
-            BOOST_ASSERT(unpacked_core_markers[i] == 0 || unpacked_core_markers[i] == 1);
-
-            if (unpacked_core_markers[i] == 1)
-            {
-                const unsigned bucket = i / 32;
-                const unsigned offset = i % 32;
-                const unsigned value = [&] {
-                    unsigned return_value = 0;
-                    if (0 != offset)
-                    {
-                        return_value = core_marker_ptr[bucket];
-                    }
-                    return return_value;
-                }();
-
-                core_marker_ptr[bucket] = (value | (1u << offset));
-            }
-        }
+        util::Log(logWARNING) << "Ignoring the memory image: " << exception.what();
+        return false;
     }
+    return header.sources == GetMemoryImageSources();
+}
 
-    // load profile properties
+// Reads the blocks one after the other, every block is a single read and checked against the
+// checksum of the table of contents
+void Storage::ReadMemoryImage(const DataLayout &layout, char *memory_ptr) const
+{
+    const auto header = ReadMemoryImageHeader();
+    if (!std::equal(layout.num_entries.begin(),
+                    layout.num_entries.end(),
+                    header.layout.num_entries.begin()))
     {
-        io::FileReader profile_properties_file(config.properties_path,
-                                               io::FileReader::HasNoFingerprint);
-        const auto profile_properties_ptr = layout.GetBlockPtr<extractor::ProfileProperties, true>(
-            memory_ptr, DataLayout::PROPERTIES);
-        profile_properties_file.ReadInto(profile_properties_ptr,
-                                         layout.num_entries[DataLayout::PROPERTIES]);
+        throw util::exception("Memory image " + config.memory_image_path.string() +
+                              " changed while loading it" + SOURCE_REF);
     }
 
-    // Load intersection data
+    // Every block is read and verified with its own reader, so they are loaded concurrently
+    std::vector<BlockLoader> loaders;
+    for (const auto block_id : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
     {
-        io::FileReader intersection_file(config.intersection_class_path,
-                                         io::FileReader::VerifyFingerprint);
-
-        std::vector<BearingClassID> bearing_class_id_table;
-        intersection_file.DeserializeVector(bearing_class_id_table);
-
-        const auto bearing_blocks = intersection_file.ReadElementCount32();
-        intersection_file.Skip<std::uint32_t>(1); // sum_lengths
-
-        std::vector<unsigned> bearing_offsets_data(bearing_blocks);
-        std::vector<typename util::RangeTable<16, true>::BlockT> bearing_blocks_data(
-            bearing_blocks);
-
-        intersection_file.ReadInto(bearing_offsets_data.data(), bearing_blocks);
-        intersection_file.ReadInto(bearing_blocks_data.data(), bearing_blocks);
-
-        const auto num_bearings = intersection_file.ReadElementCount64();
-
-        std::vector<DiscreteBearing> bearing_class_table(num_bearings);
-        intersection_file.ReadInto(bearing_class_table.data(), num_bearings);
-
-        std::vector<util::guidance::EntryClass> entry_class_table;
-        intersection_file.DeserializeVector(entry_class_table);
-
-        // load intersection classes
-        if (!bearing_class_id_table.empty())
-        {
-            const auto bearing_id_ptr =
-                layout.GetBlockPtr<BearingClassID, true>(memory_ptr, DataLayout::BEARING_CLASSID);
-            BOOST_ASSERT(
-                static_cast<std::size_t>(layout.GetBlockSize(DataLayout::BEARING_CLASSID)) >=
-                std::distance(bearing_class_id_table.begin(), bearing_class_id_table.end()) *
-                    sizeof(decltype(bearing_class_id_table)::value_type));
-            std::copy(bearing_class_id_table.begin(), bearing_class_id_table.end(), bearing_id_ptr);
-        }
+        const auto id = static_cast<DataLayout::BlockID>(block_id);
+        const auto block = header.blocks[block_id];
+        const auto block_name = std::string(block.name, strnlen(block.name, sizeof(block.name)));
+
+        loaders.push_back({block_name, {id}, [this, &layout, memory_ptr, id, block, block_name] {
+                               char *block_ptr = layout.GetBlockPtr<char, true>(memory_ptr, id);
+                               io::FileReader block_file(config.memory_image_path,
+                                                         io::FileReader::HasNoFingerprint);
+                               block_file.Skip<char>(block.offset);
+                               block_file.ReadInto(block_ptr, block.size);
+
+                               boost::crc_32_type checksum;
+                               checksum.process_bytes(block_ptr, block.size);
+                               if (checksum.checksum() != block.checksum)
+                               {
+                                   throw util::exception("Checksum mismatch of block " +
+                                                         block_name + " in " +
+                                                         config.memory_image_path.string() +
+                                                         SOURCE_REF);
+                               }
+                           }});
+    }
 
-        if (layout.GetBlockSize(DataLayout::BEARING_OFFSETS) > 0)
-        {
-            const auto bearing_offsets_ptr =
-                layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::BEARING_OFFSETS);
-            BOOST_ASSERT(
-                static_cast<std::size_t>(layout.GetBlockSize(DataLayout::BEARING_OFFSETS)) >=
-                std::distance(bearing_offsets_data.begin(), bearing_offsets_data.end()) *
-                    sizeof(decltype(bearing_offsets_data)::value_type));
-            std::copy(
-                bearing_offsets_data.begin(), bearing_offsets_data.end(), bearing_offsets_ptr);
-        }
+    runBlockLoaders(layout, loaders);
+}
 
-        if (layout.GetBlockSize(DataLayout::BEARING_BLOCKS) > 0)
+void Storage::WriteMemoryImage()
+{
+    // taken first, so that files changed while writing make the image outdated
+    const auto sources = GetMemoryImageSources();
+    DataLayout layout;
+    PopulateLayoutFromFiles(layout);
+
+    // other processes only ever see a complete image
+    const auto temporary_path =
+        boost::filesystem::unique_path(config.memory_image_path.string() + ".%%%%-%%%%");
+    util::Log() << "writing memory image of " << layout.GetSizeOfLayout() << " bytes to "
+                << config.memory_image_path;
+    try
+    {
+        boost::iostreams::mapped_file_params params(temporary_path.string());
+        params.flags = boost::iostreams::mapped_file::readwrite;
+        params.new_file_size = MEMORY_IMAGE_DATA_OFFSET + layout.GetSizeOfLayout();
+        boost::iostreams::mapped_file image(params);
+
+        char *data_ptr = image.data() + MEMORY_IMAGE_DATA_OFFSET;
+        PopulateDataFromFiles(layout, data_ptr);
+
+        MemoryImageHeader header;
+        header.fingerprint = util::FingerPrint::GetValid();
+        header.layout = layout;
+        header.sources = sources;
+        for (const auto block_id : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
         {
-            const auto bearing_blocks_ptr =
-                layout.GetBlockPtr<typename util::RangeTable<16, true>::BlockT, true>(
-                    memory_ptr, DataLayout::BEARING_BLOCKS);
-            BOOST_ASSERT(
-                static_cast<std::size_t>(layout.GetBlockSize(DataLayout::BEARING_BLOCKS)) >=
-                std::distance(bearing_blocks_data.begin(), bearing_blocks_data.end()) *
-                    sizeof(decltype(bearing_blocks_data)::value_type));
-            std::copy(bearing_blocks_data.begin(), bearing_blocks_data.end(), bearing_blocks_ptr);
+            const auto id = static_cast<DataLayout::BlockID>(block_id);
+            const char *block_ptr = layout.GetBlockPtr<char>(data_ptr, id);
+            auto &block = header.blocks[block_id];
+            std::fill(std::begin(block.name), std::end(block.name), '\0');
+            std::copy_n(block_id_to_name[block_id],
+                        std::min(std::strlen(block_id_to_name[block_id]), sizeof(block.name) - 1),
+                        block.name);
+            block.offset = MEMORY_IMAGE_DATA_OFFSET + (block_ptr - data_ptr);
+            block.size = layout.GetBlockSize(id);
+
+            boost::crc_32_type checksum;
+            checksum.process_bytes(block_ptr, block.size);
+            block.checksum = checksum.checksum();
         }
+        std::copy_n(reinterpret_cast<const char *>(&header), sizeof(header), image.data());
+    }
+    catch (...)
+    {
+        boost::filesystem::remove(temporary_path);
+        throw;
+    }
+    boost::filesystem::rename(temporary_path, config.memory_image_path);
+}
 
-        if (!bearing_class_table.empty())
-        {
-            const auto bearing_class_ptr =
-                layout.GetBlockPtr<DiscreteBearing, true>(memory_ptr, DataLayout::BEARING_VALUES);
-            BOOST_ASSERT(
-                static_cast<std::size_t>(layout.GetBlockSize(DataLayout::BEARING_VALUES)) >=
-                std::distance(bearing_class_table.begin(), bearing_class_table.end()) *
-                    sizeof(decltype(bearing_class_table)::value_type));
-            std::copy(bearing_class_table.begin(), bearing_class_table.end(), bearing_class_ptr);
-        }
+bool Storage::UpdateMemoryImage()
+{
+    if (IsMemoryImageCurrent())
+    {
+        return true;
+    }
 
-        if (!entry_class_table.empty())
-        {
-            const auto entry_class_ptr = layout.GetBlockPtr<util::guidance::EntryClass, true>(
-                memory_ptr, DataLayout::ENTRY_CLASS);
-            BOOST_ASSERT(static_cast<std::size_t>(layout.GetBlockSize(DataLayout::ENTRY_CLASS)) >=
-                         std::distance(entry_class_table.begin(), entry_class_table.end()) *
-                             sizeof(decltype(entry_class_table)::value_type));
-            std::copy(entry_class_table.begin(), entry_class_table.end(), entry_class_ptr);
-        }
+    // the image file is created before any data is loaded, so this fails early
+    try
+    {
+        WriteMemoryImage();
+    }
+    catch (const std::ios_base::failure &exception)
+    {
+        util::Log(logWARNING) << "Can't write the memory image " << config.memory_image_path
+                              << ": " << exception.what();
+        return false;
+    }
+    catch (const boost::filesystem::filesystem_error &exception)
+    {
+        util::Log(logWARNING) << "Can't write the memory image " << config.memory_image_path
+                              << ": " << exception.what();
+        return false;
     }
+    return true;
 }
 }
 }
@@ -3,6 +3,9 @@
 
 #include <boost/filesystem/operations.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace osrm
 {
 namespace storage
@@ -17,36 +20,58 @@ StorageConfig::StorageConfig(const boost::filesystem::path &base)
       datasource_indexes_path{base.string() + ".datasource_indexes"},
       names_data_path{base.string() + ".names"}, properties_path{base.string() + ".properties"},
       intersection_class_path{base.string() + ".icd"}, turn_lane_data_path{base.string() + ".tld"},
-      turn_lane_description_path{base.string() + ".tls"}
+      turn_lane_description_path{base.string() + ".tls"},
+      mld_graph_path{base.string() + ".mldgr"}, partition_path{base.string() + ".partition"},
+      cells_path{base.string() + ".cells"}, memory_image_path{base.string() + ".memory"}
 {
 }
 
-bool StorageConfig::IsValid() const
+namespace
 {
-    const constexpr auto num_files = 13;
-    const boost::filesystem::path paths[num_files] = {ram_index_path,
-                                                      file_index_path,
-                                                      hsgr_data_path,
-                                                      nodes_data_path,
-                                                      edges_data_path,
-                                                      core_data_path,
-                                                      geometries_path,
-                                                      timestamp_path,
-                                                      datasource_indexes_path,
-                                                      datasource_indexes_path,
-                                                      names_data_path,
-                                                      properties_path,
-                                                      intersection_class_path};
+bool allFilesExist(const std::vector<boost::filesystem::path> &paths)
+{
+    return std::all_of(paths.begin(), paths.end(), [](const boost::filesystem::path &path) {
+        return boost::filesystem::is_regular_file(path);
+    });
+}
 
+bool checkFiles(const std::vector<boost::filesystem::path> &paths)
+{
     bool success = true;
-    for (auto path = paths; path != paths + num_files; ++path)
+    for (const auto &path : paths)
     {
-        if (!boost::filesystem::is_regular_file(*path))
+        if (!boost::filesystem::is_regular_file(path))
         {
-            util::Log(logWARNING) << "Missing/Broken File: " << path->string();
+            util::Log(logWARNING) << "Missing/Broken File: " << path.string();
             success = false;
         }
     }
+    return success;
+}
+}
+
+bool StorageConfig::IsValid() const
+{
+    bool success = checkFiles({ram_index_path,
+                               file_index_path,
+                               nodes_data_path,
+                               edges_data_path,
+                               geometries_path,
+                               timestamp_path,
+                               datasource_indexes_path,
+                               names_data_path,
+                               properties_path,
+                               intersection_class_path});
+
+    const std::vector<boost::filesystem::path> ch_paths = {hsgr_data_path, core_data_path};
+    const std::vector<boost::filesystem::path> mld_paths = {
+        mld_graph_path, partition_path, cells_path};
+    if (!allFilesExist(ch_paths) && !allFilesExist(mld_paths))
+    {
+        checkFiles(ch_paths);
+        util::Log(logWARNING) << "Run osrm-contract, or osrm-partition and osrm-customize";
+        success = false;
+    }
 
     return success;
 }
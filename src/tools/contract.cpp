@@ -54,6 +54,11 @@ return_code parseArguments(int argc, char *argv[], contractor::ContractorConfig
         boost::program_options::value<bool>(&contractor_config.use_cached_priority)
             ->default_value(false),
         "Use .level file to retain the contaction level for each node from the last run.")(
+        "incremental",
+        boost::program_options::value<bool>(&contractor_config.use_previous_hierarchy)
+            ->default_value(false),
+        "Use the .hsgr and .level files of the last run and only re-contract the nodes affected "
+        "by changed weights. Needs a core factor of 1.0.")(
         "edge-weight-updates-over-factor",
         boost::program_options::value<double>(&contractor_config.log_edge_updates_factor)
             ->default_value(0.0),
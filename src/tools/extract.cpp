@@ -12,6 +12,7 @@
 #include <cstdlib>
 #include <exception>
 #include <new>
+#include <string>
 
 using namespace osrm;
 
@@ -24,6 +25,8 @@ enum class return_code : unsigned
 
 return_code parseArguments(int argc, char *argv[], extractor::ExtractorConfig &extractor_config)
 {
+    std::string sort_mode;
+
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
     generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
@@ -48,7 +51,13 @@ return_code parseArguments(int argc, char *argv[], extractor::ExtractorConfig &e
         boost::program_options::value<unsigned int>(&extractor_config.small_component_size)
             ->default_value(1000),
         "Number of nodes required before a strongly-connected-componennt is considered big "
-        "(affects nearest neighbor snapping)");
+        "(affects nearest neighbor snapping)")(
+        "sort-mode",
+        boost::program_options::value<std::string>(&sort_mode)->default_value("auto"),
+        "How the parsed data is sorted: memory to sort in RAM on all threads, external to sort "
+        "with stxxl on disk, auto to sort in RAM if the data fits twice into the available "
+        "memory. Sorting in RAM copies the data out of stxxl, which doubles the peak memory "
+        "while sorting");
 
     // hidden options, will be allowed on command line, but will not be
     // shown to the user
@@ -108,6 +117,25 @@ return_code parseArguments(int argc, char *argv[], extractor::ExtractorConfig &e
         return return_code::exit;
     }
 
+    if (sort_mode == "auto")
+    {
+        extractor_config.sort_mode = extractor::ExtractorConfig::SortMode::Auto;
+    }
+    else if (sort_mode == "memory")
+    {
+        extractor_config.sort_mode = extractor::ExtractorConfig::SortMode::InMemory;
+    }
+    else if (sort_mode == "external")
+    {
+        extractor_config.sort_mode = extractor::ExtractorConfig::SortMode::External;
+    }
+    else
+    {
+        util::Log(logERROR) << "Unknown sort mode " << sort_mode
+                            << ", use auto, memory or external";
+        return return_code::fail;
+    }
+
     return return_code::ok;
 }
 
@@ -59,16 +59,24 @@ inline unsigned generateServerProgramOptions(const int argc,
                                              int &ip_port,
                                              int &requested_num_threads,
                                              bool &use_shared_memory,
+                                             bool &use_mmap,
+                                             boost::filesystem::path &memory_image_path,
+                                             bool &compress_rtree_leaves,
+                                             int &phantom_node_cache_size,
                                              bool &trial,
                                              int &max_locations_trip,
                                              int &max_locations_viaroute,
                                              int &max_locations_distance_table,
                                              int &max_locations_map_matching,
-                                             int &max_results_nearest)
+                                             int &max_results_nearest,
+                                             int &max_threads_distance_table,
+                                             EngineConfig::Algorithm &algorithm)
 {
     using boost::program_options::value;
     using boost::filesystem::path;
 
+    std::string algorithm_name;
+
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
     generic_options.add_options()                                         //
@@ -90,6 +98,27 @@ inline unsigned generateServerProgramOptions(const int argc,
         ("shared-memory,s",
          value<bool>(&use_shared_memory)->implicit_value(true)->default_value(false),
          "Load data from shared memory") //
+        ("mmap,m",
+         value<bool>(&use_mmap)->implicit_value(true)->default_value(false),
+         "Map the data from a memory image next to the data files instead of loading it. The "
+         "first start and every start after the data files changed load the data and write "
+         "the whole image to disk before serving requests. Without a writable image the data is "
+         "loaded as without --mmap") //
+        ("memory-image",
+         value<boost::filesystem::path>(&memory_image_path),
+         "Path of the memory image for --mmap, for data in a read-only directory") //
+        ("compress-rtree-leaves",
+         value<bool>(&compress_rtree_leaves)->implicit_value(true)->default_value(false),
+         "Keep the leaves of the r-tree delta encoded in memory instead of mapping the leaf "
+         "file") //
+        ("phantom-node-cache-size",
+         value<int>(&phantom_node_cache_size)->default_value(0),
+         "Number of recent queries per coordinate, radius and bearing whose phantom nodes are "
+         "cached, 0 disables the cache") //
+        ("algorithm,a",
+         value<std::string>(&algorithm_name)->default_value("CH"),
+         "Routing algorithm: CH for data of osrm-contract, MLD for data of osrm-partition and "
+         "osrm-customize") //
         ("max-viaroute-size",
          value<int>(&max_locations_viaroute)->default_value(500),
          "Max. locations supported in viaroute query") //
@@ -104,7 +133,10 @@ inline unsigned generateServerProgramOptions(const int argc,
          "Max. locations supported in map matching query") //
         ("max-nearest-size",
          value<int>(&max_results_nearest)->default_value(100),
-         "Max. results supported in nearest query");
+         "Max. results supported in nearest query") //
+        ("max-table-threads",
+         value<int>(&max_threads_distance_table)->default_value(1),
+         "Max. threads a single distance table query may use");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -154,6 +186,20 @@ inline unsigned generateServerProgramOptions(const int argc,
 
     boost::program_options::notify(option_variables);
 
+    if (algorithm_name == "CH")
+    {
+        algorithm = EngineConfig::Algorithm::CH;
+    }
+    else if (algorithm_name == "MLD")
+    {
+        algorithm = EngineConfig::Algorithm::MLD;
+    }
+    else
+    {
+        util::Log(logERROR) << "Unknown algorithm " << algorithm_name << ", use CH or MLD";
+        return INIT_FAILED;
+    }
+
     if (!use_shared_memory && option_variables.count("base"))
     {
         return INIT_OK_START_ENGINE;
@@ -181,6 +227,7 @@ int main(int argc, const char *argv[]) try
 
     EngineConfig config;
     boost::filesystem::path base_path;
+    boost::filesystem::path memory_image_path;
     const unsigned init_result = generateServerProgramOptions(argc,
                                                               argv,
                                                               base_path,
@@ -188,12 +235,18 @@ int main(int argc, const char *argv[]) try
                                                               ip_port,
                                                               requested_thread_num,
                                                               config.use_shared_memory,
+                                                              config.use_mmap,
+                                                              memory_image_path,
+                                                              config.compress_rtree_leaves,
+                                                              config.phantom_node_cache_size,
                                                               trial_run,
                                                               config.max_locations_trip,
                                                               config.max_locations_viaroute,
                                                               config.max_locations_distance_table,
                                                               config.max_locations_map_matching,
-                                                              config.max_results_nearest);
+                                                              config.max_results_nearest,
+                                                              config.max_threads_distance_table,
+                                                              config.algorithm);
     if (init_result == INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -205,6 +258,10 @@ int main(int argc, const char *argv[]) try
     if (!base_path.empty())
     {
         config.storage_config = storage::StorageConfig(base_path);
+        if (!memory_image_path.empty())
+        {
+            config.storage_config.memory_image_path = memory_image_path;
+        }
     }
     if (!config.IsValid())
     {
@@ -13,7 +13,8 @@ using namespace osrm;
 bool generateDataStoreOptions(const int argc,
                               const char *argv[],
                               boost::filesystem::path &base_path,
-                              int &max_wait)
+                              int &max_wait,
+                              bool &write_memory_image)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
@@ -25,7 +26,13 @@ bool generateDataStoreOptions(const int argc,
     config_options.add_options()(
         "max-wait",
         boost::program_options::value<int>(&max_wait)->default_value(-1),
-        "Maximum number of seconds to wait on requests that use the old dataset.");
+        "Maximum number of seconds to wait on requests that use the old dataset.")(
+        "write-memory-image",
+        boost::program_options::value<bool>(&write_memory_image)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Write the data into a single .memory file that is loaded instead of the individual "
+        "files, then exit without loading the data into shared memory");
 
     // hidden options, will be allowed on command line but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -93,7 +100,8 @@ int main(const int argc, const char *argv[]) try
 
     boost::filesystem::path base_path;
     int max_wait = -1;
-    if (!generateDataStoreOptions(argc, argv, base_path, max_wait))
+    bool write_memory_image = false;
+    if (!generateDataStoreOptions(argc, argv, base_path, max_wait, write_memory_image))
     {
         return EXIT_SUCCESS;
     }
@@ -105,6 +113,12 @@ int main(const int argc, const char *argv[]) try
     }
     storage::Storage storage(std::move(config));
 
+    if (write_memory_image)
+    {
+        storage.WriteMemoryImage();
+        return EXIT_SUCCESS;
+    }
+
     // We will attempt to load this dataset to memory several times if we encounter
     // an error we can recover from. This is needed when we need to clear mutexes
     // that have been left dangling by other processes.
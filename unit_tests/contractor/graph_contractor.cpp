@@ -0,0 +1,311 @@
+#include "contractor/graph_contractor.hpp"
+
+#include "contractor/query_edge.hpp"
+#include "extractor/edge_based_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/static_graph.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(graph_contractor)
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+namespace
+{
+using QueryGraph = util::StaticGraph<QueryEdge::EdgeData>;
+
+// Grid with random weights and some one-ways
+template <NodeID NUMBER_OF_ROWS, NodeID NUMBER_OF_COLUMNS> struct Grid
+{
+    Grid() : generator(23)
+    {
+        std::uniform_int_distribution<EdgeWeight> weight_distribution(1, 100);
+        std::bernoulli_distribution oneway_distribution(0.2);
+
+        for (NodeID row = 0; row < ROWS; ++row)
+        {
+            for (NodeID column = 0; column < COLUMNS; ++column)
+            {
+                const auto node = row * COLUMNS + column;
+                for (const auto neighbour : {node + 1, node + COLUMNS})
+                {
+                    if ((neighbour == node + 1 && column + 1 == COLUMNS) ||
+                        neighbour >= ROWS * COLUMNS)
+                    {
+                        continue;
+                    }
+                    edges.emplace_back(node,
+                                       neighbour,
+                                       static_cast<NodeID>(edges.size()),
+                                       weight_distribution(generator),
+                                       true,
+                                       false);
+                    if (!oneway_distribution(generator))
+                    {
+                        edges.emplace_back(neighbour,
+                                           node,
+                                           static_cast<NodeID>(edges.size()),
+                                           weight_distribution(generator),
+                                           true,
+                                           false);
+                    }
+                }
+            }
+        }
+    }
+
+    // Changes the weights of some edges, making them faster or slower
+    void UpdateWeights(const std::size_t number_of_updates)
+    {
+        std::uniform_int_distribution<std::size_t> edge_distribution(0, edges.size() - 1);
+        std::uniform_int_distribution<EdgeWeight> weight_distribution(1, 300);
+        for (std::size_t update = 0; update < number_of_updates; ++update)
+        {
+            edges[edge_distribution(generator)].weight = weight_distribution(generator);
+        }
+    }
+
+    // Makes the edges leaving node slower
+    void SlowDownEdgesOf(const NodeID node)
+    {
+        for (auto &edge : edges)
+        {
+            if (edge.source == node)
+            {
+                edge.weight += 10;
+            }
+        }
+    }
+
+    util::DeallocatingVector<extractor::EdgeBasedEdge> EdgeList() const
+    {
+        util::DeallocatingVector<extractor::EdgeBasedEdge> edge_list;
+        for (const auto &edge : edges)
+        {
+            edge_list.push_back(edge);
+        }
+        return edge_list;
+    }
+
+    static QueryGraph MakeQueryGraph(GraphContractor &contractor)
+    {
+        util::DeallocatingVector<QueryEdge> contracted_edges;
+        contractor.GetEdges(contracted_edges);
+        std::vector<QueryEdge> edges(contracted_edges.begin(), contracted_edges.end());
+        std::sort(edges.begin(), edges.end());
+        return QueryGraph(ROWS * COLUMNS, edges);
+    }
+
+    std::vector<EdgeWeight> Dijkstra(const NodeID source) const
+    {
+        std::vector<std::vector<std::pair<NodeID, EdgeWeight>>> adjacency(ROWS * COLUMNS);
+        for (const auto &edge : edges)
+        {
+            adjacency[edge.source].emplace_back(edge.target, edge.weight);
+        }
+
+        std::vector<EdgeWeight> weights(ROWS * COLUMNS, INVALID_EDGE_WEIGHT);
+        using QueueEntry = std::pair<EdgeWeight, NodeID>;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+        weights[source] = 0;
+        queue.emplace(0, source);
+        while (!queue.empty())
+        {
+            const auto entry = queue.top();
+            queue.pop();
+            if (entry.first > weights[entry.second])
+            {
+                continue;
+            }
+            for (const auto &neighbour : adjacency[entry.second])
+            {
+                const auto weight = entry.first + neighbour.second;
+                if (weight < weights[neighbour.first])
+                {
+                    weights[neighbour.first] = weight;
+                    queue.emplace(weight, neighbour.first);
+                }
+            }
+        }
+        return weights;
+    }
+
+    // Upward searches from source and target, meeting at the highest node of the shortest path
+    static EdgeWeight Query(const QueryGraph &graph, const NodeID source, const NodeID target)
+    {
+        const auto upward_search = [&graph](const NodeID start, const bool forward) {
+            std::vector<EdgeWeight> weights(graph.GetNumberOfNodes(), INVALID_EDGE_WEIGHT);
+            using QueueEntry = std::pair<EdgeWeight, NodeID>;
+            std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>>
+                queue;
+            weights[start] = 0;
+            queue.emplace(0, start);
+            while (!queue.empty())
+            {
+                const auto entry = queue.top();
+                queue.pop();
+                if (entry.first > weights[entry.second])
+                {
+                    continue;
+                }
+                for (const auto edge : graph.GetAdjacentEdgeRange(entry.second))
+                {
+                    const auto &data = graph.GetEdgeData(edge);
+                    const auto to = graph.GetTarget(edge);
+                    const auto weight = entry.first + data.weight;
+                    if ((forward ? data.forward : data.backward) && weight < weights[to])
+                    {
+                        weights[to] = weight;
+                        queue.emplace(weight, to);
+                    }
+                }
+            }
+            return weights;
+        };
+
+        const auto forward_weights = upward_search(source, true);
+        const auto reverse_weights = upward_search(target, false);
+        EdgeWeight weight = INVALID_EDGE_WEIGHT;
+        for (NodeID node = 0; node < graph.GetNumberOfNodes(); ++node)
+        {
+            if (forward_weights[node] != INVALID_EDGE_WEIGHT &&
+                reverse_weights[node] != INVALID_EDGE_WEIGHT)
+            {
+                weight = std::min(weight, forward_weights[node] + reverse_weights[node]);
+            }
+        }
+        return weight;
+    }
+
+    void CheckQueries(const QueryGraph &graph)
+    {
+        std::uniform_int_distribution<NodeID> node_distribution(0, ROWS * COLUMNS - 1);
+        for (int query = 0; query < 20; ++query)
+        {
+            const auto source = node_distribution(generator);
+            const auto expected = Dijkstra(source);
+            for (NodeID target = 0; target < ROWS * COLUMNS; target += 7)
+            {
+                if (source != target)
+                {
+                    BOOST_CHECK_EQUAL(Query(graph, source, target), expected[target]);
+                }
+            }
+        }
+    }
+
+    static constexpr NodeID ROWS = NUMBER_OF_ROWS;
+    static constexpr NodeID COLUMNS = NUMBER_OF_COLUMNS;
+
+    std::mt19937 generator;
+    std::vector<extractor::EdgeBasedEdge> edges;
+};
+
+using GridFixture = Grid<30, 30>;
+// large enough for the upper levels of the hierarchy to be a small part of it
+using LargeGridFixture = Grid<60, 60>;
+}
+
+BOOST_FIXTURE_TEST_CASE(contraction_matches_dijkstra, GridFixture)
+{
+    auto edge_list = EdgeList();
+    GraphContractor contractor(
+        ROWS * COLUMNS, edge_list, {}, std::vector<EdgeWeight>(ROWS * COLUMNS, 0));
+    contractor.Run();
+
+    CheckQueries(MakeQueryGraph(contractor));
+}
+
+BOOST_FIXTURE_TEST_CASE(incremental_contraction_matches_dijkstra, GridFixture)
+{
+    std::vector<float> node_levels;
+    QueryGraph hierarchy = [&] {
+        auto edge_list = EdgeList();
+        GraphContractor contractor(
+            ROWS * COLUMNS, edge_list, {}, std::vector<EdgeWeight>(ROWS * COLUMNS, 0));
+        contractor.Run();
+        contractor.GetNodeLevels(node_levels);
+        return MakeQueryGraph(contractor);
+    }();
+
+    // the result of an incremental run can be updated again
+    for (int update = 0; update < 3; ++update)
+    {
+        UpdateWeights(10);
+
+        auto edge_list = EdgeList();
+        GraphContractor contractor(ROWS * COLUMNS,
+                                   edge_list,
+                                   std::move(node_levels),
+                                   std::vector<EdgeWeight>(ROWS * COLUMNS, 0));
+        const auto number_of_recontracted_nodes = contractor.RunIncremental(hierarchy);
+        BOOST_CHECK_GT(number_of_recontracted_nodes, 0);
+        BOOST_CHECK_LT(number_of_recontracted_nodes, ROWS * COLUMNS * 3 / 4);
+        contractor.GetNodeLevels(node_levels);
+        hierarchy = MakeQueryGraph(contractor);
+
+        CheckQueries(hierarchy);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(incremental_contraction_after_local_update, LargeGridFixture)
+{
+    std::vector<float> node_levels;
+    const QueryGraph hierarchy = [&] {
+        auto edge_list = EdgeList();
+        GraphContractor contractor(
+            ROWS * COLUMNS, edge_list, {}, std::vector<EdgeWeight>(ROWS * COLUMNS, 0));
+        contractor.Run();
+        contractor.GetNodeLevels(node_levels);
+        return MakeQueryGraph(contractor);
+    }();
+
+    SlowDownEdgesOf(ROWS / 2 * COLUMNS + COLUMNS / 2);
+
+    auto edge_list = EdgeList();
+    GraphContractor contractor(ROWS * COLUMNS,
+                               edge_list,
+                               std::move(node_levels),
+                               std::vector<EdgeWeight>(ROWS * COLUMNS, 0));
+    const auto number_of_recontracted_nodes = contractor.RunIncremental(hierarchy);
+    // the node, its neighbourhood and the nodes above it in the hierarchy
+    BOOST_CHECK_GT(number_of_recontracted_nodes, 0);
+    BOOST_CHECK_LT(number_of_recontracted_nodes, ROWS * COLUMNS / 50);
+
+    CheckQueries(MakeQueryGraph(contractor));
+}
+
+BOOST_FIXTURE_TEST_CASE(incremental_contraction_without_updates, GridFixture)
+{
+    std::vector<float> node_levels;
+    const QueryGraph hierarchy = [&] {
+        auto edge_list = EdgeList();
+        GraphContractor contractor(
+            ROWS * COLUMNS, edge_list, {}, std::vector<EdgeWeight>(ROWS * COLUMNS, 0));
+        contractor.Run();
+        contractor.GetNodeLevels(node_levels);
+        return MakeQueryGraph(contractor);
+    }();
+
+    auto edge_list = EdgeList();
+    GraphContractor contractor(ROWS * COLUMNS,
+                               edge_list,
+                               std::move(node_levels),
+                               std::vector<EdgeWeight>(ROWS * COLUMNS, 0));
+    BOOST_CHECK_EQUAL(contractor.RunIncremental(hierarchy), 0);
+
+    CheckQueries(MakeQueryGraph(contractor));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,196 @@
+#include "customizer/cell_customizer.hpp"
+#include "customizer/cell_storage.hpp"
+#include "partition/multi_level_partition.hpp"
+#include "partition/recursive_bisection.hpp"
+
+#include "contractor/query_edge.hpp"
+#include "util/static_graph.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(cell_customizer)
+
+using namespace osrm;
+using namespace osrm::customizer;
+using namespace osrm::partition;
+
+namespace
+{
+using EdgeData = contractor::QueryEdge::EdgeData;
+using Graph = util::StaticGraph<EdgeData>;
+
+struct GridFixture
+{
+    // Grid with random weights, some one-ways and every edge stored at both ends like in
+    // osrm-customize
+    GridFixture() : generator(1337)
+    {
+        std::uniform_int_distribution<EdgeWeight> weight_distribution(1, 100);
+        std::bernoulli_distribution oneway_distribution(0.2);
+
+        std::vector<std::pair<NodeID, NodeID>> undirected_edges;
+        const auto add_edge = [&](const NodeID from, const NodeID to) {
+            EdgeData data;
+            data.id = static_cast<NodeID>(edges.size());
+            data.shortcut = false;
+            data.weight = weight_distribution(generator);
+            data.forward = true;
+            data.backward = false;
+            edges.emplace_back(from, to, data);
+            data.forward = false;
+            data.backward = true;
+            edges.emplace_back(to, from, data);
+            undirected_edges.emplace_back(from, to);
+        };
+
+        for (NodeID row = 0; row < ROWS; ++row)
+        {
+            for (NodeID column = 0; column < COLUMNS; ++column)
+            {
+                const auto node = row * COLUMNS + column;
+                for (const auto neighbour : {node + 1, node + COLUMNS})
+                {
+                    if ((neighbour == node + 1 && column + 1 == COLUMNS) ||
+                        neighbour >= ROWS * COLUMNS)
+                    {
+                        continue;
+                    }
+                    add_edge(node, neighbour);
+                    if (!oneway_distribution(generator))
+                    {
+                        add_edge(neighbour, node);
+                    }
+                }
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+
+        const RecursiveBisection bisection(ROWS * COLUMNS, undirected_edges);
+        partition = MultiLevelPartition(bisection.ComputeCells({8, 32, 128}));
+    }
+
+    // Dijkstra on the base graph that doesn't leave the cell
+    std::vector<EdgeWeight> CellDijkstra(const Graph &graph,
+                                         const LevelID level,
+                                         const NodeID source) const
+    {
+        const auto cell = partition.GetCell(level, source);
+        std::vector<EdgeWeight> weights(graph.GetNumberOfNodes(), INVALID_EDGE_WEIGHT);
+        using QueueEntry = std::pair<EdgeWeight, NodeID>;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+        weights[source] = 0;
+        queue.emplace(0, source);
+        while (!queue.empty())
+        {
+            const auto entry = queue.top();
+            queue.pop();
+            if (entry.first > weights[entry.second])
+            {
+                continue;
+            }
+            for (const auto edge : graph.GetAdjacentEdgeRange(entry.second))
+            {
+                const auto &data = graph.GetEdgeData(edge);
+                const auto target = graph.GetTarget(edge);
+                const auto weight = entry.first + data.weight;
+                if (data.forward && partition.GetCell(level, target) == cell &&
+                    weight < weights[target])
+                {
+                    weights[target] = weight;
+                    queue.emplace(weight, target);
+                }
+            }
+        }
+        return weights;
+    }
+
+    static constexpr NodeID ROWS = 20;
+    static constexpr NodeID COLUMNS = 30;
+
+    std::mt19937 generator;
+    std::vector<contractor::QueryEdge> edges;
+    MultiLevelPartition partition;
+};
+}
+
+BOOST_FIXTURE_TEST_CASE(boundary_nodes, GridFixture)
+{
+    const Graph graph(ROWS * COLUMNS, edges);
+    const CellStorage cell_storage(partition, graph);
+
+    for (LevelID level = 1; level <= partition.GetNumberOfLevels(); ++level)
+    {
+        for (CellID id = 0; id < partition.GetNumberOfCells(level); ++id)
+        {
+            const auto cell = cell_storage.GetCell(level, id);
+            for (std::uint32_t index = 0; index < cell.GetNumberOfSourceNodes(); ++index)
+            {
+                const auto source = cell.GetSourceNode(index);
+                BOOST_CHECK_EQUAL(partition.GetCell(level, source), id);
+                BOOST_CHECK_EQUAL(cell.GetSourceIndex(source), index);
+                // some edge enters the cell at the source
+                bool entered = false;
+                for (const auto edge : graph.GetAdjacentEdgeRange(source))
+                {
+                    entered |= graph.GetEdgeData(edge).backward &&
+                               partition.GetCell(level, graph.GetTarget(edge)) != id;
+                }
+                BOOST_CHECK(entered);
+            }
+            for (std::uint32_t index = 0; index < cell.GetNumberOfDestinationNodes(); ++index)
+            {
+                const auto destination = cell.GetDestinationNode(index);
+                BOOST_CHECK_EQUAL(partition.GetCell(level, destination), id);
+                BOOST_CHECK_EQUAL(cell.GetDestinationIndex(destination), index);
+            }
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(cliques_match_dijkstra_in_cell, GridFixture)
+{
+    const Graph graph(ROWS * COLUMNS, edges);
+    CellStorage cell_storage(partition, graph);
+    BOOST_REQUIRE_EQUAL(partition.GetNumberOfLevels(), 3);
+
+    const CellCustomizer customizer(partition);
+    CellCustomizer::Heap heap(graph.GetNumberOfNodes());
+    for (LevelID level = 1; level <= partition.GetNumberOfLevels(); ++level)
+    {
+        for (CellID id = 0; id < partition.GetNumberOfCells(level); ++id)
+        {
+            customizer.Customize(graph, heap, cell_storage, level, id);
+        }
+    }
+
+    std::size_t number_of_checked_weights = 0;
+    for (LevelID level = 1; level <= partition.GetNumberOfLevels(); ++level)
+    {
+        for (CellID id = 0; id < partition.GetNumberOfCells(level); ++id)
+        {
+            const auto cell = static_cast<const CellStorage &>(cell_storage).GetCell(level, id);
+            for (std::uint32_t row = 0; row < cell.GetNumberOfSourceNodes(); ++row)
+            {
+                const auto expected = CellDijkstra(graph, level, cell.GetSourceNode(row));
+                for (std::uint32_t column = 0; column < cell.GetNumberOfDestinationNodes();
+                     ++column)
+                {
+                    BOOST_CHECK_EQUAL(cell.GetWeight(row, column),
+                                      expected[cell.GetDestinationNode(column)]);
+                    ++number_of_checked_weights;
+                }
+            }
+        }
+    }
+    BOOST_CHECK_GT(number_of_checked_weights, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
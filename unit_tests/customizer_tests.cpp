@@ -0,0 +1,7 @@
+#define BOOST_TEST_MODULE customizer tests
+
+#include <boost/test/unit_test.hpp>
+
+/*
+ * This file will contain an automatically generated main function.
+ */
@@ -0,0 +1,110 @@
+#include "engine/routing_algorithms/bucket_relaxation.hpp"
+#include "util/cpu_features.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(bucket_relaxation_kernels)
+
+using namespace osrm;
+using namespace osrm::engine::routing_algorithms;
+
+namespace
+{
+struct RelaxFixture
+{
+    RelaxFixture() : row(ROW_SIZE), generator(42)
+    {
+        std::uniform_int_distribution<EdgeWeight> row_distribution(0, 10000);
+        for (auto &weight : row)
+        {
+            weight = row_distribution(generator);
+        }
+        // leave a few entries unreached
+        for (std::size_t i = 0; i < row.size(); i += 7)
+        {
+            row[i] = std::numeric_limits<EdgeWeight>::max();
+        }
+
+        std::vector<unsigned> all_targets(ROW_SIZE);
+        std::iota(all_targets.begin(), all_targets.end(), 0);
+        std::shuffle(all_targets.begin(), all_targets.end(), generator);
+        // odd count to exercise the scalar tail of the vector kernels
+        target_ids.assign(all_targets.begin(), all_targets.begin() + 91);
+
+        std::uniform_int_distribution<EdgeWeight> bucket_distribution(0, 8000);
+        for (std::size_t i = 0; i < target_ids.size(); ++i)
+        {
+            weights.push_back(bucket_distribution(generator));
+        }
+    }
+
+    static constexpr std::size_t ROW_SIZE = 256;
+    static constexpr EdgeWeight SOURCE_WEIGHT = 1500;
+
+    std::vector<EdgeWeight> Expected() const
+    {
+        auto expected = row;
+        for (std::size_t i = 0; i < target_ids.size(); ++i)
+        {
+            expected[target_ids[i]] =
+                std::min(expected[target_ids[i]], SOURCE_WEIGHT + weights[i]);
+        }
+        return expected;
+    }
+
+    std::vector<EdgeWeight> row;
+    std::vector<unsigned> target_ids;
+    std::vector<EdgeWeight> weights;
+    std::mt19937 generator;
+};
+}
+
+BOOST_FIXTURE_TEST_CASE(scalar_kernel, RelaxFixture)
+{
+    const auto expected = Expected();
+    bucket_relaxation::RelaxScalar(
+        row.data(), target_ids.data(), weights.data(), target_ids.size(), SOURCE_WEIGHT);
+    BOOST_CHECK_EQUAL_COLLECTIONS(row.begin(), row.end(), expected.begin(), expected.end());
+}
+
+#if OSRM_X86_SIMD
+BOOST_FIXTURE_TEST_CASE(avx2_kernel, RelaxFixture)
+{
+    if (!util::cpu::HasAVX2())
+    {
+        BOOST_TEST_MESSAGE("AVX2 not supported, skipping");
+        return;
+    }
+    const auto expected = Expected();
+    bucket_relaxation::RelaxAVX2(
+        row.data(), target_ids.data(), weights.data(), target_ids.size(), SOURCE_WEIGHT);
+    BOOST_CHECK_EQUAL_COLLECTIONS(row.begin(), row.end(), expected.begin(), expected.end());
+}
+#endif
+
+BOOST_FIXTURE_TEST_CASE(dispatched_kernel_all_sizes, RelaxFixture)
+{
+    for (std::size_t count = 0; count <= target_ids.size(); ++count)
+    {
+        auto actual = row;
+        auto expected = row;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            expected[target_ids[i]] =
+                std::min(expected[target_ids[i]], SOURCE_WEIGHT + weights[i]);
+        }
+        bucket_relaxation::Relax(
+            actual.data(), target_ids.data(), weights.data(), count, SOURCE_WEIGHT);
+        BOOST_CHECK_EQUAL_COLLECTIONS(
+            actual.begin(), actual.end(), expected.begin(), expected.end());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,135 @@
+#include "engine/dataset_slot.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(dataset_slot)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+// Counts the sharable locks like a named_sharable_mutex would hold them
+struct CountingMutex
+{
+    void lock_sharable() { ++locks; }
+    void unlock_sharable()
+    {
+        if (locks-- <= 0)
+        {
+            unbalanced = true;
+        }
+    }
+
+    std::atomic<int> locks{0};
+    std::atomic<bool> unbalanced{false};
+};
+
+// Counts the facades that are alive and checks that none is used after its release
+struct Facade
+{
+    explicit Facade(std::atomic<int> &facades_) : facades(facades_) { ++facades; }
+    ~Facade()
+    {
+        alive = false;
+        --facades;
+    }
+
+    std::atomic<int> &facades;
+    std::atomic<bool> alive{true};
+};
+
+using Slot = DatasetSlot<Facade, CountingMutex>;
+}
+
+BOOST_AUTO_TEST_CASE(last_release_frees_the_facade)
+{
+    CountingMutex mutex;
+    std::atomic<int> facades{0};
+    Slot slot(mutex);
+    const auto make_facade = [&] { return std::make_shared<Facade>(facades); };
+
+    BOOST_CHECK(!slot.TryAcquire());
+    slot.Acquire(1, make_facade);
+    BOOST_CHECK_EQUAL(mutex.locks, 1);
+    BOOST_CHECK(slot.TryAcquire());
+    slot.Release();
+    BOOST_CHECK_EQUAL(facades, 1);
+    slot.Release();
+    BOOST_CHECK_EQUAL(facades, 0);
+    BOOST_CHECK_EQUAL(mutex.locks, 0);
+
+    // a newer dataset replaces the facade of an unused slot
+    slot.Acquire(1, make_facade);
+    slot.Release();
+    slot.Acquire(2, make_facade);
+    BOOST_CHECK_EQUAL(slot.GetTimestamp(), 2);
+    BOOST_CHECK_EQUAL(mutex.locks, 1);
+    slot.Release();
+    BOOST_CHECK_EQUAL(mutex.locks, 0);
+    BOOST_CHECK(!mutex.unbalanced);
+}
+
+// Queries take and drop references while an updater keeps reviving and dropping the slot like
+// the data watchdog does when datasets switch. Every release to zero has to free the facade
+// and the lock exactly once, no matter which thread drops the last reference.
+BOOST_AUTO_TEST_CASE(concurrent_release_and_update)
+{
+    CountingMutex mutex;
+    std::atomic<int> facades{0};
+    Slot slot(mutex);
+    const auto make_facade = [&] { return std::make_shared<Facade>(facades); };
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> used_released_facades{0};
+    std::vector<std::thread> queries;
+    for (int thread = 0; thread < 4; ++thread)
+    {
+        queries.emplace_back([&] {
+            while (!stop)
+            {
+                if (slot.TryAcquire())
+                {
+                    const auto &facade = slot.GetFacade();
+                    if (!facade || !facade->alive)
+                    {
+                        ++used_released_facades;
+                    }
+                    slot.Release();
+                }
+            }
+        });
+    }
+
+    // the slot holds exactly one facade and one lock while it is acquired
+    int inconsistent_updates = 0;
+    for (unsigned update = 0; update < 20000; ++update)
+    {
+        slot.Acquire(update / 100, make_facade);
+        if (mutex.locks != 1 || facades != 1)
+        {
+            ++inconsistent_updates;
+        }
+        slot.Release();
+    }
+    stop = true;
+    for (auto &thread : queries)
+    {
+        thread.join();
+    }
+
+    BOOST_CHECK_EQUAL(inconsistent_updates, 0);
+    BOOST_CHECK_EQUAL(used_released_facades, 0);
+    BOOST_CHECK_EQUAL(slot.GetReferences(), 0);
+    BOOST_CHECK_EQUAL(facades, 0);
+    BOOST_CHECK_EQUAL(mutex.locks, 0);
+    BOOST_CHECK(!mutex.unbalanced);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
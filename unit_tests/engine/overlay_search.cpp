@@ -0,0 +1,227 @@
+#include "engine/routing_algorithms/routing_base.hpp"
+
+#include "contractor/query_edge.hpp"
+#include "customizer/cell_customizer.hpp"
+#include "customizer/cell_storage.hpp"
+#include "engine/phantom_node.hpp"
+#include "engine/search_engine_data.hpp"
+#include "partition/multi_level_partition.hpp"
+#include "util/static_graph.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(overlay_search)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+using EdgeData = contractor::QueryEdge::EdgeData;
+using Graph = util::StaticGraph<EdgeData>;
+
+// The parts of the data facade the multi-level search uses
+class OverlayFacade
+{
+  public:
+    using EdgeData = contractor::QueryEdge::EdgeData;
+
+    OverlayFacade(const Graph &graph_,
+                  const partition::MultiLevelPartition &partition_,
+                  const customizer::CellStorage &cell_storage_)
+        : graph(graph_), partition(partition_), cell_storage(cell_storage_)
+    {
+    }
+
+    Graph::EdgeRange GetAdjacentEdgeRange(const NodeID node) const
+    {
+        return graph.GetAdjacentEdgeRange(node);
+    }
+    NodeID GetTarget(const EdgeID edge) const { return graph.GetTarget(edge); }
+    const EdgeData &GetEdgeData(const EdgeID edge) const { return graph.GetEdgeData(edge); }
+    const partition::MultiLevelPartition &GetMultiLevelPartition() const { return partition; }
+    const customizer::CellStorage &GetCellStorage() const { return cell_storage; }
+
+  private:
+    const Graph &graph;
+    const partition::MultiLevelPartition &partition;
+    const customizer::CellStorage &cell_storage;
+};
+
+class OverlaySearch final
+    : public routing_algorithms::BasicRoutingInterface<OverlayFacade, OverlaySearch>
+{
+};
+
+struct GridFixture
+{
+    // Grid with random weights and some one-ways, cells are blocks of 5x5 and 10x15 nodes
+    GridFixture() : generator(42)
+    {
+        std::uniform_int_distribution<EdgeWeight> weight_distribution(1, 100);
+        std::bernoulli_distribution oneway_distribution(0.2);
+
+        const auto add_edge = [&](const NodeID from, const NodeID to) {
+            EdgeData data;
+            data.id = static_cast<NodeID>(edges.size());
+            data.shortcut = false;
+            data.weight = weight_distribution(generator);
+            data.forward = true;
+            data.backward = false;
+            edges.emplace_back(from, to, data);
+            data.forward = false;
+            data.backward = true;
+            edges.emplace_back(to, from, data);
+        };
+
+        std::vector<std::vector<CellID>> cell_ids(2, std::vector<CellID>(ROWS * COLUMNS));
+        for (NodeID row = 0; row < ROWS; ++row)
+        {
+            for (NodeID column = 0; column < COLUMNS; ++column)
+            {
+                const auto node = row * COLUMNS + column;
+                cell_ids[0][node] = (row / 5) * (COLUMNS / 5) + column / 5;
+                cell_ids[1][node] = (row / 10) * (COLUMNS / 15) + column / 15;
+                for (const auto neighbour : {node + 1, node + COLUMNS})
+                {
+                    if ((neighbour == node + 1 && column + 1 == COLUMNS) ||
+                        neighbour >= ROWS * COLUMNS)
+                    {
+                        continue;
+                    }
+                    add_edge(node, neighbour);
+                    if (!oneway_distribution(generator))
+                    {
+                        add_edge(neighbour, node);
+                    }
+                }
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        partition = partition::MultiLevelPartition(cell_ids);
+    }
+
+    std::vector<EdgeWeight> Dijkstra(const Graph &graph, const NodeID source) const
+    {
+        std::vector<EdgeWeight> weights(graph.GetNumberOfNodes(), INVALID_EDGE_WEIGHT);
+        using QueueEntry = std::pair<EdgeWeight, NodeID>;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+        weights[source] = 0;
+        queue.emplace(0, source);
+        while (!queue.empty())
+        {
+            const auto entry = queue.top();
+            queue.pop();
+            if (entry.first > weights[entry.second])
+            {
+                continue;
+            }
+            for (const auto edge : graph.GetAdjacentEdgeRange(entry.second))
+            {
+                const auto &data = graph.GetEdgeData(edge);
+                const auto target = graph.GetTarget(edge);
+                const auto weight = entry.first + data.weight;
+                if (data.forward && weight < weights[target])
+                {
+                    weights[target] = weight;
+                    queue.emplace(weight, target);
+                }
+            }
+        }
+        return weights;
+    }
+
+    static constexpr NodeID ROWS = 20;
+    static constexpr NodeID COLUMNS = 30;
+
+    std::mt19937 generator;
+    std::vector<contractor::QueryEdge> edges;
+    partition::MultiLevelPartition partition;
+};
+}
+
+BOOST_FIXTURE_TEST_CASE(overlay_search_matches_dijkstra, GridFixture)
+{
+    const Graph graph(ROWS * COLUMNS, edges);
+    customizer::CellStorage cell_storage(partition, graph);
+    const customizer::CellCustomizer customizer(partition);
+    customizer::CellCustomizer::Heap customizer_heap(graph.GetNumberOfNodes());
+    for (LevelID level = 1; level <= partition.GetNumberOfLevels(); ++level)
+    {
+        for (CellID id = 0; id < partition.GetNumberOfCells(level); ++id)
+        {
+            customizer.Customize(graph, customizer_heap, cell_storage, level, id);
+        }
+    }
+
+    const OverlayFacade facade(graph, partition, cell_storage);
+    const OverlaySearch search;
+    SearchEngineData::QueryHeap forward_heap(graph.GetNumberOfNodes());
+    SearchEngineData::QueryHeap reverse_heap(graph.GetNumberOfNodes());
+    SearchEngineData::QueryHeap unpack_heap(graph.GetNumberOfNodes());
+
+    std::uniform_int_distribution<NodeID> node_distribution(0, ROWS * COLUMNS - 1);
+    for (int query = 0; query < 200; ++query)
+    {
+        const auto source = node_distribution(generator);
+        const auto target = node_distribution(generator);
+        const auto expected = Dijkstra(graph, source)[target];
+
+        PhantomNodes phantom_nodes;
+        phantom_nodes.source_phantom.forward_segment_id = {source, true};
+        phantom_nodes.target_phantom.forward_segment_id = {target, true};
+        forward_heap.Clear();
+        reverse_heap.Clear();
+        forward_heap.Insert(source, 0, source);
+        reverse_heap.Insert(target, 0, target);
+
+        EdgeWeight weight = INVALID_EDGE_WEIGHT;
+        std::vector<NodeID> packed_leg;
+        search.SearchOnOverlay(facade,
+                               forward_heap,
+                               reverse_heap,
+                               unpack_heap,
+                               weight,
+                               packed_leg,
+                               false,
+                               false,
+                               phantom_nodes);
+
+        BOOST_CHECK_EQUAL(weight, expected);
+        if (weight == INVALID_EDGE_WEIGHT)
+        {
+            continue;
+        }
+
+        // the leg consists of edges of the graph only
+        BOOST_REQUIRE(!packed_leg.empty());
+        BOOST_CHECK_EQUAL(packed_leg.front(), source);
+        BOOST_CHECK_EQUAL(packed_leg.back(), target);
+        EdgeWeight path_weight = 0;
+        for (std::size_t index = 1; index < packed_leg.size(); ++index)
+        {
+            EdgeWeight edge_weight = INVALID_EDGE_WEIGHT;
+            for (const auto edge : graph.GetAdjacentEdgeRange(packed_leg[index - 1]))
+            {
+                const auto &data = graph.GetEdgeData(edge);
+                if (data.forward && graph.GetTarget(edge) == packed_leg[index])
+                {
+                    edge_weight = std::min(edge_weight, data.weight);
+                }
+            }
+            BOOST_REQUIRE_NE(edge_weight, INVALID_EDGE_WEIGHT);
+            path_weight += edge_weight;
+        }
+        BOOST_CHECK_EQUAL(path_weight, weight);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,90 @@
+#include "engine/phantom_node_cache.hpp"
+#include "engine/phantom_node.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <osrm/coordinate.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(phantom_node_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+// Answers every query with a phantom node at its coordinate and counts the queries
+struct CountingNearest
+{
+    std::vector<PhantomNodePair> operator()(const std::vector<NearestQuery> &queries) const
+    {
+        std::vector<PhantomNodePair> results;
+        for (const auto &query : queries)
+        {
+            PhantomNode phantom;
+            phantom.location = query.coordinate;
+            phantom.input_location = query.coordinate;
+            results.emplace_back(phantom, phantom);
+        }
+        number_of_queries += queries.size();
+        return results;
+    }
+
+    mutable std::size_t number_of_queries = 0;
+};
+
+NearestQuery MakeQuery(const double lon, const double lat)
+{
+    return NearestQuery{util::Coordinate{util::FloatLongitude{lon}, util::FloatLatitude{lat}}};
+}
+}
+
+BOOST_AUTO_TEST_CASE(only_missing_queries_are_answered)
+{
+    PhantomNodeCache<PhantomNodePair> cache("test", 16);
+    CountingNearest nearest;
+
+    const std::vector<NearestQuery> first = {MakeQuery(1, 1), MakeQuery(2, 2)};
+    const auto first_results = cache.Query(first, nearest);
+    BOOST_CHECK_EQUAL(nearest.number_of_queries, 2);
+    BOOST_CHECK_EQUAL(cache.GetHits(), 0);
+    BOOST_CHECK_EQUAL(cache.GetMisses(), 2);
+
+    const std::vector<NearestQuery> second = {MakeQuery(2, 2), MakeQuery(3, 3), MakeQuery(1, 1)};
+    const auto second_results = cache.Query(second, nearest);
+    BOOST_CHECK_EQUAL(nearest.number_of_queries, 3);
+    BOOST_CHECK_EQUAL(cache.GetHits(), 2);
+    BOOST_CHECK_EQUAL(cache.GetMisses(), 3);
+    BOOST_CHECK_CLOSE(cache.GetHitRate(), 0.4, 1e-6);
+
+    BOOST_REQUIRE_EQUAL(second_results.size(), second.size());
+    for (const auto i : util::irange<std::size_t>(0UL, second.size()))
+    {
+        BOOST_CHECK_EQUAL(second_results[i].first.location, second[i].coordinate);
+    }
+    BOOST_CHECK_EQUAL(second_results[0].first.location, first_results[1].first.location);
+}
+
+BOOST_AUTO_TEST_CASE(restrictions_are_part_of_the_key)
+{
+    PhantomNodeCache<PhantomNodePair> cache("test", 16);
+    CountingNearest nearest;
+
+    auto with_radius = MakeQuery(1, 1);
+    with_radius.max_distance = 10.;
+    auto with_bearing = MakeQuery(1, 1);
+    with_bearing.bearing = Bearing{90, 10};
+    auto with_other_bearing = MakeQuery(1, 1);
+    with_other_bearing.bearing = Bearing{90, 20};
+
+    cache.Query({MakeQuery(1, 1), with_radius, with_bearing, with_other_bearing}, nearest);
+    BOOST_CHECK_EQUAL(nearest.number_of_queries, 4);
+
+    cache.Query({with_other_bearing, with_radius}, nearest);
+    BOOST_CHECK_EQUAL(nearest.number_of_queries, 4);
+    BOOST_CHECK_EQUAL(cache.GetHits(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
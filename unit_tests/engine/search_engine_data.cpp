@@ -0,0 +1,70 @@
+#include "engine/search_engine_data.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(search_engine_data)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+// Reaches enough nodes that the next Clear() switches the heap to its dense index storage
+template <typename Heap> void FillDense(Heap &heap, const unsigned number_of_nodes)
+{
+    for (unsigned node = 0; node < number_of_nodes; ++node)
+    {
+        heap.Insert(node, static_cast<int>(node), node);
+    }
+    heap.Clear();
+}
+}
+
+BOOST_AUTO_TEST_CASE(query_heaps_grow_with_the_dataset)
+{
+    const unsigned small_number_of_nodes = 20000;
+    const unsigned large_number_of_nodes = 2 * small_number_of_nodes;
+
+    SearchEngineData engine_working_data;
+    engine_working_data.InitializeOrClearFirstThreadLocalStorage(small_number_of_nodes);
+    FillDense(*engine_working_data.forward_heap_1, small_number_of_nodes);
+    BOOST_CHECK_EQUAL(engine_working_data.forward_heap_1->Capacity(), small_number_of_nodes);
+
+    // a smaller dataset keeps the heap
+    const auto *heap = engine_working_data.forward_heap_1.get();
+    engine_working_data.InitializeOrClearFirstThreadLocalStorage(small_number_of_nodes / 2);
+    BOOST_CHECK_EQUAL(engine_working_data.forward_heap_1.get(), heap);
+
+    engine_working_data.InitializeOrClearFirstThreadLocalStorage(large_number_of_nodes);
+    auto &forward_heap = *engine_working_data.forward_heap_1;
+    auto &reverse_heap = *engine_working_data.reverse_heap_1;
+    BOOST_CHECK_GE(forward_heap.Capacity(), large_number_of_nodes);
+    BOOST_CHECK_GE(reverse_heap.Capacity(), large_number_of_nodes);
+
+    const NodeID last_node = large_number_of_nodes - 1;
+    forward_heap.Insert(last_node, 1, last_node);
+    BOOST_CHECK(forward_heap.WasInserted(last_node));
+    BOOST_CHECK_EQUAL(forward_heap.DeleteMin(), last_node);
+}
+
+BOOST_AUTO_TEST_CASE(many_to_many_heap_grows_with_the_dataset)
+{
+    const unsigned small_number_of_nodes = 20000;
+    const unsigned large_number_of_nodes = 2 * small_number_of_nodes;
+
+    SearchEngineData engine_working_data;
+    engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(small_number_of_nodes);
+    FillDense(*engine_working_data.many_to_many_heap, small_number_of_nodes);
+
+    engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(large_number_of_nodes);
+    auto &heap = *engine_working_data.many_to_many_heap;
+    BOOST_CHECK_GE(heap.Capacity(), large_number_of_nodes);
+
+    const NodeID last_node = large_number_of_nodes - 1;
+    heap.Insert(last_node, 1, last_node);
+    BOOST_CHECK(heap.WasInserted(last_node));
+    BOOST_CHECK_EQUAL(heap.DeleteMin(), last_node);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,246 @@
+#ifndef OSRM_UNIT_TEST_BINARY_DECODER
+#define OSRM_UNIT_TEST_BINARY_DECODER
+
+#include "engine/api/binary_writer.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Reference decoder for the binary responses, independent of the writer on purpose
+
+namespace osrm
+{
+namespace test
+{
+
+class BinaryReader
+{
+  public:
+    explicit BinaryReader(const std::vector<char> &buffer_) : buffer(buffer_), position(0) {}
+
+    std::uint16_t ReadHeader()
+    {
+        const auto magic = ReadBytes(4);
+        if (magic != "OSRM")
+            throw std::runtime_error("invalid magic number");
+        const auto version = Read<std::uint16_t>();
+        if (version != engine::api::binary::SCHEMA_VERSION)
+            throw std::runtime_error("unknown schema version");
+        return Read<std::uint16_t>();
+    }
+
+    // assumes a little-endian host
+    template <typename T> T Read()
+    {
+        const auto bytes = ReadBytes(sizeof(T));
+        T value;
+        std::memcpy(&value, bytes.data(), sizeof(T));
+        return value;
+    }
+
+    std::string ReadString() { return ReadBytes(Read<std::uint32_t>()); }
+
+    std::pair<double, double> ReadCoordinate()
+    {
+        const auto lon = Read<std::int32_t>();
+        const auto lat = Read<std::int32_t>();
+        return {lon / 1e6, lat / 1e6};
+    }
+
+    std::vector<std::pair<double, double>> ReadGeometry()
+    {
+        std::vector<std::pair<double, double>> coordinates(Read<std::uint32_t>());
+        for (auto &coordinate : coordinates)
+            coordinate = ReadCoordinate();
+        return coordinates;
+    }
+
+    bool AtEnd() const { return position == buffer.size(); }
+
+  private:
+    char Next()
+    {
+        if (position >= buffer.size())
+            throw std::runtime_error("unexpected end of buffer");
+        return buffer[position++];
+    }
+
+    std::string ReadBytes(const std::size_t size)
+    {
+        std::string bytes;
+        for (std::size_t i = 0; i < size; ++i)
+            bytes.push_back(Next());
+        return bytes;
+    }
+
+    const std::vector<char> &buffer;
+    std::size_t position;
+};
+
+struct DecodedWaypoint
+{
+    std::string name;
+    std::pair<double, double> location;
+    std::string hint;
+};
+
+inline DecodedWaypoint decodeWaypoint(BinaryReader &reader)
+{
+    DecodedWaypoint waypoint;
+    waypoint.name = reader.ReadString();
+    waypoint.location = reader.ReadCoordinate();
+    waypoint.hint = reader.ReadString();
+    return waypoint;
+}
+
+struct DecodedTable
+{
+    std::string code;
+    std::vector<DecodedWaypoint> sources;
+    std::vector<DecodedWaypoint> destinations;
+    // durations in deciseconds, INT32_MAX for no route
+    std::vector<std::vector<std::int32_t>> durations;
+};
+
+inline DecodedTable decodeTable(const std::vector<char> &buffer)
+{
+    BinaryReader reader(buffer);
+    const auto type = reader.ReadHeader();
+    if (type != static_cast<std::uint16_t>(engine::api::binary::ResponseType::Table))
+        throw std::runtime_error("not a table response");
+
+    DecodedTable table;
+    table.code = reader.ReadString();
+    table.sources.resize(reader.Read<std::uint32_t>());
+    table.destinations.resize(reader.Read<std::uint32_t>());
+    for (auto &source : table.sources)
+        source = decodeWaypoint(reader);
+    for (auto &destination : table.destinations)
+        destination = decodeWaypoint(reader);
+
+    table.durations.resize(table.sources.size());
+    for (auto &row : table.durations)
+    {
+        row.resize(table.destinations.size());
+        for (auto &duration : row)
+            duration = reader.Read<std::int32_t>();
+    }
+
+    if (!reader.AtEnd())
+        throw std::runtime_error("trailing bytes after table");
+    return table;
+}
+
+struct DecodedStep
+{
+    double distance;
+    double duration;
+    std::string name;
+    std::string mode;
+    std::string maneuver_type;
+    std::string maneuver_modifier;
+    std::pair<double, double> maneuver_location;
+    std::vector<std::pair<double, double>> geometry;
+};
+
+struct DecodedAnnotation
+{
+    std::vector<double> distances;
+    std::vector<double> durations;
+    std::vector<std::uint8_t> datasources;
+    std::vector<std::uint64_t> nodes;
+};
+
+struct DecodedLeg
+{
+    double distance;
+    double duration;
+    std::string summary;
+    std::vector<DecodedStep> steps;
+    bool has_annotation;
+    DecodedAnnotation annotation;
+};
+
+struct DecodedRoute
+{
+    double distance;
+    double duration;
+    std::vector<std::pair<double, double>> geometry;
+    std::vector<DecodedLeg> legs;
+};
+
+struct DecodedRouteResponse
+{
+    std::string code;
+    std::vector<DecodedWaypoint> waypoints;
+    std::vector<DecodedRoute> routes;
+};
+
+inline DecodedRouteResponse decodeRoute(const std::vector<char> &buffer)
+{
+    BinaryReader reader(buffer);
+    const auto type = reader.ReadHeader();
+    if (type != static_cast<std::uint16_t>(engine::api::binary::ResponseType::Route))
+        throw std::runtime_error("not a route response");
+
+    DecodedRouteResponse response;
+    response.code = reader.ReadString();
+    response.waypoints.resize(reader.Read<std::uint32_t>());
+    for (auto &waypoint : response.waypoints)
+        waypoint = decodeWaypoint(reader);
+
+    response.routes.resize(reader.Read<std::uint32_t>());
+    for (auto &route : response.routes)
+    {
+        route.distance = reader.Read<double>();
+        route.duration = reader.Read<double>();
+        route.geometry = reader.ReadGeometry();
+        route.legs.resize(reader.Read<std::uint32_t>());
+        for (auto &leg : route.legs)
+        {
+            leg.distance = reader.Read<double>();
+            leg.duration = reader.Read<double>();
+            leg.summary = reader.ReadString();
+            leg.steps.resize(reader.Read<std::uint32_t>());
+            for (auto &step : leg.steps)
+            {
+                step.distance = reader.Read<double>();
+                step.duration = reader.Read<double>();
+                step.name = reader.ReadString();
+                step.mode = reader.ReadString();
+                step.maneuver_type = reader.ReadString();
+                step.maneuver_modifier = reader.ReadString();
+                step.maneuver_location = reader.ReadCoordinate();
+                step.geometry = reader.ReadGeometry();
+            }
+
+            leg.has_annotation = reader.Read<std::uint8_t>() == 1;
+            if (leg.has_annotation)
+            {
+                auto &annotation = leg.annotation;
+                const auto number_of_segments = reader.Read<std::uint32_t>();
+                for (std::uint32_t i = 0; i < number_of_segments; ++i)
+                    annotation.distances.push_back(reader.Read<double>());
+                for (std::uint32_t i = 0; i < number_of_segments; ++i)
+                    annotation.durations.push_back(reader.Read<double>());
+                for (std::uint32_t i = 0; i < number_of_segments; ++i)
+                    annotation.datasources.push_back(reader.Read<std::uint8_t>());
+                annotation.nodes.resize(reader.Read<std::uint32_t>());
+                for (auto &node : annotation.nodes)
+                    node = reader.Read<std::uint64_t>();
+            }
+        }
+    }
+
+    if (!reader.AtEnd())
+        throw std::runtime_error("trailing bytes after route");
+    return response;
+}
+}
+}
+
+#endif
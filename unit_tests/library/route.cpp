@@ -2,6 +2,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "args.hpp"
+#include "binary_decoder.hpp"
 #include "coordinates.hpp"
 #include "equal_json.hpp"
 #include "fixture.hpp"
@@ -14,6 +15,8 @@
 #include "osrm/route_parameters.hpp"
 #include "osrm/status.hpp"
 
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(route)
 
 BOOST_AUTO_TEST_CASE(test_route_same_coordinates_fixture)
@@ -361,4 +364,117 @@ BOOST_AUTO_TEST_CASE(test_route_response_for_locations_across_components)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_route_binary_matches_json)
+{
+    const auto args = get_args();
+    auto osrm = getOSRM(args.at(0));
+
+    using namespace osrm;
+
+    const auto locations = get_locations_in_big_component();
+
+    RouteParameters params;
+    params.steps = true;
+    params.annotations = true;
+    params.coordinates.push_back(locations.at(0));
+    params.coordinates.push_back(locations.at(1));
+    params.coordinates.push_back(locations.at(2));
+
+    json::Object json_result;
+    BOOST_CHECK(osrm.Route(params, json_result) == Status::Ok);
+
+    params.format = RouteParameters::OutputFormatType::Binary;
+    std::vector<char> binary_result;
+    BOOST_CHECK(osrm.Route(params, binary_result) == Status::Ok);
+
+    const auto response = test::decodeRoute(binary_result);
+    BOOST_CHECK_EQUAL(response.code, "Ok");
+
+    const auto &waypoints = json_result.values.at("waypoints").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(response.waypoints.size(), waypoints.size());
+    for (std::size_t i = 0; i < waypoints.size(); ++i)
+    {
+        const auto &waypoint = waypoints[i].get<json::Object>().values;
+        BOOST_CHECK_EQUAL(response.waypoints[i].name,
+                          waypoint.at("name").get<json::String>().value);
+        BOOST_CHECK_EQUAL(response.waypoints[i].hint,
+                          waypoint.at("hint").get<json::String>().value);
+    }
+
+    const auto &routes = json_result.values.at("routes").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(response.routes.size(), routes.size());
+    for (std::size_t i = 0; i < routes.size(); ++i)
+    {
+        const auto &route = routes[i].get<json::Object>().values;
+        const auto &decoded_route = response.routes[i];
+        BOOST_CHECK_EQUAL(decoded_route.distance, route.at("distance").get<json::Number>().value);
+        BOOST_CHECK_EQUAL(decoded_route.duration, route.at("duration").get<json::Number>().value);
+        BOOST_CHECK(!decoded_route.geometry.empty());
+
+        const auto &legs = route.at("legs").get<json::Array>().values;
+        BOOST_REQUIRE_EQUAL(decoded_route.legs.size(), legs.size());
+        for (std::size_t j = 0; j < legs.size(); ++j)
+        {
+            const auto &leg = legs[j].get<json::Object>().values;
+            const auto &decoded_leg = decoded_route.legs[j];
+            BOOST_CHECK_EQUAL(decoded_leg.distance, leg.at("distance").get<json::Number>().value);
+            BOOST_CHECK_EQUAL(decoded_leg.duration, leg.at("duration").get<json::Number>().value);
+            BOOST_CHECK_EQUAL(decoded_leg.summary, leg.at("summary").get<json::String>().value);
+
+            const auto &steps = leg.at("steps").get<json::Array>().values;
+            BOOST_REQUIRE_EQUAL(decoded_leg.steps.size(), steps.size());
+            for (std::size_t k = 0; k < steps.size(); ++k)
+            {
+                const auto &step = steps[k].get<json::Object>().values;
+                const auto &maneuver = step.at("maneuver").get<json::Object>().values;
+                const auto &decoded_step = decoded_leg.steps[k];
+                BOOST_CHECK_EQUAL(decoded_step.name, step.at("name").get<json::String>().value);
+                BOOST_CHECK_EQUAL(decoded_step.mode, step.at("mode").get<json::String>().value);
+                BOOST_CHECK_EQUAL(decoded_step.maneuver_type,
+                                  maneuver.at("type").get<json::String>().value);
+            }
+
+            BOOST_REQUIRE(decoded_leg.has_annotation);
+            const auto &annotation = leg.at("annotation").get<json::Object>().values;
+            const auto &distances = annotation.at("distance").get<json::Array>().values;
+            const auto &nodes = annotation.at("nodes").get<json::Array>().values;
+            BOOST_CHECK_EQUAL(decoded_leg.annotation.distances.size(), distances.size());
+            BOOST_CHECK_EQUAL(decoded_leg.annotation.nodes.size(), nodes.size());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_route_mmap_matches_process_memory)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {args[0]};
+    config.use_shared_memory = false;
+    OSRM process_memory_osrm{config};
+    config.use_mmap = true;
+    // the first engine writes the memory image, the second one maps the existing image and the
+    // last one reads it into process memory
+    OSRM written_image_osrm{config};
+    OSRM mapped_image_osrm{config};
+    config.use_mmap = false;
+    OSRM read_image_osrm{config};
+
+    RouteParameters params;
+    params.steps = true;
+    params.coordinates = get_locations_in_big_component();
+
+    json::Object process_memory_result;
+    BOOST_CHECK(process_memory_osrm.Route(params, process_memory_result) == Status::Ok);
+    for (OSRM *osrm : {&written_image_osrm, &mapped_image_osrm, &read_image_osrm})
+    {
+        json::Object result;
+        BOOST_CHECK(osrm->Route(params, result) == Status::Ok);
+        CHECK_EQUAL_JSON(result, process_memory_result);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
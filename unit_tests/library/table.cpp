@@ -2,7 +2,9 @@
 #include <boost/test/unit_test.hpp>
 
 #include "args.hpp"
+#include "binary_decoder.hpp"
 #include "coordinates.hpp"
+#include "equal_json.hpp"
 #include "fixture.hpp"
 #include "waypoint_check.hpp"
 
@@ -14,6 +16,13 @@
 #include "osrm/osrm.hpp"
 #include "osrm/status.hpp"
 
+#include "util/json_renderer.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(table)
 
 BOOST_AUTO_TEST_CASE(test_table_three_coords_one_source_one_dest_matrix)
@@ -161,4 +170,179 @@ BOOST_AUTO_TEST_CASE(test_table_three_coordinates_matrix)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_table_parallel_matches_sequential)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {args[0]};
+    config.use_shared_memory = false;
+    OSRM sequential_osrm{config};
+    config.max_threads_distance_table = 4;
+    OSRM parallel_osrm{config};
+
+    // a grid over monaco that is large enough to be split up between threads
+    TableParameters params;
+    for (int x = 0; x < 10; ++x)
+    {
+        for (int y = 0; y < 8; ++y)
+        {
+            params.coordinates.push_back(
+                {Longitude{7.412 + 0.002 * x}, Latitude{43.728 + 0.002 * y}});
+        }
+    }
+
+    json::Object sequential_result;
+    json::Object parallel_result;
+    BOOST_CHECK(sequential_osrm.Table(params, sequential_result) == Status::Ok);
+    BOOST_CHECK(parallel_osrm.Table(params, parallel_result) == Status::Ok);
+
+    CHECK_EQUAL_JSON(sequential_result.values.at("durations"),
+                     parallel_result.values.at("durations"));
+}
+
+BOOST_AUTO_TEST_CASE(test_table_tiled_rendering_matches_json)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {args[0]};
+    config.use_shared_memory = false;
+    // a handful of rows per tile, the last tile is only partially filled
+    config.max_entries_table_tile = 3 * 80;
+    OSRM osrm{config};
+
+    TableParameters params;
+    for (int x = 0; x < 10; ++x)
+    {
+        for (int y = 0; y < 8; ++y)
+        {
+            params.coordinates.push_back(
+                {Longitude{7.412 + 0.002 * x}, Latitude{43.728 + 0.002 * y}});
+        }
+    }
+
+    json::Object json_result;
+    std::vector<char> rendered_result;
+    BOOST_CHECK(osrm.Table(params, json_result) == Status::Ok);
+    BOOST_CHECK(osrm.Table(params, rendered_result) == Status::Ok);
+
+    const std::string rendered(rendered_result.begin(), rendered_result.end());
+    BOOST_CHECK_EQUAL(rendered.front(), '{');
+    BOOST_CHECK_EQUAL(rendered.back(), '}');
+    BOOST_CHECK(rendered.find("\"code\":\"Ok\"") != std::string::npos);
+
+    const auto render_member = [&](const std::string &key) {
+        std::vector<char> buffer;
+        mapbox::util::apply_visitor(json::ArrayRenderer(buffer), json_result.values.at(key));
+        return "\"" + key + "\":" + std::string(buffer.begin(), buffer.end());
+    };
+    BOOST_CHECK(rendered.find(render_member("durations")) != std::string::npos);
+    BOOST_CHECK(rendered.find(render_member("sources")) != std::string::npos);
+    BOOST_CHECK(rendered.find(render_member("destinations")) != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_table_tiled_rendering_error)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {args[0]};
+    config.use_shared_memory = false;
+    config.max_locations_distance_table = 3;
+    OSRM osrm{config};
+
+    TableParameters params;
+    for (int i = 0; i < 4; ++i)
+    {
+        params.coordinates.push_back(get_dummy_location());
+    }
+
+    std::vector<char> rendered_result;
+    BOOST_CHECK(osrm.Table(params, rendered_result) == Status::Error);
+
+    const std::string rendered(rendered_result.begin(), rendered_result.end());
+    BOOST_CHECK(rendered.find("\"code\":\"TooBig\"") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_table_binary_matches_json)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {args[0]};
+    config.use_shared_memory = false;
+    config.max_entries_table_tile = 3 * 8;
+    OSRM osrm{config};
+
+    TableParameters params;
+    for (int x = 0; x < 4; ++x)
+    {
+        for (int y = 0; y < 2; ++y)
+        {
+            params.coordinates.push_back(
+                {Longitude{7.412 + 0.004 * x}, Latitude{43.728 + 0.004 * y}});
+        }
+    }
+    params.sources = {0, 2, 4, 5, 7};
+
+    json::Object json_result;
+    BOOST_CHECK(osrm.Table(params, json_result) == Status::Ok);
+
+    params.format = TableParameters::OutputFormatType::Binary;
+    std::vector<char> binary_result;
+    BOOST_CHECK(osrm.Table(params, binary_result) == Status::Ok);
+
+    const auto table = test::decodeTable(binary_result);
+    BOOST_CHECK_EQUAL(table.code, "Ok");
+
+    const auto &sources = json_result.values.at("sources").get<json::Array>().values;
+    const auto &destinations = json_result.values.at("destinations").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(table.sources.size(), sources.size());
+    BOOST_REQUIRE_EQUAL(table.destinations.size(), destinations.size());
+    for (std::size_t i = 0; i < sources.size(); ++i)
+    {
+        const auto &source = sources[i].get<json::Object>().values;
+        const auto &location = source.at("location").get<json::Array>().values;
+        BOOST_CHECK_EQUAL(table.sources[i].name, source.at("name").get<json::String>().value);
+        BOOST_CHECK_EQUAL(table.sources[i].hint, source.at("hint").get<json::String>().value);
+        BOOST_CHECK_CLOSE(
+            table.sources[i].location.first, location[0].get<json::Number>().value, 1e-4);
+        BOOST_CHECK_CLOSE(
+            table.sources[i].location.second, location[1].get<json::Number>().value, 1e-4);
+    }
+
+    const auto &durations = json_result.values.at("durations").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(table.durations.size(), durations.size());
+    for (std::size_t row = 0; row < durations.size(); ++row)
+    {
+        const auto &json_row = durations[row].get<json::Array>().values;
+        BOOST_REQUIRE_EQUAL(table.durations[row].size(), json_row.size());
+        for (std::size_t column = 0; column < json_row.size(); ++column)
+        {
+            const auto duration = table.durations[row][column];
+            if (json_row[column].is<json::Null>())
+            {
+                BOOST_CHECK_EQUAL(duration, std::numeric_limits<std::int32_t>::max());
+            }
+            else
+            {
+                BOOST_CHECK_EQUAL(duration / 10., json_row[column].get<json::Number>().value);
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
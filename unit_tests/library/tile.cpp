@@ -16,6 +16,8 @@
 
 #include <protozero/pbf_reader.hpp>
 
+#include <unordered_map>
+
 BOOST_AUTO_TEST_SUITE(tile)
 
 BOOST_AUTO_TEST_CASE(test_tile)
@@ -21,6 +21,8 @@ class MockDataFacade final : public engine::datafacade::BaseDataFacade
 {
   private:
     EdgeData foo;
+    partition::MultiLevelPartitionView partition;
+    customizer::CellStorageView cell_storage;
 
   public:
     unsigned GetNumberOfNodes() const override { return 0; }
@@ -196,6 +198,19 @@ class MockDataFacade final : public engine::datafacade::BaseDataFacade
         return {};
     }
 
+    std::vector<std::vector<engine::PhantomNodeWithDistance>>
+    NearestPhantomNodes(const std::vector<engine::NearestQuery> &queries) const override
+    {
+        return std::vector<std::vector<engine::PhantomNodeWithDistance>>(queries.size());
+    }
+
+    std::vector<std::pair<engine::PhantomNode, engine::PhantomNode>>
+    NearestPhantomNodeWithAlternativeFromBigComponent(
+        const std::vector<engine::NearestQuery> &queries) const override
+    {
+        return std::vector<std::pair<engine::PhantomNode, engine::PhantomNode>>(queries.size());
+    }
+
     unsigned GetCheckSum() const override { return 0; }
     bool IsCoreNode(const NodeID /* id */) const override { return false; }
     unsigned GetNameIndexFromEdgeID(const unsigned /* id */) const override { return 0; }
@@ -204,6 +219,11 @@ class MockDataFacade final : public engine::datafacade::BaseDataFacade
     std::string GetPronunciationForID(const unsigned /* name_id */) const override { return ""; }
     std::string GetDestinationsForID(const unsigned /* name_id */) const override { return ""; }
     std::size_t GetCoreSize() const override { return 0; }
+    const partition::MultiLevelPartitionView &GetMultiLevelPartition() const override
+    {
+        return partition;
+    }
+    const customizer::CellStorageView &GetCellStorage() const override { return cell_storage; }
     std::string GetTimestamp() const override { return ""; }
     bool GetContinueStraightDefault() const override { return true; }
     double GetMapMatchingMaxSpeed() const override { return 180 / 3.6; }
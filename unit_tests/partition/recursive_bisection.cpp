@@ -0,0 +1,129 @@
+#include "partition/multi_level_partition.hpp"
+#include "partition/recursive_bisection.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(recursive_bisection)
+
+using namespace osrm;
+using namespace osrm::partition;
+
+namespace
+{
+// Grid graph with edges in both directions
+std::vector<std::pair<NodeID, NodeID>> makeGrid(const NodeID rows, const NodeID columns)
+{
+    std::vector<std::pair<NodeID, NodeID>> edges;
+    for (NodeID row = 0; row < rows; ++row)
+    {
+        for (NodeID column = 0; column < columns; ++column)
+        {
+            const auto node = row * columns + column;
+            if (column + 1 < columns)
+            {
+                edges.emplace_back(node, node + 1);
+                edges.emplace_back(node + 1, node);
+            }
+            if (row + 1 < rows)
+            {
+                edges.emplace_back(node, node + columns);
+                edges.emplace_back(node + columns, node);
+            }
+        }
+    }
+    return edges;
+}
+
+std::map<CellID, std::size_t> cellSizes(const MultiLevelPartition &partition, const LevelID level)
+{
+    std::map<CellID, std::size_t> sizes;
+    for (NodeID node = 0; node < partition.GetNumberOfNodes(); ++node)
+    {
+        ++sizes[partition.GetCell(level, node)];
+    }
+    return sizes;
+}
+}
+
+BOOST_AUTO_TEST_CASE(grid_cells_are_nested_and_bounded)
+{
+    const NodeID number_of_nodes = 40 * 50;
+    const RecursiveBisection bisection(number_of_nodes, makeGrid(40, 50));
+    const std::vector<std::size_t> max_cell_sizes{16, 128, 1024};
+    const MultiLevelPartition partition(bisection.ComputeCells(max_cell_sizes));
+
+    BOOST_CHECK_EQUAL(partition.GetNumberOfNodes(), number_of_nodes);
+    BOOST_REQUIRE_EQUAL(partition.GetNumberOfLevels(), 3);
+
+    for (LevelID level = 1; level <= partition.GetNumberOfLevels(); ++level)
+    {
+        const auto sizes = cellSizes(partition, level);
+        // ids are consecutive
+        BOOST_CHECK_EQUAL(sizes.size(), partition.GetNumberOfCells(level));
+        BOOST_CHECK_EQUAL(sizes.rbegin()->first + 1, partition.GetNumberOfCells(level));
+        for (const auto &cell_size : sizes)
+        {
+            BOOST_CHECK_LE(cell_size.second, max_cell_sizes[level - 1]);
+            // bisection splits evenly, so cells are at least half of the maximal size
+            BOOST_CHECK_GT(2 * cell_size.second, max_cell_sizes[level - 1] / 2);
+        }
+    }
+
+    // every cell is contained in a single cell of the level above
+    for (LevelID level = 1; level < partition.GetNumberOfLevels(); ++level)
+    {
+        std::map<CellID, CellID> parent;
+        for (NodeID node = 0; node < number_of_nodes; ++node)
+        {
+            const auto inserted = parent.emplace(partition.GetCell(level, node),
+                                                 partition.GetCell(level + 1, node));
+            BOOST_CHECK_EQUAL(inserted.first->second, partition.GetCell(level + 1, node));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(single_cell_levels_are_dropped)
+{
+    const RecursiveBisection bisection(100, makeGrid(10, 10));
+
+    const MultiLevelPartition partition(bisection.ComputeCells({10, 1000, 10000}));
+    BOOST_CHECK_EQUAL(partition.GetNumberOfLevels(), 1);
+
+    // the first level is always there, even if it has a single cell
+    const MultiLevelPartition single_cell(bisection.ComputeCells({100, 1000}));
+    BOOST_REQUIRE_EQUAL(single_cell.GetNumberOfLevels(), 1);
+    BOOST_CHECK_EQUAL(single_cell.GetNumberOfCells(1), 1);
+}
+
+BOOST_AUTO_TEST_CASE(disconnected_graph)
+{
+    // no edges at all, so every split has to restart the search
+    const RecursiveBisection bisection(1000, {});
+    const MultiLevelPartition partition(bisection.ComputeCells({10, 100}));
+
+    BOOST_REQUIRE_EQUAL(partition.GetNumberOfLevels(), 2);
+    for (const auto &cell_size : cellSizes(partition, 1))
+    {
+        BOOST_CHECK_LE(cell_size.second, 10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(highest_different_level)
+{
+    // 4 nodes, two cells of two nodes on level 1 and one cell on level 2
+    const MultiLevelPartition partition(
+        std::vector<std::vector<CellID>>{{0, 0, 1, 2}, {0, 0, 0, 1}});
+
+    BOOST_CHECK_EQUAL(partition.GetNumberOfCells(1), 3);
+    BOOST_CHECK_EQUAL(partition.GetNumberOfCells(2), 2);
+    BOOST_CHECK_EQUAL(partition.GetHighestDifferentLevel(0, 1), 0);
+    BOOST_CHECK_EQUAL(partition.GetHighestDifferentLevel(0, 2), 1);
+    BOOST_CHECK_EQUAL(partition.GetHighestDifferentLevel(2, 3), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -46,6 +46,22 @@ inline std::ostream &operator<<(std::ostream &out, api::RouteParameters::Overvie
     }
     return out;
 }
+
+inline std::ostream &operator<<(std::ostream &out, api::BaseParameters::OutputFormatType format)
+{
+    switch (format)
+    {
+    case api::BaseParameters::OutputFormatType::JSON:
+        out << "JSON";
+        break;
+    case api::BaseParameters::OutputFormatType::Binary:
+        out << "Binary";
+        break;
+    default:
+        BOOST_ASSERT_MSG(false, "OutputFormatType not fully captured");
+    }
+    return out;
+}
 }
 
 inline std::ostream &operator<<(std::ostream &out, Bearing bearing)
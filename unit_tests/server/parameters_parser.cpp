@@ -63,6 +63,8 @@ BOOST_AUTO_TEST_CASE(invalid_route_urls)
     BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>(std::string{"1,2;3,4"} + '\0' + ".json"),
                       7);
     BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>(std::string{"1,2;3,"} + '\0'), 6);
+    BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4.bin.json"), 11);
+    BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4.binary"), 11);
 
     // BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>(), );
 }
@@ -332,6 +334,43 @@ BOOST_AUTO_TEST_CASE(valid_table_urls)
     CHECK_EQUAL_RANGE(reference_1.bearings, result_3->bearings);
     CHECK_EQUAL_RANGE(reference_1.radiuses, result_3->radiuses);
     CHECK_EQUAL_RANGE(reference_1.coordinates, result_3->coordinates);
+
+    auto result_4 = parseParameters<TableParameters>("1,2;3,4.json?sources=all");
+    BOOST_CHECK(result_4);
+    BOOST_CHECK_EQUAL(result_4->format, TableParameters::OutputFormatType::JSON);
+    CHECK_EQUAL_RANGE(reference_1.coordinates, result_4->coordinates);
+
+    auto result_5 = parseParameters<TableParameters>("1,2;3,4.bin?sources=1;2;3&destinations=4;5");
+    BOOST_CHECK(result_5);
+    BOOST_CHECK_EQUAL(result_5->format, TableParameters::OutputFormatType::Binary);
+    CHECK_EQUAL_RANGE(reference_2.sources, result_5->sources);
+    CHECK_EQUAL_RANGE(reference_2.destinations, result_5->destinations);
+    CHECK_EQUAL_RANGE(reference_2.coordinates, result_5->coordinates);
+}
+
+BOOST_AUTO_TEST_CASE(valid_binary_route_urls)
+{
+    std::vector<util::Coordinate> coords_1 = {{util::FloatLongitude{1}, util::FloatLatitude{2}},
+                                              {util::FloatLongitude{3}, util::FloatLatitude{4}}};
+
+    auto result_1 = parseParameters<RouteParameters>("1,2;3,4");
+    BOOST_CHECK(result_1);
+    BOOST_CHECK_EQUAL(result_1->format, RouteParameters::OutputFormatType::JSON);
+
+    auto result_2 = parseParameters<RouteParameters>("1,2;3,4.bin?steps=true");
+    BOOST_CHECK(result_2);
+    BOOST_CHECK_EQUAL(result_2->format, RouteParameters::OutputFormatType::Binary);
+    BOOST_CHECK_EQUAL(result_2->steps, true);
+    CHECK_EQUAL_RANGE(coords_1, result_2->coordinates);
+
+    // a dot directly in front of the extension belongs to the number
+    auto result_3 = parseParameters<RouteParameters>("1,2;3,4..bin");
+    BOOST_CHECK(result_3);
+    BOOST_CHECK_EQUAL(result_3->format, RouteParameters::OutputFormatType::Binary);
+    CHECK_EQUAL_RANGE(coords_1, result_3->coordinates);
+
+    // only route and table render binary responses
+    BOOST_CHECK_EQUAL(testInvalidOptions<NearestParameters>("1,2.bin"), 3);
 }
 
 BOOST_AUTO_TEST_CASE(valid_match_urls)
@@ -25,7 +25,10 @@ typedef int TestKey;
 typedef int TestWeight;
 typedef boost::mpl::list<ArrayStorage<TestNodeID, TestKey>,
                          MapStorage<TestNodeID, TestKey>,
-                         UnorderedMapStorage<TestNodeID, TestKey>>
+                         UnorderedMapStorage<TestNodeID, TestKey>,
+                         GenerationArrayStorage<TestNodeID, TestKey>,
+                         AdaptiveArrayStorage<TestNodeID, TestKey>,
+                         AdaptiveArrayStorage<TestNodeID, TestKey, 4>>
     storage_types;
 
 template <unsigned NUM_ELEM> struct RandomDataFixture
@@ -123,6 +126,36 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_all_test, T, storage_types, RandomDataFi
     BOOST_CHECK(heap.Empty());
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(clear_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+{
+    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+
+    // run a few "queries" on the same heap, each reaching a different subset of nodes
+    for (unsigned round = 1; round <= 3; ++round)
+    {
+        heap.Clear();
+
+        for (auto id : ids)
+        {
+            BOOST_CHECK(!heap.WasInserted(id));
+        }
+
+        for (unsigned idx : order)
+        {
+            if (ids[idx] % round == 0)
+            {
+                heap.Insert(ids[idx], weights[idx], data[idx]);
+            }
+        }
+
+        for (auto id : ids)
+        {
+            BOOST_CHECK_EQUAL(heap.WasInserted(id), id % round == 0);
+        }
+        BOOST_CHECK_EQUAL(heap.Min(), 0);
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types, RandomDataFixture<10>)
 {
     BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(10);
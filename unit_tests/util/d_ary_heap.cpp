@@ -0,0 +1,130 @@
+#include "util/d_ary_heap.hpp"
+#include "util/binary_heap.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/mpl/list.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(d_ary_heap)
+
+using namespace osrm;
+using namespace osrm::util;
+
+struct TestData
+{
+    unsigned value;
+};
+
+typedef NodeID TestNodeID;
+typedef int TestKey;
+typedef int TestWeight;
+typedef boost::mpl::list<
+    DAryHeap<TestNodeID, TestKey, TestWeight, TestData, ArrayStorage<TestNodeID, TestKey>, 2>,
+    DAryHeap<TestNodeID, TestKey, TestWeight, TestData, ArrayStorage<TestNodeID, TestKey>, 3>,
+    DAryHeap<TestNodeID, TestKey, TestWeight, TestData, ArrayStorage<TestNodeID, TestKey>, 4>,
+    DAryHeap<TestNodeID, TestKey, TestWeight, TestData, UnorderedMapStorage<TestNodeID, TestKey>, 8>>
+    heap_types;
+
+constexpr unsigned NUM_NODES = 1000;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(delete_min_order_test, T, heap_types)
+{
+    T heap(NUM_NODES);
+
+    // Choosen by a fair W20 dice roll
+    std::mt19937 g(15);
+    std::vector<TestNodeID> ids(NUM_NODES);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), g);
+
+    for (auto id : ids)
+    {
+        BOOST_CHECK(!heap.WasInserted(id));
+        heap.Insert(id, static_cast<TestWeight>(id) * 10, TestData{id});
+        BOOST_CHECK(heap.WasInserted(id));
+    }
+    BOOST_CHECK_EQUAL(heap.Size(), NUM_NODES);
+
+    for (TestNodeID id = 0; id < NUM_NODES; ++id)
+    {
+        BOOST_CHECK_EQUAL(heap.Min(), id);
+        BOOST_CHECK_EQUAL(heap.MinKey(), static_cast<TestWeight>(id) * 10);
+        BOOST_CHECK_EQUAL(heap.GetData(id).value, id);
+        BOOST_CHECK(!heap.WasRemoved(id));
+        BOOST_CHECK_EQUAL(heap.DeleteMin(), id);
+        BOOST_CHECK(heap.WasRemoved(id));
+    }
+    BOOST_CHECK(heap.Empty());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(decrease_key_test, T, heap_types)
+{
+    T heap(NUM_NODES);
+
+    for (TestNodeID id = 0; id < NUM_NODES; ++id)
+    {
+        heap.Insert(id, 1000000, TestData{id});
+    }
+
+    // walk the ids backwards so every decrease creates a new minimum
+    for (TestNodeID id = 0; id < NUM_NODES; ++id)
+    {
+        const TestNodeID node = NUM_NODES - 1 - id;
+        heap.DecreaseKey(node, static_cast<TestWeight>(node));
+        BOOST_CHECK_EQUAL(heap.Min(), node);
+        BOOST_CHECK_EQUAL(heap.GetKey(node), static_cast<TestWeight>(node));
+    }
+
+    heap.DeleteAll();
+    BOOST_CHECK(heap.Empty());
+}
+
+// Runs the same random sequence of operations against BinaryHeap
+BOOST_AUTO_TEST_CASE_TEMPLATE(binary_heap_equivalence_test, T, heap_types)
+{
+    T heap(NUM_NODES);
+    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, ArrayStorage<TestNodeID, TestKey>>
+        reference(NUM_NODES);
+
+    std::mt19937 g(42);
+    std::uniform_int_distribution<TestNodeID> node_distribution(0, NUM_NODES - 1);
+    std::uniform_int_distribution<TestWeight> weight_distribution(0, 10000);
+
+    for (unsigned round = 0; round < 3; ++round)
+    {
+        heap.Clear();
+        reference.Clear();
+        for (unsigned step = 0; step < 5000; ++step)
+        {
+            const auto node = node_distribution(g);
+            const auto weight = weight_distribution(g);
+            if (!reference.WasInserted(node))
+            {
+                heap.Insert(node, weight, TestData{node});
+                reference.Insert(node, weight, TestData{node});
+            }
+            else if (!reference.WasRemoved(node) && weight < reference.GetKey(node))
+            {
+                heap.DecreaseKey(node, weight);
+                reference.DecreaseKey(node, weight);
+            }
+            else if (!reference.Empty())
+            {
+                BOOST_CHECK_EQUAL(heap.MinKey(), reference.MinKey());
+                const auto min_key = reference.MinKey();
+                reference.DeleteMin();
+                BOOST_CHECK_EQUAL(heap.GetKey(heap.DeleteMin()), min_key);
+            }
+            BOOST_CHECK_EQUAL(heap.Size(), reference.Size());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,101 @@
+#include "util/json_arena.hpp"
+#include "util/json_container.hpp"
+#include "util/json_renderer.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(json_container)
+
+using namespace osrm;
+using namespace osrm::util;
+
+std::string renderToString(const json::Object &object)
+{
+    std::vector<char> buffer;
+    json::render(buffer, object);
+    return std::string(buffer.begin(), buffer.end());
+}
+
+BOOST_AUTO_TEST_CASE(object_keeps_insertion_order)
+{
+    json::Object object;
+    object.values["z"] = 1.;
+    object.values["a"] = "b";
+    object.values["m"] = json::Array{{json::Null(), json::True()}};
+    object.values["a"] = "c";
+
+    BOOST_CHECK_EQUAL(object.values.size(), 3);
+    BOOST_CHECK_EQUAL(renderToString(object), "{\"z\":1,\"a\":\"c\",\"m\":[null,true]}");
+}
+
+BOOST_AUTO_TEST_CASE(object_lookup)
+{
+    json::Object object{{{"first", 1.}, {"second", json::False()}}};
+
+    BOOST_CHECK(object.values.find("second") != object.values.end());
+    BOOST_CHECK(object.values.find("third") == object.values.end());
+    BOOST_CHECK_EQUAL(object.values.count("first"), 1);
+    BOOST_CHECK_EQUAL(object.values.at("first").get<json::Number>().value, 1.);
+    BOOST_CHECK_THROW(object.values.at("third"), std::out_of_range);
+
+    BOOST_CHECK(!object.values.emplace("first", 2.).second);
+    BOOST_CHECK_EQUAL(object.values.at("first").get<json::Number>().value, 1.);
+    BOOST_CHECK_EQUAL(object.values.erase("first"), 1);
+    BOOST_CHECK_EQUAL(object.values.erase("first"), 0);
+    BOOST_CHECK_EQUAL(renderToString(object), "{\"second\":false}");
+}
+
+BOOST_AUTO_TEST_CASE(arena_scope)
+{
+    json::Object heap_object;
+    heap_object.values["heap"] = json::Array{{1.}};
+
+    json::Arena arena;
+    {
+        json::ArenaScope scope(arena);
+
+        json::Object object;
+        object.values["nested"] = json::Object{{{"values", json::Array{{1., 2., 3.}}}}};
+        object.values["text"] = "arena";
+        BOOST_CHECK(arena.NumberOfAllocations() > 0);
+
+        // heap values can be moved into arena values and are still freed correctly
+        object.values["heap"] = std::move(heap_object);
+        BOOST_CHECK_EQUAL(
+            renderToString(object),
+            "{\"nested\":{\"values\":[1,2,3]},\"text\":\"arena\",\"heap\":{\"heap\":[1]}}");
+    }
+
+    // once the scope ended new values come from the heap again
+    const auto allocations = arena.NumberOfAllocations();
+    json::Object object;
+    object.values["key"] = json::Array{{1.}};
+    BOOST_CHECK_EQUAL(arena.NumberOfAllocations(), allocations);
+}
+
+// copies made after the scope ended don't refer to the arena and outlive it
+BOOST_AUTO_TEST_CASE(arena_copy_outlives_arena)
+{
+    json::Object copy;
+    {
+        json::Arena arena;
+        json::Object object = [&arena] {
+            json::ArenaScope scope(arena);
+            json::Object object;
+            object.values["values"] = json::Array{{1., 2., 3.}};
+            return object;
+        }();
+        const auto allocations = arena.NumberOfAllocations();
+        copy = object;
+        BOOST_CHECK_EQUAL(arena.NumberOfAllocations(), allocations);
+    }
+    BOOST_CHECK_EQUAL(renderToString(copy), "{\"values\":[1,2,3]}");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
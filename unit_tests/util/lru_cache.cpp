@@ -0,0 +1,52 @@
+#include "util/lru_cache.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(lru_cache)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(evicts_least_recently_used)
+{
+    LRUCache<int, std::string> cache(2);
+    std::string value;
+
+    cache.Insert(1, "one");
+    cache.Insert(2, "two");
+    BOOST_CHECK_EQUAL(cache.Size(), 2);
+
+    // 1 is now used more recently than 2
+    BOOST_CHECK(cache.Get(1, value));
+    BOOST_CHECK_EQUAL(value, "one");
+
+    cache.Insert(3, "three");
+    BOOST_CHECK_EQUAL(cache.Size(), 2);
+    BOOST_CHECK(!cache.Get(2, value));
+    BOOST_CHECK(cache.Get(1, value));
+    BOOST_CHECK_EQUAL(value, "one");
+    BOOST_CHECK(cache.Get(3, value));
+    BOOST_CHECK_EQUAL(value, "three");
+}
+
+BOOST_AUTO_TEST_CASE(insert_replaces_value)
+{
+    LRUCache<int, std::string> cache(2);
+    std::string value;
+
+    cache.Insert(1, "one");
+    cache.Insert(2, "two");
+    cache.Insert(1, "uno");
+    BOOST_CHECK_EQUAL(cache.Size(), 2);
+
+    // replacing marked 1 as most recently used
+    cache.Insert(3, "three");
+    BOOST_CHECK(!cache.Get(2, value));
+    BOOST_CHECK(cache.Get(1, value));
+    BOOST_CHECK_EQUAL(value, "uno");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
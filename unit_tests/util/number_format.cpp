@@ -0,0 +1,88 @@
+#include "util/cast.hpp"
+#include "util/number_format.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(number_format)
+
+using namespace osrm;
+using namespace osrm::util;
+
+std::string formatToString(const double value)
+{
+    char buffer[FixedPointLength<6>::value];
+    return std::string(buffer, formatFixedPoint(buffer, value));
+}
+
+BOOST_AUTO_TEST_CASE(format_integer)
+{
+    char buffer[20];
+    BOOST_CHECK_EQUAL(std::string(buffer, formatInteger(buffer, 0)), "0");
+    BOOST_CHECK_EQUAL(std::string(buffer, formatInteger(buffer, 1234567)), "1234567");
+    BOOST_CHECK_EQUAL(
+        std::string(buffer, formatInteger(buffer, std::numeric_limits<std::uint64_t>::max())),
+        "18446744073709551615");
+}
+
+BOOST_AUTO_TEST_CASE(format_fixed_point)
+{
+    BOOST_CHECK_EQUAL(formatToString(0.), "0");
+    BOOST_CHECK_EQUAL(formatToString(-0.), "-0");
+    BOOST_CHECK_EQUAL(formatToString(42.), "42");
+    BOOST_CHECK_EQUAL(formatToString(-1.5), "-1.5");
+    BOOST_CHECK_EQUAL(formatToString(7.43707), "7.43707");
+    BOOST_CHECK_EQUAL(formatToString(0.1 + 0.2), "0.3");
+    BOOST_CHECK_EQUAL(formatToString(1e-7), "0");
+    BOOST_CHECK_EQUAL(formatToString(1.0000005), "1.000001");
+    BOOST_CHECK_EQUAL(formatToString(1e20), "100000000000000000000");
+    BOOST_CHECK_EQUAL(formatToString(std::numeric_limits<double>::quiet_NaN()), "null");
+    BOOST_CHECK_EQUAL(formatToString(std::numeric_limits<double>::infinity()), "null");
+}
+
+BOOST_AUTO_TEST_CASE(format_fixed_point_matches_iostreams)
+{
+    const auto check = [](const double value) {
+        BOOST_CHECK_EQUAL(formatToString(value), cast::to_string_with_precision(value));
+    };
+
+    for (const double value : {0.5e-6,
+                               1.5e-6,
+                               2.5e-6,
+                               -2.5e-6,
+                               0.1234565,
+                               123456789.123456789,
+                               9007199254740993.,
+                               std::numeric_limits<double>::denorm_min(),
+                               std::numeric_limits<double>::max(),
+                               std::numeric_limits<double>::lowest()})
+    {
+        check(value);
+    }
+
+    std::mt19937_64 generator(7);
+    std::uniform_real_distribution<double> coordinate_distribution(-180., 180.);
+    for (int i = 0; i < 10000; ++i)
+    {
+        check(coordinate_distribution(generator));
+        check(std::round(coordinate_distribution(generator) * 10) / 10.);
+        check(i * 0.5e-6);
+
+        const auto bits = generator();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (std::isfinite(value))
+        {
+            check(value);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
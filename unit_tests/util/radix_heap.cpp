@@ -0,0 +1,145 @@
+#include "util/radix_heap.hpp"
+#include "util/binary_heap.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/mpl/list.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(radix_heap)
+
+using namespace osrm;
+using namespace osrm::util;
+
+struct TestData
+{
+    unsigned value;
+};
+
+typedef NodeID TestNodeID;
+typedef int TestKey;
+typedef int TestWeight;
+typedef boost::mpl::list<ArrayStorage<TestNodeID, TestKey>,
+                         UnorderedMapStorage<TestNodeID, TestKey>,
+                         GenerationArrayStorage<TestNodeID, TestKey>>
+    storage_types;
+
+constexpr unsigned NUM_NODES = 1000;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(delete_min_order_test, T, storage_types)
+{
+    RadixHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+
+    // Choosen by a fair W20 dice roll
+    std::mt19937 g(15);
+    std::vector<TestNodeID> ids(NUM_NODES);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), g);
+
+    // negative weights are used by the many-to-many search for phantom node offsets
+    const auto to_weight = [](const TestNodeID id) { return static_cast<TestWeight>(id) - 500; };
+
+    for (auto id : ids)
+    {
+        BOOST_CHECK(!heap.WasInserted(id));
+        heap.Insert(id, to_weight(id), TestData{id});
+        BOOST_CHECK(heap.WasInserted(id));
+    }
+    BOOST_CHECK_EQUAL(heap.Size(), NUM_NODES);
+
+    for (TestNodeID id = 0; id < NUM_NODES; ++id)
+    {
+        BOOST_CHECK_EQUAL(heap.Min(), id);
+        BOOST_CHECK_EQUAL(heap.MinKey(), to_weight(id));
+        BOOST_CHECK_EQUAL(heap.GetData(id).value, id);
+        BOOST_CHECK(!heap.WasRemoved(id));
+        BOOST_CHECK_EQUAL(heap.DeleteMin(), id);
+        BOOST_CHECK(heap.WasRemoved(id));
+    }
+    BOOST_CHECK(heap.Empty());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types)
+{
+    RadixHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+
+    for (TestNodeID id = 0; id < NUM_NODES; ++id)
+    {
+        heap.Insert(id, std::numeric_limits<TestWeight>::max(), TestData{id});
+    }
+
+    // no minimum was extracted yet, so any decrease is still monotone
+    for (TestNodeID id = 0; id < NUM_NODES; ++id)
+    {
+        const TestNodeID node = NUM_NODES - 1 - id;
+        heap.DecreaseKey(node, static_cast<TestWeight>(id));
+        BOOST_CHECK_EQUAL(heap.GetKey(node), static_cast<TestWeight>(id));
+    }
+    BOOST_CHECK_EQUAL(heap.Size(), NUM_NODES);
+
+    for (TestNodeID id = 0; id < NUM_NODES; ++id)
+    {
+        BOOST_CHECK_EQUAL(heap.DeleteMin(), NUM_NODES - 1 - id);
+    }
+    BOOST_CHECK(heap.Empty());
+}
+
+// Dijkstra on a random graph must settle nodes with the same distances as with a BinaryHeap
+BOOST_AUTO_TEST_CASE_TEMPLATE(dijkstra_test, T, storage_types)
+{
+    std::mt19937 g(42);
+    std::uniform_int_distribution<TestNodeID> node_distribution(0, NUM_NODES - 1);
+    std::uniform_int_distribution<TestWeight> weight_distribution(1, 1000);
+
+    std::vector<std::vector<std::pair<TestNodeID, TestWeight>>> adjacency(NUM_NODES);
+    for (unsigned edge = 0; edge < NUM_NODES * 4; ++edge)
+    {
+        adjacency[node_distribution(g)].emplace_back(node_distribution(g),
+                                                     weight_distribution(g));
+    }
+
+    const auto dijkstra = [&](auto &heap, const TestNodeID source) {
+        std::vector<TestWeight> distances(NUM_NODES, std::numeric_limits<TestWeight>::max());
+        heap.Clear();
+        heap.Insert(source, 0, TestData{source});
+        while (!heap.Empty())
+        {
+            const auto node = heap.DeleteMin();
+            const auto weight = heap.GetKey(node);
+            distances[node] = weight;
+            for (const auto &edge : adjacency[node])
+            {
+                const auto to_weight = weight + edge.second;
+                if (!heap.WasInserted(edge.first))
+                {
+                    heap.Insert(edge.first, to_weight, TestData{node});
+                }
+                else if (!heap.WasRemoved(edge.first) && to_weight < heap.GetKey(edge.first))
+                {
+                    heap.DecreaseKey(edge.first, to_weight);
+                }
+            }
+        }
+        return distances;
+    };
+
+    RadixHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> reference(NUM_NODES);
+    for (TestNodeID source = 0; source < 10; ++source)
+    {
+        const auto distances = dijkstra(heap, source);
+        const auto reference_distances = dijkstra(reference, source);
+        BOOST_CHECK_EQUAL_COLLECTIONS(distances.begin(),
+                                      distances.end(),
+                                      reference_distances.begin(),
+                                      reference_distances.end());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,171 @@
+#include "util/segment_projection.hpp"
+#include "util/coordinate.hpp"
+#include "util/cpu_features.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(segment_projection_kernels)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+struct ProjectionFixture
+{
+    ProjectionFixture() : generator(42), query{FloatLongitude{7.25}, FloatLatitude{-3.5}}
+    {
+        std::uniform_real_distribution<double> world_distribution(-180., 180.);
+        std::uniform_real_distribution<double> offset_distribution(-0.01, 0.01);
+        for (std::size_t i = 0; i < NUM_SEGMENTS; ++i)
+        {
+            source_lon.push_back(world_distribution(generator));
+            source_lat.push_back(world_distribution(generator));
+            if (i % 5 == 0)
+            {
+                // degenerated segments project onto their source
+                target_lon.push_back(source_lon.back());
+                target_lat.push_back(source_lat.back());
+            }
+            else if (i % 3 == 0)
+            {
+                // short segments near the query, the projection lies inside of them
+                source_lon.back() = static_cast<double>(query.lon) + offset_distribution(generator);
+                source_lat.back() = static_cast<double>(query.lat) + offset_distribution(generator);
+                target_lon.push_back(static_cast<double>(query.lon) +
+                                     offset_distribution(generator));
+                target_lat.push_back(static_cast<double>(query.lat) +
+                                     offset_distribution(generator));
+            }
+            else
+            {
+                target_lon.push_back(world_distribution(generator));
+                target_lat.push_back(world_distribution(generator));
+            }
+        }
+    }
+
+    struct Output
+    {
+        explicit Output(const std::size_t size)
+            : nearest_lon(size), nearest_lat(size), squared_distance(size)
+        {
+        }
+
+        segment_projection::Results Results()
+        {
+            return {nearest_lon.data(), nearest_lat.data(), squared_distance.data()};
+        }
+
+        std::vector<std::int32_t> nearest_lon;
+        std::vector<std::int32_t> nearest_lat;
+        std::vector<std::uint64_t> squared_distance;
+    };
+
+    segment_projection::Segments Segments() const
+    {
+        return {source_lon.data(), source_lat.data(), target_lon.data(), target_lat.data()};
+    }
+
+    Output Expected(const std::size_t count) const
+    {
+        Output expected(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            FloatCoordinate projected_nearest;
+            std::tie(std::ignore, projected_nearest) =
+                coordinate_calculation::projectPointOnSegment(
+                    {FloatLongitude{source_lon[i]}, FloatLatitude{source_lat[i]}},
+                    {FloatLongitude{target_lon[i]}, FloatLatitude{target_lat[i]}},
+                    query);
+            const Coordinate nearest{projected_nearest};
+            expected.nearest_lon[i] = static_cast<std::int32_t>(nearest.lon);
+            expected.nearest_lat[i] = static_cast<std::int32_t>(nearest.lat);
+            expected.squared_distance[i] =
+                coordinate_calculation::squaredEuclideanDistance(Coordinate{query}, nearest);
+        }
+        return expected;
+    }
+
+    static void CheckEqual(const Output &actual, const Output &expected)
+    {
+        BOOST_CHECK_EQUAL_COLLECTIONS(actual.nearest_lon.begin(),
+                                      actual.nearest_lon.end(),
+                                      expected.nearest_lon.begin(),
+                                      expected.nearest_lon.end());
+        BOOST_CHECK_EQUAL_COLLECTIONS(actual.nearest_lat.begin(),
+                                      actual.nearest_lat.end(),
+                                      expected.nearest_lat.begin(),
+                                      expected.nearest_lat.end());
+        BOOST_CHECK_EQUAL_COLLECTIONS(actual.squared_distance.begin(),
+                                      actual.squared_distance.end(),
+                                      expected.squared_distance.begin(),
+                                      expected.squared_distance.end());
+    }
+
+    // odd count to exercise the scalar tail of the vector kernels
+    static constexpr std::size_t NUM_SEGMENTS = 127;
+
+    std::mt19937 generator;
+    FloatCoordinate query;
+    std::vector<double> source_lon;
+    std::vector<double> source_lat;
+    std::vector<double> target_lon;
+    std::vector<double> target_lat;
+};
+}
+
+BOOST_FIXTURE_TEST_CASE(scalar_kernel, ProjectionFixture)
+{
+    Output actual(NUM_SEGMENTS);
+    segment_projection::ProjectScalar(
+        Segments(), NUM_SEGMENTS, query, Coordinate{query}, actual.Results());
+    CheckEqual(actual, Expected(NUM_SEGMENTS));
+}
+
+#if OSRM_X86_SIMD
+BOOST_FIXTURE_TEST_CASE(sse41_kernel, ProjectionFixture)
+{
+    if (!util::cpu::HasSSE41())
+    {
+        BOOST_TEST_MESSAGE("SSE4.1 not supported, skipping");
+        return;
+    }
+    Output actual(NUM_SEGMENTS);
+    segment_projection::ProjectSSE41(
+        Segments(), NUM_SEGMENTS, query, Coordinate{query}, actual.Results());
+    CheckEqual(actual, Expected(NUM_SEGMENTS));
+}
+
+BOOST_FIXTURE_TEST_CASE(avx2_kernel, ProjectionFixture)
+{
+    if (!util::cpu::HasAVX2())
+    {
+        BOOST_TEST_MESSAGE("AVX2 not supported, skipping");
+        return;
+    }
+    Output actual(NUM_SEGMENTS);
+    segment_projection::ProjectAVX2(
+        Segments(), NUM_SEGMENTS, query, Coordinate{query}, actual.Results());
+    CheckEqual(actual, Expected(NUM_SEGMENTS));
+}
+#endif
+
+BOOST_FIXTURE_TEST_CASE(dispatched_kernel_all_sizes, ProjectionFixture)
+{
+    for (std::size_t count = 0; count <= NUM_SEGMENTS; ++count)
+    {
+        Output actual(count);
+        segment_projection::Project(Segments(), count, query, Coordinate{query}, actual.Results());
+        CheckEqual(actual, Expected(count));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -16,8 +16,11 @@
 
 #include <cmath>
 #include <cstdint>
+#include <limits>
 
 #include <algorithm>
+#include <fstream>
+#include <iterator>
 #include <memory>
 #include <random>
 #include <string>
@@ -302,6 +305,84 @@ BOOST_FIXTURE_TEST_CASE(construct_multiple_levels_test, TestRandomGraphFixture_M
     construction_test("test_5", this);
 }
 
+std::vector<char> read_file(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file),
+                             std::istreambuf_iterator<char>());
+}
+
+BOOST_FIXTURE_TEST_CASE(construction_is_deterministic, TestRandomGraphFixture_MultipleLevels)
+{
+    std::string leaves_path;
+    std::string nodes_path;
+    std::string other_leaves_path;
+    std::string other_nodes_path;
+    build_rtree("test_deterministic", this, leaves_path, nodes_path);
+    build_rtree("test_deterministic_other", this, other_leaves_path, other_nodes_path);
+
+    const auto leaves = read_file(leaves_path);
+    const auto nodes = read_file(nodes_path);
+    BOOST_CHECK(leaves == read_file(other_leaves_path));
+    BOOST_CHECK(nodes == read_file(other_nodes_path));
+
+    // every leaf is referenced once and the rectangles of the children are inside their parent
+    using TreeNode = TestStaticRTree::TreeNode;
+    using LeafNode = TestStaticRTree::LeafNode;
+    BOOST_REQUIRE_EQUAL(leaves.size() % sizeof(LeafNode), 0);
+    std::vector<std::uint32_t> leaf_object_counts;
+    std::vector<RectangleInt2D> leaf_rectangles;
+    for (auto position = leaves.begin(); position != leaves.end(); position += sizeof(LeafNode))
+    {
+        LeafNode leaf;
+        std::copy_n(position, sizeof(LeafNode), reinterpret_cast<char *>(&leaf));
+        leaf_object_counts.push_back(leaf.object_count);
+        leaf_rectangles.push_back(leaf.minimum_bounding_rectangle);
+    }
+    std::uint64_t number_of_tree_nodes;
+    std::copy_n(nodes.begin(),
+                sizeof(number_of_tree_nodes),
+                reinterpret_cast<char *>(&number_of_tree_nodes));
+    BOOST_REQUIRE_EQUAL(nodes.size(),
+                        sizeof(number_of_tree_nodes) + number_of_tree_nodes * sizeof(TreeNode));
+    std::vector<TreeNode> tree_nodes(number_of_tree_nodes);
+    std::copy(nodes.begin() + sizeof(number_of_tree_nodes),
+              nodes.end(),
+              reinterpret_cast<char *>(tree_nodes.data()));
+
+    const auto contains = [](const RectangleInt2D &outer, const RectangleInt2D &inner) {
+        return outer.min_lon <= inner.min_lon && inner.max_lon <= outer.max_lon &&
+               outer.min_lat <= inner.min_lat && inner.max_lat <= outer.max_lat;
+    };
+    std::vector<unsigned> leaf_references(leaf_rectangles.size(), 0);
+    std::size_t number_of_objects = 0;
+    for (const auto &node : tree_nodes)
+    {
+        for (const auto i : irange(0u, node.child_count))
+        {
+            const auto child = node.children[i];
+            if (child.is_leaf)
+            {
+                BOOST_REQUIRE_LT(child.index, leaf_rectangles.size());
+                ++leaf_references[child.index];
+                number_of_objects += leaf_object_counts[child.index];
+                BOOST_CHECK(contains(node.minimum_bounding_rectangle,
+                                     leaf_rectangles[child.index]));
+            }
+            else
+            {
+                BOOST_REQUIRE_LT(child.index, tree_nodes.size());
+                BOOST_CHECK(contains(node.minimum_bounding_rectangle,
+                                     tree_nodes[child.index].minimum_bounding_rectangle));
+            }
+        }
+    }
+    BOOST_CHECK(std::all_of(leaf_references.begin(), leaf_references.end(), [](unsigned count) {
+        return count == 1;
+    }));
+    BOOST_CHECK_EQUAL(number_of_objects, edges.size());
+}
+
 // Bug: If you querry a point that lies between two BBs that have a gap,
 // one BB will be pruned, even if it could contain a nearer match.
 BOOST_AUTO_TEST_CASE(regression_test)
@@ -440,6 +521,172 @@ BOOST_AUTO_TEST_CASE(bearing_tests)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(batch_nearest_test, TestRandomGraphFixture_MultipleLevels)
+{
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree("test_batch", this, leaves_path, nodes_path);
+    TestStaticRTree rtree(nodes_path, leaves_path, coords);
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+    std::vector<Coordinate> queries;
+    for (unsigned i = 0; i < 100; i++)
+    {
+        queries.emplace_back(FixedLongitude{lon_udist(g)}, FixedLatitude{lat_udist(g)});
+    }
+    // duplicates and close queries share the leaves
+    queries.push_back(queries.front());
+    queries.emplace_back(queries.front().lon + FixedLongitude{10}, queries.front().lat);
+
+    const auto results = rtree.Nearest(queries, 5);
+    BOOST_REQUIRE_EQUAL(results.size(), queries.size());
+    for (const auto i : irange<std::size_t>(0, queries.size()))
+    {
+        const auto expected = rtree.Nearest(queries[i], 5);
+        BOOST_REQUIRE_EQUAL(results[i].size(), expected.size());
+        for (const auto j : irange<std::size_t>(0, expected.size()))
+        {
+            BOOST_CHECK_EQUAL(results[i][j].u, expected[j].u);
+            BOOST_CHECK_EQUAL(results[i][j].v, expected[j].v);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batch_bearing_tests)
+{
+    using Coord = std::pair<FloatLongitude, FloatLatitude>;
+    using Edge = std::pair<unsigned, unsigned>;
+    GraphFixture fixture(
+        {
+            Coord(FloatLongitude{0.0}, FloatLatitude{0.0}),
+            Coord(FloatLongitude{10.0}, FloatLatitude{10.0}),
+        },
+        {Edge(0, 1), Edge(1, 0)});
+
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<GraphFixture, MiniStaticRTree>(
+        "test_batch_bearing", &fixture, leaves_path, nodes_path);
+    MiniStaticRTree rtree(nodes_path, leaves_path, fixture.coords);
+    MockDataFacade mockfacade;
+    engine::GeospatialQuery<MiniStaticRTree, MockDataFacade> query(
+        rtree, fixture.coords, mockfacade);
+
+    Coordinate input(FloatLongitude{5.1}, FloatLatitude{5.0});
+
+    std::vector<engine::NearestQuery> queries(4, engine::NearestQuery{input});
+    queries[0].max_results = 5;
+    queries[1].max_results = 5;
+    queries[1].bearing = engine::Bearing{270, 10};
+    queries[2].max_distance = 11000;
+    queries[2].bearing = engine::Bearing{45, 10};
+    queries[3].max_distance = 0.01;
+
+    const auto results = query.NearestPhantomNodes(queries);
+    BOOST_REQUIRE_EQUAL(results.size(), 4);
+
+    BOOST_CHECK_EQUAL(results[0].size(), 2);
+    BOOST_CHECK_EQUAL(results[0].back().phantom_node.forward_segment_id.id, 0);
+    BOOST_CHECK_EQUAL(results[0].back().phantom_node.reverse_segment_id.id, 1);
+
+    BOOST_CHECK_EQUAL(results[1].size(), 0);
+
+    BOOST_REQUIRE_EQUAL(results[2].size(), 2);
+    BOOST_CHECK(results[2][0].phantom_node.forward_segment_id.enabled);
+    BOOST_CHECK(!results[2][0].phantom_node.reverse_segment_id.enabled);
+    BOOST_CHECK_EQUAL(results[2][0].phantom_node.forward_segment_id.id, 1);
+    BOOST_CHECK(!results[2][1].phantom_node.forward_segment_id.enabled);
+    BOOST_CHECK(results[2][1].phantom_node.reverse_segment_id.enabled);
+    BOOST_CHECK_EQUAL(results[2][1].phantom_node.reverse_segment_id.id, 1);
+
+    BOOST_CHECK_EQUAL(results[3].size(), 0);
+
+    const auto pairs = query.NearestPhantomNodeWithAlternativeFromBigComponent(queries);
+    BOOST_REQUIRE_EQUAL(pairs.size(), 4);
+    const auto expected = query.NearestPhantomNodeWithAlternativeFromBigComponent(input);
+    BOOST_CHECK_EQUAL(pairs[0].first.forward_segment_id.id, expected.first.forward_segment_id.id);
+    BOOST_CHECK_EQUAL(pairs[0].first.reverse_segment_id.id, expected.first.reverse_segment_id.id);
+    BOOST_CHECK(!pairs[1].first.IsValid());
+    BOOST_CHECK(pairs[2].first.IsValid());
+    BOOST_CHECK(!pairs[3].first.IsValid());
+}
+
+void check_equal_edges(const std::vector<TestData> &lhs, const std::vector<TestData> &rhs)
+{
+    BOOST_REQUIRE_EQUAL(lhs.size(), rhs.size());
+    for (const auto i : irange<std::size_t>(0, lhs.size()))
+    {
+        BOOST_CHECK_EQUAL(lhs[i].forward_segment_id.id, rhs[i].forward_segment_id.id);
+        BOOST_CHECK_EQUAL(lhs[i].forward_segment_id.enabled, rhs[i].forward_segment_id.enabled);
+        BOOST_CHECK_EQUAL(lhs[i].reverse_segment_id.id, rhs[i].reverse_segment_id.id);
+        BOOST_CHECK_EQUAL(lhs[i].reverse_segment_id.enabled, rhs[i].reverse_segment_id.enabled);
+        BOOST_CHECK_EQUAL(lhs[i].u, rhs[i].u);
+        BOOST_CHECK_EQUAL(lhs[i].v, rhs[i].v);
+        BOOST_CHECK_EQUAL(lhs[i].name_id, rhs[i].name_id);
+        BOOST_CHECK_EQUAL(lhs[i].packed_geometry_id, rhs[i].packed_geometry_id);
+        BOOST_CHECK_EQUAL(lhs[i].component.id, rhs[i].component.id);
+        BOOST_CHECK_EQUAL(lhs[i].component.is_tiny, rhs[i].component.is_tiny);
+        BOOST_CHECK_EQUAL(lhs[i].fwd_segment_position, rhs[i].fwd_segment_position);
+        BOOST_CHECK_EQUAL(lhs[i].forward_travel_mode, rhs[i].forward_travel_mode);
+        BOOST_CHECK_EQUAL(lhs[i].backward_travel_mode, rhs[i].backward_travel_mode);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(compressed_leaves_test, TestRandomGraphFixture_MultipleLevels)
+{
+    // every field of the objects survives the encoding, including the special ids
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<unsigned> id_udist(0, 1000);
+    std::uniform_int_distribution<unsigned> mode_udist(0, 15);
+    for (auto &edge : edges)
+    {
+        const auto id = id_udist(g);
+        edge.forward_segment_id = {id, id % 2 == 0};
+        edge.reverse_segment_id = id % 3 == 0 ? SegmentID{SPECIAL_SEGMENTID, false}
+                                              : SegmentID{id + 1, true};
+        edge.name_id = id_udist(g);
+        edge.packed_geometry_id = id % 5 == 0 ? SPECIAL_GEOMETRYID : id_udist(g);
+        edge.component = {id_udist(g), id % 7 == 0};
+        edge.fwd_segment_position = id % 11 == 0 ? std::numeric_limits<unsigned short>::max()
+                                                 : static_cast<unsigned short>(id_udist(g));
+        edge.forward_travel_mode = mode_udist(g);
+        edge.backward_travel_mode = mode_udist(g);
+    }
+
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree("test_compressed", this, leaves_path, nodes_path);
+    TestStaticRTree mapped_rtree(nodes_path, leaves_path, coords);
+    TestStaticRTree compressed_rtree(nodes_path, leaves_path, coords);
+    const auto mapped_size = compressed_rtree.GetLeavesSize();
+    compressed_rtree.CompressLeaves();
+    BOOST_CHECK(compressed_rtree.HasCompressedLeaves());
+    BOOST_CHECK_LT(compressed_rtree.GetLeavesSize(), mapped_size);
+
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+    std::vector<Coordinate> queries;
+    for (unsigned i = 0; i < 100; i++)
+    {
+        queries.emplace_back(FixedLongitude{lon_udist(g)}, FixedLatitude{lat_udist(g)});
+        check_equal_edges(compressed_rtree.Nearest(queries.back(), 10),
+                          mapped_rtree.Nearest(queries.back(), 10));
+    }
+
+    const auto compressed_results = compressed_rtree.Nearest(queries, 10);
+    const auto mapped_results = mapped_rtree.Nearest(queries, 10);
+    for (const auto i : irange<std::size_t>(0, queries.size()))
+    {
+        check_equal_edges(compressed_results[i], mapped_results[i]);
+    }
+
+    const RectangleInt2D bbox{
+        FloatLongitude{-90.0}, FloatLongitude{90.0}, FloatLatitude{-45.0}, FloatLatitude{45.0}};
+    check_equal_edges(compressed_rtree.SearchInBox(bbox), mapped_rtree.SearchInBox(bbox));
+}
+
 BOOST_AUTO_TEST_CASE(bbox_search_tests)
 {
     using Coord = std::pair<FloatLongitude, FloatLatitude>;
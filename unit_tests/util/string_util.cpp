@@ -4,6 +4,8 @@
 #include <boost/test/unit_test.hpp>
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 BOOST_AUTO_TEST_SUITE(string_util)
 
@@ -20,6 +22,11 @@ BOOST_AUTO_TEST_CASE(json_escaping)
     input = "Aleja \"Solidarnosci\"";
     output = escape_JSON(input);
     BOOST_CHECK_EQUAL(output, "Aleja \\\"Solidarnosci\\\"");
+
+    std::vector<char> buffer{'"'};
+    escape_JSON(input + "\n", buffer);
+    BOOST_CHECK_EQUAL(std::string(buffer.begin(), buffer.end()),
+                      "\"Aleja \\\"Solidarnosci\\\"\\n");
 }
 
 BOOST_AUTO_TEST_CASE(print_int)